@@ -22,6 +22,7 @@
 #define COMPRESS_DUMMY_FILE_PATH_DIST "@COMPRESS_DUMMY_FILE_PATH_DIST@"
 #define UNCOMPRESSED_DUMMY_FILE_PATH_SRC "@UNCOMPRESSED_DUMMY_FILE_PATH_SRC@"
 #define UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST "@UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST@"
+#define STORED_DUMMY_FILE_PATH_SRC "@STORED_DUMMY_FILE_PATH_SRC@"
 
 #define CTEST_RETURN_SUCCESS @CTEST_RETURN_SUCCESS@
 #define CTEST_RETURN_FAIL @CTEST_RETURN_FAIL@
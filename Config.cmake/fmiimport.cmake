@@ -64,6 +64,7 @@ set(FMIIMPORTHEADERS
 set(FMIIMPORTSOURCE
 	src/FMI/fmi_import_context.c
 	src/FMI/fmi_import_util.c
+	src/FMI/fmi_import_unpack_cache.c
 	
 	src/FMI1/fmi1_import_cosim.c
 	src/FMI1/fmi1_import_capi.c
@@ -82,6 +83,7 @@ set(FMIIMPORTSOURCE
 	src/FMI2/fmi2_import_variable.c
 	src/FMI2/fmi2_import_variable_list.c
 	src/FMI2/fmi2_import.c
+	src/FMI2/fmi2_import_md_cache.c
 	src/FMI2/fmi2_import_convenience.c
 	)
 
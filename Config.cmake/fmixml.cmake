@@ -24,10 +24,13 @@ set(FMIXML_EXPAT_DIR "${FMILIB_THIRDPARTYLIBS}/Expat/expat-2.1.0")
 set(FMIXMLHEADERS
 	include/FMI/fmi_xml_context.h
 	src/FMI/fmi_xml_context_impl.h
+	src/FMI/fmi_xml_hash.h
+	src/FMI/fmi_xml_file.h
 
     include/FMI1/fmi1_xml_model_description.h
     src/FMI1/fmi1_xml_model_description_impl.h
     src/FMI1/fmi1_xml_parser.h
+    src/FMI1/fmi1_xml_parser_hash.h
     include/FMI1/fmi1_xml_type.h
     src/FMI1/fmi1_xml_type_impl.h
     include/FMI1/fmi1_xml_unit.h
@@ -44,6 +47,7 @@ set(FMIXMLHEADERS
     include/FMI2/fmi2_xml_model_structure.h
     src/FMI2/fmi2_xml_model_structure_impl.h
     src/FMI2/fmi2_xml_parser.h
+    src/FMI2/fmi2_xml_parser_hash.h
     include/FMI2/fmi2_xml_type.h
     src/FMI2/fmi2_xml_type_impl.h
     include/FMI2/fmi2_xml_unit.h
@@ -54,6 +58,7 @@ set(FMIXMLHEADERS
 
 set(FMIXMLSOURCE
 	src/FMI/fmi_xml_context.c
+	src/FMI/fmi_xml_file.c
 
     src/FMI1/fmi1_xml_parser.c
     src/FMI1/fmi1_xml_model_description.c
@@ -67,6 +72,7 @@ set(FMIXMLSOURCE
     src/FMI2/fmi2_xml_parser.c
     src/FMI2/fmi2_xml_model_description.c
     src/FMI2/fmi2_xml_model_structure.c
+    src/FMI2/fmi2_xml_model_image.c
     src/FMI2/fmi2_xml_type.c
     src/FMI2/fmi2_xml_unit.c
 	src/FMI2/fmi2_xml_vendor_annotations.c
@@ -27,18 +27,70 @@ if(NOT FMIZIPDIR)
 set(FMIZIPSOURCE
   ${FMIZIPDIR}/src/fmi_zip_unzip.c
   ${FMIZIPDIR}/src/fmi_zip_zip.c
+  ${FMIZIPDIR}/src/fmi_zip_backend.c
+  ${FMIZIPDIR}/src/fmi_zip_crc32_pclmul.c
 )
 
 set(FMIZIPHEADERS
 #  src/fmi_zip_unzip_impl.h
+  ${FMIZIPDIR}/src/fmi_zip_backend_impl.h
   ${FMIZIPDIR}/include/FMI/fmi_zip_unzip.h
   ${FMIZIPDIR}/include/FMI/fmi_zip_zip.h
+  ${FMIZIPDIR}/include/FMI/fmi_zip_backend.h
 )
 
 #include_directories("${FMILIB_THIRDPARTYLIBS}/zlib/lib/VS2005/win32")
 
 SET(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DZLIB_STATIC")
 
+if(CMAKE_COMPILER_IS_GNUCC)
+  # Minizip headers (unzip.h, zip.h) are not C89 clean
+  set_source_files_properties(${FMIZIPSOURCE} PROPERTIES COMPILE_FLAGS "-std=c99")
+endif()
+
+# CRC-32 with carry-less multiplication on x86. The kernel is compiled with the instruction sets
+# enabled in a file of its own and selected at run time after checking the processor.
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|i.86|x86)$")
+  if(MSVC)
+    set(FMI_ZIP_HAVE_PCLMUL ON)
+  else()
+    include(CheckCSourceCompiles)
+    set(CMAKE_REQUIRED_FLAGS "-msse4.1 -mpclmul")
+    check_c_source_compiles("
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#include <cpuid.h>
+int main(void) {
+  unsigned int a, b, c, d;
+  __m128i x = _mm_clmulepi64_si128(_mm_setzero_si128(), _mm_setzero_si128(), 0);
+  __get_cpuid(1, &a, &b, &c, &d);
+  return _mm_extract_epi32(x, 1);
+}" FMI_ZIP_HAVE_PCLMUL)
+    unset(CMAKE_REQUIRED_FLAGS)
+    if(FMI_ZIP_HAVE_PCLMUL)
+      set_property(SOURCE ${FMIZIPDIR}/src/fmi_zip_crc32_pclmul.c APPEND_STRING PROPERTY COMPILE_FLAGS " -msse4.1 -mpclmul")
+    endif()
+  endif()
+  if(FMI_ZIP_HAVE_PCLMUL)
+    set_property(SOURCE ${FMIZIPDIR}/src/fmi_zip_backend.c ${FMIZIPDIR}/src/fmi_zip_crc32_pclmul.c APPEND PROPERTY COMPILE_DEFINITIONS FMI_ZIP_HAVE_PCLMUL)
+  endif()
+endif()
+
+if(NOT WIN32)
+  # Kernel side copying of the entries stored without compression
+  include(CheckSymbolExists)
+  set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+  check_symbol_exists(copy_file_range "unistd.h" FMI_ZIP_HAVE_COPY_FILE_RANGE)
+  check_symbol_exists(sendfile "sys/sendfile.h" FMI_ZIP_HAVE_SENDFILE)
+  check_symbol_exists(posix_fallocate "fcntl.h" FMI_ZIP_HAVE_POSIX_FALLOCATE)
+  unset(CMAKE_REQUIRED_DEFINITIONS)
+  foreach(feature FMI_ZIP_HAVE_COPY_FILE_RANGE FMI_ZIP_HAVE_SENDFILE FMI_ZIP_HAVE_POSIX_FALLOCATE)
+    if(${feature})
+      set_property(SOURCE ${FMIZIPDIR}/src/fmi_zip_unzip.c APPEND PROPERTY COMPILE_DEFINITIONS ${feature})
+    endif()
+  endforeach()
+endif()
+
 add_library(fmizip ${FMILIBKIND} ${FMIZIPSOURCE} ${FMIZIPHEADERS})
 
 target_link_libraries(fmizip minizip jmutils)
@@ -21,6 +21,12 @@ set(JMUTILSOURCE
  JM/jm_callbacks.c
  JM/jm_templates_inst.c
  JM/jm_named_ptr.c
+ JM/jm_hash.c
+ JM/jm_arena.c
+ JM/jm_string_intern.c
+ JM/jm_named_index.c
+ JM/jm_thread_pool.c
+ JM/jm_number.c
  JM/jm_portability.c
  FMI/fmi_version.c
  FMI/fmi_util.c
@@ -33,13 +39,21 @@ set(JMUTILHEADERS
   JM/jm_callbacks.h
   JM/jm_vector.h
   JM/jm_vector_template.h
+  JM/jm_sort_template.h
   JM/jm_stack.h
   JM/jm_types.h
   JM/jm_named_ptr.h
+  JM/jm_hash.h
   JM/jm_string_set.h
+  JM/jm_arena.h
+  JM/jm_string_intern.h
+  JM/jm_named_index.h
+  JM/jm_thread_pool.h
+  JM/jm_number.h
   JM/jm_portability.h
   FMI/fmi_version.h
   FMI/fmi_util.h
+  FMI/fmi_xml_parse_options.h
 
   FMI1/fmi1_functions.h
   FMI1/fmi1_types.h
@@ -62,8 +76,36 @@ endif(CYGWIN)
 
 target_link_libraries(jmutils c99snprintf)
 
+# 64-bit integers for the Eisel-Lemire conversion of doubles
+include(CheckCSourceCompiles)
+if(CMAKE_COMPILER_IS_GNUCC)
+	set(CMAKE_REQUIRED_FLAGS "-std=c99")
+endif()
+check_c_source_compiles("
+#include <stdint.h>
+int main(void) {
+  uint64_t x = UINT64_C(0x8000000000000000);
+  return (int)(x >> 63) - 1;
+}" JM_HAVE_UINT64)
+unset(CMAKE_REQUIRED_FLAGS)
+if(JM_HAVE_UINT64)
+	set_property(SOURCE ${JMUTILDIR}/src/JM/jm_number.c APPEND PROPERTY COMPILE_DEFINITIONS JM_HAVE_UINT64)
+	if(CMAKE_COMPILER_IS_GNUCC)
+		set_property(SOURCE ${JMUTILDIR}/src/JM/jm_number.c APPEND_STRING PROPERTY COMPILE_FLAGS " -std=c99")
+	endif()
+endif()
+
 if(UNIX) 
-	target_link_libraries(jmutils dl)
+	# Loading FMU binaries from memory
+	include(CheckSymbolExists)
+	set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+	check_symbol_exists(memfd_create "sys/mman.h" JM_HAVE_MEMFD_CREATE)
+	unset(CMAKE_REQUIRED_DEFINITIONS)
+	if(JM_HAVE_MEMFD_CREATE)
+		set_property(SOURCE ${JMUTILDIR}/src/JM/jm_portability.c APPEND PROPERTY COMPILE_DEFINITIONS JM_HAVE_MEMFD_CREATE)
+	endif()
+	find_package(Threads REQUIRED)
+	target_link_libraries(jmutils dl ${CMAKE_THREAD_LIBS_INIT})
 endif(UNIX)
 if(WIN32)
 	target_link_libraries(jmutils Shlwapi)
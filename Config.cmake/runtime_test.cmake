@@ -55,6 +55,7 @@ endfunction()
 
 set(UNCOMPRESSED_DUMMY_FILE_PATH_SRC "${RTTESTDIR}/try_to_uncompress_this_file.zip")
 set(UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST "${TEST_OUTPUT_FOLDER}")
+set(STORED_DUMMY_FILE_PATH_SRC "${RTTESTDIR}/try_to_uncompress_this_stored_file.zip")
 file(COPY "${UNCOMPRESSED_DUMMY_FILE_PATH_SRC}" DESTINATION "${UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST}")
 
 set(COMPRESS_DUMMY_FILE_PATH_SRC "${RTTESTDIR}/try_to_compress_this_file.xml")
@@ -69,6 +70,7 @@ if (WIN32)
 	STRING(REPLACE "/" "\\\\" UNCOMPRESSED_DUMMY_FILE_PATH_SRC "${UNCOMPRESSED_DUMMY_FILE_PATH_SRC}")
 	STRING(REPLACE "/" "\\\\" UNCOMPRESSED_DUMMY_FILE_PATH_DIST "${UNCOMPRESSED_DUMMY_FILE_PATH_DIST}")
 	STRING(REPLACE "/" "\\\\" UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST "${UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST}")
+	STRING(REPLACE "/" "\\\\" STORED_DUMMY_FILE_PATH_SRC "${STORED_DUMMY_FILE_PATH_SRC}")
 	STRING(REPLACE "/" "\\\\" COMPRESS_DUMMY_FILE_PATH_SRC "${COMPRESS_DUMMY_FILE_PATH_SRC}")
 	STRING(REPLACE "/" "\\\\" COMPRESS_DUMMY_FILE_PATH_DIST "${COMPRESS_DUMMY_FILE_PATH_DIST}")
 endif(WIN32)
@@ -124,6 +126,27 @@ target_link_libraries (fmi_zip_zip_test ${FMIZIP_LIBRARIES})
 add_executable (fmi_zip_unzip_test ${RTTESTDIR}/FMI1/fmi_zip_unzip_test.c )
 target_link_libraries (fmi_zip_unzip_test ${FMIZIP_LIBRARIES})
 
+add_executable (fmi_zip_benchmark ${RTTESTDIR}/fmi_zip_benchmark.c )
+target_link_libraries (fmi_zip_benchmark ${FMIZIP_LIBRARIES})
+
+add_executable (fmi_xml_number_benchmark ${RTTESTDIR}/fmi_xml_number_benchmark.c )
+target_link_libraries (fmi_xml_number_benchmark ${FMIXML_LIBRARIES})
+
+add_executable (jm_vector_benchmark ${RTTESTDIR}/jm_vector_benchmark.c )
+target_link_libraries (jm_vector_benchmark ${JMUTIL_LIBRARIES})
+
+add_executable (jm_portability_test ${RTTESTDIR}/jm_portability_test.c )
+target_link_libraries (jm_portability_test ${JMUTIL_LIBRARIES})
+
+# Checks the perfect hash tables of the XML parsers and regenerates them with --generate
+add_executable (fmi_xml_hash_test
+					${RTTESTDIR}/fmi_xml_hash_test.c
+					${RTTESTDIR}/fmi_xml_hash_test.h
+					${RTTESTDIR}/FMI1/fmi1_xml_hash_test.c
+					${RTTESTDIR}/FMI2/fmi2_xml_hash_test.c)
+set_property(TARGET fmi_xml_hash_test APPEND PROPERTY INCLUDE_DIRECTORIES ${FMIXMLDIR}/src)
+target_link_libraries (fmi_xml_hash_test ${FMIXML_LIBRARIES})
+
 add_executable (fmi_import_test 
 					${RTTESTDIR}/fmi_import_test.c
 					${RTTESTDIR}/FMI1/fmi1_import_test.c
@@ -133,6 +156,11 @@ target_link_libraries (fmi_import_test  ${FMILIBFORTEST})
 set_target_properties(
 	fmi_zip_zip_test   
 	fmi_zip_unzip_test
+	fmi_zip_benchmark
+	fmi_xml_number_benchmark
+	jm_vector_benchmark
+	jm_portability_test
+	fmi_xml_hash_test
 	fmi_import_test
     PROPERTIES FOLDER "Test")
 # include CTest gives more options (such as running valgrind automatically)
@@ -159,6 +187,22 @@ ADD_TEST(ctest_fmi_zip_zip_test fmi_zip_zip_test)
 include(test_fmi1)
 include(test_fmi2)
 
+# Compares the CRC-32 and inflate implementations, run with more repetitions for meaningful timings
+ADD_TEST(ctest_fmi_zip_benchmark fmi_zip_benchmark 1 ${TEST_OUTPUT_FOLDER} ${UNCOMPRESSED_DUMMY_FILE_PATH_SRC} ${STORED_DUMMY_FILE_PATH_SRC} ${FMU_ME_PATH} ${FMU2_CS_PATH})
+
+# Checks the number parsers against the C library, run with more variables and repetitions for meaningful timings
+ADD_TEST(ctest_fmi_xml_number_benchmark fmi_xml_number_benchmark 10000 1 ${TEST_OUTPUT_FOLDER})
+
+# Checks that filling a vector scales linearly, run with more items and repetitions for meaningful timings
+ADD_TEST(ctest_jm_vector_benchmark jm_vector_benchmark 100000 1)
+
+ADD_TEST(ctest_fmi_xml_hash_test fmi_xml_hash_test)
+
+# Loads two libraries from memory at the same time
+ADD_TEST(ctest_jm_portability_test jm_portability_test
+	${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_CFG_INTDIR}/${CMAKE_SHARED_LIBRARY_PREFIX}fmu1_dll_me${CMAKE_SHARED_LIBRARY_SUFFIX}
+	${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_CFG_INTDIR}/${CMAKE_SHARED_LIBRARY_PREFIX}fmu2_dll_me${CMAKE_SHARED_LIBRARY_SUFFIX})
+
 ADD_TEST(ctest_fmi_import_test_no_xml fmi_import_test ${UNCOMPRESSED_DUMMY_FILE_PATH_SRC} ${TEST_OUTPUT_FOLDER})	
   set_tests_properties(ctest_fmi_import_test_no_xml PROPERTIES WILL_FAIL TRUE)
 ADD_TEST(ctest_fmi_import_test_me_1 fmi_import_test ${FMU_ME_PATH} ${FMU_TEMPFOLDER})
@@ -175,6 +219,11 @@ if(FMILIB_BUILD_BEFORE_TESTS)
 		ctest_fmi_import_test_cs_2
 		ctest_fmi_zip_unzip_test
 		ctest_fmi_zip_zip_test
+		ctest_fmi_zip_benchmark
+		ctest_fmi_xml_number_benchmark
+		ctest_jm_vector_benchmark
+		ctest_jm_portability_test
+		ctest_fmi_xml_hash_test
 		PROPERTIES DEPENDS ctest_build_all)
 endif()
 SET_TESTS_PROPERTIES ( ctest_fmi_import_test_no_xml PROPERTIES DEPENDS ctest_fmi_zip_unzip_test) 
\ No newline at end of file
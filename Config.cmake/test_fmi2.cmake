@@ -68,9 +68,12 @@ add_executable (fmi2_import_me_test ${RTTESTDIR}/FMI2/fmi2_import_me_test.c )
 target_link_libraries (fmi2_import_me_test  ${FMILIBFORTEST}  )
 add_executable (fmi2_import_cs_test ${RTTESTDIR}/FMI2/fmi2_import_cs_test.c )
 target_link_libraries (fmi2_import_cs_test  ${FMILIBFORTEST}  )
+add_executable (fmi2_import_model_test ${RTTESTDIR}/FMI2/fmi2_import_model_test.c )
+target_link_libraries (fmi2_import_model_test  ${FMILIBFORTEST}  )
 set_target_properties(
 	fmi2_import_xml_test 
 	fmi2_import_me_test fmi2_import_cs_test
+	fmi2_import_model_test
     PROPERTIES FOLDER "Test/FMI2")
 ADD_TEST(ctest_fmi2_import_xml_test_empty fmi2_import_xml_test ${FMU2_DUMMY_FOLDER})
 add_test(ctest_fmi2_import_xml_test_me fmi2_import_xml_test ${TEST_OUTPUT_FOLDER}/${FMU2_DUMMY_ME_MODEL_IDENTIFIER}_me)
@@ -79,6 +82,7 @@ add_test(ctest_fmi2_import_xml_test_mf fmi2_import_xml_test ${TEST_OUTPUT_FOLDER
   set_tests_properties(ctest_fmi2_import_xml_test_mf PROPERTIES WILL_FAIL TRUE)
 add_test(ctest_fmi2_import_test_me fmi2_import_me_test ${FMU2_ME_PATH} ${FMU_TEMPFOLDER})
 add_test(ctest_fmi2_import_test_cs fmi2_import_cs_test ${FMU2_CS_PATH} ${FMU_TEMPFOLDER})
+add_test(ctest_fmi2_import_model_test fmi2_import_model_test ${FMU_TEMPFOLDER})
 
 if(FMILIB_BUILD_BEFORE_TESTS)
 	SET_TESTS_PROPERTIES ( 
@@ -88,6 +92,7 @@ if(FMILIB_BUILD_BEFORE_TESTS)
 		ctest_fmi2_import_xml_test_empty
 		ctest_fmi2_import_test_me
 		ctest_fmi2_import_test_cs
+		ctest_fmi2_import_model_test
 		PROPERTIES DEPENDS ctest_build_all)
 endif()
 
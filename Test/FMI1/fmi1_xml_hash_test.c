@@ -0,0 +1,44 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <FMI1/fmi1_xml_parser.h>
+#include <FMI1/fmi1_xml_parser_hash.h>
+#include "fmi_xml_hash_test.h"
+
+#define NAME_STR(name) #name,
+#define NAME_STR_NO_COMMA(name) #name
+
+static const char* elm_names[] = { FMI1_XML_ELMLIST(NAME_STR) };
+static const char* attr_names[] = { FMI1_XML_ATTRLIST(NAME_STR_NO_COMMA) };
+
+void fmi1_xml_hash_test_tables(fmi_xml_hash_table_t* elm, fmi_xml_hash_table_t* attr) {
+	elm->prefix = "fmi1_xml_elm";
+	elm->macroPrefix = "FMI1_XML_ELM";
+	elm->names = elm_names;
+	elm->count = FMI_XML_HASH_TEST_SIZE(elm_names);
+	elm->expectedCount = fmi1_xml_elm_number;
+	elm->seed = FMI1_XML_ELM_HASH_SEED;
+	elm->size = FMI_XML_HASH_TEST_SIZE(fmi1_xml_elm_hash_table);
+	elm->table = fmi1_xml_elm_hash_table;
+
+	attr->prefix = "fmi1_xml_attr";
+	attr->macroPrefix = "FMI1_XML_ATTR";
+	attr->names = attr_names;
+	attr->count = FMI_XML_HASH_TEST_SIZE(attr_names);
+	attr->expectedCount = fmi1_xml_attr_number;
+	attr->seed = FMI1_XML_ATTR_HASH_SEED;
+	attr->size = FMI_XML_HASH_TEST_SIZE(fmi1_xml_attr_hash_table);
+	attr->table = fmi1_xml_attr_hash_table;
+}
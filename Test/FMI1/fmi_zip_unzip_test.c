@@ -21,7 +21,9 @@
 
 #include <JM/jm_types.h>
 #include <JM/jm_callbacks.h>
+#include <JM/jm_portability.h>
 #include <FMI/fmi_zip_unzip.h>
+#include <FMI/fmi_zip_backend.h>
 #include "config_test.h"
 
 
@@ -38,6 +40,108 @@ void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_leve
         printf("module = %s, log level = %d: %s\n", module, log_level, message);
 }
 
+/* Compare an extracted file with the data read through minizip */
+int compare_with_archive(const char* zipPath, const char* name, jm_callbacks* callbacks)
+{
+	char path[FILENAME_MAX + 1];
+	char* expected;
+	char* actual;
+	size_t size;
+	FILE* file;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(fmi_zip_unzip_to_memory(zipPath, name, &expected, &size, callbacks) == jm_status_error) {
+		printf("Failed to read the entry %s into memory\n", name);
+		return CTEST_RETURN_FAIL;
+	}
+	actual = (char*)malloc(size + 1);
+	sprintf(path, "%s/%s", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, name);
+	file = fopen(path, "rb");
+	if(!file || !actual || (fread(actual, 1, size + 1, file) != size) || memcmp(expected, actual, size)) {
+		printf("Extracted entry %s differs from the archive\n", path);
+		ret = CTEST_RETURN_FAIL;
+	}
+	if(file) fclose(file);
+	free(actual);
+	callbacks->free(expected);
+	return ret;
+}
+
+/* Extract the compressed entries with several threads, the files are removed first so that the old copies do not count */
+int parallel_test(jm_callbacks* callbacks)
+{
+	const char* names[] = {"successfully_uncompressed_this_file.xml", "successfully_uncompressed_this_sub_folder/somefile.xml"};
+	char path[FILENAME_MAX + 1];
+	size_t k;
+
+	for(k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+		sprintf(path, "%s/%s", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, names[k]);
+		remove(path);
+	}
+	if(fmi_zip_unzip_parallel(UNCOMPRESSED_DUMMY_FILE_PATH_SRC, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 0, 0, 4, callbacks) == jm_status_error) {
+		printf("Failed to uncompress the file using several threads\n");
+		return CTEST_RETURN_FAIL;
+	}
+	for(k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+		if(compare_with_archive(UNCOMPRESSED_DUMMY_FILE_PATH_SRC, names[k], callbacks) != CTEST_RETURN_SUCCESS) return CTEST_RETURN_FAIL;
+	}
+	return CTEST_RETURN_SUCCESS;
+}
+
+/* Extract an archive with entries stored without compression and compare with the data read through minizip */
+int stored_test(jm_callbacks* callbacks)
+{
+	if(fmi_zip_unzip_parallel(STORED_DUMMY_FILE_PATH_SRC, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 0, 0, 2, callbacks) == jm_status_error) {
+		printf("Failed to uncompress the stored entries\n");
+		return CTEST_RETURN_FAIL;
+	}
+	return compare_with_archive(STORED_DUMMY_FILE_PATH_SRC, "successfully_uncompressed_stored_folder/stored_file.txt", callbacks);
+}
+
+/* A damaged copy of the stored archive must be rejected whether the CRC is checked while extracting or deferred */
+int crc_test(jm_callbacks* callbacks)
+{
+	char path[FILENAME_MAX + 1];
+	char* data;
+	long size;
+	FILE* file;
+	int deferred, ret = CTEST_RETURN_SUCCESS;
+
+	/* Both checks pass on the intact archives */
+	fmi_zip_set_deferred_crc_check(1);
+	if((fmi_zip_unzip_parallel(UNCOMPRESSED_DUMMY_FILE_PATH_SRC, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 0, 0, 2, callbacks) != jm_status_success) ||
+	   (fmi_zip_unzip_parallel(STORED_DUMMY_FILE_PATH_SRC, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 0, 0, 1, callbacks) != jm_status_success)) {
+		printf("Failed to uncompress with deferred CRC checks\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+
+	file = fopen(STORED_DUMMY_FILE_PATH_SRC, "rb");
+	if(!file) return CTEST_RETURN_FAIL;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	data = (char*)malloc(size);
+	fread(data, 1, size, file);
+	fclose(file);
+	/* The middle of the archive is inside the data of the large stored file */
+	data[size / 2] ^= 1;
+	sprintf(path, "%s/damaged_stored_file.zip", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST);
+	file = fopen(path, "wb");
+	fwrite(data, 1, size, file);
+	fclose(file);
+	free(data);
+
+	for(deferred = 0; deferred <= 1; deferred++) {
+		fmi_zip_set_deferred_crc_check(deferred);
+		if(fmi_zip_unzip_parallel(path, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 0, 0, 1, callbacks) != jm_status_error) {
+			printf("CRC error was not detected%s\n", deferred ? " with deferred checks" : "");
+			ret = CTEST_RETURN_FAIL;
+		}
+	}
+	fmi_zip_set_deferred_crc_check(0);
+	return ret;
+}
+
 /**
  * \brief Unzip test. Tests the fmi_zip_unzip function by uncompressing some file.
  *
@@ -46,6 +150,8 @@ int main(int argc, char *argv[])
 {
 	jm_callbacks callbacks;
 	jm_status_enu_t status;	
+	char cwdBefore[FILENAME_MAX + 1];
+	char cwdAfter[FILENAME_MAX + 1];
 
 	callbacks.malloc = malloc;
     callbacks.calloc = calloc;
@@ -55,11 +161,24 @@ int main(int argc, char *argv[])
 	callbacks.log_level = jm_log_level_debug;
     callbacks.context = 0;
 
+	jm_portability_get_current_working_directory(cwdBefore, FILENAME_MAX + 1);
+
 	status = fmi_zip_unzip(UNCOMPRESSED_DUMMY_FILE_PATH_SRC, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, &callbacks);
 
+	jm_portability_get_current_working_directory(cwdAfter, FILENAME_MAX + 1);
+
 	if (status == jm_status_error) {
 		printf("Failed to uncompress the file\n");
 		do_exit(CTEST_RETURN_FAIL);
+	} else if (strcmp(cwdBefore, cwdAfter) != 0) {
+		printf("Current working directory was changed while uncompressing\n");
+		do_exit(CTEST_RETURN_FAIL);
+	} else if (parallel_test(&callbacks) != CTEST_RETURN_SUCCESS) {
+		do_exit(CTEST_RETURN_FAIL);
+	} else if (stored_test(&callbacks) != CTEST_RETURN_SUCCESS) {
+		do_exit(CTEST_RETURN_FAIL);
+	} else if (crc_test(&callbacks) != CTEST_RETURN_SUCCESS) {
+		do_exit(CTEST_RETURN_FAIL);
 	} else {
 		printf("Succesfully uncompressed the file\n");
 		do_exit(CTEST_RETURN_SUCCESS);
@@ -15,10 +15,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <JM/jm_types.h>
 #include <JM/jm_callbacks.h>
 #include <FMI/fmi_zip_zip.h>
+#include <FMI/fmi_zip_unzip.h>
 #include "config_test.h"
 
 #define PRINT_MY_DEBUG printf("Line: %d \t File: %s \n",__LINE__, __FILE__)
@@ -38,6 +40,63 @@ void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_leve
         printf("module = %s, log level = %d: %s\n", module, log_level, message);
 }
 
+/* Compress a generated file larger than one chunk in parallel and compare the archive content with it */
+int parallel_test(jm_callbacks* callbacks)
+{
+	const char* large_file = "successfully_compressed_large_file.txt";
+	const char* files_to_zip[2];
+	fmi_zip_level_rule_t rules[1];
+	char path[FILENAME_MAX + 1];
+	char zip_path[FILENAME_MAX + 1];
+	char* expected;
+	char* actual;
+	size_t size = 0, actual_size;
+	FILE* file;
+	int i, ret = CTEST_RETURN_SUCCESS;
+
+	sprintf(path, "%s/%s", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, large_file);
+	sprintf(zip_path, "%s/%s", UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, "successfully_compressed_in_parallel.zip");
+	expected = (char*)malloc(3000000);
+	file = fopen(path, "wb");
+	if(!expected || !file) {
+		printf("Could not create %s\n", path);
+		return CTEST_RETURN_FAIL;
+	}
+	for(i = 0; size < 2900000; i++) {
+		size += sprintf(expected + size, "Line %d with some text to compress %d\n", i, (i * 7919) % 1000);
+	}
+	fwrite(expected, 1, size, file);
+	fclose(file);
+
+	files_to_zip[0] = large_file;
+	files_to_zip[1] = "try_to_compress_this_file.xml";
+	rules[0].pattern = "*.xml";
+	rules[0].level = FMI_ZIP_LEVEL_STORE;
+	if(fmi_zip_zip_parallel(zip_path, UNCOMPRESSED_DUMMY_FOLDER_PATH_DIST, 2, files_to_zip, rules, 1, FMI_ZIP_LEVEL_BEST, 4, callbacks) != jm_status_success) {
+		printf("Failed to compress the files in parallel\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+	else if(fmi_zip_unzip_to_memory(zip_path, large_file, &actual, &actual_size, callbacks) != jm_status_success) {
+		printf("Failed to read back the compressed file\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		if((actual_size != size) || memcmp(expected, actual, size)) {
+			printf("The file compressed in parallel differs from the original\n");
+			ret = CTEST_RETURN_FAIL;
+		}
+		callbacks->free(actual);
+		if(fmi_zip_unzip_to_memory(zip_path, files_to_zip[1], &actual, &actual_size, callbacks) != jm_status_success) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			callbacks->free(actual);
+		}
+	}
+	free(expected);
+	return ret;
+}
+
 /**
  * \brief Zip test. Tests the fmi_zip_zip function by compressing some file.
  *
@@ -64,6 +123,8 @@ int main(int argc, char *argv[])
 	if (status == jm_status_error) {
 		printf("Failed to compress the file\n");
 		do_exit(CTEST_RETURN_FAIL);
+	} else if (parallel_test(&callbacks) != CTEST_RETURN_SUCCESS) {
+		do_exit(CTEST_RETURN_FAIL);
 	} else {
 		printf("Succesfully compressed the file\n");
 		do_exit(CTEST_RETURN_SUCCESS);
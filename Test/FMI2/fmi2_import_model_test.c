@@ -0,0 +1,458 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* Parses generated model descriptions and checks the result against values computed by the test */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <config_test.h>
+#include <fmilib.h>
+
+#define BUFFER 65536
+
+/* Output variables of the list test, there is one Unknown for each */
+#define LIST_TEST_OUTPUTS 18
+
+void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_level, jm_string message)
+{
+	printf("module = %s, log level = %d: %s\n", module, log_level, message);
+}
+
+/* Write modelDescription.xml into the directory and parse it */
+static fmi2_import_t* parse_model(fmi_import_context_t* context, const char* dirPath, const char* typeDefinitions, const char* variables, const char* structure)
+{
+	char xmlPath[BUFFER];
+	FILE* file;
+
+	strcpy(xmlPath, dirPath);
+	strcat(xmlPath, FMI_FILE_SEP "modelDescription.xml");
+	file = fopen(xmlPath, "w");
+	if(!file) {
+		printf("Could not create %s\n", xmlPath);
+		return 0;
+	}
+	fprintf(file,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<fmiModelDescription fmiVersion=\"2.0\" modelName=\"model_test\" guid=\"{model_test}\" numberOfEventIndicators=\"0\">\n"
+		"<ModelExchange modelIdentifier=\"model_test\"/>\n"
+		"%s"
+		"<ModelVariables>\n%s</ModelVariables>\n"
+		"<ModelStructure>\n%s</ModelStructure>\n"
+		"</fmiModelDescription>\n", typeDefinitions, variables, structure);
+	fclose(file);
+	return fmi2_import_parse_xml(context, dirPath, 0);
+}
+
+static int is_space(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+/* Append a string to an attribute value, white space other than blanks as character references so that expat keeps it */
+static void append_attr(char* attr, const char* str)
+{
+	attr += strlen(attr);
+	for(; *str; str++) {
+		switch(*str) {
+		case '\t': strcpy(attr, "&#9;"); break;
+		case '\n': strcpy(attr, "&#10;"); break;
+		case '\r': strcpy(attr, "&#13;"); break;
+		default: attr[0] = *str; attr[1] = 0; break;
+		}
+		attr += strlen(attr);
+	}
+}
+
+/* Split a list the plain way, returns the number of items */
+static size_t split_list(const char* str, const char** items, size_t* lengths)
+{
+	size_t count = 0;
+	while(*str) {
+		if(is_space(*str)) {
+			str++;
+			continue;
+		}
+		items[count] = str;
+		while(*str && !is_space(*str)) str++;
+		lengths[count] = str - items[count];
+		count++;
+	}
+	return count;
+}
+
+/*
+	Build a dependency list and a matching dependenciesKind list. The lists start with 'shift' white
+	space characters, so with shifts 0-17 every item boundary lands on and next to the 16 byte edges
+	that the vectorized item count works with. Both lists are longer than 32 characters and mix
+	blanks, tabs, line feeds and carriage returns.
+*/
+static void make_lists(int shift, char* deps, char* kinds)
+{
+	static const char space[] = " \t\n\r";
+	static const char* kindNames[] = {"dependent", "constant", "fixed", "tunable", "discrete"};
+	int i, j;
+	size_t depLen, kindLen;
+
+	for(i = 0; i < shift; i++) {
+		deps[i] = space[i % 4];
+		kinds[i] = space[(i + 1) % 4];
+	}
+	depLen = kindLen = shift;
+	for(i = 0; (depLen < 48 + (size_t)shift) || (kindLen < 48 + (size_t)shift); i++) {
+		/* separators of one to three white space characters */
+		if(i) {
+			for(j = 0; j <= (i + shift) % 3; j++) {
+				deps[depLen++] = space[(i + j) % 4];
+				kinds[kindLen++] = space[(i + j + shift) % 4];
+			}
+		}
+		depLen += sprintf(deps + depLen, "%d", (i * 7 + shift) % LIST_TEST_OUTPUTS + 1);
+		kindLen += sprintf(kinds + kindLen, "%s", kindNames[(i + shift) % 5]);
+	}
+	/* a trailing separator on every other list */
+	if(shift % 2) {
+		deps[depLen++] = space[shift % 4];
+		kinds[kindLen++] = space[(shift + 2) % 4];
+	}
+	deps[depLen] = 0;
+	kinds[kindLen] = 0;
+}
+
+static char kind_of(const char* item, size_t len)
+{
+	if(!strncmp(item, "dependent", len)) return fmi2_dependency_factor_kind_dependent;
+	if(!strncmp(item, "constant", len)) return fmi2_dependency_factor_kind_constant;
+	if(!strncmp(item, "fixed", len)) return fmi2_dependency_factor_kind_fixed;
+	if(!strncmp(item, "tunable", len)) return fmi2_dependency_factor_kind_tunable;
+	return fmi2_dependency_factor_kind_discrete;
+}
+
+/* Long white space separated lists in the model structure must give the same items as a plain split */
+static int list_test(fmi_import_context_t* context, const char* dirPath)
+{
+	static char variables[BUFFER], structure[BUFFER];
+	static char deps[LIST_TEST_OUTPUTS][256], kinds[LIST_TEST_OUTPUTS][256];
+	const char* items[256];
+	size_t lengths[256];
+	fmi2_import_t* fmu;
+	size_t *startIndex, *dependency;
+	char* factorKind;
+	int i, ret = CTEST_RETURN_SUCCESS;
+
+	variables[0] = structure[0] = 0;
+	strcat(structure, "<Outputs>\n");
+	for(i = 0; i < LIST_TEST_OUTPUTS; i++) {
+		sprintf(variables + strlen(variables),
+			"<ScalarVariable name=\"y%d\" valueReference=\"%d\" causality=\"output\" variability=\"continuous\"><Real/></ScalarVariable>\n", i + 1, i);
+		make_lists(i, deps[i], kinds[i]);
+		sprintf(structure + strlen(structure), "<Unknown index=\"%d\" dependencies=\"", i + 1);
+		append_attr(structure, deps[i]);
+		strcat(structure, "\" dependenciesKind=\"");
+		append_attr(structure, kinds[i]);
+		strcat(structure, "\"/>\n");
+	}
+	strcat(structure, "</Outputs>\n");
+
+	fmu = parse_model(context, dirPath, "", variables, structure);
+	if(!fmu) {
+		printf("Could not parse the model with long dependency lists\n");
+		return CTEST_RETURN_FAIL;
+	}
+	fmi2_import_get_outputs_dependencies(fmu, &startIndex, &dependency, &factorKind);
+	if(!startIndex) {
+		printf("The dependencies of the outputs are missing\n");
+		fmi2_import_free(fmu);
+		return CTEST_RETURN_FAIL;
+	}
+	for(i = 0; (i < LIST_TEST_OUTPUTS) && (ret == CTEST_RETURN_SUCCESS); i++) {
+		size_t j, count = split_list(deps[i], items, lengths);
+		if((split_list(kinds[i], items + count, lengths + count) != count) || (startIndex[i + 1] - startIndex[i] != count)) {
+			printf("Unknown %d: expected %u dependencies, got %u\n", i + 1, (unsigned)count, (unsigned)(startIndex[i + 1] - startIndex[i]));
+			ret = CTEST_RETURN_FAIL;
+			break;
+		}
+		for(j = 0; j < count; j++) {
+			size_t k = startIndex[i] + j;
+			if((dependency[k] != strtoul(items[j], 0, 10)) || (factorKind[k] != kind_of(items[count + j], lengths[count + j]))) {
+				printf("Unknown %d: dependency %u differs from the plain split\n", i + 1, (unsigned)j);
+				ret = CTEST_RETURN_FAIL;
+				break;
+			}
+		}
+	}
+	fmi2_import_free(fmu);
+	if(ret == CTEST_RETURN_SUCCESS) printf("Long dependency lists are parsed as expected\n");
+	return ret;
+}
+
+/* The lookup the index must agree with: the first base variable with the reference in the sorted vector */
+static fmi2_import_variable_t* find_by_vr(fmi2_import_variable_list_t* byVR, fmi2_base_type_enu_t baseType, fmi2_value_reference_t vr)
+{
+	size_t i, n = fmi2_import_get_variable_list_size(byVR);
+	if(baseType == fmi2_base_type_enum) baseType = fmi2_base_type_int;
+	for(i = 0; i < n; i++) {
+		fmi2_import_variable_t* v = fmi2_import_get_variable(byVR, i);
+		fmi2_base_type_enu_t t = fmi2_import_get_variable_base_type(v);
+		if(t == fmi2_base_type_enum) t = fmi2_base_type_int;
+		if((t == baseType) && (fmi2_import_get_variable_vr(v) == vr) && (fmi2_import_get_variable_alias_kind(v) == fmi2_variable_is_not_alias))
+			return v;
+	}
+	return 0;
+}
+
+static fmi2_import_variable_t* find_by_name(fmi2_import_variable_list_t* byName, const char* name)
+{
+	size_t i, n = fmi2_import_get_variable_list_size(byName);
+	for(i = 0; i < n; i++) {
+		fmi2_import_variable_t* v = fmi2_import_get_variable(byName, i);
+		if(!strcmp(fmi2_import_get_variable_name(v), name)) return v;
+	}
+	return 0;
+}
+
+/* Sparse value references, an Integer and an Enumeration sharing a reference and lookups that miss */
+static int index_test(fmi_import_context_t* context, const char* dirPath)
+{
+	static const char* typeDefinitions =
+		"<TypeDefinitions>\n"
+		"<SimpleType name=\"Mode\"><Enumeration><Item name=\"off\" value=\"1\"/><Item name=\"on\" value=\"2\"/></Enumeration></SimpleType>\n"
+		"</TypeDefinitions>\n";
+	static const char* variableLines[] = {
+		"<ScalarVariable name=\"r0\" valueReference=\"0\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"r1\" valueReference=\"1000000\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"r2\" valueReference=\"4000000000\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"r2alias\" valueReference=\"4000000000\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"i0\" valueReference=\"0\"><Integer/></ScalarVariable>\n",
+		"<ScalarVariable name=\"i1\" valueReference=\"1000000\"><Integer/></ScalarVariable>\n",
+		"<ScalarVariable name=\"i2\" valueReference=\"4000000000\"><Integer/></ScalarVariable>\n",
+		"<ScalarVariable name=\"shared\" valueReference=\"7\"><Integer/></ScalarVariable>\n",
+		"<ScalarVariable name=\"mode\" valueReference=\"7\"><Enumeration declaredType=\"Mode\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"mode2\" valueReference=\"8\"><Enumeration declaredType=\"Mode\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"b0\" valueReference=\"0\"><Boolean/></ScalarVariable>\n",
+		"<ScalarVariable name=\"b1\" valueReference=\"1\"><Boolean/></ScalarVariable>\n",
+		"<ScalarVariable name=\"b2\" valueReference=\"2\"><Boolean/></ScalarVariable>\n",
+		"<ScalarVariable name=\"s0\" valueReference=\"1000000\"><String/></ScalarVariable>\n"
+	};
+	static const fmi2_value_reference_t vrs[] = {
+		0, 1, 2, 3, 7, 8, 999999, 1000000, 1000001, 3999999999U, 4000000000U, 4000000001U, 4294967295U
+	};
+	static const char* names[] = {
+		"r0", "r1", "r2", "r2alias", "i0", "i1", "i2", "shared", "mode", "mode2", "b0", "b1", "b2", "s0",
+		"", "r", "r00", "r2alia", "r2alias_", "s1", "zz"
+	};
+	static char variables[BUFFER];
+	fmi2_base_type_enu_t t;
+	fmi2_import_t* fmu;
+	fmi2_import_variable_list_t *byName = 0, *byVR = 0;
+	size_t i;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	variables[0] = 0;
+	for(i = 0; i < sizeof(variableLines) / sizeof(variableLines[0]); i++) strcat(variables, variableLines[i]);
+	fmu = parse_model(context, dirPath, typeDefinitions, variables, "");
+	if(!fmu) {
+		printf("Could not parse the model with sparse value references\n");
+		return CTEST_RETURN_FAIL;
+	}
+	byName = fmi2_import_get_variable_list(fmu, 1);
+	byVR = fmi2_import_get_variable_list(fmu, 2);
+	if(!byName || !byVR || (fmi2_import_get_variable_list_size(byName) != 14)) {
+		printf("The sorted variable lists are not complete\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+	for(i = 0; (ret == CTEST_RETURN_SUCCESS) && (i < sizeof(names) / sizeof(names[0])); i++) {
+		if(fmi2_import_get_variable_by_name(fmu, names[i]) != find_by_name(byName, names[i])) {
+			printf("Lookup of the name '%s' differs from the sorted list\n", names[i]);
+			ret = CTEST_RETURN_FAIL;
+		}
+	}
+	for(t = fmi2_base_type_real; (ret == CTEST_RETURN_SUCCESS) && (t <= fmi2_base_type_enum); t = (fmi2_base_type_enu_t)(t + 1)) {
+		for(i = 0; i < sizeof(vrs) / sizeof(vrs[0]); i++) {
+			if(fmi2_import_get_variable_by_vr(fmu, t, vrs[i]) != find_by_vr(byVR, t, vrs[i])) {
+				printf("Lookup of %s reference %u differs from the sorted list\n", fmi2_base_type_to_string(t), (unsigned)vrs[i]);
+				ret = CTEST_RETURN_FAIL;
+				break;
+			}
+		}
+	}
+	/* the cases that matter are really found */
+	if((ret == CTEST_RETURN_SUCCESS) &&
+		(!fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_real, 4000000000U) || !fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_enum, 7) ||
+		 !fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_enum, 8) || fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_bool, 3))) {
+		printf("Lookups by value reference give unexpected results\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+	if(byName) fmi2_import_free_variable_list(byName);
+	if(byVR) fmi2_import_free_variable_list(byVR);
+	fmi2_import_free(fmu);
+	if(ret == CTEST_RETURN_SUCCESS) printf("Lookups by name and value reference agree with the sorted lists\n");
+	return ret;
+}
+
+/* Compare a variable list with the expected names, and with the expected alias kinds if given */
+static int check_list(fmi2_import_variable_list_t* list, const char* what, const char** names, const char* aliases, size_t num)
+{
+	size_t i;
+
+	if(!list || (fmi2_import_get_variable_list_size(list) != num)) {
+		printf("The variables %s do not have the expected size\n", what);
+		return CTEST_RETURN_FAIL;
+	}
+	for(i = 0; i < num; i++) {
+		fmi2_import_variable_t* v = fmi2_import_get_variable(list, i);
+		if(strcmp(fmi2_import_get_variable_name(v), names[i])) {
+			printf("Variable %u %s is '%s', expected '%s'\n", (unsigned)i, what, fmi2_import_get_variable_name(v), names[i]);
+			return CTEST_RETURN_FAIL;
+		}
+		if(aliases && ((fmi2_import_get_variable_alias_kind(v) == fmi2_variable_is_alias) != (aliases[i] == 'a'))) {
+			printf("Variable '%s' has the wrong alias kind\n", names[i]);
+			return CTEST_RETURN_FAIL;
+		}
+	}
+	return CTEST_RETURN_SUCCESS;
+}
+
+/*
+	Alias sets with conflicting start values lose all the variables of the conflicting base type.
+	Integer and Enumeration variables with the same value reference form one set, but the aliases
+	are among the variables of the same base type only.
+*/
+static int alias_test(fmi_import_context_t* context, const char* dirPath)
+{
+	static const char* typeDefinitions =
+		"<TypeDefinitions>\n"
+		"<SimpleType name=\"Mode\"><Enumeration><Item name=\"off\" value=\"1\"/><Item name=\"on\" value=\"2\"/></Enumeration></SimpleType>\n"
+		"</TypeDefinitions>\n";
+	static const char* variableLines[] = {
+		/* two start values, all removed */
+		"<ScalarVariable name=\"ra1\" valueReference=\"1\" initial=\"exact\"><Real start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ra2\" valueReference=\"1\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ra3\" valueReference=\"1\" initial=\"exact\"><Real start=\"2\"/></ScalarVariable>\n",
+		/* a correct set */
+		"<ScalarVariable name=\"rb1\" valueReference=\"2\"><Real/></ScalarVariable>\n",
+		"<ScalarVariable name=\"rb2\" valueReference=\"2\" initial=\"exact\"><Real start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"rb3\" valueReference=\"2\"><Real/></ScalarVariable>\n",
+		/* the Integers conflict, the Enumerations stay */
+		"<ScalarVariable name=\"ic1\" valueReference=\"3\" variability=\"discrete\" initial=\"exact\"><Integer start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ec1\" valueReference=\"3\" variability=\"discrete\" initial=\"exact\"><Enumeration declaredType=\"Mode\" start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ic2\" valueReference=\"3\" variability=\"discrete\" initial=\"exact\"><Integer start=\"2\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ec2\" valueReference=\"3\" variability=\"discrete\"><Enumeration declaredType=\"Mode\"/></ScalarVariable>\n",
+		/* the Enumerations conflict, the Integers stay */
+		"<ScalarVariable name=\"ed1\" valueReference=\"4\" variability=\"discrete\" initial=\"exact\"><Enumeration declaredType=\"Mode\" start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"id1\" valueReference=\"4\" variability=\"discrete\"><Integer/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ed2\" valueReference=\"4\" variability=\"discrete\" initial=\"exact\"><Enumeration declaredType=\"Mode\" start=\"2\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"id2\" valueReference=\"4\" variability=\"discrete\" initial=\"exact\"><Integer start=\"5\"/></ScalarVariable>\n",
+		/* Integer and Enumeration with one start value each */
+		"<ScalarVariable name=\"ie1\" valueReference=\"5\" variability=\"discrete\" initial=\"exact\"><Integer start=\"1\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ee1\" valueReference=\"5\" variability=\"discrete\" initial=\"exact\"><Enumeration declaredType=\"Mode\" start=\"2\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"ie2\" valueReference=\"5\" variability=\"discrete\"><Integer/></ScalarVariable>\n",
+		/* Booleans, a conflicting set and a single variable */
+		"<ScalarVariable name=\"bf1\" valueReference=\"1\" variability=\"discrete\" initial=\"exact\"><Boolean start=\"true\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"bf2\" valueReference=\"1\" variability=\"discrete\" initial=\"exact\"><Boolean start=\"false\"/></ScalarVariable>\n",
+		"<ScalarVariable name=\"bg1\" valueReference=\"2\" variability=\"discrete\"><Boolean/></ScalarVariable>\n"
+	};
+	static const char* removed[] = {"ra1", "ra2", "ra3", "ic1", "ic2", "ed1", "ed2", "bf1", "bf2"};
+	static const char* origOrder[] = {"rb1", "rb2", "rb3", "ec1", "ec2", "id1", "id2", "ie1", "ee1", "ie2", "bg1"};
+	static const char origAliases[] = "naananannan";
+	static const char* byName[] = {"bg1", "ec1", "ec2", "ee1", "id1", "id2", "ie1", "ie2", "rb1", "rb2", "rb3"};
+	static const char* byVR[] = {"rb1", "rb2", "rb3", "ec1", "ec2", "id1", "id2", "ie1", "ee1", "ie2", "bg1"};
+	static char variables[BUFFER];
+	fmi2_import_t* fmu;
+	fmi2_import_variable_list_t* list;
+	size_t i;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	variables[0] = 0;
+	for(i = 0; i < sizeof(variableLines) / sizeof(variableLines[0]); i++) strcat(variables, variableLines[i]);
+	fmu = parse_model(context, dirPath, typeDefinitions, variables, "");
+	if(!fmu) {
+		printf("Could not parse the model with alias sets\n");
+		return CTEST_RETURN_FAIL;
+	}
+	for(i = 0; i < sizeof(removed) / sizeof(removed[0]); i++) {
+		if(fmi2_import_get_variable_by_name(fmu, removed[i])) {
+			printf("Variable '%s' of a bad alias set was not removed\n", removed[i]);
+			ret = CTEST_RETURN_FAIL;
+		}
+	}
+	if(ret == CTEST_RETURN_SUCCESS) {
+		list = fmi2_import_get_variable_list(fmu, 0);
+		ret = check_list(list, "in the original order", origOrder, origAliases, sizeof(origOrder) / sizeof(origOrder[0]));
+		if(list) fmi2_import_free_variable_list(list);
+	}
+	if(ret == CTEST_RETURN_SUCCESS) {
+		list = fmi2_import_get_variable_list(fmu, 1);
+		ret = check_list(list, "by name", byName, 0, sizeof(byName) / sizeof(byName[0]));
+		if(list) fmi2_import_free_variable_list(list);
+	}
+	if(ret == CTEST_RETURN_SUCCESS) {
+		list = fmi2_import_get_variable_list(fmu, 2);
+		ret = check_list(list, "by value reference", byVR, 0, sizeof(byVR) / sizeof(byVR[0]));
+		if(list) fmi2_import_free_variable_list(list);
+	}
+	/* lookups by value reference give the first base variable, Integer and Enumeration alike */
+	if((ret == CTEST_RETURN_SUCCESS) &&
+		((fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_real, 2) != fmi2_import_get_variable_by_name(fmu, "rb1")) ||
+		 (fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_int, 3) != fmi2_import_get_variable_by_name(fmu, "ec1")) ||
+		 (fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_enum, 4) != fmi2_import_get_variable_by_name(fmu, "id1")) ||
+		 (fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_enum, 5) != fmi2_import_get_variable_by_name(fmu, "ie1")) ||
+		 fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_real, 1) || fmi2_import_get_variable_by_vr(fmu, fmi2_base_type_bool, 1))) {
+		printf("Lookups by value reference do not give the base variables\n");
+		ret = CTEST_RETURN_FAIL;
+	}
+	fmi2_import_free(fmu);
+	if(ret == CTEST_RETURN_SUCCESS) printf("Bad alias sets are removed and the rest is marked correctly\n");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	jm_callbacks callbacks;
+	fmi_import_context_t* context;
+	char* dirPath;
+	int ret;
+
+	if(argc < 2) {
+		printf("Usage: %s <temporary_dir>\n", argv[0]);
+		return CTEST_RETURN_FAIL;
+	}
+
+	callbacks.malloc = malloc;
+	callbacks.calloc = calloc;
+	callbacks.realloc = realloc;
+	callbacks.free = free;
+	callbacks.logger = importlogger;
+	callbacks.log_level = jm_log_level_warning;
+	callbacks.context = 0;
+
+	context = fmi_import_allocate_context(&callbacks);
+	dirPath = fmi_import_mk_temp_dir(&callbacks, argv[1], "fmil_model_");
+	if(!context || !dirPath) {
+		printf("Could not set up the test\n");
+		if(context) fmi_import_free_context(context);
+		return CTEST_RETURN_FAIL;
+	}
+
+	ret = list_test(context, dirPath);
+	if(ret == CTEST_RETURN_SUCCESS) ret = index_test(context, dirPath);
+	if(ret == CTEST_RETURN_SUCCESS) ret = alias_test(context, dirPath);
+
+	fmi_import_rmdir(&callbacks, dirPath);
+	callbacks.free(dirPath);
+	fmi_import_free_context(context);
+	return ret;
+}
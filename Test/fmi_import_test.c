@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include <config_test.h>
 #include <fmilib.h>
@@ -25,9 +26,13 @@
 extern int fmi1_test(fmi_import_context_t* context, const char* dirPath);
 extern int fmi2_test(fmi_import_context_t* context, const char* dirPath);
 
+/* Set when a model description is taken from the model description cache */
+static int imageLoaded = 0;
+
 void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_level, jm_string message)
 {
         printf("module = %s, log level = %d: %s\n", module, log_level, message);
+		if(strstr(message, "Loaded model description from image")) imageLoaded = 1;
 }
 
 void do_exit(int code)
@@ -36,7 +41,544 @@ void do_exit(int code)
 	/* getchar(); */
 	exit(code);
 }
+
+/* Parse the model description straight from the FMU archive and compare with the unpacked one */
+int archive_test(fmi_import_context_t* context, const char* FMUPath, const char* dirPath, fmi_version_enu_t version)
+{
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(fmi_import_get_fmi_version_from_archive(context, FMUPath) != version) {
+		printf("FMI version detected from the archive differs from the unpacked FMU\n");
+		return CTEST_RETURN_FAIL;
+	}
+
+	if(version == fmi_version_1_enu) {
+		fmi1_import_t* fmu = fmi1_import_parse_xml(context, dirPath);
+		fmi1_import_t* fmuArchive = fmi1_import_parse_xml_from_archive(context, FMUPath);
+		fmi1_callback_functions_t callBackFunctions;
+		memset(&callBackFunctions, 0, sizeof(callBackFunctions));
+		if(!fmu || !fmuArchive || strcmp(fmi1_import_get_GUID(fmu), fmi1_import_get_GUID(fmuArchive))
+			|| (fmi1_import_get_variable_list_size(fmi1_import_get_variable_list(fmuArchive)) == 0)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		/* Binaries are unpacked on demand */
+		else if(fmi1_import_create_dllfmu(fmuArchive, callBackFunctions, 0) != jm_status_success) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi1_import_destroy_dllfmu(fmuArchive);
+		}
+		if(fmu) fmi1_import_free(fmu);
+		if(fmuArchive) fmi1_import_free(fmuArchive);
+	}
+	else {
+		fmi2_import_t* fmu = fmi2_import_parse_xml(context, dirPath, 0);
+		fmi2_import_t* fmuArchive = fmi2_import_parse_xml_from_archive(context, FMUPath, 0);
+		if(!fmu || !fmuArchive || strcmp(fmi2_import_get_GUID(fmu), fmi2_import_get_GUID(fmuArchive))
+			|| (fmi2_import_get_variable_list_size(fmi2_import_get_variable_list(fmuArchive, 0)) == 0)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi2_fmu_kind_enu_t kind = (fmi2_import_get_fmu_kind(fmuArchive) == fmi2_fmu_kind_cs) ? fmi2_fmu_kind_cs : fmi2_fmu_kind_me;
+			/* Binaries are loaded from memory, then unpacked on demand */
+			fmi2_import_set_load_binary_from_memory(fmuArchive, 1);
+			if(fmi2_import_create_dllfmu(fmuArchive, kind, 0) != jm_status_success) {
+				ret = CTEST_RETURN_FAIL;
+			}
+			fmi2_import_destroy_dllfmu(fmuArchive);
+			fmi2_import_set_load_binary_from_memory(fmuArchive, 0);
+			if(fmi2_import_create_dllfmu(fmuArchive, kind, 0) != jm_status_success) {
+				ret = CTEST_RETURN_FAIL;
+			}
+			fmi2_import_destroy_dllfmu(fmuArchive);
+		}
+		if(fmu) fmi2_import_free(fmu);
+		if(fmuArchive) fmi2_import_free(fmuArchive);
+	}
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("Parsing the model description from the archive failed\n");
+	}
+	return ret;
+}
 	   
+/* Unpack the FMU twice into a shared cache and check that the second time the first copy is reused */
+int cache_test(jm_callbacks* callbacks, const char* FMUPath, const char* tmpPath)
+{
+	char cacheDir[BUFFER];
+	char xmlPath[BUFFER];
+	char stalePath[BUFFER];
+	char staleFile[BUFFER];
+	char staleInfo[BUFFER];
+	char* tempDir;
+	fmi_import_unpack_lease_t* lease1;
+	fmi_import_unpack_lease_t* lease2;
+	FILE* xml;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	sprintf(cacheDir, "%s%s%s", tmpPath, FMI_FILE_SEP, "unpack_cache");
+	lease1 = fmi_import_unzip_cached(callbacks, FMUPath, cacheDir, 0);
+	lease2 = fmi_import_unzip_cached(callbacks, FMUPath, cacheDir, 0);
+	if(!lease1 || !lease2 || strcmp(fmi_import_get_unpack_lease_dir(lease1), fmi_import_get_unpack_lease_dir(lease2))) {
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		sprintf(xmlPath, "%s%s%s", fmi_import_get_unpack_lease_dir(lease2), FMI_FILE_SEP, FMI_MODEL_DESCRIPTION_XML);
+		xml = fopen(xmlPath, "r");
+		if(xml) fclose(xml);
+		else ret = CTEST_RETURN_FAIL;
+	}
+	fmi_import_release_unpack_lease(lease1);
+	fmi_import_release_unpack_lease(lease2);
+
+	/* Leftovers of a process that died while unpacking and of one that died before publishing */
+	strcpy(stalePath, cacheDir);
+	strcat(stalePath, FMI_FILE_SEP "0123456789abcdef.staging.2147483647.1");
+	strcpy(staleFile, stalePath);
+	strcat(staleFile, FMI_FILE_SEP "file");
+	strcpy(staleInfo, cacheDir);
+	strcat(staleInfo, FMI_FILE_SEP "fedcba9876543210.info");
+	tempDir = fmi_import_mk_temp_dir(callbacks, cacheDir, 0);
+	if(!tempDir || rename(tempDir, stalePath)) ret = CTEST_RETURN_FAIL;
+	callbacks->free(tempDir);
+	xml = fopen(staleFile, "w");
+	if(xml) fclose(xml);
+	xml = fopen(staleInfo, "w");
+	if(xml) {
+		fprintf(xml, "1000\n");
+		fclose(xml);
+	}
+
+	/* The leftovers are removed even without a size limit */
+	lease1 = fmi_import_unzip_cached(callbacks, FMUPath, cacheDir, 0);
+	if(!lease1 || (ret != CTEST_RETURN_SUCCESS)) {
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		xml = fopen(xmlPath, "r");
+		if(xml) fclose(xml);
+		else ret = CTEST_RETURN_FAIL;
+		xml = fopen(staleFile, "r");
+		if(xml) {
+			fclose(xml);
+			ret = CTEST_RETURN_FAIL;
+		}
+		xml = fopen(staleInfo, "r");
+		if(xml) {
+			fclose(xml);
+			ret = CTEST_RETURN_FAIL;
+		}
+	}
+
+	/* Leased entries must survive eviction */
+	lease2 = fmi_import_unzip_cached(callbacks, FMUPath, cacheDir, 1);
+	if(!lease2 || (ret != CTEST_RETURN_SUCCESS)) {
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		xml = fopen(xmlPath, "r");
+		if(xml) fclose(xml);
+		else ret = CTEST_RETURN_FAIL;
+	}
+	fmi_import_release_unpack_lease(lease1);
+	fmi_import_release_unpack_lease(lease2);
+
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("Unpacking the FMU into the cache failed\n");
+	}
+	return ret;
+}
+
+static int compare_strings(const char* s1, const char* s2) {
+	if(!s1 || !s2) return (s1 != s2);
+	return strcmp(s1, s2);
+}
+
+/* Compare the value references in two variable lists and free the lists */
+static int compare_variable_lists(fmi2_import_variable_list_t* vl1, fmi2_import_variable_list_t* vl2) {
+	size_t i, n = vl1 ? fmi2_import_get_variable_list_size(vl1) : 0;
+	int ret = (!vl1 != !vl2) || (vl2 && (n != fmi2_import_get_variable_list_size(vl2)));
+	for(i = 0; !ret && (i < n); i++) {
+		ret = (fmi2_import_get_variable_vr(fmi2_import_get_variable(vl1, i)) != fmi2_import_get_variable_vr(fmi2_import_get_variable(vl2, i)));
+	}
+	if(vl1) fmi2_import_free_variable_list(vl1);
+	if(vl2) fmi2_import_free_variable_list(vl2);
+	return ret;
+}
+
+/* Check that two FMI 2.0 model descriptions agree on the data visible through the API */
+static int compare_fmi2_model_descriptions(fmi2_import_t* fmu1, fmi2_import_t* fmu2)
+{
+	fmi2_import_variable_list_t* vl1 = fmi2_import_get_variable_list(fmu1, 0);
+	fmi2_import_variable_list_t* vl2 = fmi2_import_get_variable_list(fmu2, 0);
+	fmi2_import_unit_definitions_t* ud1 = fmi2_import_get_unit_definitions(fmu1);
+	fmi2_import_unit_definitions_t* ud2 = fmi2_import_get_unit_definitions(fmu2);
+	size_t i, n = fmi2_import_get_variable_list_size(vl1);
+	int ret = compare_strings(fmi2_import_get_GUID(fmu1), fmi2_import_get_GUID(fmu2))
+		|| compare_strings(fmi2_import_get_model_name(fmu1), fmi2_import_get_model_name(fmu2))
+		|| compare_strings(fmi2_import_get_description(fmu1), fmi2_import_get_description(fmu2))
+		|| compare_strings(fmi2_import_get_generation_tool(fmu1), fmi2_import_get_generation_tool(fmu2))
+		|| (fmi2_import_get_fmu_kind(fmu1) != fmi2_import_get_fmu_kind(fmu2))
+		|| (fmi2_import_get_number_of_continuous_states(fmu1) != fmi2_import_get_number_of_continuous_states(fmu2))
+		|| (fmi2_import_get_number_of_event_indicators(fmu1) != fmi2_import_get_number_of_event_indicators(fmu2))
+		|| (fmi2_import_get_default_experiment_stop(fmu1) != fmi2_import_get_default_experiment_stop(fmu2))
+		|| (fmi2_import_get_type_definition_number(fmi2_import_get_type_definitions(fmu1))
+			!= fmi2_import_get_type_definition_number(fmi2_import_get_type_definitions(fmu2)))
+		|| (!ud1 != !ud2)
+		|| (ud1 && (fmi2_import_get_unit_definitions_number(ud1) != fmi2_import_get_unit_definitions_number(ud2)))
+		|| (n != fmi2_import_get_variable_list_size(vl2))
+		|| compare_variable_lists(fmi2_import_get_outputs_list(fmu1), fmi2_import_get_outputs_list(fmu2))
+		|| compare_variable_lists(fmi2_import_get_derivatives_list(fmu1), fmi2_import_get_derivatives_list(fmu2));
+
+	for(i = 0; !ret && (i < n); i++) {
+		fmi2_import_variable_t* v1 = fmi2_import_get_variable(vl1, i);
+		fmi2_import_variable_t* v2 = fmi2_import_get_variable(vl2, i);
+		fmi2_import_variable_typedef_t* t1 = fmi2_import_get_variable_declared_type(v1);
+		fmi2_import_variable_typedef_t* t2 = fmi2_import_get_variable_declared_type(v2);
+
+		ret = compare_strings(fmi2_import_get_variable_name(v1), fmi2_import_get_variable_name(v2))
+			|| compare_strings(fmi2_import_get_variable_description(v1), fmi2_import_get_variable_description(v2))
+			|| (fmi2_import_get_variable_vr(v1) != fmi2_import_get_variable_vr(v2))
+			|| (fmi2_import_get_variable_base_type(v1) != fmi2_import_get_variable_base_type(v2))
+			|| (fmi2_import_get_causality(v1) != fmi2_import_get_causality(v2))
+			|| (fmi2_import_get_variability(v1) != fmi2_import_get_variability(v2))
+			|| (fmi2_import_get_variable_has_start(v1) != fmi2_import_get_variable_has_start(v2))
+			|| (!t1 != !t2)
+			|| (t1 && compare_strings(fmi2_import_get_type_name(t1), fmi2_import_get_type_name(t2)));
+		if(!ret && (fmi2_import_get_variable_base_type(v1) == fmi2_base_type_real)) {
+			fmi2_import_real_variable_t* r1 = fmi2_import_get_variable_as_real(v1);
+			fmi2_import_real_variable_t* r2 = fmi2_import_get_variable_as_real(v2);
+			fmi2_import_unit_t* u1 = fmi2_import_get_real_variable_unit(r1);
+			fmi2_import_unit_t* u2 = fmi2_import_get_real_variable_unit(r2);
+			ret = (fmi2_import_get_real_variable_start(r1) != fmi2_import_get_real_variable_start(r2))
+				|| (fmi2_import_get_real_variable_min(r1) != fmi2_import_get_real_variable_min(r2))
+				|| (fmi2_import_get_real_variable_max(r1) != fmi2_import_get_real_variable_max(r2))
+				|| (!u1 != !u2)
+				|| (u1 && compare_strings(fmi2_import_get_unit_name(u1), fmi2_import_get_unit_name(u2)));
+		}
+	}
+	fmi2_import_free_variable_list(vl1);
+	fmi2_import_free_variable_list(vl2);
+	return ret;
+}
+
+/* Parse the model description twice with the model description cache and compare with plain parsing */
+int md_cache_test(fmi_import_context_t* context, jm_callbacks* callbacks, const char* dirPath)
+{
+	char* cacheDir = fmi_import_mk_temp_dir(callbacks, dirPath, "fmil_md_");
+	fmi2_import_t* fmu;
+	fmi2_import_t* fmuCached;
+	int ret = CTEST_RETURN_SUCCESS;
+	int pass;
+
+	fmu = fmi2_import_parse_xml(context, dirPath, 0);
+	if(!cacheDir || !fmu || (fmi_import_set_model_description_cache_dir(context, cacheDir) != jm_status_success)) {
+		printf("Could not set up the model description cache\n");
+		if(fmu) fmi2_import_free(fmu);
+		callbacks->free(cacheDir);
+		return CTEST_RETURN_FAIL;
+	}
+	/* The first pass populates the cache, the second one must use it */
+	for(pass = 0; (pass < 2) && (ret == CTEST_RETURN_SUCCESS); pass++) {
+		imageLoaded = 0;
+		fmuCached = fmi2_import_parse_xml(context, dirPath, 0);
+		if(!fmuCached || compare_fmi2_model_descriptions(fmu, fmuCached) || ((pass == 1) && !imageLoaded)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		if(fmuCached) fmi2_import_free(fmuCached);
+	}
+	fmi_import_set_model_description_cache_dir(context, 0);
+	fmi2_import_free(fmu);
+	fmi_import_rmdir(callbacks, cacheDir);
+	callbacks->free(cacheDir);
+
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("The model description from the cache differs from the parsed one\n");
+	}
+	return ret;
+}
+
+/* Parse the model description without the optional sections and compare with the complete one */
+int parse_options_test(fmi_import_context_t* context, const char* dirPath, fmi_version_enu_t version)
+{
+	fmi_xml_parse_options_t options;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	options.skipSections = fmi_xml_section_all;
+	options.numThreads = 0;
+	if(version == fmi_version_1_enu) {
+		fmi1_import_t* fmu = fmi1_import_parse_xml(context, dirPath);
+		fmi1_import_t* fmuSkipped;
+		fmi_import_set_parse_options(context, &options);
+		fmuSkipped = fmi1_import_parse_xml(context, dirPath);
+		if(!fmu || !fmuSkipped || (fmi1_import_get_parsed_sections(fmu) != fmi_xml_section_all)
+			|| (fmi1_import_get_parsed_sections(fmuSkipped) != 0)
+			|| strcmp(fmi1_import_get_GUID(fmu), fmi1_import_get_GUID(fmuSkipped))
+			|| (fmi1_import_get_number_of_continuous_states(fmu) != fmi1_import_get_number_of_continuous_states(fmuSkipped))
+			|| fmi1_import_get_unit_definitions(fmuSkipped)
+			|| fmi1_import_get_description(fmuSkipped)
+			|| fmi1_import_get_vendor_list(fmuSkipped)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi1_import_variable_list_t* vl1 = fmi1_import_get_variable_list(fmu);
+			fmi1_import_variable_list_t* vl2 = fmi1_import_get_variable_list(fmuSkipped);
+			size_t i, n = fmi1_import_get_variable_list_size(vl1);
+			if(n != fmi1_import_get_variable_list_size(vl2)) ret = CTEST_RETURN_FAIL;
+			for(i = 0; (ret == CTEST_RETURN_SUCCESS) && (i < n); i++) {
+				fmi1_import_variable_t* v1 = fmi1_import_get_variable(vl1, (unsigned int)i);
+				fmi1_import_variable_t* v2 = fmi1_import_get_variable(vl2, (unsigned int)i);
+				if(strcmp(fmi1_import_get_variable_name(v1), fmi1_import_get_variable_name(v2))
+					|| (fmi1_import_get_variable_vr(v1) != fmi1_import_get_variable_vr(v2))
+					|| (fmi1_import_get_causality(v1) != fmi1_import_get_causality(v2))
+					|| fmi1_import_get_variable_description(v2)
+					|| ((fmi1_import_get_causality(v2) == fmi1_causality_enu_output) && fmi1_import_get_direct_dependency(fmuSkipped, v2))) {
+					ret = CTEST_RETURN_FAIL;
+				}
+			}
+			fmi1_import_free_variable_list(vl1);
+			fmi1_import_free_variable_list(vl2);
+		}
+		if(fmu) fmi1_import_free(fmu);
+		if(fmuSkipped) fmi1_import_free(fmuSkipped);
+	}
+	else {
+		fmi2_import_t* fmu = fmi2_import_parse_xml(context, dirPath, 0);
+		fmi2_import_t* fmuSkipped;
+		fmi_import_set_parse_options(context, &options);
+		fmuSkipped = fmi2_import_parse_xml(context, dirPath, 0);
+		if(!fmu || !fmuSkipped || (fmi2_import_get_parsed_sections(fmu) != fmi_xml_section_all)
+			|| (fmi2_import_get_parsed_sections(fmuSkipped) != 0)
+			|| strcmp(fmi2_import_get_GUID(fmu), fmi2_import_get_GUID(fmuSkipped))
+			|| (fmi2_import_get_number_of_continuous_states(fmu) != fmi2_import_get_number_of_continuous_states(fmuSkipped))
+			|| fmi2_import_get_unit_definitions(fmuSkipped)
+			|| fmi2_import_get_outputs_list(fmuSkipped)
+			|| fmi2_import_get_description(fmuSkipped)
+			|| fmi2_import_get_vendors_num(fmuSkipped)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi2_import_variable_list_t* vl1 = fmi2_import_get_variable_list(fmu, 0);
+			fmi2_import_variable_list_t* vl2 = fmi2_import_get_variable_list(fmuSkipped, 0);
+			size_t i, n = fmi2_import_get_variable_list_size(vl1);
+			if(n != fmi2_import_get_variable_list_size(vl2)) ret = CTEST_RETURN_FAIL;
+			for(i = 0; (ret == CTEST_RETURN_SUCCESS) && (i < n); i++) {
+				fmi2_import_variable_t* v1 = fmi2_import_get_variable(vl1, i);
+				fmi2_import_variable_t* v2 = fmi2_import_get_variable(vl2, i);
+				if(strcmp(fmi2_import_get_variable_name(v1), fmi2_import_get_variable_name(v2))
+					|| (fmi2_import_get_variable_vr(v1) != fmi2_import_get_variable_vr(v2))
+					|| (fmi2_import_get_causality(v1) != fmi2_import_get_causality(v2))
+					|| fmi2_import_get_variable_description(v2)) {
+					ret = CTEST_RETURN_FAIL;
+				}
+			}
+			fmi2_import_free_variable_list(vl1);
+			fmi2_import_free_variable_list(vl2);
+		}
+		if(fmu) fmi2_import_free(fmu);
+		if(fmuSkipped) fmi2_import_free(fmuSkipped);
+	}
+	fmi_import_set_parse_options(context, 0);
+
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("Parsing the model description without the optional sections failed\n");
+	}
+	return ret;
+}
+
+/* Variables of a completely parsed model description to compare the streamed ones with */
+typedef struct variable_handle_test_t {
+	fmi2_import_variable_list_t* variables;
+	size_t count;
+	int failed;
+	int abortAt;
+} variable_handle_test_t;
+
+static int test_variable_handle(void* context, const fmi2_xml_variable_record_t* record)
+{
+	variable_handle_test_t* test = (variable_handle_test_t*)context;
+	fmi2_import_variable_t* v;
+
+	if(++test->count == test->abortAt) return 1;
+	if((record->index != test->count) || (record->index > fmi2_import_get_variable_list_size(test->variables))) {
+		test->failed = 1;
+		return 0;
+	}
+	v = fmi2_import_get_variable(test->variables, record->index - 1);
+	if(strcmp(record->name, fmi2_import_get_variable_name(v))
+		|| compare_strings(record->description, fmi2_import_get_variable_description(v))
+		|| (record->vr != fmi2_import_get_variable_vr(v))
+		|| (record->baseType != fmi2_import_get_variable_base_type(v))
+		|| (record->causality != fmi2_import_get_causality(v))
+		|| (record->variability != fmi2_import_get_variability(v))
+		|| (record->hasStart != fmi2_import_get_variable_has_start(v))) {
+		test->failed = 1;
+	}
+	else if(record->baseType == fmi2_base_type_real) {
+		fmi2_import_real_variable_t* rv = fmi2_import_get_variable_as_real(v);
+		if((record->start.real != fmi2_import_get_real_variable_start(rv))
+			|| (record->min.real != fmi2_import_get_real_variable_min(rv))
+			|| (record->max.real != fmi2_import_get_real_variable_max(rv))
+			|| ((record->derivativeOf != 0) != (fmi2_import_get_real_variable_derivative_of(rv) != 0))) {
+			test->failed = 1;
+		}
+	}
+	return 0;
+}
+
+/* Stream the variables to a handle and compare them with the variable list */
+int variable_handle_test(fmi_import_context_t* context, const char* dirPath)
+{
+	fmi2_import_t* fmu = fmi2_import_parse_xml(context, dirPath, 0);
+	fmi2_import_t* fmuStreamed = 0;
+	variable_handle_test_t test;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(!fmu) return CTEST_RETURN_FAIL;
+	test.variables = fmi2_import_get_variable_list(fmu, 0);
+	test.count = 0;
+	test.failed = 0;
+	test.abortAt = 0;
+	fmi2_import_set_variable_handle(context, test_variable_handle, &test);
+	fmuStreamed = fmi2_import_parse_xml(context, dirPath, 0);
+	if(!fmuStreamed || test.failed
+		|| (test.count != fmi2_import_get_variable_list_size(test.variables))
+		|| (fmi2_import_get_parsed_sections(fmuStreamed) != (fmi_xml_section_all & ~fmi_xml_section_model_structure))
+		|| (fmi2_import_get_number_of_continuous_states(fmu) != fmi2_import_get_number_of_continuous_states(fmuStreamed))
+		|| strcmp(fmi2_import_get_GUID(fmu), fmi2_import_get_GUID(fmuStreamed))) {
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		fmi2_import_variable_list_t* vl = fmi2_import_get_variable_list(fmuStreamed, 0);
+		if(fmi2_import_get_variable_list_size(vl) != 0) ret = CTEST_RETURN_FAIL;
+		fmi2_import_free_variable_list(vl);
+	}
+	if(fmuStreamed) fmi2_import_free(fmuStreamed);
+
+	/* a non-zero return from the handle aborts parsing */
+	test.count = 0;
+	test.abortAt = 1;
+	fmuStreamed = fmi2_import_parse_xml(context, dirPath, 0);
+	if(fmuStreamed) {
+		fmi2_import_free(fmuStreamed);
+		ret = CTEST_RETURN_FAIL;
+	}
+
+	fmi2_import_set_variable_handle(context, 0, 0);
+	fmi2_import_free_variable_list(test.variables);
+	fmi2_import_free(fmu);
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("Streaming the model variables failed\n");
+	}
+	return ret;
+}
+
+/* Returns non-zero if the contents of the two files differ or a file cannot be read */
+static int compare_files(const char* path1, const char* path2)
+{
+	FILE* f1 = fopen(path1, "rb");
+	FILE* f2 = fopen(path2, "rb");
+	int c1, c2, ret = !f1 || !f2;
+
+	while(!ret) {
+		c1 = getc(f1);
+		c2 = getc(f2);
+		if(c1 != c2) ret = 1;
+		else if(c1 == EOF) break;
+	}
+	if(f1) fclose(f1);
+	if(f2) fclose(f2);
+	return ret;
+}
+
+/* Unpack the FMU with several threads. The model description must match the serially unpacked file and the
+   one read straight from the archive, and the binary must load. */
+int unzip_parallel_test(fmi_import_context_t* context, jm_callbacks* callbacks, const char* FMUPath, const char* tmpPath, fmi_version_enu_t version)
+{
+	char xmlPath[BUFFER];
+	char serialXmlPath[BUFFER];
+	char* dirPath = fmi_import_mk_temp_dir(callbacks, tmpPath, "fmil_parallel_");
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(!dirPath || (fmi_import_unzip_parallel(callbacks, FMUPath, dirPath, 4) != jm_status_success)) {
+		printf("Unpacking the FMU with several threads failed\n");
+		callbacks->free(dirPath);
+		return CTEST_RETURN_FAIL;
+	}
+	sprintf(xmlPath, "%s%s%s", dirPath, FMI_FILE_SEP, FMI_MODEL_DESCRIPTION_XML);
+	sprintf(serialXmlPath, "%s%s%s", tmpPath, FMI_FILE_SEP, FMI_MODEL_DESCRIPTION_XML);
+	if(compare_files(xmlPath, serialXmlPath)) {
+		printf("%s differs from %s\n", xmlPath, serialXmlPath);
+		ret = CTEST_RETURN_FAIL;
+	}
+	else if(version == fmi_version_1_enu) {
+		fmi1_import_t* fmu = fmi1_import_parse_xml(context, dirPath);
+		fmi1_import_t* fmuArchive = fmi1_import_parse_xml_from_archive(context, FMUPath);
+		fmi1_callback_functions_t callBackFunctions;
+		memset(&callBackFunctions, 0, sizeof(callBackFunctions));
+		if(!fmu || !fmuArchive || strcmp(fmi1_import_get_GUID(fmu), fmi1_import_get_GUID(fmuArchive))
+			|| (fmi1_import_get_variable_list_size(fmi1_import_get_variable_list(fmu))
+				!= fmi1_import_get_variable_list_size(fmi1_import_get_variable_list(fmuArchive)))
+			|| (fmi1_import_create_dllfmu(fmu, callBackFunctions, 0) != jm_status_success)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi1_import_destroy_dllfmu(fmu);
+		}
+		if(fmu) fmi1_import_free(fmu);
+		if(fmuArchive) fmi1_import_free(fmuArchive);
+	}
+	else {
+		fmi2_import_t* fmu = fmi2_import_parse_xml(context, dirPath, 0);
+		fmi2_import_t* fmuArchive = fmi2_import_parse_xml_from_archive(context, FMUPath, 0);
+		if(!fmu || !fmuArchive || compare_fmi2_model_descriptions(fmu, fmuArchive)
+			|| (fmi2_import_create_dllfmu(fmu, (fmi2_import_get_fmu_kind(fmu) == fmi2_fmu_kind_cs) ? fmi2_fmu_kind_cs : fmi2_fmu_kind_me, 0) != jm_status_success)) {
+			ret = CTEST_RETURN_FAIL;
+		}
+		else {
+			fmi2_import_destroy_dllfmu(fmu);
+		}
+		if(fmu) fmi2_import_free(fmu);
+		if(fmuArchive) fmi2_import_free(fmuArchive);
+	}
+	if(ret != CTEST_RETURN_SUCCESS) {
+		printf("The FMU unpacked with several threads is not usable\n");
+	}
+	fmi_import_rmdir(callbacks, dirPath);
+	callbacks->free(dirPath);
+	return ret;
+}
+
+/* Unpack the FMU into a temporary directory and remove it in the background */
+int rmdir_test(jm_callbacks* callbacks, const char* FMUPath)
+{
+	char xmlPath[BUFFER];
+	char* dirPath = fmi_import_mk_temp_dir(callbacks, 0, 0);
+	FILE* xml;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(!dirPath || (fmi_import_unzip_parallel(callbacks, FMUPath, dirPath, 0) != jm_status_success)) {
+		printf("Unpacking the FMU into a temporary directory failed\n");
+		return CTEST_RETURN_FAIL;
+	}
+	sprintf(xmlPath, "%s%s%s", dirPath, FMI_FILE_SEP, FMI_MODEL_DESCRIPTION_XML);
+
+	fmi_import_set_rmdir_async(1);
+	if(fmi_import_rmdir(callbacks, dirPath) != jm_status_success) {
+		ret = CTEST_RETURN_FAIL;
+	}
+	fmi_import_wait_rmdir();
+	fmi_import_set_rmdir_async(0);
+
+	xml = fopen(xmlPath, "r");
+	if(xml) {
+		fclose(xml);
+		printf("Temporary directory %s was not removed\n", dirPath);
+		ret = CTEST_RETURN_FAIL;
+	}
+	callbacks->free(dirPath);
+	return ret;
+}
+
 int main(int argc, char *argv[])
 {
 	const char* FMUPath;
@@ -71,6 +613,19 @@ int main(int argc, char *argv[])
 
 	version = fmi_import_get_fmi_version(context, FMUPath, tmpPath);
 
+	if((version == fmi_version_1_enu) || (version == fmi_version_2_0_enu)) {
+		if((archive_test(context, FMUPath, tmpPath, version) != CTEST_RETURN_SUCCESS) ||
+		   (cache_test(&callbacks, FMUPath, tmpPath) != CTEST_RETURN_SUCCESS) ||
+		   (unzip_parallel_test(context, &callbacks, FMUPath, tmpPath, version) != CTEST_RETURN_SUCCESS) ||
+		   (rmdir_test(&callbacks, FMUPath) != CTEST_RETURN_SUCCESS) ||
+		   (parse_options_test(context, tmpPath, version) != CTEST_RETURN_SUCCESS) ||
+		   ((version == fmi_version_2_0_enu) && (md_cache_test(context, &callbacks, tmpPath) != CTEST_RETURN_SUCCESS)) ||
+		   ((version == fmi_version_2_0_enu) && (variable_handle_test(context, tmpPath) != CTEST_RETURN_SUCCESS))) {
+			fmi_import_free_context(context);
+			do_exit(CTEST_RETURN_FAIL);
+		}
+	}
+
 	if(version == fmi_version_1_enu) {
 		ret = fmi1_test(context, tmpPath);
 	}
@@ -0,0 +1,170 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config_test.h"
+
+#include <FMI/fmi_xml_hash.h>
+#include "fmi_xml_hash_test.h"
+
+/* Largest table that the generator will try */
+#define MAX_TABLE_SIZE 4096
+/* Number of seeds to try for each table size */
+#define MAX_SEEDS 100000
+
+/* Fill the table for the given seed. Returns 0 if two names end up in the same slot. */
+static int fill_table(const char** names, size_t count, unsigned int seed, size_t size, unsigned char* table) {
+	size_t i;
+	memset(table, FMI_XML_HASH_EMPTY, size);
+	for(i = 0; i < count; i++) {
+		unsigned int slot = fmi_xml_hash(names[i], seed) & (unsigned int)(size - 1);
+		if(table[slot] != FMI_XML_HASH_EMPTY) return 0;
+		table[slot] = (unsigned char)i;
+	}
+	return 1;
+}
+
+/* Check that the compiled in table matches the name list */
+static int check_table(fmi_xml_hash_table_t* t) {
+	unsigned char expected[MAX_TABLE_SIZE];
+	size_t i;
+
+	if(t->count != t->expectedCount) {
+		printf("%s: name list does not match the ID enum\n", t->prefix);
+		return 0;
+	}
+	if((t->count >= FMI_XML_HASH_EMPTY) || (t->size > MAX_TABLE_SIZE) || (t->size & (t->size - 1))) {
+		printf("%s: bad table size\n", t->prefix);
+		return 0;
+	}
+	if(!fill_table(t->names, t->count, t->seed, t->size, expected) || memcmp(expected, t->table, t->size)) {
+		printf("%s: hash table does not match the name list, regenerate it (see FMI/fmi_xml_hash.h)\n", t->prefix);
+		return 0;
+	}
+	/* a lookup must find every name and nothing else */
+	for(i = 0; i < t->count; i++) {
+		unsigned int id = t->table[fmi_xml_hash(t->names[i], t->seed) & (unsigned int)(t->size - 1)];
+		if(id != i) {
+			printf("%s: lookup of '%s' failed\n", t->prefix, t->names[i]);
+			return 0;
+		}
+	}
+	{
+		const char* unknown[] = {"", "fmiModelDescriptio", "ScalarVariables", "xsi:type", "REAL"};
+		for(i = 0; i < FMI_XML_HASH_TEST_SIZE(unknown); i++) {
+			unsigned int id = t->table[fmi_xml_hash(unknown[i], t->seed) & (unsigned int)(t->size - 1)];
+			if((id != FMI_XML_HASH_EMPTY) && (strcmp(t->names[id], unknown[i]) == 0)) {
+				printf("%s: unexpected match for '%s'\n", t->prefix, unknown[i]);
+				return 0;
+			}
+		}
+	}
+	printf("%s: %u names in %u slots\n", t->prefix, (unsigned)t->count, (unsigned)t->size);
+	return 1;
+}
+
+/* Find the smallest table and the first seed that give a perfect hash and print it as C code */
+static int generate_table(fmi_xml_hash_table_t* t) {
+	unsigned char table[MAX_TABLE_SIZE];
+	size_t size, i;
+	unsigned int seed = 0, k;
+
+	for(size = 16; size < 2 * t->count; size *= 2);
+	for(; size <= MAX_TABLE_SIZE; size *= 2) {
+		for(k = 0; k < MAX_SEEDS; k++) {
+			seed = (2166136261U + k * 2654435769U) & 0xFFFFFFFFU;
+			if(fill_table(t->names, t->count, seed, size, table)) break;
+		}
+		if(k < MAX_SEEDS) break;
+	}
+	if(size > MAX_TABLE_SIZE) {
+		fprintf(stderr, "Could not find a perfect hash for %s\n", t->prefix);
+		return 0;
+	}
+	printf("#define %s_HASH_SEED 0x%08XU\n", t->macroPrefix, seed);
+	printf("#define %s_HASH_MASK %u\n\n", t->macroPrefix, (unsigned)(size - 1));
+	printf("static const unsigned char %s_hash_table[%u] = {", t->prefix, (unsigned)size);
+	for(i = 0; i < size; i++) {
+		printf("%s%s%u", i ? "," : "", (i % 16) ? " " : "\n\t", table[i]);
+	}
+	printf("\n};\n\n");
+	return 1;
+}
+
+/* Print the header with the tables for one FMI version */
+static int generate(const char* version, const char* guard, fmi_xml_hash_table_t* elm, fmi_xml_hash_table_t* attr) {
+	const char* license[] = {
+		"/*",
+		"    Copyright (C) 2012 Modelon AB",
+		"",
+		"    This program is free software: you can redistribute it and/or modify",
+		"    it under the terms of the BSD style license.",
+		"",
+		"     This program is distributed in the hope that it will be useful,",
+		"    but WITHOUT ANY WARRANTY; without even the implied warranty of",
+		"    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the",
+		"    FMILIB_License.txt file for more details.",
+		"",
+		"    You should have received a copy of the FMILIB_License.txt file",
+		"    along with this program. If not, contact Modelon AB <http://www.modelon.com>.",
+		"*/"
+	};
+	size_t i;
+	int ok;
+
+	for(i = 0; i < FMI_XML_HASH_TEST_SIZE(license); i++) {
+		printf("%s\n", license[i]);
+	}
+	printf("\n/* Generated by fmi_xml_hash_test --generate %s, see FMI/fmi_xml_hash.h. Do not edit. */\n\n", version);
+	printf("#ifndef %s\n#define %s\n\n", guard, guard);
+	ok = generate_table(elm) && generate_table(attr);
+	printf("#endif /* %s */\n", guard);
+	return ok;
+}
+
+/**
+ * \brief Check the element and attribute hash tables used by the XML parsers.
+ *
+ * Usage: fmi_xml_hash_test [--generate fmi1|fmi2]
+ * With --generate the table header for the given version is printed instead.
+ */
+int main(int argc, char *argv[])
+{
+	fmi_xml_hash_table_t tables[4];
+	size_t i;
+	int ok = 1;
+
+	fmi1_xml_hash_test_tables(&tables[0], &tables[1]);
+	fmi2_xml_hash_test_tables(&tables[2], &tables[3]);
+
+	if((argc == 3) && (strcmp(argv[1], "--generate") == 0)) {
+		if(strcmp(argv[2], "fmi1") == 0)
+			ok = generate(argv[2], "FMI1_XML_PARSER_HASH_H", &tables[0], &tables[1]);
+		else if(strcmp(argv[2], "fmi2") == 0)
+			ok = generate(argv[2], "FMI2_XML_PARSER_HASH_H", &tables[2], &tables[3]);
+		else {
+			fprintf(stderr, "Unknown FMI version '%s'\n", argv[2]);
+			ok = 0;
+		}
+		return ok ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+	}
+
+	for(i = 0; i < FMI_XML_HASH_TEST_SIZE(tables); i++) {
+		ok = check_table(&tables[i]) && ok;
+	}
+	return ok ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
@@ -0,0 +1,39 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef FMI_XML_HASH_TEST_H
+#define FMI_XML_HASH_TEST_H
+
+#include <stddef.h>
+
+/* A name list from the XML parser together with the perfect hash table compiled into the library */
+typedef struct fmi_xml_hash_table_t {
+	const char* prefix; /* prefix of the generated identifiers */
+	const char* macroPrefix; /* prefix of the generated macros */
+	const char** names;
+	size_t count; /* number of names */
+	size_t expectedCount; /* number of IDs in the enum */
+	unsigned int seed;
+	size_t size;
+	const unsigned char* table;
+} fmi_xml_hash_table_t;
+
+#define FMI_XML_HASH_TEST_SIZE(t) (sizeof(t)/sizeof(t[0]))
+
+/* Get the element and attribute tables */
+void fmi1_xml_hash_test_tables(fmi_xml_hash_table_t* elm, fmi_xml_hash_table_t* attr);
+void fmi2_xml_hash_test_tables(fmi_xml_hash_table_t* elm, fmi_xml_hash_table_t* attr);
+
+#endif
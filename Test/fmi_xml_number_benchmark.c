@@ -0,0 +1,429 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* gettimeofday is not visible in strict C89 mode otherwise */
+#if !defined(WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#define _BSD_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <locale.h>
+
+#include <JM/jm_types.h>
+#include <JM/jm_callbacks.h>
+#include <JM/jm_number.h>
+#include <FMI2/fmi2_xml_model_description.h>
+#include <FMI2/fmi2_xml_variable.h>
+#include "config_test.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+/* Wall clock time in seconds */
+static double bench_time(void)
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+#endif
+}
+
+static void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_level, jm_string message)
+{
+	printf("module = %s, log level = %d: %s\n", module, log_level, message);
+}
+
+/* Small deterministic generator so that runs are comparable */
+static unsigned long bench_rand_state = 12345;
+static unsigned bench_rand(void)
+{
+	bench_rand_state = (bench_rand_state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+	return (unsigned)((bench_rand_state >> 16) & 0x7FFF);
+}
+
+/* Write a number with a random number of significant digits and a random exponent */
+static void bench_random_number(char* buf)
+{
+	double mantissa = (double)bench_rand() / 32768.0 + (double)bench_rand() / (32768.0 * 32768.0);
+	int digits = 1 + (int)(bench_rand() % 17);
+	int exponent = (int)(bench_rand() % 61) - 30;
+	double scale = 1.0;
+	int i;
+
+	for(i = 0; i < (exponent < 0 ? -exponent : exponent); i++) scale *= 10.0;
+	if(exponent < 0) mantissa /= scale; else mantissa *= scale;
+	if(bench_rand() & 1) mantissa = -mantissa;
+	sprintf(buf, "%.*g", digits, mantissa);
+}
+
+/* Write up to 25 random digits with an exponent over the whole double range and beyond */
+static void bench_random_digits(char* buf)
+{
+	int digits = 1 + (int)(bench_rand() % 25);
+	int point = (int)(bench_rand() % (unsigned)(digits + 1));
+	int exponent = (int)(bench_rand() % 661) - 345;
+	int i;
+
+	if(bench_rand() & 1) *buf++ = '-';
+	for(i = 0; i < digits; i++) {
+		if(i == point) *buf++ = '.';
+		*buf++ = (char)('0' + bench_rand() % 10);
+	}
+	sprintf(buf, "e%d", exponent);
+}
+
+static int same_double(double a, double b)
+{
+	return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+/* Compare with the C library in the "C" locale */
+static int check_double(const char* str)
+{
+	double expected = strtod(str, 0), actual;
+	if(jm_parse_double(str, &actual) != jm_status_success) {
+		printf("Could not parse '%s'\n", str);
+		return 0;
+	}
+	if(!same_double(expected, actual)) {
+		printf("'%s' parsed as %.17g, expected %.17g\n", str, actual, expected);
+		return 0;
+	}
+	return 1;
+}
+
+static int check_numbers(void)
+{
+	const char* doubles[] = {
+		"0", "-0", "0.0", "1", "-1", "1.5", ".5", "5.", "+2.5", "0.1", "0.3", "273.15", "-9.81", "1e-6", "1E+10",
+		"1.0e22", "1e23", "9007199254740993", "123456789012345678901234567890", "0.000000000000000000000000001",
+		"1.7976931348623157e308", "2.2250738585072014e-308", "4.9e-324", "2.4703282292062327e-324", "1e-400",
+		"1e400", "0.30000000000000004", "3.14159265358979323846264338327950288", "  42.5\t", "\n1e3\r\n",
+		"9007199254740993e10", "1.00000000000000011102230246251565404236316680908203125", "2.2250738585072011e-308",
+		"7.2057594037927933e16", "9999999999999999999e289", "1234567890123456789e-320", "1e-342", "1e308", "5e-324"
+	};
+	const char* bad_doubles[] = {"", " ", "-", ".", "e5", "1e", "1e+", "1.5x", "1,5", "0x10", "1 2", "--1", "in", "nanx"};
+	const char* bad_ints[] = {"", "+", "-", "1.0", "12abc", "0x1", "1 2", "2147483648", "-2147483649"};
+	char buf[64];
+	double d;
+	int i, n;
+	unsigned int u;
+	size_t k;
+
+	for(k = 0; k < sizeof(doubles) / sizeof(doubles[0]); k++) {
+		if(!check_double(doubles[k])) return 0;
+	}
+	for(k = 0; k < sizeof(bad_doubles) / sizeof(bad_doubles[0]); k++) {
+		if(jm_parse_double(bad_doubles[k], &d) != jm_status_error) {
+			printf("'%s' should not parse as a real\n", bad_doubles[k]);
+			return 0;
+		}
+	}
+	if((jm_parse_double("INF", &d) != jm_status_success) || (d <= 1e308)
+		|| (jm_parse_double("-Infinity", &d) != jm_status_success) || (d >= -1e308)
+		|| (jm_parse_double("NaN", &d) != jm_status_success) || (d == d)) {
+		printf("Special values are not handled\n");
+		return 0;
+	}
+	for(n = 0; n < 200000; n++) {
+		bench_random_number(buf);
+		if(!check_double(buf)) return 0;
+		bench_random_digits(buf);
+		if(!check_double(buf)) return 0;
+	}
+
+	for(k = 0; k < sizeof(bad_ints) / sizeof(bad_ints[0]); k++) {
+		if(jm_parse_int(bad_ints[k], &i) != jm_status_error) {
+			printf("'%s' should not parse as an integer\n", bad_ints[k]);
+			return 0;
+		}
+	}
+	if((jm_parse_int("2147483647", &i) != jm_status_success) || (i != INT_MAX)
+		|| (jm_parse_int("-2147483648", &i) != jm_status_success) || (i != INT_MIN)
+		|| (jm_parse_int(" -17 ", &i) != jm_status_success) || (i != -17)
+		|| (jm_parse_uint("4294967295", &u) != jm_status_success) || (u != UINT_MAX)
+		|| (jm_parse_uint("+0012", &u) != jm_status_success) || (u != 12)
+		|| (jm_parse_uint("4294967296", &u) != jm_status_error)
+		|| (jm_parse_uint("-1", &u) != jm_status_error)) {
+		printf("Integer limits are not handled\n");
+		return 0;
+	}
+	return 1;
+}
+
+/* The result must not change with a locale that uses a decimal comma */
+static int check_locale(void)
+{
+	const char* locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "German"};
+	const char* numbers[] = {"1.5", "-273.15", "3.14159265358979323846", "1e-320"};
+	double expected[sizeof(numbers) / sizeof(numbers[0])], actual;
+	size_t k;
+	int ok = 1;
+
+	for(k = 0; k < sizeof(numbers) / sizeof(numbers[0]); k++) {
+		expected[k] = strtod(numbers[k], 0);
+	}
+	for(k = 0; k < sizeof(locales) / sizeof(locales[0]); k++) {
+		if(setlocale(LC_NUMERIC, locales[k]) && (strcmp(localeconv()->decimal_point, ".") != 0)) break;
+	}
+	if(k == sizeof(locales) / sizeof(locales[0])) {
+		printf("No locale with a decimal comma is installed, locale check skipped\n");
+		setlocale(LC_NUMERIC, "C");
+		return 1;
+	}
+	printf("Checking with locale %s\n", locales[k]);
+	for(k = 0; k < sizeof(numbers) / sizeof(numbers[0]); k++) {
+		if((jm_parse_double(numbers[k], &actual) != jm_status_success) || !same_double(actual, expected[k])) {
+			printf("'%s' is not parsed correctly with a decimal comma locale\n", numbers[k]);
+			ok = 0;
+		}
+	}
+	setlocale(LC_NUMERIC, "C");
+	return ok;
+}
+
+/* Generate a model description with the given number of variables. The attribute values are returned in values. */
+static char* bench_model_description(int nVariables, char** values, size_t* size)
+{
+	size_t capacity = 400 + (size_t)nVariables * 400, len;
+	char* xml = (char*)malloc(capacity);
+	char* v = (char*)malloc((size_t)nVariables * 4 * 32);
+	int i, j;
+
+	if(!xml || !v) {
+		free(xml);
+		free(v);
+		return 0;
+	}
+	len = sprintf(xml,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<fmiModelDescription fmiVersion=\"2.0\" modelName=\"Synthetic\" guid=\"123\">\n"
+		"<CoSimulation modelIdentifier=\"Synthetic\"/>\n"
+		"<ModelVariables>\n");
+	for(i = 0; i < nVariables; i++) {
+		char* attr[4];
+		for(j = 0; j < 4; j++) {
+			attr[j] = v + (i * 4 + j) * 32;
+			bench_random_number(attr[j]);
+		}
+		len += sprintf(xml + len,
+			"<ScalarVariable name=\"x%d\" valueReference=\"%d\" causality=\"parameter\" variability=\"fixed\" initial=\"exact\">\n"
+			"<Real start=\"%s\" min=\"%s\" max=\"%s\" nominal=\"%s\"/>\n"
+			"</ScalarVariable>\n", i, i, attr[0], attr[1], attr[2], attr[3]);
+	}
+	len += sprintf(xml + len, "</ModelVariables>\n<ModelStructure>\n</ModelStructure>\n</fmiModelDescription>\n");
+	*values = v;
+	*size = len;
+	return xml;
+}
+
+/* Parse the model description from memory or from a file and check the start values */
+static int bench_parse_xml(const char* xml, size_t size, const char* fileName, const char* values, int nVariables, int repetitions, jm_callbacks* callbacks)
+{
+	double start = bench_time(), d;
+	int r, i;
+
+	for(r = 0; r < repetitions; r++) {
+		fmi2_xml_model_description_t* md = fmi2_xml_allocate_model_description(callbacks);
+		if(!md) return 0;
+		if(fileName ? fmi2_xml_parse_model_description(md, fileName, 0) : fmi2_xml_parse_model_description_from_buffer(md, xml, size, 0)) {
+			printf("Could not parse %s: %s\n", fileName ? fileName : "the synthetic model description", fmi2_xml_get_last_error(md));
+			fmi2_xml_free_model_description(md);
+			return 0;
+		}
+		/* the values in the model description must be the ones that the parser returns */
+		for(i = 0; (r == 0) && (i < nVariables); i += 1 + nVariables / 100) {
+			fmi2_xml_variable_t* v = fmi2_xml_get_variable_by_vr(md, fmi2_base_type_real, (fmi2_value_reference_t)i);
+			jm_parse_double(values + i * 4 * 32, &d);
+			if(!v || !same_double(fmi2_xml_get_real_variable_start(fmi2_xml_get_variable_as_real(v)), d)) {
+				printf("Start value of variable %d is not '%s'\n", i, values + i * 4 * 32);
+				fmi2_xml_free_model_description(md);
+				return 0;
+			}
+		}
+		fmi2_xml_free_model_description(md);
+	}
+	printf("  parse XML %-5s %10.3f ms\n", fileName ? "file" : "", (bench_time() - start) * 1000.0 / repetitions);
+	return 1;
+}
+
+/* Parse the model description sorting the variables on several threads and check that the order is the same as with one thread */
+static int bench_parse_threads(const char* xml, size_t size, unsigned int numThreads, jm_callbacks* callbacks)
+{
+	fmi2_xml_model_description_t* md[2];
+	double start = 0, elapsed = 0;
+	size_t i, n = 0;
+	int k, ok = 1;
+
+	for(k = 0; k < 2; k++) {
+		md[k] = fmi2_xml_allocate_model_description(callbacks);
+		if(!md[k]) {
+			ok = 0;
+			continue;
+		}
+		fmi2_xml_set_parse_threads(md[k], k ? numThreads : 0);
+		if(k) start = bench_time();
+		if(fmi2_xml_parse_model_description_from_buffer(md[k], xml, size, 0)) {
+			printf("Could not parse the synthetic model description: %s\n", fmi2_xml_get_last_error(md[k]));
+			ok = 0;
+		}
+		if(k) elapsed = bench_time() - start;
+	}
+	if(ok) {
+		n = jm_vector_get_size(jm_named_ptr)(fmi2_xml_get_variables_alphabetical_order(md[0]));
+		ok = (jm_vector_get_size(jm_named_ptr)(fmi2_xml_get_variables_alphabetical_order(md[1])) == n)
+			&& (jm_vector_get_size(jm_voidp)(fmi2_xml_get_variables_vr_order(md[1])) == n);
+	}
+	for(i = 0; ok && (i < n); i++) {
+		jm_named_ptr byName[2];
+		fmi2_xml_variable_t* byVR[2];
+		for(k = 0; k < 2; k++) {
+			byName[k] = jm_vector_get_item(jm_named_ptr)(fmi2_xml_get_variables_alphabetical_order(md[k]), i);
+			byVR[k] = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(fmi2_xml_get_variables_vr_order(md[k]), i);
+		}
+		if(strcmp(byName[0].name, byName[1].name) ||
+		   (fmi2_xml_get_variable_original_order(byVR[0]) != fmi2_xml_get_variable_original_order(byVR[1]))) {
+			printf("Variable %u is not in the same place when sorting on %u threads\n", (unsigned)i, numThreads);
+			ok = 0;
+		}
+	}
+	for(k = 0; k < 2; k++) {
+		if(md[k]) fmi2_xml_free_model_description(md[k]);
+	}
+	if(ok) printf("  parse XML, sorting on %u threads %10.3f ms\n", numThreads, elapsed * 1000.0);
+	return ok;
+}
+
+/* Time the conversion of the attribute values and the parsing of the whole model description */
+static int bench_parse(int nVariables, int repetitions, const char* outputFolder, jm_callbacks* callbacks)
+{
+	char* values;
+	size_t size;
+	char* xml = bench_model_description(nVariables, &values, &size);
+	double start, sum = 0, d;
+	unsigned int u;
+	int r, i, ok = 1;
+
+	if(!xml) return 0;
+	printf("Synthetic model description with %d variables, %u bytes\n", nVariables, (unsigned)size);
+
+	start = bench_time();
+	for(r = 0; r < repetitions; r++) {
+		for(i = 0; i < nVariables * 4; i++) {
+			sscanf(values + i * 32, "%lf", &d);
+			sum += d;
+		}
+	}
+	printf("  sscanf %%lf      %10.3f ms\n", (bench_time() - start) * 1000.0 / repetitions);
+	start = bench_time();
+	for(r = 0; r < repetitions; r++) {
+		for(i = 0; i < nVariables * 4; i++) {
+			jm_parse_double(values + i * 32, &d);
+			sum -= d;
+		}
+	}
+	printf("  jm_parse_double %10.3f ms\n", (bench_time() - start) * 1000.0 / repetitions);
+
+	start = bench_time();
+	for(r = 0; r < repetitions; r++) {
+		for(i = 0; i < nVariables; i++) {
+			char vr[16];
+			sprintf(vr, "%d", i);
+			sscanf(vr, "%u", &u);
+			sum += u;
+		}
+	}
+	printf("  sscanf %%u       %10.3f ms (including sprintf)\n", (bench_time() - start) * 1000.0 / repetitions);
+	start = bench_time();
+	for(r = 0; r < repetitions; r++) {
+		for(i = 0; i < nVariables; i++) {
+			char vr[16];
+			sprintf(vr, "%d", i);
+			jm_parse_uint(vr, &u);
+			sum -= u;
+		}
+	}
+	printf("  jm_parse_uint   %10.3f ms (including sprintf)\n", (bench_time() - start) * 1000.0 / repetitions);
+
+	ok = bench_parse_xml(xml, size, 0, values, nVariables, repetitions, callbacks)
+		&& bench_parse_threads(xml, size, 3, callbacks);
+	if(ok && outputFolder) {
+		/* large files are memory mapped, smaller ones read into the expat buffer */
+		char* fileName = (char*)malloc(strlen(outputFolder) + 32);
+		FILE* file = 0;
+		if(fileName) {
+			sprintf(fileName, "%s/fmi_xml_number_benchmark.xml", outputFolder);
+			file = fopen(fileName, "wb");
+		}
+		ok = file && (fwrite(xml, 1, size, file) == size);
+		if(file) fclose(file);
+		ok = ok && bench_parse_xml(xml, size, fileName, values, nVariables, repetitions, callbacks);
+		if(file) remove(fileName);
+		free(fileName);
+	}
+	if(sum != sum) printf("%g\n", sum); /* keep the loops from being optimized away */
+	free(xml);
+	free(values);
+	return ok;
+}
+
+/**
+ * \brief Check the number parsers and compare them with sscanf.
+ *
+ * Usage: fmi_xml_number_benchmark <number of variables> <repetitions> [output folder]
+ * The program fails if a number is not converted exactly as by the C library.
+ * With an output folder the model description is also written to a file and parsed from there.
+ * Sorting the variables on several threads must give the same order as on one thread.
+ */
+int main(int argc, char *argv[])
+{
+	jm_callbacks callbacks;
+	int nVariables, repetitions;
+
+	if(argc < 3) {
+		printf("Usage: %s <number of variables> <repetitions> [output folder]\n", argv[0]);
+		return CTEST_RETURN_FAIL;
+	}
+	nVariables = atoi(argv[1]);
+	if(nVariables < 1) nVariables = 1;
+	repetitions = atoi(argv[2]);
+	if(repetitions < 1) repetitions = 1;
+
+	callbacks.malloc = malloc;
+	callbacks.calloc = calloc;
+	callbacks.realloc = realloc;
+	callbacks.free = free;
+	callbacks.logger = importlogger;
+	callbacks.log_level = jm_log_level_warning;
+	callbacks.context = 0;
+
+	if(!check_numbers() || !check_locale() || !bench_parse(nVariables, repetitions, (argc > 3) ? argv[3] : 0, &callbacks)) {
+		return CTEST_RETURN_FAIL;
+	}
+	return CTEST_RETURN_SUCCESS;
+}
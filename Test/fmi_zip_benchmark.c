@@ -0,0 +1,203 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* gettimeofday is not visible in strict C89 mode otherwise */
+#if !defined(WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#define _BSD_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include <JM/jm_types.h>
+#include <JM/jm_callbacks.h>
+#include <JM/jm_portability.h>
+#include <FMI/fmi_zip_unzip.h>
+#include <FMI/fmi_zip_backend.h>
+#include "config_test.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+/* Wall clock time in seconds */
+static double bench_time(void)
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+#endif
+}
+
+static void importlogger(jm_callbacks* c, jm_string module, jm_log_level_enu_t log_level, jm_string message)
+{
+	printf("module = %s, log level = %d: %s\n", module, log_level, message);
+}
+
+static const fmi_zip_crc32_backend_enu_t crc32_backends[] = {
+	fmi_zip_crc32_backend_zlib, fmi_zip_crc32_backend_slice8, fmi_zip_crc32_backend_pclmul
+};
+#define N_CRC32_BACKENDS (sizeof(crc32_backends) / sizeof(crc32_backends[0]))
+
+/* Compare every CRC-32 implementation against zlib for all alignments and short lengths */
+static int check_crc32_backends(const unsigned char* data, size_t size)
+{
+	size_t b, offset, len;
+
+	for(b = 0; b < N_CRC32_BACKENDS; b++) {
+		if(fmi_zip_set_crc32_backend(crc32_backends[b]) != jm_status_success) continue;
+		for(offset = 0; (offset < 16) && (offset < size); offset++) {
+			for(len = 0; (len < 300) && (offset + len <= size); len++) {
+				uLong expected = crc32(0L, data + offset, (uInt)len);
+				/* Split in two calls to check that a running CRC is continued correctly */
+				uLong actual = fmi_zip_crc32(fmi_zip_crc32(0L, data + offset, len / 3), data + offset + len / 3, len - len / 3);
+				if(actual != expected) {
+					printf("CRC-32 %s differs from zlib at offset %u length %u\n",
+						fmi_zip_crc32_backend_to_string(crc32_backends[b]), (unsigned)offset, (unsigned)len);
+					return 0;
+				}
+			}
+		}
+		if(fmi_zip_crc32(0L, data, size) != crc32(0L, data, (uInt)size)) {
+			printf("CRC-32 %s differs from zlib\n", fmi_zip_crc32_backend_to_string(crc32_backends[b]));
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Checksum the whole archive file with every CRC-32 implementation */
+static int bench_crc32(const char* path, int repetitions)
+{
+	FILE* file = fopen(path, "rb");
+	unsigned char* data;
+	long size;
+	size_t b;
+	int r, ok;
+
+	if(!file) {
+		printf("Could not open %s\n", path);
+		return 0;
+	}
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	data = (unsigned char*)malloc(size > 0 ? size : 1);
+	ok = data && (fread(data, 1, size, file) == (size_t)size);
+	fclose(file);
+	if(!ok || !check_crc32_backends(data, (size_t)size)) {
+		free(data);
+		return 0;
+	}
+
+	for(b = 0; b < N_CRC32_BACKENDS; b++) {
+		double start, elapsed;
+		unsigned long crc = 0;
+		if(fmi_zip_set_crc32_backend(crc32_backends[b]) != jm_status_success) {
+			printf("  crc32 %-10s not supported\n", fmi_zip_crc32_backend_to_string(crc32_backends[b]));
+			continue;
+		}
+		start = bench_time();
+		for(r = 0; r < repetitions; r++) {
+			crc = fmi_zip_crc32(crc, data, (size_t)size);
+		}
+		elapsed = bench_time() - start;
+		printf("  crc32 %-10s %10.3f ms %10.1f MB/s\n", fmi_zip_crc32_backend_to_string(crc32_backends[b]),
+			elapsed * 1000.0 / repetitions, (double)size * repetitions / (1024.0 * 1024.0) / (elapsed + 1e-9));
+	}
+	fmi_zip_set_crc32_backend(fmi_zip_crc32_backend_auto);
+	free(data);
+	return 1;
+}
+
+/* Unpack the archive with every inflate implementation, with and without deferred CRC checks */
+static int bench_unzip(const char* path, const char* output_folder, int repetitions, jm_callbacks* callbacks)
+{
+	fmi_zip_inflate_backend_enu_t backend;
+	int deferred, r;
+
+	for(backend = fmi_zip_inflate_backend_minizip; backend <= fmi_zip_inflate_backend_chunked; backend++) {
+		for(deferred = 0; deferred <= 1; deferred++) {
+			double start;
+			fmi_zip_set_inflate_backend(backend);
+			fmi_zip_set_deferred_crc_check(deferred);
+			start = bench_time();
+			for(r = 0; r < repetitions; r++) {
+				if(fmi_zip_unzip_parallel(path, output_folder, 0, 0, 1, callbacks) != jm_status_success) {
+					printf("Failed to unpack %s with %s inflate\n", path, fmi_zip_inflate_backend_to_string(backend));
+					return 0;
+				}
+			}
+			printf("  unzip %-8s%-10s %8.3f ms\n", fmi_zip_inflate_backend_to_string(backend), deferred ? " deferred" : "",
+				(bench_time() - start) * 1000.0 / repetitions);
+		}
+	}
+	fmi_zip_set_inflate_backend(fmi_zip_inflate_backend_chunked);
+	fmi_zip_set_deferred_crc_check(0);
+	return 1;
+}
+
+/**
+ * \brief Compare the checksum and inflate implementations.
+ *
+ * Usage: fmi_zip_benchmark <repetitions> <output folder> <archive>...
+ * The program fails if the implementations do not agree.
+ */
+int main(int argc, char *argv[])
+{
+	jm_callbacks callbacks;
+	char* temp_dir;
+	int repetitions, i, ok = 1;
+
+	if(argc < 4) {
+		printf("Usage: %s <repetitions> <output folder> <archive>...\n", argv[0]);
+		return CTEST_RETURN_FAIL;
+	}
+	repetitions = atoi(argv[1]);
+	if(repetitions < 1) repetitions = 1;
+
+	callbacks.malloc = malloc;
+	callbacks.calloc = calloc;
+	callbacks.realloc = realloc;
+	callbacks.free = free;
+	callbacks.logger = importlogger;
+	callbacks.log_level = jm_log_level_warning;
+	callbacks.context = 0;
+
+	temp_dir = jm_mk_temp_dir(&callbacks, argv[2], "fmi_zip_benchmark");
+	if(!temp_dir) return CTEST_RETURN_FAIL;
+
+	printf("Default CRC-32 implementation: %s\n", fmi_zip_crc32_backend_to_string(fmi_zip_get_crc32_backend()));
+	for(i = 3; ok && (i < argc); i++) {
+		printf("%s\n", argv[i]);
+		ok = bench_crc32(argv[i], repetitions) && bench_unzip(argv[i], temp_dir, repetitions, &callbacks);
+	}
+
+	jm_rmdir(&callbacks, temp_dir);
+	free(temp_dir);
+	return ok ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
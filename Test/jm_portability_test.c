@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <stdio.h>
+
+#include "config_test.h"
+
+#include <JM/jm_portability.h>
+
+/* Copy the shared library file into the memory file image */
+static jm_status_enu_t fill_from_file(char* image, size_t size, void* data) {
+	FILE* file = (FILE*)data;
+	return (fread(image, 1, size, file) == size) ? jm_status_success : jm_status_error;
+}
+
+/* Load the shared library file through a memory file */
+static DLL_HANDLE load_from_memory(const char* path, int* memory_file) {
+	DLL_HANDLE handle = 0;
+	FILE* file = fopen(path, "rb");
+	long size;
+
+	*memory_file = -1;
+	if(!file) {
+		printf("Cannot open %s\n", path);
+		return 0;
+	}
+	if((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) > 0) && (fseek(file, 0, SEEK_SET) == 0)) {
+		handle = jm_portability_load_dll_handle_from_memory("jm_portability_test", (size_t)size, fill_from_file, file, memory_file);
+	}
+	fclose(file);
+	return handle;
+}
+
+/*
+	Loads two different libraries from memory while the first one stays loaded.
+	The loader must not hand back the first library for the second memory file.
+*/
+int main(int argc, char *argv[])
+{
+	DLL_HANDLE first;
+	DLL_HANDLE second;
+	int first_file, second_file;
+	jm_dll_function_ptr f;
+	int ret = CTEST_RETURN_SUCCESS;
+
+	if(argc < 3) {
+		printf("Usage: %s <first library> <second library exporting fmi2GetVersion>\n", argv[0]);
+		return CTEST_RETURN_FAIL;
+	}
+
+	first = load_from_memory(argv[1], &first_file);
+	if(!first) {
+		printf("Loading from memory is not supported here, nothing to test\n");
+		return CTEST_RETURN_SUCCESS;
+	}
+	second = load_from_memory(argv[2], &second_file);
+	if(!second) {
+		printf("Could not load %s from memory\n", argv[2]);
+		ret = CTEST_RETURN_FAIL;
+	}
+	else {
+		if(second == first) {
+			printf("The second library from memory returned the handle of the first one\n");
+			ret = CTEST_RETURN_FAIL;
+		}
+		else if(jm_portability_load_dll_function(second, "fmi2GetVersion", &f) != jm_status_success) {
+			printf("fmi2GetVersion not found in the second library from memory\n");
+			ret = CTEST_RETURN_FAIL;
+		}
+		jm_portability_free_dll_handle(second);
+		jm_portability_close_memory_file(second_file);
+	}
+	jm_portability_free_dll_handle(first);
+	jm_portability_close_memory_file(first_file);
+
+	if(ret == CTEST_RETURN_SUCCESS) printf("Libraries loaded from memory are kept apart\n");
+	return ret;
+}
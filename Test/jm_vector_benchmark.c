@@ -0,0 +1,294 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* gettimeofday is not visible in strict C89 mode otherwise */
+#if !defined(WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#define _BSD_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <JM/jm_vector.h>
+#include <JM/jm_named_ptr.h>
+#include <JM/jm_thread_pool.h>
+#include "config_test.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+/* Wall clock time in seconds */
+static double bench_time(void)
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+#endif
+}
+
+/* Fill a vector with push_back and check the contents, then release the unused capacity */
+static int bench_push_back(size_t n, int repetitions, jm_callbacks* callbacks)
+{
+	jm_vector(size_t) v;
+	double start, elapsed;
+	size_t i;
+	int r, ok = 1;
+
+	start = bench_time();
+	for(r = 0; r < repetitions; r++) {
+		jm_vector_init(size_t)(&v, 0, callbacks);
+		for(i = 0; i < n; i++) {
+			if(!jm_vector_push_back(size_t)(&v, i)) break;
+		}
+		if(r + 1 < repetitions) jm_vector_free_data(size_t)(&v);
+	}
+	elapsed = bench_time() - start;
+
+	if(jm_vector_get_size(size_t)(&v) != n) {
+		printf("Vector size %lu, expected %lu\n", (unsigned long)jm_vector_get_size(size_t)(&v), (unsigned long)n);
+		ok = 0;
+	}
+	for(i = 0; ok && (i < n); i++) {
+		if(jm_vector_get_item(size_t)(&v, i) != i) {
+			printf("Vector item %lu is wrong after push_back\n", (unsigned long)i);
+			ok = 0;
+		}
+	}
+	if(ok && (jm_vector_shrink_to_fit(size_t)(&v) < n)) {
+		printf("Vector capacity is smaller than its size after jm_vector_shrink_to_fit\n");
+		ok = 0;
+	}
+	for(i = 0; ok && (i < n); i++) {
+		if(jm_vector_get_item(size_t)(&v, i) != i) {
+			printf("Vector item %lu is wrong after jm_vector_shrink_to_fit\n", (unsigned long)i);
+			ok = 0;
+		}
+	}
+	printf("  %10lu items %10.3f ms %8.2f ns per item\n", (unsigned long)n,
+		elapsed * 1000.0 / repetitions, elapsed * 1e9 / ((double)n * repetitions));
+	jm_vector_free_data(size_t)(&v);
+	return ok;
+}
+
+/* Insert at the front of a vector, which also grows the capacity */
+static int bench_insert(size_t n, jm_callbacks* callbacks)
+{
+	jm_vector(size_t) v;
+	size_t i;
+	int ok = 1;
+
+	jm_vector_init(size_t)(&v, 0, callbacks);
+	jm_vector_push_back(size_t)(&v, n);
+	for(i = n; i-- > 0;) {
+		if(!jm_vector_insert(size_t)(&v, 0, i)) break;
+	}
+	for(i = 0; i <= n; i++) {
+		if((i >= jm_vector_get_size(size_t)(&v)) || (jm_vector_get_item(size_t)(&v, i) != i)) {
+			printf("Vector item %lu is wrong after jm_vector_insert\n", (unsigned long)i);
+			ok = 0;
+			break;
+		}
+	}
+	jm_vector_free_data(size_t)(&v);
+	return ok;
+}
+
+/* Compare jm_named_vector_sort() with jm_vector_qsort() and check the results and the search */
+static int bench_sort(size_t n, int repetitions, jm_callbacks* callbacks)
+{
+	jm_vector(jm_named_ptr) unsorted, v;
+	char* names = (char*)malloc(n * 16);
+	double start, qsortTime, sortTime;
+	unsigned long state = 12345;
+	size_t i;
+	int r, ok = (names != 0);
+
+	jm_vector_init(jm_named_ptr)(&unsorted, 0, callbacks);
+	jm_vector_init(jm_named_ptr)(&v, 0, callbacks);
+	for(i = 0; ok && (i < n); i++) {
+		jm_named_ptr named;
+		/* names with common prefixes and duplicates like in a model description */
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		sprintf(names + i * 16, "x.y%lu", (state >> 8) % (unsigned long)n);
+		named.name = names + i * 16;
+		named.ptr = 0;
+		ok = (jm_vector_push_back(jm_named_ptr)(&unsorted, named) != 0);
+	}
+
+	start = bench_time();
+	for(r = 0; ok && (r < repetitions); r++) {
+		ok = (jm_vector_copy(jm_named_ptr)(&v, &unsorted) == n);
+		jm_vector_qsort(jm_named_ptr)(&v, jm_compare_named);
+	}
+	qsortTime = bench_time() - start;
+
+	start = bench_time();
+	for(r = 0; ok && (r < repetitions); r++) {
+		ok = (jm_vector_copy(jm_named_ptr)(&v, &unsorted) == n);
+		jm_named_vector_sort(&v);
+	}
+	sortTime = bench_time() - start;
+
+	for(i = 1; ok && (i < n); i++) {
+		if(strcmp(jm_vector_get_item(jm_named_ptr)(&v, i - 1).name, jm_vector_get_item(jm_named_ptr)(&v, i).name) > 0) {
+			printf("jm_named_vector_sort result is not sorted at item %lu\n", (unsigned long)i);
+			ok = 0;
+		}
+	}
+	for(i = 0; ok && (i < n); i++) {
+		jm_string name = jm_vector_get_item(jm_named_ptr)(&unsorted, i).name;
+		jm_named_ptr* found = jm_named_vector_search(&v, name);
+		if(!found || strcmp(found->name, name) || ((found != v.items) && !strcmp(found[-1].name, name))) {
+			printf("jm_named_vector_search did not find the first item named %s\n", name);
+			ok = 0;
+		}
+	}
+	if(ok && jm_named_vector_search(&v, "x.z")) {
+		printf("jm_named_vector_search found a name that is not in the vector\n");
+		ok = 0;
+	}
+	printf("  %10lu names qsort %10.3f ms, jm_named_vector_sort %10.3f ms\n", (unsigned long)n,
+		qsortTime * 1000.0 / repetitions, sortTime * 1000.0 / repetitions);
+
+	jm_vector_free_data(jm_named_ptr)(&unsorted);
+	jm_vector_free_data(jm_named_ptr)(&v);
+	free(names);
+	return ok;
+}
+
+/* Names are ordered by the name and then by the position, the ptr of the items points to the name itself */
+static int bench_is_named_less(const jm_named_ptr* a, const jm_named_ptr* b)
+{
+	int c = strcmp(a->name, b->name);
+	return (c < 0) || ((c == 0) && ((const char*)a->ptr < (const char*)b->ptr));
+}
+
+#define JM_SORT_TEMPLATE_TYPE jm_named_ptr
+#define JM_SORT_TEMPLATE_NAME bench_named
+#define JM_SORT_TEMPLATE_LESS(a, b) bench_is_named_less(a, b)
+#include <JM/jm_sort_template.h>
+
+/* Sort names with duplicates on several threads and check that the result is the same as with one thread */
+static int bench_parallel_sort(size_t n, jm_callbacks* callbacks)
+{
+	jm_vector(jm_named_ptr) unsorted, sorted, v;
+	char* names = (char*)malloc(n * 16);
+	unsigned long state = 54321;
+	unsigned int numThreads;
+	size_t i;
+	int ok = (names != 0);
+
+	jm_vector_init(jm_named_ptr)(&unsorted, 0, callbacks);
+	jm_vector_init(jm_named_ptr)(&sorted, 0, callbacks);
+	jm_vector_init(jm_named_ptr)(&v, 0, callbacks);
+	for(i = 0; ok && (i < n); i++) {
+		jm_named_ptr named;
+		state = (state * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		sprintf(names + i * 16, "x.y%lu", (state >> 8) % (unsigned long)(n / 4 + 1));
+		named.name = names + i * 16;
+		named.ptr = names + i * 16;
+		ok = (jm_vector_push_back(jm_named_ptr)(&unsorted, named) != 0);
+	}
+	ok = ok && (jm_vector_copy(jm_named_ptr)(&sorted, &unsorted) == n);
+	if(ok) jm_vector_sort(bench_named)(&sorted);
+
+	for(numThreads = 1; ok && (numThreads <= 5); numThreads++) {
+		jm_thread_pool_t* pool = jm_thread_pool_create(callbacks, numThreads);
+		jm_parallel_sort_t sort;
+		double start;
+
+		ok = pool && (jm_vector_copy(jm_named_ptr)(&v, &unsorted) == n);
+		sort.items = jm_vector_get_itemp(jm_named_ptr)(&v, 0);
+		sort.numItems = n;
+		sort.itemSize = sizeof(jm_named_ptr);
+		sort.sortChunk = jm_sort_array(bench_named);
+		sort.merge = jm_sort_merge(bench_named);
+		sort.context = 0;
+		start = bench_time();
+		ok = ok && (jm_thread_pool_sort(pool, &sort, 1) == jm_status_success);
+		if(ok) {
+			printf("  %10lu names %u threads %10.3f ms\n", (unsigned long)n, numThreads, (bench_time() - start) * 1000.0);
+		}
+		for(i = 0; ok && (i < n); i++) {
+			if(jm_vector_get_item(jm_named_ptr)(&v, i).ptr != jm_vector_get_item(jm_named_ptr)(&sorted, i).ptr) {
+				printf("jm_thread_pool_sort on %u threads differs from jm_vector_sort at item %lu\n", numThreads, (unsigned long)i);
+				ok = 0;
+			}
+		}
+		jm_thread_pool_free(pool);
+	}
+
+	jm_vector_free_data(jm_named_ptr)(&unsorted);
+	jm_vector_free_data(jm_named_ptr)(&sorted);
+	jm_vector_free_data(jm_named_ptr)(&v);
+	free(names);
+	return ok;
+}
+
+/**
+ * \brief Check that filling a vector scales linearly with the number of items.
+ *
+ * Usage: jm_vector_benchmark <maximum number of items> <repetitions>
+ * The time per item is printed for sizes growing by a factor of ten up to the maximum.
+ * It stays roughly constant when the capacity grows geometrically.
+ * Sorting a vector of names is also compared with the qsort based sorting and with sorting on several threads.
+ */
+int main(int argc, char *argv[])
+{
+	jm_callbacks callbacks;
+	size_t maxItems, n;
+	int repetitions, ok = 1;
+
+	if(argc < 3) {
+		printf("Usage: %s <maximum number of items> <repetitions>\n", argv[0]);
+		return CTEST_RETURN_FAIL;
+	}
+	maxItems = (size_t)atol(argv[1]);
+	if(maxItems < 1) maxItems = 1;
+	repetitions = atoi(argv[2]);
+	if(repetitions < 1) repetitions = 1;
+
+	callbacks.malloc = malloc;
+	callbacks.calloc = calloc;
+	callbacks.realloc = realloc;
+	callbacks.free = free;
+	callbacks.logger = 0;
+	callbacks.log_level = jm_log_level_nothing;
+	callbacks.context = 0;
+
+	printf("jm_vector_push_back:\n");
+	for(n = 10; ok && (n <= maxItems); n *= 10) {
+		ok = bench_push_back(n, repetitions, &callbacks);
+	}
+	ok = ok && bench_insert(1000, &callbacks);
+	printf("Sorting by name:\n");
+	for(n = 10; ok && (n <= maxItems); n *= 10) {
+		ok = bench_sort(n, repetitions, &callbacks);
+	}
+	printf("Sorting on several threads:\n");
+	ok = ok && bench_parallel_sort(maxItems, &callbacks);
+	return ok ? CTEST_RETURN_SUCCESS : CTEST_RETURN_FAIL;
+}
@@ -1,10 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include "config_test.h"
 #include <JM/jm_vector.h>
 #include <JM/jm_stack.h>
+#include <JM/jm_string_intern.h>
 
 void print_int(int i,void* data) {
     printf("%d\n", i);
@@ -30,6 +32,26 @@ void log_error(const char* fmt, ...) {
 
 #define TESTVAL 49
 
+/* The interner must keep one copy per distinct string */
+void test_string_intern(void) {
+    jm_string_intern_t intern;
+    char buf[32];
+    jm_string first;
+    int i;
+
+    jm_string_intern_init(&intern, 0);
+    for(i = 0; i < 1000; i++) {
+        sprintf(buf, "string %d", (i * 7919) % 500);
+        if(strcmp(jm_string_intern_put(&intern, buf), buf)) log_error("jm_string_intern_put returned a different string\n");
+    }
+    if(jm_string_intern_get_size(&intern) != 500) log_error("Interned string count %u, expected 500\n", (unsigned)jm_string_intern_get_size(&intern));
+    first = jm_string_intern_find(&intern, "string 0");
+    if(!first || (jm_string_intern_put(&intern, "string 0") != first)) log_error("Interned string is not unique\n");
+    if(jm_string_intern_find(&intern, "string 500")) log_error("Found a string that was never added\n");
+
+    jm_string_intern_free_data(&intern);
+}
+
 int main() {
     int i, k;
     jm_vector(int) stackv;
@@ -73,5 +95,7 @@ int main() {
 
     jm_vector_free_data(int)(v);
     jm_stack_free(double)(s);
+
+    test_string_intern();
     return return_code;
 }
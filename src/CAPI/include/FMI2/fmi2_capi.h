@@ -88,6 +88,17 @@ jm_status_enu_t fmi2_capi_load_fcn(fmi2_capi_t* fmu, unsigned int capabilities[]
  * @return Error status. If the function returns with an error, no other C-API functions than fmi2_import_destroy_dllfmu are allowed to be called.
  */
 jm_status_enu_t fmi2_capi_load_dll(fmi2_capi_t* fmu);
+
+/**
+ * \brief Loads the FMU shared library from memory, see jm_portability_load_dll_handle_from_memory().
+ * 
+ * @param fmu A model description object returned by fmi2_import_allocate.
+ * @param size Size of the shared library file. The dllPath given at creation is only used for naming.
+ * @param fill Function writing the contents of the shared library file.
+ * @param data Passed to the fill function.
+ * @return Error status. Failures are not logged as errors so that the caller may fall back to fmi2_capi_load_dll.
+ */
+jm_status_enu_t fmi2_capi_load_dll_from_memory(fmi2_capi_t* fmu, size_t size, jm_dll_image_fill_ft fill, void* data);
 
 /**
  * \brief Frees the handle to the FMUs shared library. After this function returnes, no other C-API functions than fmi2_import_destroy_dllfmu and fmi2_import_create_dllfmu are allowed to be called.
@@ -270,6 +270,7 @@ fmi2_capi_t* fmi2_capi_create_dllfmu(jm_callbacks* cb, const char* dllPath, cons
 
 	/* Set FMI standard to load */
 	fmu->standard = standard;
+	fmu->dllMemoryFile = -1;
 
 	/* Set all memory alloated pointers to NULL */
 	fmu->dllPath = NULL;
@@ -328,6 +329,19 @@ jm_status_enu_t fmi2_capi_load_dll(fmi2_capi_t* fmu)
 	}
 }
 
+jm_status_enu_t fmi2_capi_load_dll_from_memory(fmi2_capi_t* fmu, size_t size, jm_dll_image_fill_ft fill, void* data)
+{
+	assert(fmu && fmu->dllPath);
+	fmu->dllHandle = jm_portability_load_dll_handle_from_memory(fmu->dllPath, size, fill, data, &fmu->dllMemoryFile);
+	if (fmu->dllHandle == NULL) {
+		jm_log_verbose(fmu->callbacks, FMI_CAPI_MODULE_NAME, "Could not load the DLL %s from memory", fmu->dllPath);
+		return jm_status_error;
+	} else {
+		jm_log_verbose(fmu->callbacks, FMI_CAPI_MODULE_NAME, "Loaded FMU binary %s from memory", fmu->dllPath);
+		return jm_status_success;
+	}
+}
+
 void fmi2_capi_set_debug_mode(fmi2_capi_t* fmu, int mode) {
 	if(fmu)
 		fmu->debugMode = mode;
@@ -356,6 +370,11 @@ jm_status_enu_t fmi2_capi_free_dll(fmi2_capi_t* fmu)
                 jm_status_success:
                 jm_portability_free_dll_handle(fmu->dllHandle);
 		fmu->dllHandle = 0;
+		/* A library kept loaded in debug mode still owns its path */
+		if (fmu->debugMode == 0) {
+			jm_portability_close_memory_file(fmu->dllMemoryFile);
+			fmu->dllMemoryFile = -1;
+		}
 		if (status == jm_status_error) { /* Free the library handle */
 			jm_log(fmu->callbacks, FMI_CAPI_MODULE_NAME, jm_log_level_error, "Could not free the DLL: %s", jm_portability_get_last_dll_error());
 			return jm_status_error;
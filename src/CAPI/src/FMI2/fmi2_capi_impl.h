@@ -41,6 +41,7 @@ struct fmi2_capi_t {
 	jm_callbacks* callbacks;
 
 	DLL_HANDLE dllHandle;
+	int dllMemoryFile; /* memory file the library was loaded from, -1 if loaded from a file */
 
 	fmi2_fmu_kind_enu_t standard;
 
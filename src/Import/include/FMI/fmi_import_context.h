@@ -26,6 +26,7 @@
 #include <JM/jm_callbacks.h>
 #include <FMI2/fmi2_xml_callbacks.h>
 #include <FMI/fmi_version.h> 
+#include <FMI/fmi_xml_parse_options.h>
 #include <FMI1/fmi1_types.h>
 #include <FMI1/fmi1_enums.h>
 #include <FMI2/fmi2_types.h>
@@ -76,6 +77,57 @@ FMILIB_EXPORT fmi_import_context_t* fmi_import_allocate_context( jm_callbacks* c
 */
 FMILIB_EXPORT void fmi_import_free_context( fmi_import_context_t* c);
 
+/**
+	\brief Set a directory where parsed model descriptions are cached.
+
+	When a cache directory is set fmi2_import_parse_xml() saves a binary image of every model description
+	it parses in the directory. Later calls, also from other processes, load the image instead of parsing
+	an XML file with the same content again. Images are found by the GUID of the model and only used if the
+	size and modification time of the XML file are the ones it was saved for, so loading an image does not
+	read the whole XML file. Annotations
+	are not cached, so the cache is not used when annotation callbacks are given.
+	FMI 1.0 model descriptions are always parsed: the images are laid out for the FMI 2.0 structures, and
+	FMI 1.0 keeps data that they have no records for, such as the vendor annotations and the direct
+	dependencies of the outputs.
+	@param c - library context.
+	@param cacheDir - an existing directory, or NULL to turn the cache off.
+	@return Error status.
+*/
+FMILIB_EXPORT jm_status_enu_t fmi_import_set_model_description_cache_dir( fmi_import_context_t* c, const char* cacheDir);
+
+/**
+	\brief Set the options used when parsing model descriptions.
+
+	The options apply to fmi1_import_parse_xml(), fmi2_import_parse_xml() and to parsing from archives.
+	Sections that are skipped are passed over by the parser, which makes parsing faster when only the
+	variables are of interest. fmi1_import_get_parsed_sections() and fmi2_import_get_parsed_sections()
+	tell which sections are available. The functions that take the fmu and return data from a skipped
+	section report an error and return NULL or 0. The descriptions of variables, types and items are
+	NULL when descriptions are skipped. Annotation callbacks are not called when annotations are skipped. Model descriptions parsed
+	with skipped sections are not cached, see fmi_import_set_model_description_cache_dir().
+	Setting numThreads sorts the variables of large models on several threads once they are parsed. The
+	result is the same as when sorting on the calling thread, which is the default.
+	@param c - library context.
+	@param options - the options to use, or NULL to parse complete model descriptions.
+*/
+FMILIB_EXPORT void fmi_import_set_parse_options( fmi_import_context_t* c, const fmi_xml_parse_options_t* options);
+
+/**
+	\brief Stream the variables of FMI 2.0 model descriptions to a handle instead of keeping them.
+
+	Meant for models too large to be indexed in memory. fmi2_import_parse_xml() and
+	fmi2_import_parse_xml_from_archive() pass each ScalarVariable to the handle as soon as it is parsed,
+	fully decoded with its declared type applied, and drop it afterwards. Nothing is sorted and the memory
+	needed does not grow with the number of variables. The returned FMU holds everything but the
+	variables: the variable lists are empty and the model structure, which refers to the variables, is
+	skipped. The number of continuous states is counted from the derivative attributes. Model descriptions
+	are not cached while a handle is set.
+	@param c - library context.
+	@param handle - the handle to call for each variable, or NULL to keep the variables as usual.
+	@param handleContext - forwarded to the handle.
+*/
+FMILIB_EXPORT void fmi2_import_set_variable_handle( fmi_import_context_t* c, fmi2_xml_variable_handle_ft handle, void* handleContext);
+
 /**
 	\brief Unzip an FMU specified by the fileName into directory dirName and parse XML to get FMI standard version.
 	@param c - library context.
@@ -84,6 +136,15 @@ FMILIB_EXPORT void fmi_import_free_context( fmi_import_context_t* c);
 */
 FMILIB_EXPORT fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const char* fileName, const char* dirName);
 
+/**
+	\brief Parse XML inside an FMU specified by the fileName to get FMI standard version.
+
+	The model description is read directly from the archive into memory. Nothing is written to disk.
+	@param c - library context.
+	@param fileName - an FMU file name.
+*/
+FMILIB_EXPORT fmi_version_enu_t fmi_import_get_fmi_version_from_archive( fmi_import_context_t* c, const char* fileName);
+
 /**
 	\brief FMU version 1.0 object
 */
@@ -102,6 +163,17 @@ typedef struct fmi2_import_t fmi2_import_t;
 */
 FMILIB_EXPORT fmi1_import_t* fmi1_import_parse_xml( fmi_import_context_t* c, const char* dirName);
 
+/**
+	\brief Parse FMI 1.0 XML file found inside the FMU archive fileName without unpacking the FMU.
+
+	The returned object gives access to all the model description information. 
+	Since no directory is associated with the FMU the binary cannot be loaded with fmi1_import_create_dllfmu().
+	\param c - library context.
+	\param fileName - an FMU file name.
+	\return fmi1_import_t:: opaque object pointer
+*/
+FMILIB_EXPORT fmi1_import_t* fmi1_import_parse_xml_from_archive( fmi_import_context_t* c, const char* fileName);
+
 /**
     \brief Create ::fmi2_import_t structure and parse the FMI 2.0 XML file found in the directory dirName.
 	\param context - library context.
@@ -111,6 +183,18 @@ FMILIB_EXPORT fmi1_import_t* fmi1_import_parse_xml( fmi_import_context_t* c, con
 */
 FMILIB_EXPORT fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks);
 
+/**
+    \brief Create ::fmi2_import_t structure and parse the FMI 2.0 XML file found inside the FMU archive fileName without unpacking the FMU.
+
+	The returned object gives access to all the model description information. 
+	Since no directory is associated with the FMU the binary cannot be loaded with fmi2_import_create_dllfmu().
+	\param context - library context.
+	\param fileName - an FMU file name.
+	\param xml_callbacks Callbacks to use for processing of annotations (may be NULL).
+	\return fmi2_import_t:: opaque object pointer
+*/
+FMILIB_EXPORT fmi2_import_t* fmi2_import_parse_xml_from_archive( fmi_import_context_t* context, const char* fileName, fmi2_xml_callbacks_t* xml_callbacks);
+
 /** 
 @}
 */
@@ -44,6 +44,71 @@ FMILIB_EXPORT char* fmi_import_mk_temp_dir(jm_callbacks* cb, const char* systemT
 */
 FMILIB_EXPORT jm_status_enu_t fmi_import_rmdir(jm_callbacks* cb, const char* dir);
 
+/**
+	\brief Make fmi_import_rmdir() return immediately and remove the directories in a background thread.
+
+	This also applies to the temporary directories removed by fmi1_import_free() and fmi2_import_free(),
+	which keeps the removal of large unpacked FMUs off the critical path. Errors in the background are reported
+	to the default logger. Call fmi_import_wait_rmdir() before exiting the process, otherwise the removal may
+	be left incomplete.
+	\param enable - non-zero to remove directories in the background. Default is zero.
+*/
+FMILIB_EXPORT void fmi_import_set_rmdir_async(int enable);
+
+/** \brief Wait until all the directories scheduled for removal in the background have been removed. */
+FMILIB_EXPORT void fmi_import_wait_rmdir(void);
+
+/**
+	\brief Unpack an FMU using several threads.
+
+	Large FMUs with many resource files are unpacked considerably faster since the files are inflated in parallel.
+	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
+	\param fmuPath - an FMU file name.
+	\param dirPath - directory where the files are unpacked. The directory must exist.
+	\param numThreads - number of threads to use. Zero means one thread per processor.
+	\return Status success or error.
+*/
+FMILIB_EXPORT jm_status_enu_t fmi_import_unzip_parallel(jm_callbacks* cb, const char* fmuPath, const char* dirPath, unsigned int numThreads);
+
+/**
+	\brief Unpack only the parts of an FMU that are needed to load it on the current platform.
+
+	These are the binaries in the binaries/FMI_PLATFORM directory and the resources directory.
+	Sources, documentation and binaries for other platforms are not extracted.
+	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
+	\param fmuPath - an FMU file name.
+	\param dirPath - directory where the files are unpacked. The directory must exist.
+	\return Status success or error.
+*/
+FMILIB_EXPORT jm_status_enu_t fmi_import_unzip_for_platform(jm_callbacks* cb, const char* fmuPath, const char* dirPath);
+
+/** Opaque handle to an FMU unpacked into a shared cache, see fmi_import_unzip_cached() */
+typedef struct fmi_import_unpack_lease_t fmi_import_unpack_lease_t;
+
+/**
+	\brief Unpack an FMU into a content-addressed cache shared by all the processes using the same cache directory.
+
+	The FMU is identified by a digest of its central directory (entry names, CRCs and sizes), so the same FMU
+	is unpacked only once no matter how many processes or instances load it. Unpacking is done into a staging
+	directory that is atomically renamed when complete, hence a partially unpacked FMU is never seen.
+	While a lease is held the directory is protected from eviction. Leases of processes that died are
+	cleaned up automatically.
+	The unpacked directory is shared and must be treated as read-only.
+	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
+	\param fmuPath - an FMU file name.
+	\param cacheDir - cache directory. It is created if it does not exist.
+	\param maxCacheSize - when the total uncompressed size of the cached FMUs exceeds this limit the least recently
+				used FMUs that are not leased are removed. Zero means no limit.
+	\return A lease that must be released with fmi_import_release_unpack_lease(), or NULL on error.
+*/
+FMILIB_EXPORT fmi_import_unpack_lease_t* fmi_import_unzip_cached(jm_callbacks* cb, const char* fmuPath, const char* cacheDir, size_t maxCacheSize);
+
+/** \brief Get the directory the FMU was unpacked into (no terminating '/'). Valid until the lease is released. */
+FMILIB_EXPORT const char* fmi_import_get_unpack_lease_dir(fmi_import_unpack_lease_t* lease);
+
+/** \brief Release a lease obtained with fmi_import_unzip_cached() allowing the directory to be evicted. */
+FMILIB_EXPORT void fmi_import_release_unpack_lease(fmi_import_unpack_lease_t* lease);
+
 /** 
 	\brief Create a file:// URL from absolute path
 	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
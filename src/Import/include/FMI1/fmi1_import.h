@@ -101,6 +101,15 @@ FMILIB_EXPORT int fmi1_import_clear_last_error(fmi1_import_t* fmu);
 @param fmu An fmu object as returned by fmi1_import_parse_xml().
 */
 FMILIB_EXPORT void fmi1_import_free(fmi1_import_t* fmu);
+
+/**
+\brief Get the sections of the model description that were parsed, see fmi_import_set_parse_options().
+
+Functions that return data from a section that was skipped report an error.
+@param fmu An fmu object as returned by fmi1_import_parse_xml().
+@return A combination of ::fmi_xml_section_enu_t flags.
+*/
+FMILIB_EXPORT unsigned int fmi1_import_get_parsed_sections(fmi1_import_t* fmu);
 /** @}
 \addtogroup fmi1_import_gen
  * \brief Functions for retrieving general model information. Memory for the strings is allocated and deallocated in the module.
@@ -129,6 +138,7 @@ FMILIB_EXPORT const char* fmi1_import_get_GUID(fmi1_import_t* fmu);
 /** 
 \brief Get FMU description.
 @param fmu An fmu object as returned by fmi1_import_parse_xml().
+@return The description, or NULL if descriptions were not parsed.
 */
 FMILIB_EXPORT const char* fmi1_import_get_description(fmi1_import_t* fmu);
 
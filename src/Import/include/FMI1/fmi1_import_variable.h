@@ -86,6 +86,7 @@ FMILIB_EXPORT const char* fmi1_import_get_variable_name(fmi1_import_variable_t*)
 
 /** \brief Get variable description. 
 	@return Description string or empty string ("") if no description in the XML file was given.
+	NULL if descriptions were not parsed, see fmi1_import_get_parsed_sections().
 */
 FMILIB_EXPORT const char* fmi1_import_get_variable_description(fmi1_import_variable_t*);
 
@@ -71,7 +71,7 @@ FMILIB_EXPORT const char* fmi1_import_get_annotation_name(fmi1_import_annotation
 /** \brief Get the value for the annotation */
 FMILIB_EXPORT const char* fmi1_import_get_annotation_value(fmi1_import_annotation_t*);
 
-/** \brief Get the list of all the vendor annotations present in the XML file */
+/** \brief Get the list of all the vendor annotations present in the XML file, NULL if annotations were not parsed */
 FMILIB_EXPORT fmi1_import_vendor_list_t* fmi1_import_get_vendor_list(fmi1_import_t* fmu);
 
 /** @} */
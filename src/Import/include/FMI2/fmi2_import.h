@@ -90,6 +90,15 @@ FMILIB_EXPORT int fmi2_import_clear_last_error(fmi2_import_t* fmu);
 @param fmu An fmu object as returned by fmi2_import_parse_xml().
 */
 FMILIB_EXPORT void fmi2_import_free(fmi2_import_t* fmu);
+
+/**
+\brief Get the sections of the model description that were parsed, see fmi_import_set_parse_options().
+
+Functions that return data from a section that was skipped report an error.
+@param fmu An fmu object as returned by fmi2_import_parse_xml().
+@return A combination of ::fmi_xml_section_enu_t flags.
+*/
+FMILIB_EXPORT unsigned int fmi2_import_get_parsed_sections(fmi2_import_t* fmu);
 /** @}
 \addtogroup fmi2_import_gen
  * \brief Functions for retrieving general model information. Memory for the strings is allocated and deallocated in the module.
@@ -127,6 +136,7 @@ FMILIB_EXPORT const char* fmi2_import_get_GUID(fmi2_import_t* fmu);
 /** 
 \brief Get FMU description.
 @param fmu An fmu object as returned by fmi2_import_parse_xml().
+@return The description, or NULL if descriptions were not parsed.
 */
 FMILIB_EXPORT const char* fmi2_import_get_description(fmi2_import_t* fmu);
 
@@ -228,10 +238,10 @@ FMILIB_EXPORT fmi2_import_variable_list_t* fmi2_import_get_variable_list(fmi2_im
 */
 FMILIB_EXPORT fmi2_import_variable_list_t* fmi2_import_create_var_list(fmi2_import_t* fmu,fmi2_import_variable_t* v);
 
-/** \brief Get the number of vendors that had annotations in the XML*/
+/** \brief Get the number of vendors that had annotations in the XML, 0 if annotations were not parsed */
 FMILIB_EXPORT size_t fmi2_import_get_vendors_num(fmi2_import_t* fmu);
 
-/** \brief Get the name of the vendor with that had annotations in the XML by index */
+/** \brief Get the name of the vendor with that had annotations in the XML by index, NULL if annotations were not parsed */
 FMILIB_EXPORT const char* fmi2_import_get_vendor_name(fmi2_import_t* fmu, size_t index);
 
 /** \brief Get the number of log categories defined in the XML */
@@ -240,7 +250,7 @@ FMILIB_EXPORT size_t fmi2_import_get_log_categories_num(fmi2_import_t* fmu);
 /** \brief Get the log category by index */
 FMILIB_EXPORT const char* fmi2_import_get_log_category(fmi2_import_t* fmu, size_t index);
 
-/** \brief Get the log category description by index */
+/** \brief Get the log category description by index, NULL if descriptions were not parsed */
 FMILIB_EXPORT const char* fmi2_import_get_log_category_description(fmi2_import_t* fmu, size_t index);
 
 /** \brief Get the number of source files for ME defined in the XML */
@@ -88,6 +88,19 @@ FMILIB_EXPORT void fmi2_import_destroy_dllfmu(fmi2_import_t* fmu);
  * @param mode The debug mode to set.
  */
 FMILIB_EXPORT void fmi2_import_set_debug_mode(fmi2_import_t* fmu, int mode);
+
+/**
+ * \brief Load the FMU binary without unpacking it to disk.
+ *
+ * Applies to FMUs parsed with fmi2_import_parse_xml_from_archive(). When enabled, fmi2_import_create_dllfmu()
+ * inflates the binary into an anonymous memory file and loads it from there (Linux only). Resources are still
+ * unpacked into a temporary directory, but only if the FMU has any. If the binary cannot be loaded from memory,
+ * e.g., because it depends on other libraries in the binaries directory, it is unpacked and loaded as usual.
+ * 
+ * @param fmu A model description object returned by fmi2_import_parse_xml_from_archive().
+ * @param enable Non-zero to load the binary from memory. Default is zero.
+ */
+FMILIB_EXPORT void fmi2_import_set_load_binary_from_memory(fmi2_import_t* fmu, int enable);
 /**@} */
 
 /**
@@ -69,6 +69,7 @@ FMILIB_EXPORT const char* fmi2_import_get_variable_name(fmi2_import_variable_t*)
 
 /** \brief Get variable description. 
 	@return Description string or empty string ("") if no description in the XML file was given.
+	NULL if descriptions were not parsed, see fmi2_import_get_parsed_sections().
 */
 FMILIB_EXPORT const char* fmi2_import_get_variable_description(fmi2_import_variable_t*);
 
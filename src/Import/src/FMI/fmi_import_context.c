@@ -14,6 +14,7 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <stdarg.h>
 
 #include <JM/jm_named_ptr.h>
@@ -34,6 +35,38 @@ void fmi_import_free_context( fmi_import_context_t* c) {
 	fmi_xml_free_context(c);
 }
 
+jm_status_enu_t fmi_import_set_model_description_cache_dir( fmi_import_context_t* c, const char* cacheDir) {
+	char* dir = 0;
+	if(cacheDir) {
+		size_t len = strlen(cacheDir);
+		dir = (char*)c->callbacks->malloc(len + 1);
+		if(!dir) {
+			jm_log_fatal(c->callbacks, MODULE, "Could not allocate memory");
+			return jm_status_error;
+		}
+		memcpy(dir, cacheDir, len + 1);
+		jm_log_verbose(c->callbacks, MODULE, "Caching model descriptions in %s", dir);
+	}
+	c->callbacks->free(c->modelDescriptionCacheDir);
+	c->modelDescriptionCacheDir = dir;
+	return jm_status_success;
+}
+
+void fmi_import_set_parse_options( fmi_import_context_t* c, const fmi_xml_parse_options_t* options) {
+	if(options) {
+		c->parseOptions = *options;
+	}
+	else {
+		c->parseOptions.skipSections = 0;
+		c->parseOptions.numThreads = 0;
+	}
+}
+
+void fmi2_import_set_variable_handle( fmi_import_context_t* c, fmi2_xml_variable_handle_ft handle, void* handleContext) {
+	c->fmi2VariableHandle = handle;
+	c->fmi2VariableHandleContext = handleContext;
+}
+
 
 fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const char* fileName, const char* dirName) {
 	fmi_version_enu_t ret = fmi_version_unknown_enu;
@@ -56,3 +89,20 @@ fmi_version_enu_t fmi_import_get_fmi_version( fmi_import_context_t* c, const cha
 	c->callbacks->free(mdpath);
 	return ret;
 }
+
+fmi_version_enu_t fmi_import_get_fmi_version_from_archive( fmi_import_context_t* c, const char* fileName) {
+	fmi_version_enu_t ret = fmi_version_unknown_enu;
+	char* xml;
+	size_t size;
+	jm_log_verbose(c->callbacks, MODULE, "Detecting FMI standard version");
+	if(!fileName || !*fileName) {
+		jm_log_fatal(c->callbacks, MODULE, "No FMU filename specified");
+		return fmi_version_unknown_enu;
+	}
+	if(fmi_zip_unzip_to_memory(fileName, FMI_MODEL_DESCRIPTION_XML, &xml, &size, c->callbacks) == jm_status_error) 
+		return fmi_version_unknown_enu;
+	ret = fmi_xml_get_fmi_version_from_buffer(c, xml, size);
+	jm_log_info(c->callbacks, MODULE, "XML specifies FMI standard version %s", fmi_version_to_string(ret));
+	c->callbacks->free(xml);
+	return ret;
+}
@@ -24,6 +24,7 @@
 
 #include <FMI1/fmi1_xml_model_description.h>
 #include <FMI/fmi_xml_context.h>
+#include <FMI2/fmi2_xml_callbacks.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +36,14 @@ struct fmi_xml_context_t {
     XML_Parser parser;
 
 	fmi_version_enu_t fmi_version;
+
+	char* modelDescriptionCacheDir; /* see fmi_import_set_model_description_cache_dir() */
+
+	fmi_xml_parse_options_t parseOptions; /* see fmi_import_set_parse_options() */
+
+	/* see fmi2_import_set_variable_handle() */
+	fmi2_xml_variable_handle_ft fmi2VariableHandle;
+	void* fmi2VariableHandleContext;
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,488 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* flock, kill and directory functions are not visible in strict C89 mode otherwise */
+#if !defined(WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#define _BSD_SOURCE
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <fmilib_config.h>
+#include <JM/jm_portability.h>
+#include <JM/jm_vector.h>
+#include <FMI/fmi_import_util.h>
+#include <FMI/fmi_zip_unzip.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#define fmi_import_cache_mkdir(dir) _mkdir(dir)
+#define fmi_import_cache_utime _utime
+#define fmi_import_cache_getpid() ((unsigned long)GetCurrentProcessId())
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <utime.h>
+#include <sys/file.h>
+#define fmi_import_cache_mkdir(dir) mkdir(dir, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH)
+#define fmi_import_cache_utime utime
+#define fmi_import_cache_getpid() ((unsigned long)getpid())
+#endif
+#ifndef S_ISDIR
+#define S_ISDIR(mode) (((mode) & S_IFMT) == S_IFDIR)
+#endif
+
+static const char* module = "FMILIB";
+
+/*
+	Layout of the cache directory:
+	.lock                            - lock file serializing publish, lease and eviction
+	<digest>/                        - unpacked FMU
+	<digest>.info                    - total size of the unpacked FMU, modification time gives LRU order,
+	                                   written before <digest>/ is published
+	<digest>.lease.<pid>.<id>        - one file per active lease
+	<digest>.staging.<pid>.<id>/     - FMU being unpacked, renamed to <digest> when complete
+	<digest>.evicted.<pid>.<id>/     - evicted FMU being removed
+*/
+#define FMI_IMPORT_CACHE_LOCK ".lock"
+#define FMI_IMPORT_CACHE_INFO ".info"
+#define FMI_IMPORT_CACHE_LEASE ".lease."
+#define FMI_IMPORT_CACHE_STAGING ".staging."
+#define FMI_IMPORT_CACHE_EVICTED ".evicted."
+#define FMI_IMPORT_CACHE_DIGEST_LEN (FMI_ZIP_DIGEST_SIZE - 1)
+
+struct fmi_import_unpack_lease_t {
+	jm_callbacks* cb;
+	char* dirPath;
+	char* leasePath;
+};
+
+#ifdef WIN32
+typedef HANDLE fmi_import_cache_lock_t;
+#else
+typedef int fmi_import_cache_lock_t;
+#endif
+
+/* One unpacked FMU found while scanning the cache */
+typedef struct fmi_import_cache_entry_t {
+	char digest[FMI_ZIP_DIGEST_SIZE];
+	unsigned long size;
+	time_t lastUsed;
+	int leased;
+} fmi_import_cache_entry_t;
+
+/* Concatenate the cache directory, a separator, the name and a suffix into newly allocated memory */
+static char* fmi_import_cache_path(jm_callbacks* cb, const char* cacheDir, const char* name, const char* suffix) {
+	size_t len = strlen(cacheDir) + strlen(FMI_FILE_SEP) + strlen(name) + strlen(suffix) + 1;
+	char* path = (char*)cb->malloc(len);
+	if(!path) {
+		jm_log_fatal(cb, module, "Could not allocate memory");
+		return 0;
+	}
+	jm_snprintf(path, len, "%s%s%s%s", cacheDir, FMI_FILE_SEP, name, suffix);
+	return path;
+}
+
+/* Suffix that is unique among the processes and leases using the cache */
+static void fmi_import_cache_unique_suffix(char* buf, size_t len, const char* kind, void* id) {
+	jm_snprintf(buf, len, "%s%lu.%lx", kind, fmi_import_cache_getpid(), (unsigned long)(size_t)id);
+}
+
+static int fmi_import_cache_is_dir(const char* path) {
+	struct stat st;
+	return (stat(path, &st) == 0) && S_ISDIR(st.st_mode);
+}
+
+static jm_status_enu_t fmi_import_cache_lock(jm_callbacks* cb, const char* cacheDir, fmi_import_cache_lock_t* lock) {
+	char* lockPath = fmi_import_cache_path(cb, cacheDir, FMI_IMPORT_CACHE_LOCK, "");
+	jm_status_enu_t status = jm_status_success;
+	if(!lockPath) return jm_status_error;
+#ifdef WIN32
+	{
+		OVERLAPPED ov;
+		memset(&ov, 0, sizeof(ov));
+		*lock = CreateFileA(lockPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, 0, NULL);
+		if((*lock == INVALID_HANDLE_VALUE) || !LockFileEx(*lock, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov)) {
+			if(*lock != INVALID_HANDLE_VALUE) CloseHandle(*lock);
+			status = jm_status_error;
+		}
+	}
+#else
+	/* flock locks belong to the open file, so threads of one process exclude each other too */
+	*lock = open(lockPath, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+	if((*lock < 0) || flock(*lock, LOCK_EX)) {
+		if(*lock >= 0) close(*lock);
+		status = jm_status_error;
+	}
+#endif
+	if(status != jm_status_success) {
+		jm_log_error(cb, module, "Could not lock the unpack cache %s (%s)", lockPath, strerror(errno));
+	}
+	cb->free(lockPath);
+	return status;
+}
+
+static void fmi_import_cache_unlock(fmi_import_cache_lock_t lock) {
+#ifdef WIN32
+	CloseHandle(lock);
+#else
+	flock(lock, LOCK_UN);
+	close(lock);
+#endif
+}
+
+/* A lease is stale if the process that took it is gone */
+static int fmi_import_cache_is_process_alive(unsigned long pid) {
+#ifdef WIN32
+	HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+	int alive;
+	if(!h) return (GetLastError() == ERROR_ACCESS_DENIED);
+	alive = (WaitForSingleObject(h, 0) == WAIT_TIMEOUT);
+	CloseHandle(h);
+	return alive;
+#else
+	return (kill((pid_t)pid, 0) == 0) || (errno == EPERM);
+#endif
+}
+
+/* Check if the name is <digest><kind><pid>.<id> and get the pid of the process that created it */
+static int fmi_import_cache_get_pid(const char* name, const char* kind, unsigned long* pid) {
+	size_t len = strlen(kind);
+	if((strlen(name) <= FMI_IMPORT_CACHE_DIGEST_LEN + len) ||
+	   strncmp(name + FMI_IMPORT_CACHE_DIGEST_LEN, kind, len)) return 0;
+	*pid = strtoul(name + FMI_IMPORT_CACHE_DIGEST_LEN + len, 0, 10);
+	return 1;
+}
+
+/* Collect the names of all the files in the cache directory */
+static jm_status_enu_t fmi_import_cache_list(jm_callbacks* cb, const char* cacheDir, jm_vector(jm_voidp)* names) {
+	jm_status_enu_t status = jm_status_success;
+#ifdef WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE h;
+	char* pattern = fmi_import_cache_path(cb, cacheDir, "*", "");
+	if(!pattern) return jm_status_error;
+	h = FindFirstFileA(pattern, &data);
+	cb->free(pattern);
+	if(h == INVALID_HANDLE_VALUE) return jm_status_error;
+	do {
+		const char* name = data.cFileName;
+#else
+	struct dirent* de;
+	DIR* dir = opendir(cacheDir);
+	if(!dir) return jm_status_error;
+	while((de = readdir(dir)) != 0) {
+		const char* name = de->d_name;
+#endif
+		char* copy = (char*)cb->malloc(strlen(name) + 1);
+		if(!copy || !jm_vector_push_back(jm_voidp)(names, copy)) {
+			cb->free(copy);
+			status = jm_status_error;
+			break;
+		}
+		strcpy(copy, name);
+#ifdef WIN32
+	} while(FindNextFileA(h, &data));
+	FindClose(h);
+#else
+	}
+	closedir(dir);
+#endif
+	return status;
+}
+
+static int fmi_import_cache_compare_last_used(const void* a, const void* b) {
+	const fmi_import_cache_entry_t* e1 = *(const fmi_import_cache_entry_t**)a;
+	const fmi_import_cache_entry_t* e2 = *(const fmi_import_cache_entry_t**)b;
+	if(e1->lastUsed != e2->lastUsed) return (e1->lastUsed < e2->lastUsed) ? -1 : 1;
+	return strcmp(e1->digest, e2->digest);
+}
+
+/* Remove least recently used unpacked FMUs without active leases until the cache fits into maxSize,
+   zero meaning no limit. Must be called with the cache locked. The evicted directories are renamed and their names added
+   to the removed list so that the (slow) removal can be done after unlocking. Staging and evicted
+   directories left by processes that died are removed the same way. */
+static void fmi_import_cache_evict(jm_callbacks* cb, const char* cacheDir, size_t maxSize, jm_vector(jm_voidp)* removed) {
+	jm_vector(jm_voidp) names;
+	jm_vector(jm_voidp) entries;
+	size_t i, j, totalSize = 0;
+
+	jm_vector_init(jm_voidp)(&names, 0, cb);
+	jm_vector_init(jm_voidp)(&entries, 0, cb);
+	if(fmi_import_cache_list(cb, cacheDir, &names) != jm_status_success) {
+		jm_log_warning(cb, module, "Could not list the files in the unpack cache %s", cacheDir);
+	}
+
+	for(i = 0; i < jm_vector_get_size(jm_voidp)(&names); i++) {
+		const char* name = (const char*)jm_vector_get_item(jm_voidp)(&names, i);
+		fmi_import_cache_entry_t* entry;
+		char digest[FMI_ZIP_DIGEST_SIZE];
+		char* infoPath;
+		char* dirPath;
+		FILE* info;
+		struct stat st;
+
+		if((strlen(name) != FMI_IMPORT_CACHE_DIGEST_LEN + strlen(FMI_IMPORT_CACHE_INFO)) ||
+		   strcmp(name + FMI_IMPORT_CACHE_DIGEST_LEN, FMI_IMPORT_CACHE_INFO)) continue;
+		memcpy(digest, name, FMI_IMPORT_CACHE_DIGEST_LEN);
+		digest[FMI_IMPORT_CACHE_DIGEST_LEN] = 0;
+		infoPath = fmi_import_cache_path(cb, cacheDir, name, "");
+		dirPath = fmi_import_cache_path(cb, cacheDir, digest, "");
+		if(infoPath && dirPath && !fmi_import_cache_is_dir(dirPath)) {
+			/* left by a process that died before publishing the directory */
+			jm_log_verbose(cb, module, "Removing stale %s", infoPath);
+			remove(infoPath);
+			cb->free(infoPath);
+			cb->free(dirPath);
+			continue;
+		}
+		cb->free(dirPath);
+		entry = (fmi_import_cache_entry_t*)cb->calloc(1, sizeof(fmi_import_cache_entry_t));
+		if(!infoPath || !entry || !jm_vector_push_back(jm_voidp)(&entries, entry)) {
+			cb->free(infoPath);
+			cb->free(entry);
+			break;
+		}
+		memcpy(entry->digest, digest, FMI_ZIP_DIGEST_SIZE);
+		info = fopen(infoPath, "r");
+		if(info) {
+			if(fscanf(info, "%lu", &entry->size) != 1) entry->size = 0;
+			fclose(info);
+		}
+		if(stat(infoPath, &st) == 0) entry->lastUsed = st.st_mtime;
+		totalSize += entry->size;
+		cb->free(infoPath);
+	}
+
+	/* Mark the entries that are in use and clean up leases left by processes that died */
+	for(i = 0; i < jm_vector_get_size(jm_voidp)(&names); i++) {
+		const char* name = (const char*)jm_vector_get_item(jm_voidp)(&names, i);
+		unsigned long pid;
+		if(fmi_import_cache_get_pid(name, FMI_IMPORT_CACHE_STAGING, &pid) ||
+		   fmi_import_cache_get_pid(name, FMI_IMPORT_CACHE_EVICTED, &pid)) {
+			char digest[FMI_ZIP_DIGEST_SIZE];
+			char suffix[100];
+			char* stalePath;
+			char* evictedPath;
+			if(fmi_import_cache_is_process_alive(pid)) continue;
+			/* take the directory over so that no other process removes it at the same time */
+			memcpy(digest, name, FMI_IMPORT_CACHE_DIGEST_LEN);
+			digest[FMI_IMPORT_CACHE_DIGEST_LEN] = 0;
+			fmi_import_cache_unique_suffix(suffix, sizeof(suffix), FMI_IMPORT_CACHE_EVICTED, (void*)name);
+			stalePath = fmi_import_cache_path(cb, cacheDir, name, "");
+			evictedPath = fmi_import_cache_path(cb, cacheDir, digest, suffix);
+			if(stalePath && evictedPath && (rename(stalePath, evictedPath) == 0)) {
+				jm_log_verbose(cb, module, "Removing stale %s", stalePath);
+				if(jm_vector_push_back(jm_voidp)(removed, evictedPath)) evictedPath = 0;
+			}
+			cb->free(stalePath);
+			cb->free(evictedPath);
+			continue;
+		}
+		if(!fmi_import_cache_get_pid(name, FMI_IMPORT_CACHE_LEASE, &pid)) continue;
+		if(!fmi_import_cache_is_process_alive(pid)) {
+			char* leasePath = fmi_import_cache_path(cb, cacheDir, name, "");
+			if(leasePath) {
+				jm_log_verbose(cb, module, "Removing stale lease %s", leasePath);
+				remove(leasePath);
+				cb->free(leasePath);
+			}
+			continue;
+		}
+		for(j = 0; j < jm_vector_get_size(jm_voidp)(&entries); j++) {
+			fmi_import_cache_entry_t* entry = (fmi_import_cache_entry_t*)jm_vector_get_item(jm_voidp)(&entries, j);
+			if(strncmp(entry->digest, name, FMI_IMPORT_CACHE_DIGEST_LEN) == 0) entry->leased = 1;
+		}
+	}
+
+	jm_vector_qsort(jm_voidp)(&entries, fmi_import_cache_compare_last_used);
+	for(j = 0; (maxSize > 0) && (j < jm_vector_get_size(jm_voidp)(&entries)) && (totalSize > maxSize); j++) {
+		fmi_import_cache_entry_t* entry = (fmi_import_cache_entry_t*)jm_vector_get_item(jm_voidp)(&entries, j);
+		char suffix[100];
+		char* dirPath;
+		char* evictedPath;
+		char* infoPath;
+
+		if(entry->leased) continue;
+		fmi_import_cache_unique_suffix(suffix, sizeof(suffix), FMI_IMPORT_CACHE_EVICTED, entry);
+		dirPath = fmi_import_cache_path(cb, cacheDir, entry->digest, "");
+		evictedPath = fmi_import_cache_path(cb, cacheDir, entry->digest, suffix);
+		infoPath = fmi_import_cache_path(cb, cacheDir, entry->digest, FMI_IMPORT_CACHE_INFO);
+		if(dirPath && evictedPath && infoPath && (rename(dirPath, evictedPath) == 0)) {
+			jm_log_verbose(cb, module, "Evicting %s from the unpack cache", dirPath);
+			remove(infoPath);
+			totalSize -= entry->size;
+			if(jm_vector_push_back(jm_voidp)(removed, evictedPath)) evictedPath = 0;
+		}
+		cb->free(dirPath);
+		cb->free(evictedPath);
+		cb->free(infoPath);
+	}
+
+	for(i = 0; i < jm_vector_get_size(jm_voidp)(&names); i++) {
+		cb->free(jm_vector_get_item(jm_voidp)(&names, i));
+	}
+	for(i = 0; i < jm_vector_get_size(jm_voidp)(&entries); i++) {
+		cb->free(jm_vector_get_item(jm_voidp)(&entries, i));
+	}
+	jm_vector_free_data(jm_voidp)(&names);
+	jm_vector_free_data(jm_voidp)(&entries);
+}
+
+/* Publish a fully unpacked staging directory. Must be called with the cache locked. */
+static jm_status_enu_t fmi_import_cache_publish(fmi_import_unpack_lease_t* lease, const char* stagingPath, const char* infoPath, size_t size) {
+	jm_callbacks* cb = lease->cb;
+	FILE* info;
+	int written = 0;
+
+	/* The size is recorded first so that every published directory is accounted for by the eviction */
+	info = fopen(infoPath, "w");
+	if(info) {
+		written = (fprintf(info, "%lu\n", (unsigned long)size) > 0);
+		if(fclose(info)) written = 0;
+	}
+	if(!written) {
+		jm_log_error(cb, module, "Could not write %s (%s)", infoPath, strerror(errno));
+		if(info) remove(infoPath);
+		return jm_status_error;
+	}
+	if(rename(stagingPath, lease->dirPath) != 0) {
+		if(!fmi_import_cache_is_dir(lease->dirPath)) {
+			jm_log_error(cb, module, "Could not rename %s to %s (%s)", stagingPath, lease->dirPath, strerror(errno));
+			remove(infoPath);
+			return jm_status_error;
+		}
+		/* Another process published the same FMU in the meantime. Its copy is used. */
+		jm_log_verbose(cb, module, "FMU was unpacked into the cache by another process");
+	}
+	return jm_status_success;
+}
+
+fmi_import_unpack_lease_t* fmi_import_unzip_cached(jm_callbacks* cb, const char* fmuPath, const char* cacheDir, size_t maxCacheSize) {
+	fmi_import_unpack_lease_t* lease;
+	fmi_import_cache_lock_t lock;
+	jm_vector(jm_voidp) removed;
+	char digest[FMI_ZIP_DIGEST_SIZE];
+	char suffix[100];
+	char* infoPath = 0;
+	char* stagingPath = 0;
+	size_t size, i;
+	FILE* leaseFile = 0;
+	int removeStaging = 0;
+
+	if(!cb) {
+		cb = jm_get_default_callbacks();
+	}
+	if(fmi_zip_get_archive_digest(fmuPath, digest, &size, cb) != jm_status_success) return 0;
+
+	lease = (fmi_import_unpack_lease_t*)cb->calloc(1, sizeof(fmi_import_unpack_lease_t));
+	if(!lease) {
+		jm_log_fatal(cb, module, "Could not allocate memory");
+		return 0;
+	}
+	lease->cb = cb;
+	jm_vector_init(jm_voidp)(&removed, 0, cb);
+
+	fmi_import_cache_mkdir(cacheDir);
+	fmi_import_cache_unique_suffix(suffix, sizeof(suffix), FMI_IMPORT_CACHE_LEASE, lease);
+	lease->dirPath = fmi_import_cache_path(cb, cacheDir, digest, "");
+	lease->leasePath = fmi_import_cache_path(cb, cacheDir, digest, suffix);
+	infoPath = fmi_import_cache_path(cb, cacheDir, digest, FMI_IMPORT_CACHE_INFO);
+	fmi_import_cache_unique_suffix(suffix, sizeof(suffix), FMI_IMPORT_CACHE_STAGING, lease);
+	stagingPath = fmi_import_cache_path(cb, cacheDir, digest, suffix);
+	if(!lease->dirPath || !lease->leasePath || !infoPath || !stagingPath ||
+	   (fmi_import_cache_lock(cb, cacheDir, &lock) != jm_status_success)) {
+		goto fail;
+	}
+
+	if(fmi_import_cache_is_dir(lease->dirPath)) {
+		jm_log_verbose(cb, module, "Reusing unpacked FMU %s", lease->dirPath);
+	}
+	else {
+		/* Unpacking is done without holding the lock. The result only becomes visible with the rename. */
+		fmi_import_cache_unlock(lock);
+		jm_log_verbose(cb, module, "Unpacking FMU into the cache %s", cacheDir);
+		removeStaging = 1;
+		if((fmi_import_cache_mkdir(stagingPath) != 0) ||
+		   (fmi_zip_unzip(fmuPath, stagingPath, cb) != jm_status_success) ||
+		   (fmi_import_cache_lock(cb, cacheDir, &lock) != jm_status_success)) {
+			goto fail;
+		}
+		if(fmi_import_cache_publish(lease, stagingPath, infoPath, size) != jm_status_success) {
+			fmi_import_cache_unlock(lock);
+			goto fail;
+		}
+		removeStaging = fmi_import_cache_is_dir(stagingPath);
+	}
+
+	leaseFile = fopen(lease->leasePath, "w");
+	if(!leaseFile) {
+		jm_log_error(cb, module, "Could not create lease file %s (%s)", lease->leasePath, strerror(errno));
+		fmi_import_cache_unlock(lock);
+		goto fail;
+	}
+	fclose(leaseFile);
+	fmi_import_cache_utime(infoPath, 0);
+
+	/* leftovers of processes that died are cleaned up even without a size limit */
+	fmi_import_cache_evict(cb, cacheDir, maxCacheSize, &removed);
+	fmi_import_cache_unlock(lock);
+
+	for(i = 0; i < jm_vector_get_size(jm_voidp)(&removed); i++) {
+		fmi_import_rmdir(cb, (char*)jm_vector_get_item(jm_voidp)(&removed, i));
+		cb->free(jm_vector_get_item(jm_voidp)(&removed, i));
+	}
+	jm_vector_free_data(jm_voidp)(&removed);
+	if(removeStaging) fmi_import_rmdir(cb, stagingPath);
+	cb->free(stagingPath);
+	cb->free(infoPath);
+	return lease;
+
+fail:
+	if(removeStaging) fmi_import_rmdir(cb, stagingPath);
+	jm_vector_free_data(jm_voidp)(&removed);
+	cb->free(stagingPath);
+	cb->free(infoPath);
+	cb->free(lease->leasePath);
+	cb->free(lease->dirPath);
+	cb->free(lease);
+	return 0;
+}
+
+const char* fmi_import_get_unpack_lease_dir(fmi_import_unpack_lease_t* lease) {
+	return lease->dirPath;
+}
+
+void fmi_import_release_unpack_lease(fmi_import_unpack_lease_t* lease) {
+	jm_callbacks* cb;
+	if(!lease) return;
+	cb = lease->cb;
+	if(remove(lease->leasePath) != 0) {
+		jm_log_warning(cb, module, "Could not remove lease file %s (%s)", lease->leasePath, strerror(errno));
+	}
+	cb->free(lease->leasePath);
+	cb->free(lease->dirPath);
+	cb->free(lease);
+}
@@ -21,6 +21,7 @@
 #include <fmilib_config.h>
 #include <JM/jm_portability.h>
 #include <FMI/fmi_import_util.h>
+#include <FMI/fmi_zip_unzip.h>
 
 char* fmi_import_mk_temp_dir(jm_callbacks* cb, const char* systemTempDir, const char* tempPrefix) {
 	if(!tempPrefix) tempPrefix = "fmil";
@@ -31,10 +32,46 @@ char* fmi_import_create_URL_from_abs_path(jm_callbacks* cb, const char* absPath)
 	return jm_create_URL_from_abs_path(cb, absPath);
 }
 
+/* Set with fmi_import_set_rmdir_async() */
+static int fmi_import_rmdir_async = 0;
+
 jm_status_enu_t fmi_import_rmdir(jm_callbacks* cb, const char* dir) {
+	if(fmi_import_rmdir_async) {
+		return jm_rmdir_async(cb, dir);
+	}
 	return jm_rmdir(cb, dir);
 }
 
+void fmi_import_set_rmdir_async(int enable) {
+	fmi_import_rmdir_async = enable;
+}
+
+void fmi_import_wait_rmdir(void) {
+	jm_rmdir_async_wait();
+}
+
+jm_status_enu_t fmi_import_unzip_parallel(jm_callbacks* cb, const char* fmuPath, const char* dirPath, unsigned int numThreads) {
+	if(!cb) {
+		cb = jm_get_default_callbacks();
+	}
+	return fmi_zip_unzip_parallel(fmuPath, dirPath, 0, 0, numThreads, cb);
+}
+
+/* Accept the entries under binaries/FMI_PLATFORM/ and resources/ */
+static int fmi_import_platform_files_filter(const char* entry_name, void* data) {
+	static const char* binaries = FMI_BINARIES "/" FMI_PLATFORM "/";
+	static const char* resources = "resources/";
+	return (strncmp(entry_name, binaries, strlen(binaries)) == 0) || 
+		(strncmp(entry_name, resources, strlen(resources)) == 0);
+}
+
+jm_status_enu_t fmi_import_unzip_for_platform(jm_callbacks* cb, const char* fmuPath, const char* dirPath) {
+	if(!cb) {
+		cb = jm_get_default_callbacks();
+	}
+	return fmi_zip_unzip_selected(fmuPath, dirPath, fmi_import_platform_files_filter, 0, cb);
+}
+
 char* fmi_import_get_dll_path(const char* fmu_unzipped_path, const char* model_identifier, jm_callbacks* callbacks)
 {
 	char* dll_path;
@@ -17,6 +17,7 @@
 #include <stdarg.h>
 
 #include <JM/jm_named_ptr.h>
+#include <FMI/fmi_zip_unzip.h>
 #include "fmi1_import_impl.h"
 #include "fmi1_import_variable_list_impl.h"
 
@@ -42,6 +43,8 @@ fmi1_import_t* fmi1_import_allocate(jm_callbacks* cb) {
 
 	fmu->dirPath = 0;
 	fmu->location = 0;
+	fmu->fmuPath = 0;
+	fmu->removeDirOnFree = 0;
 	fmu->callbacks = cb;
 	fmu->capi = 0;
 	fmu->md = fmi1_xml_allocate_model_description(cb);
@@ -81,6 +84,9 @@ fmi1_import_t* fmi1_import_parse_xml( fmi_import_context_t* context, const char*
 	
 	jm_log_verbose( cb, "FMILIB", "Parsing model description XML");
 
+	fmi1_xml_set_skipped_sections(fmu->md, context->parseOptions.skipSections);
+	fmi1_xml_set_parse_threads(fmu->md, context->parseOptions.numThreads);
+	/* The model description cache only holds FMI 2.0 images, see fmi_import_set_model_description_cache_dir() */
 	if(fmi1_xml_parse_model_description( fmu->md, xmlPath)) {
 		fmi1_import_free(fmu);
 		cb->free(xmlPath);
@@ -107,6 +113,82 @@ fmi1_import_t* fmi1_import_parse_xml( fmi_import_context_t* context, const char*
 	return fmu;
 }
 
+fmi1_import_t* fmi1_import_parse_xml_from_archive( fmi_import_context_t* context, const char* fileName) {
+	char* xml;
+	size_t size;
+	jm_callbacks* cb;
+	fmi1_import_t* fmu;
+
+	if(!context) return 0;
+
+	cb = context->callbacks; 
+
+	if(fmi_zip_unzip_to_memory(fileName, FMI_MODEL_DESCRIPTION_XML, &xml, &size, cb) == jm_status_error) 
+		return 0;
+
+	fmu = fmi1_import_allocate(cb);
+
+	if(!fmu) {
+		cb->free(xml);
+		return 0;
+	}
+	
+	jm_log_verbose( cb, "FMILIB", "Parsing model description XML");
+
+	fmi1_xml_set_skipped_sections(fmu->md, context->parseOptions.skipSections);
+	fmi1_xml_set_parse_threads(fmu->md, context->parseOptions.numThreads);
+	if(fmi1_xml_parse_model_description_from_buffer( fmu->md, xml, size)) {
+		fmi1_import_free(fmu);
+		cb->free(xml);
+		return 0;
+	}
+	cb->free(xml);
+
+	/* Remember the archive so that binaries and resources can be unpacked when needed */
+	fmu->fmuPath = (char*)cb->calloc(strlen(fileName) + 1, sizeof(char));
+	if (fmu->fmuPath == NULL) {
+		jm_log_fatal( cb, "FMILIB", "Could not allocate memory");
+		fmi1_import_free(fmu);
+		return 0;
+	}
+	strcpy(fmu->fmuPath, fileName);
+
+	jm_log_verbose( cb, "FMILIB", "Parsing finished successfully");
+
+	return fmu;
+}
+
+jm_status_enu_t fmi1_import_unpack_platform_files(fmi1_import_t* fmu) {
+	jm_callbacks* cb = fmu->callbacks;
+	char* dirPath;
+
+	if(fmu->dirPath) return jm_status_success;
+	if(!fmu->fmuPath) {
+		jm_log_error(cb, module, "No FMU directory or archive is available");
+		return jm_status_error;
+	}
+
+	jm_log_verbose(cb, module, "Unpacking binaries and resources for '" FMI_PLATFORM "'");
+	dirPath = fmi_import_mk_temp_dir(cb, 0, 0);
+	if(!dirPath) return jm_status_error;
+	if(fmi_import_unzip_for_platform(cb, fmu->fmuPath, dirPath) != jm_status_success) {
+		fmi_import_rmdir(cb, dirPath);
+		cb->free(dirPath);
+		return jm_status_error;
+	}
+
+	fmu->location = fmi_import_create_URL_from_abs_path(cb, dirPath);
+	if(!fmu->location) {
+		jm_log_fatal(cb, module, "Could not allocate memory");
+		fmi_import_rmdir(cb, dirPath);
+		cb->free(dirPath);
+		return jm_status_error;
+	}
+	fmu->dirPath = dirPath;
+	fmu->removeDirOnFree = 1;
+	return jm_status_success;
+}
+
 void fmi1_import_free(fmi1_import_t* fmu) {
     jm_callbacks* cb = fmu->callbacks;
 
@@ -118,8 +200,13 @@ void fmi1_import_free(fmi1_import_t* fmu) {
 	jm_vector_free_data(char)(&fmu->logMessageBufferCoded);
 	jm_vector_free_data(char)(&fmu->logMessageBufferExpanded);
 
+	if(fmu->removeDirOnFree) {
+		fmi_import_rmdir(cb, fmu->dirPath);
+	}
+
 	cb->free(fmu->dirPath);
 	cb->free(fmu->location);
+	cb->free(fmu->fmuPath);
     cb->free(fmu);
 }
 
@@ -148,10 +235,7 @@ const char* fmi1_import_get_GUID(fmi1_import_t* fmu){
 }
 
 const char* fmi1_import_get_description(fmi1_import_t* fmu) {
-	if(!fmu->md) {
-		jm_log_error(fmu->callbacks, module,"No FMU is loaded");
-		return 0;
-	}
+	if(!fmi1_import_check_has_section(fmu, fmi_xml_section_descriptions, "Descriptions")) return 0;
 	return fmi1_xml_get_description(fmu->md);
 }
 
@@ -268,10 +352,7 @@ void fmi1_import_set_default_experiment_tolerance(fmi1_import_t* fmu, double tol
 }
 
 fmi1_import_vendor_list_t* fmi1_import_get_vendor_list(fmi1_import_t* fmu) {
-	if(!fmu->md) {
-		jm_log_error(fmu->callbacks, module,"No FMU is loaded");
-		return 0;
-	}
+	if(!fmi1_import_check_has_section(fmu, fmi_xml_section_annotations, "Vendor annotations")) return 0;
 	return fmi1_xml_get_vendor_list(fmu->md);
 }
 
@@ -284,11 +365,28 @@ fmi1_import_vendor_t* fmi1_import_get_vendor(fmi1_import_vendor_list_t* v, unsig
 }
 
 fmi1_import_unit_definitions_t* fmi1_import_get_unit_definitions(fmi1_import_t* fmu) {
+	if(!fmi1_import_check_has_section(fmu, fmi_xml_section_units, "Unit definitions")) return 0;
+	return fmi1_xml_get_unit_definitions(fmu->md);
+}
+
+int fmi1_import_check_has_section(fmi1_import_t* fmu, fmi_xml_section_enu_t section, const char* sectionName) {
 	if(!fmu->md) {
 		jm_log_error(fmu->callbacks, module,"No FMU is loaded");
 		return 0;
 	}
-	return fmi1_xml_get_unit_definitions(fmu->md);
+	if(!(fmi1_xml_get_parsed_sections(fmu->md) & section)) {
+		jm_log_error(fmu->callbacks, module, "%s were not parsed (see fmi_import_set_parse_options())", sectionName);
+		return 0;
+	}
+	return 1;
+}
+
+unsigned int fmi1_import_get_parsed_sections(fmi1_import_t* fmu) {
+	if(!fmu->md) {
+		jm_log_error(fmu->callbacks, module,"No FMU is loaded");
+		return 0;
+	}
+	return fmi1_xml_get_parsed_sections(fmu->md);
 }
 
 unsigned int  fmi1_import_get_unit_definitions_number(fmi1_import_unit_definitions_t* ud) {
@@ -54,6 +54,11 @@ jm_status_enu_t fmi1_import_create_dllfmu(fmi1_import_t* fmu, fmi1_callback_func
 		return jm_status_error;
 	}
 
+	/* FMUs parsed directly from the archive are unpacked on first use */
+	if (fmi1_import_unpack_platform_files(fmu) != jm_status_success) {
+		return jm_status_error;
+	}
+
 	if( jm_portability_get_current_working_directory(curDir, FILENAME_MAX+1) != jm_status_success) {
 		jm_log_warning(fmu->callbacks, module, "Could not get current working directory (%s)", strerror(errno));
 		curDir[0] = 0;
@@ -36,6 +36,8 @@ extern "C" {
 struct fmi1_import_t {	
 	char* dirPath;
 	char* location;
+	char* fmuPath; /* FMU archive given to fmi1_import_parse_xml_from_archive() */
+	int removeDirOnFree; /* dirPath is a temporary directory created by the library */
 	jm_callbacks* callbacks;
 	fmi1_xml_model_description_t* md;
 	fmi1_capi_t* capi;
@@ -44,6 +46,12 @@ struct fmi1_import_t {
 	jm_vector(char) logMessageBufferExpanded;
 };
 
+/* Unpack the binaries and resources of an FMU parsed from archive into a temporary directory */
+jm_status_enu_t fmi1_import_unpack_platform_files(fmi1_import_t* fmu);
+
+/* Check that a section of the model description was parsed and report an error otherwise */
+int fmi1_import_check_has_section(fmi1_import_t* fmu, fmi_xml_section_enu_t section, const char* sectionName);
+
 extern jm_callbacks fmi1_import_active_fmu_store_callbacks;
 
 extern jm_vector(jm_voidp) fmi1_import_active_fmu_store;
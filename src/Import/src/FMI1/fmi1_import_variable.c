@@ -72,7 +72,10 @@ fmi1_causality_enu_t fmi1_import_get_causality(fmi1_import_variable_t* v) {
 
 /* DirectDependency is returned for variables with causality Output. Null pointer for others. */
 fmi1_import_variable_list_t* fmi1_import_get_direct_dependency(fmi1_import_t* fmu, fmi1_import_variable_t* v) {
-	fmi1_import_variable_list_t* list = fmi1_import_alloc_variable_list(fmu, fmi1_xml_get_direct_dependency_size(fmu->md,v));
+	fmi1_import_variable_list_t* list;
+	/* without the DirectDependency elements every output would seem to depend on all the inputs */
+	if(!fmi1_import_check_has_section(fmu, fmi_xml_section_model_structure, "Direct dependencies")) return 0;
+	list = fmi1_import_alloc_variable_list(fmu, fmi1_xml_get_direct_dependency_size(fmu->md,v));
 	if(fmi1_xml_get_direct_dependency(fmu->md,v,&list->variables) != jm_status_success) {
 		fmi1_import_free_variable_list(list);
 		return 0;
@@ -17,6 +17,8 @@
 #include <stdarg.h>
 
 #include <JM/jm_named_ptr.h>
+#include <JM/jm_portability.h>
+#include <FMI/fmi_zip_unzip.h>
 #include <FMI2/fmi2_types.h>
 #include <FMI2/fmi2_functions.h>
 #include <FMI2/fmi2_enums.h>
@@ -41,6 +43,10 @@ fmi2_import_t* fmi2_import_allocate(jm_callbacks* cb) {
 	}
 	fmu->dirPath = 0;
 	fmu->resourceLocation = 0;
+	fmu->fmuPath = 0;
+	fmu->removeDirOnFree = 0;
+	fmu->binariesUnpacked = 0;
+	fmu->loadBinaryFromMemory = 0;
 	fmu->callbacks = cb;
 	fmu->capi = 0;
 	fmu->md = fmi2_xml_allocate_model_description(cb);
@@ -58,6 +64,12 @@ const char* fmi2_import_get_last_error(fmi2_import_t* fmu) {
 	return jm_get_last_error(fmu->callbacks);
 }
 
+void fmi2_import_apply_parse_options(fmi_import_context_t* context, fmi2_import_t* fmu) {
+	fmi2_xml_set_skipped_sections(fmu->md, context->parseOptions.skipSections);
+	fmi2_xml_set_parse_threads(fmu->md, context->parseOptions.numThreads);
+	fmi2_xml_set_variable_handle(fmu->md, context->fmi2VariableHandle, context->fmi2VariableHandleContext);
+}
+
 fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks) {
 	char* xmlPath;
 	char absPath[FILENAME_MAX + 2];
@@ -92,7 +104,8 @@ fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char*
 
 	jm_log_verbose( context->callbacks, "FMILIB", "Parsing model description XML");
 
-	if(fmi2_xml_parse_model_description( fmu->md, xmlPath, xml_callbacks)) {
+	fmi2_import_apply_parse_options(context, fmu);
+	if(fmi2_import_parse_model_description_cached(context, fmu, xmlPath, xml_callbacks)) {
 		fmi2_import_free(fmu);
 		fmu = 0;
 	}
@@ -104,6 +117,113 @@ fmi2_import_t* fmi2_import_parse_xml( fmi_import_context_t* context, const char*
 	return fmu;
 }
 
+fmi2_import_t* fmi2_import_parse_xml_from_archive( fmi_import_context_t* context, const char* fileName, fmi2_xml_callbacks_t* xml_callbacks) {
+	char* xml;
+	size_t size;
+	fmi2_import_t* fmu = 0;
+
+	if(!context) return 0;
+
+	if(fmi_zip_unzip_to_memory(fileName, FMI_MODEL_DESCRIPTION_XML, &xml, &size, context->callbacks) == jm_status_error) 
+		return 0;
+
+	fmu = fmi2_import_allocate(context->callbacks);
+
+	if(!fmu) {
+		context->callbacks->free(xml);
+		return 0;
+	}
+
+	jm_log_verbose( context->callbacks, "FMILIB", "Parsing model description XML");
+
+	fmi2_import_apply_parse_options(context, fmu);
+	if(fmi2_xml_parse_model_description_from_buffer( fmu->md, xml, size, xml_callbacks)) {
+		fmi2_import_free(fmu);
+		fmu = 0;
+	}
+	context->callbacks->free(xml);
+
+	/* Remember the archive so that binaries and resources can be unpacked when needed */
+	if(fmu) {
+		fmu->fmuPath = context->callbacks->malloc(strlen(fileName) + 1);
+		if (!fmu->fmuPath) {
+			jm_log_fatal( context->callbacks, "FMILIB", "Could not allocate memory");
+			fmi2_import_free(fmu);
+			return 0;
+		}
+		strcpy(fmu->fmuPath, fileName);
+	}
+
+	if(fmu)
+		jm_log_verbose( context->callbacks, "FMILIB", "Parsing finished successfully");
+
+	return fmu;
+}
+
+/* Accepts the archive entries starting with the prefix given as data */
+static int fmi2_import_entry_prefix_filter(const char* entry_name, void* data) {
+	const char* prefix = (const char*)data;
+	return strncmp(entry_name, prefix, strlen(prefix)) == 0;
+}
+
+jm_status_enu_t fmi2_import_unpack_platform_files(fmi2_import_t* fmu, int withBinaries) {
+	jm_callbacks* cb = fmu->callbacks;
+	char* dirPath;
+	char* resourcesPath;
+
+	if(fmu->dirPath && (!fmu->removeDirOnFree || fmu->binariesUnpacked || !withBinaries)) return jm_status_success;
+	if(!fmu->fmuPath) {
+		jm_log_error(cb, module, "No FMU directory or archive is available");
+		return jm_status_error;
+	}
+
+	if(!fmu->dirPath) {
+		size_t count = 1;
+		if(!withBinaries && (fmi_zip_count_entries(fmu->fmuPath, fmi2_import_entry_prefix_filter, "resources/", &count, cb) != jm_status_success)) {
+			return jm_status_error;
+		}
+
+		/* The directory is created even without resources so that fmi2Instantiate gets a valid resource location */
+		dirPath = fmi_import_mk_temp_dir(cb, 0, 0);
+		if(!dirPath) return jm_status_error;
+		if(count) jm_log_verbose(cb, module, "Unpacking resources");
+		if(count && (fmi_zip_unzip_selected(fmu->fmuPath, dirPath, fmi2_import_entry_prefix_filter, "resources/", cb) != jm_status_success)) {
+			fmi_import_rmdir(cb, dirPath);
+			cb->free(dirPath);
+			return jm_status_error;
+		}
+
+		resourcesPath = cb->malloc(strlen(dirPath) + strlen(FMI_FILE_SEP "resources") + 1);
+		if(resourcesPath) {
+			strcpy(resourcesPath, dirPath);
+			strcat(resourcesPath, FMI_FILE_SEP "resources");
+			if(count || (jm_mkdir(cb, resourcesPath) == jm_status_success)) {
+				fmu->resourceLocation = fmi_import_create_URL_from_abs_path(cb, resourcesPath);
+			}
+			cb->free(resourcesPath);
+		}
+		else {
+			jm_log_fatal(cb, module, "Could not allocate memory");
+		}
+		if(!fmu->resourceLocation) {
+			fmi_import_rmdir(cb, dirPath);
+			cb->free(dirPath);
+			return jm_status_error;
+		}
+		fmu->dirPath = dirPath;
+		fmu->removeDirOnFree = 1;
+	}
+
+	if(withBinaries) {
+		jm_log_verbose(cb, module, "Unpacking binaries for '" FMI_PLATFORM "'");
+		if(fmi_zip_unzip_selected(fmu->fmuPath, fmu->dirPath, fmi2_import_entry_prefix_filter, FMI_BINARIES "/" FMI_PLATFORM "/", cb) != jm_status_success) {
+			return jm_status_error;
+		}
+		fmu->binariesUnpacked = 1;
+	}
+	return jm_status_success;
+}
+
 void fmi2_import_free(fmi2_import_t* fmu) {
     jm_callbacks* cb = fmu->callbacks;
 
@@ -115,8 +235,13 @@ void fmi2_import_free(fmi2_import_t* fmu) {
 	jm_vector_free_data(char)(&fmu->logMessageBufferCoded);
 	jm_vector_free_data(char)(&fmu->logMessageBufferExpanded);
 
+	if(fmu->removeDirOnFree) {
+		fmi_import_rmdir(cb, fmu->dirPath);
+	}
+
 	cb->free(fmu->resourceLocation);
 	cb->free(fmu->dirPath);
+	cb->free(fmu->fmuPath);
     cb->free(fmu);
 }
 
@@ -128,6 +253,20 @@ int fmi2_import_check_has_FMU(fmi2_import_t* fmu) {
 	return 1;
 }
 
+int fmi2_import_check_has_section(fmi2_import_t* fmu, fmi_xml_section_enu_t section, const char* sectionName) {
+	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!(fmi2_xml_get_parsed_sections(fmu->md) & section)) {
+		jm_log_error(fmu->callbacks, module, "%s were not parsed (see fmi_import_set_parse_options())", sectionName);
+		return 0;
+	}
+	return 1;
+}
+
+unsigned int fmi2_import_get_parsed_sections(fmi2_import_t* fmu) {
+	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	return fmi2_xml_get_parsed_sections(fmu->md);
+}
+
 const char* fmi2_import_get_model_name(fmi2_import_t* fmu) {
 	if(!fmi2_import_check_has_FMU(fmu)) return 0;
 
@@ -160,7 +299,7 @@ const char* fmi2_import_get_GUID(fmi2_import_t* fmu){
 }
 
 const char* fmi2_import_get_description(fmi2_import_t* fmu) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_descriptions, "Descriptions")) return 0;
 
 	return fmi2_xml_get_description(fmu->md);
 }
@@ -251,7 +390,7 @@ double fmi2_import_get_default_experiment_step(fmi2_import_t* fmu) {
 }
 
 fmi2_import_unit_definitions_t* fmi2_import_get_unit_definitions(fmi2_import_t* fmu) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_units, "Unit definitions")) return 0;
 
 	return fmi2_xml_get_unit_definitions(fmu->md);
 }
@@ -314,13 +453,13 @@ fmi2_fmu_kind_enu_t fmi2_import_get_fmu_kind(fmi2_import_t* fmu) {
 }
 
 size_t fmi2_import_get_vendors_num(fmi2_import_t* fmu){
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_annotations, "Vendor annotations")) return 0;
 
 	return fmi2_xml_get_vendors_num(fmu->md);
 }
 
 const char* fmi2_import_get_vendor_name(fmi2_import_t* fmu, size_t  index){
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_annotations, "Vendor annotations")) return 0;
 
 	return fmi2_xml_get_vendor_name(fmu->md, index);
 }
@@ -341,7 +480,7 @@ const char* fmi2_import_get_log_category(fmi2_import_t* fmu, size_t  index) {
 
 /** \brief Get the log category description by index */
 const char* fmi2_import_get_log_category_description(fmi2_import_t* fmu, size_t  index) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_descriptions, "Descriptions")) return 0;
 
 	return jm_vector_get_item(jm_string)(fmi2_xml_get_log_category_descriptions(fmu->md), index);
 }
@@ -376,28 +515,28 @@ const char* fmi2_import_get_source_file_cs(fmi2_import_t* fmu, size_t  index) {
 
 
 fmi2_import_variable_list_t* fmi2_import_get_outputs_list(fmi2_import_t* fmu) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) return 0;
 	return fmi2_import_vector_to_varlist(fmu, fmi2_xml_get_outputs(fmi2_xml_get_model_structure(fmu->md)));
 }
 
 fmi2_import_variable_list_t* fmi2_import_get_derivatives_list(fmi2_import_t* fmu){
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) return 0;
 	return fmi2_import_vector_to_varlist(fmu, fmi2_xml_get_derivatives(fmi2_xml_get_model_structure(fmu->md)));
 }
 
 fmi2_import_variable_list_t* fmi2_import_get_discrete_states_list(fmi2_import_t* fmu) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) return 0;
 	return fmi2_import_vector_to_varlist(fmu, fmi2_xml_get_discrete_states(fmi2_xml_get_model_structure(fmu->md)));
 }
 
 fmi2_import_variable_list_t* fmi2_import_get_initial_unknowns_list(fmi2_import_t* fmu) {
-	if(!fmi2_import_check_has_FMU(fmu)) return 0;
+	if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) return 0;
 	return fmi2_import_vector_to_varlist(fmu, fmi2_xml_get_initial_unknowns(fmi2_xml_get_model_structure(fmu->md)));
 }
 
 void fmi2_import_get_outputs_dependencies(fmi2_import_t* fmu,size_t** startIndex, size_t** dependency, char** factorKind) { 
     fmi2_xml_model_structure_t* ms; 
-    if(!fmi2_import_check_has_FMU(fmu)) {
+    if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) {
         *startIndex = 0;
         return;
     }    
@@ -408,7 +547,7 @@ void fmi2_import_get_outputs_dependencies(fmi2_import_t* fmu,size_t** startIndex
 
 void fmi2_import_get_derivatives_dependencies(fmi2_import_t* fmu,size_t** startIndex, size_t** dependency, char** factorKind) { 
     fmi2_xml_model_structure_t* ms; 
-    if(!fmi2_import_check_has_FMU(fmu)) {
+    if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) {
         *startIndex = 0;
         return;
     }    
@@ -419,7 +558,7 @@ void fmi2_import_get_derivatives_dependencies(fmi2_import_t* fmu,size_t** startI
 
 void fmi2_import_get_discrete_states_dependencies(fmi2_import_t* fmu,size_t** startIndex, size_t** dependency, char** factorKind) { 
     fmi2_xml_model_structure_t* ms; 
-    if(!fmi2_import_check_has_FMU(fmu)) {
+    if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) {
         *startIndex = 0;
         return;
     }    
@@ -430,7 +569,7 @@ void fmi2_import_get_discrete_states_dependencies(fmi2_import_t* fmu,size_t** st
 
 void fmi2_import_get_initial_unknowns_dependencies(fmi2_import_t* fmu,size_t** startIndex, size_t** dependency, char** factorKind) { 
     fmi2_xml_model_structure_t* ms; 
-    if(!fmi2_import_check_has_FMU(fmu)) {
+    if(!fmi2_import_check_has_section(fmu, fmi_xml_section_model_structure, "Model structure data")) {
         *startIndex = 0;
         return;
     }    
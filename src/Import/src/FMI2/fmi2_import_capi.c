@@ -24,10 +24,70 @@ extern "C" {
 #include <FMI2/fmi2_enums.h>
 #include <FMI2/fmi2_capi.h>
 #include <FMI/fmi_util.h>
+#include <FMI/fmi_zip_unzip.h>
 #include "fmi2_import_impl.h"
 
 static const char * module = "FMILIB";
 
+/* Load the DLL functions into the C-API struct. The struct is destroyed on failure. */
+static jm_status_enu_t fmi2_import_load_capi_functions(fmi2_import_t* fmu) {
+	if (fmi2_capi_load_fcn(fmu -> capi, fmi2_xml_get_capabilities(fmu->md)) == jm_status_error) {
+		fmi2_capi_free_dll(fmu -> capi);			
+		fmi2_capi_destroy_dllfmu(fmu -> capi);
+		fmu -> capi = NULL;
+		return jm_status_error;
+	}
+	jm_log_verbose(fmu->callbacks, module, "Successfully loaded all the interface functions"); 
+
+	return jm_status_success;
+}
+
+/* The binary in the FMU archive, see fmi2_import_inflate_binary() */
+typedef struct fmi2_import_archive_binary_t {
+	fmi2_import_t* fmu;
+	const char* dllEntry;
+} fmi2_import_archive_binary_t;
+
+/* Inflate the binary straight into the memory it is loaded from */
+static jm_status_enu_t fmi2_import_inflate_binary(char* image, size_t size, void* data) {
+	fmi2_import_archive_binary_t* binary = (fmi2_import_archive_binary_t*)data;
+	return fmi_zip_unzip_to_buffer(binary->fmu->fmuPath, binary->dllEntry, image, size, binary->fmu->callbacks);
+}
+
+/* Inflate the binary from the FMU archive and load it from memory without unpacking it */
+static fmi2_capi_t* fmi2_import_create_capi_from_archive(fmi2_import_t* fmu, fmi2_fmu_kind_enu_t fmuKind, const char* modelIdentifier, const fmi2_callback_functions_t* callBackFunctions) {
+	jm_callbacks* cb = fmu->callbacks;
+	fmi2_capi_t* capi = NULL;
+	fmi2_import_archive_binary_t binary;
+	char* dllEntry;
+	size_t size;
+
+	/* Archive entries always use '/' as separator */
+	dllEntry = (char*)cb->malloc(strlen(FMI_BINARIES "/" FMI_PLATFORM "/") + strlen(modelIdentifier) + strlen(FMI_DLL_EXT) + 1);
+	if (!dllEntry) {
+		jm_log_fatal(cb, module, "Could not allocate memory");
+		return NULL;
+	}
+	sprintf(dllEntry, "%s%s%s", FMI_BINARIES "/" FMI_PLATFORM "/", modelIdentifier, FMI_DLL_EXT);
+
+	if (fmi_zip_get_file_size(fmu->fmuPath, dllEntry, &size, cb) == jm_status_success) {
+		binary.fmu = fmu;
+		binary.dllEntry = dllEntry;
+		capi = fmi2_capi_create_dllfmu(cb, dllEntry, modelIdentifier, callBackFunctions, fmuKind);
+		if (capi && (fmi2_capi_load_dll_from_memory(capi, size, fmi2_import_inflate_binary, &binary) != jm_status_success)) {
+			fmi2_capi_destroy_dllfmu(capi);
+			capi = NULL;
+		}
+	}
+	cb->free(dllEntry);
+
+	if (capi) {
+		jm_log_info(cb, module, 
+			"Loading '" FMI_PLATFORM "' binary with '%s' platform types", fmi2_get_types_platform() );
+	}
+	return capi;
+}
+
 /* Load and destroy functions */
 jm_status_enu_t fmi2_import_create_dllfmu(fmi2_import_t* fmu, fmi2_fmu_kind_enu_t fmuKind, const fmi2_callback_functions_t* callBackFunctions) {
 
@@ -65,6 +125,35 @@ jm_status_enu_t fmi2_import_create_dllfmu(fmi2_import_t* fmu, fmi2_fmu_kind_enu_
 		return jm_status_error;
 	}
 
+	if(!callBackFunctions) {
+		jm_callbacks* cb = fmu->callbacks;
+		defaultCallbacks.allocateMemory = cb->calloc;
+		defaultCallbacks.freeMemory = cb->free;
+		defaultCallbacks.componentEnvironment = fmu;
+		defaultCallbacks.logger = fmi2_log_forwarding;
+		defaultCallbacks.stepFinished = 0;
+		callBackFunctions = &defaultCallbacks;
+	}
+
+	if (fmu->loadBinaryFromMemory && fmu->fmuPath && !fmu->binariesUnpacked) {
+		fmu -> capi = fmi2_import_create_capi_from_archive(fmu, fmuKind, modelIdentifier, callBackFunctions);
+		if (fmu -> capi) {
+			if (fmi2_import_unpack_platform_files(fmu, 0) != jm_status_success) {
+				fmi2_capi_free_dll(fmu -> capi);
+				fmi2_capi_destroy_dllfmu(fmu -> capi);
+				fmu -> capi = NULL;
+				return jm_status_error;
+			}
+			return fmi2_import_load_capi_functions(fmu);
+		}
+		jm_log_verbose(fmu->callbacks, module, "Loading the binary from memory failed, unpacking it instead");
+	}
+
+	/* FMUs parsed directly from the archive are unpacked on first use */
+	if (fmi2_import_unpack_platform_files(fmu, 1) != jm_status_success) {
+		return jm_status_error;
+	}
+
 	if( jm_portability_get_current_working_directory(curDir, FILENAME_MAX+1) != jm_status_success) {
 		jm_log_warning(fmu->callbacks, module, "Could not get current working directory (%s)", strerror(errno));
 		curDir[0] = 0;
@@ -78,16 +167,6 @@ jm_status_enu_t fmi2_import_create_dllfmu(fmi2_import_t* fmu, fmi2_fmu_kind_enu_
 		return jm_status_error;
 	}
 
-	if(!callBackFunctions) {
-		jm_callbacks* cb = fmu->callbacks;
-		defaultCallbacks.allocateMemory = cb->calloc;
-		defaultCallbacks.freeMemory = cb->free;
-		defaultCallbacks.componentEnvironment = fmu;
-		defaultCallbacks.logger = fmi2_log_forwarding;
-		defaultCallbacks.stepFinished = 0;
-		callBackFunctions = &defaultCallbacks;
-	}
-
 	if(jm_portability_set_current_working_directory(dllDirPath) != jm_status_success) {
 		jm_log_fatal(fmu->callbacks, module, "Could not change to the DLL directory %s", dllDirPath);
 		if(ENOENT == errno)
@@ -123,17 +202,14 @@ jm_status_enu_t fmi2_import_create_dllfmu(fmi2_import_t* fmu, fmi2_fmu_kind_enu_
 		return jm_status_error;
 	}
 
+	return fmi2_import_load_capi_functions(fmu);
+}
 
-	/* Load the DLL functions */
-	if (fmi2_capi_load_fcn(fmu -> capi, fmi2_xml_get_capabilities(fmu->md)) == jm_status_error) {
-		fmi2_capi_free_dll(fmu -> capi);			
-		fmi2_capi_destroy_dllfmu(fmu -> capi);
-		fmu -> capi = NULL;
-		return jm_status_error;
+void fmi2_import_set_load_binary_from_memory(fmi2_import_t* fmu, int enable) {
+	if (fmu == NULL) {
+		return;
 	}
-	jm_log_verbose(fmu->callbacks, module, "Successfully loaded all the interface functions"); 
-
-	return jm_status_success;
+	fmu->loadBinaryFromMemory = enable;
 }
 
 void fmi2_import_set_debug_mode(fmi2_import_t* fmu, int mode) {
@@ -36,6 +36,10 @@ extern "C" {
 struct fmi2_import_t {	
 	char* dirPath;
 	char* resourceLocation;
+	char* fmuPath; /* FMU archive given to fmi2_import_parse_xml_from_archive() */
+	int removeDirOnFree; /* dirPath is a temporary directory created by the library */
+	int binariesUnpacked; /* the platform binaries have been unpacked into the temporary directory */
+	int loadBinaryFromMemory; /* see fmi2_import_set_load_binary_from_memory() */
 	jm_callbacks* callbacks;
 	fmi2_xml_model_description_t* md;
 	fmi2_capi_t* capi;
@@ -43,6 +47,20 @@ struct fmi2_import_t {
 	jm_vector(char) logMessageBufferExpanded;
 };
 
+/* Unpack the resources and optionally the binaries of an FMU parsed from archive into a temporary directory.
+   Without binaries the directory is only created if the FMU has resources. */
+jm_status_enu_t fmi2_import_unpack_platform_files(fmi2_import_t* fmu, int withBinaries);
+
+/* Apply the parse options and the variable handle of the context to fmu->md */
+void fmi2_import_apply_parse_options(fmi_import_context_t* context, fmi2_import_t* fmu);
+
+/* Parse the model description XML into fmu->md. With a model description cache in the context the model
+   is loaded from its cached image if there is one and an image is saved after parsing otherwise. */
+int fmi2_import_parse_model_description_cached(fmi_import_context_t* context, fmi2_import_t* fmu, const char* xmlPath, fmi2_xml_callbacks_t* xml_callbacks);
+
+/* Check that a section of the model description was parsed and report an error otherwise */
+int fmi2_import_check_has_section(fmi2_import_t* fmu, fmi_xml_section_enu_t section, const char* sectionName);
+
 #ifdef __cplusplus
 }
 #endif
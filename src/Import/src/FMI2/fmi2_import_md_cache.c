@@ -0,0 +1,157 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <fmilib_config.h>
+#include <JM/jm_portability.h>
+
+#include "fmi2_import_impl.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#define fmi2_import_md_cache_getpid() ((unsigned long)GetCurrentProcessId())
+#else
+#include <sys/types.h>
+#include <unistd.h>
+#define fmi2_import_md_cache_getpid() ((unsigned long)getpid())
+#endif
+
+static const char* module = "FMILIB";
+
+/*
+	Layout of the model description cache directory:
+	<guid>.fmi2md                    - image of the last model description seen with the GUID
+	<guid>.fmi2md.staging.<pid>.<id> - image being written, renamed when complete
+	The GUID is reduced to letters, digits and '-' in the file names.
+	The key of an image is the GUID followed by the size and modification time of the XML file,
+	so a cached load only needs to stat the file and read the start of it.
+*/
+#define FMI2_IMPORT_MD_CACHE_SUFFIX ".fmi2md"
+
+/* The GUID is an attribute of the root element and expected in this many bytes of the file */
+#define FMI2_IMPORT_MD_CACHE_GUID_SCAN 4096
+/* Longest GUID that is cached, leaves room for the size and time in the key */
+#define FMI2_IMPORT_MD_CACHE_GUID_MAX 80
+
+/* Find the guid attribute of the root element at the start of the file. Returns 0 if it is not there. */
+static int fmi2_import_md_cache_read_guid(const char* xmlPath, char* guid) {
+	char buf[FMI2_IMPORT_MD_CACHE_GUID_SCAN + 1];
+	FILE* file = fopen(xmlPath, "rb");
+	const char *p, *end;
+	size_t n;
+
+	if(!file) return 0;
+	n = fread(buf, 1, FMI2_IMPORT_MD_CACHE_GUID_SCAN, file);
+	fclose(file);
+	buf[n] = 0;
+
+	p = strstr(buf, "<fmiModelDescription");
+	if(!p) return 0;
+	for(p += sizeof("<fmiModelDescription") - 1; *p && (*p != '>'); p++) {
+		char quote;
+		/* the attribute name must stand on its own */
+		if(strncmp(p, "guid", 4) || !strchr(" \t\r\n", p[-1])) continue;
+		p += 4;
+		while(*p && strchr(" \t\r\n", *p)) p++;
+		if(*p++ != '=') return 0;
+		while(*p && strchr(" \t\r\n", *p)) p++;
+		quote = *p++;
+		if((quote != '"') && (quote != '\'')) return 0;
+		end = strchr(p, quote);
+		if(!end || (end == p) || (end - p > FMI2_IMPORT_MD_CACHE_GUID_MAX)) return 0;
+		memcpy(guid, p, end - p);
+		guid[end - p] = 0;
+		return 1;
+	}
+	return 0;
+}
+
+static void fmi2_import_md_cache_save(fmi2_import_t* fmu, const char* imagePath, const char* key) {
+	jm_callbacks* cb = fmu->callbacks;
+	size_t len = strlen(imagePath) + 64;
+	char* stagingPath = (char*)cb->malloc(len);
+
+	if(!stagingPath) return;
+	jm_snprintf(stagingPath, len, "%s.staging.%lu.%lx", imagePath, fmi2_import_md_cache_getpid(), (unsigned long)(size_t)fmu);
+	/* other processes only ever see complete images */
+	if(fmi2_xml_write_model_description_image(fmu->md, stagingPath, key) == 0) {
+		if(rename(stagingPath, imagePath)) {
+			/* another process may have published the same image in the meantime */
+			remove(stagingPath);
+		}
+	}
+	else {
+		jm_log_warning(cb, module, "Could not save the model description in the cache");
+	}
+	cb->free(stagingPath);
+}
+
+int fmi2_import_parse_model_description_cached(fmi_import_context_t* context, fmi2_import_t* fmu, const char* xmlPath, fmi2_xml_callbacks_t* xml_callbacks) {
+	jm_callbacks* cb = fmu->callbacks;
+	char guid[FMI2_IMPORT_MD_CACHE_GUID_MAX + 1];
+	char name[FMI2_IMPORT_MD_CACHE_GUID_MAX + 1];
+	char key[FMI2_XML_IMAGE_KEY_SIZE];
+	char* imagePath;
+	struct stat st;
+	size_t i, len;
+	int ret;
+
+	/* annotations are not part of the images, so they can only be reported while parsing,
+	   and images always hold complete model descriptions */
+	if(!context->modelDescriptionCacheDir || xml_callbacks || context->parseOptions.skipSections || context->fmi2VariableHandle ||
+		stat(xmlPath, &st) || !fmi2_import_md_cache_read_guid(xmlPath, guid))
+		return fmi2_xml_parse_model_description(fmu->md, xmlPath, xml_callbacks);
+
+	len = strlen(context->modelDescriptionCacheDir) + strlen(guid) + sizeof(FMI_FILE_SEP FMI2_IMPORT_MD_CACHE_SUFFIX);
+	imagePath = (char*)cb->malloc(len);
+	if(!imagePath) {
+		jm_log_fatal(cb, module, "Could not allocate memory");
+		return -1;
+	}
+	for(i = 0; guid[i]; i++) {
+		char c = guid[i];
+		name[i] = (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '-')) ? c : '_';
+	}
+	name[i] = 0;
+	jm_snprintf(imagePath, len, "%s" FMI_FILE_SEP "%s" FMI2_IMPORT_MD_CACHE_SUFFIX, context->modelDescriptionCacheDir, name);
+	jm_snprintf(key, sizeof(key), "%s-%lu-%lx", guid, (unsigned long)st.st_size, (unsigned long)st.st_mtime);
+
+	ret = fmi2_xml_load_model_description_image(fmu->md, imagePath, key);
+	if(ret == 0) {
+		cb->free(imagePath);
+		return 0;
+	}
+	if(ret < 0) {
+		/* start over with an empty model description */
+		fmi2_xml_free_model_description(fmu->md);
+		fmu->md = fmi2_xml_allocate_model_description(cb);
+		if(!fmu->md) {
+			cb->free(imagePath);
+			return -1;
+		}
+		fmi2_import_apply_parse_options(context, fmu);
+	}
+
+	ret = fmi2_xml_parse_model_description(fmu->md, xmlPath, 0);
+	/* the GUID found by the scan must be the one that was parsed */
+	if((ret == 0) && !strcmp(fmi2_xml_get_GUID(fmu->md), guid)) fmi2_import_md_cache_save(fmu, imagePath, key);
+	cb->free(imagePath);
+	return ret;
+}
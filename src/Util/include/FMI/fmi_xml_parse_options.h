@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef FMI_XML_PARSE_OPTIONS_H
+#define FMI_XML_PARSE_OPTIONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	@file fmi_xml_parse_options.h
+	\brief Options that control which parts of a model description are parsed and how.
+
+	*/
+/** \addtogroup jm_utils
+  * @{
+*/
+
+/** \brief Sections of a model description that can be left out when parsing.
+
+	The values are bit flags that are combined into the fmi_xml_parse_options_t::skipSections mask
+	and into the masks returned by fmi1_import_get_parsed_sections() and fmi2_import_get_parsed_sections().
+*/
+typedef enum fmi_xml_section_enu_t {
+	/** \brief The description attributes of the model, variables, types, items, units and log categories */
+	fmi_xml_section_descriptions = 1,
+	/** \brief VendorAnnotations and, for FMI 2.0, the Annotations of variables */
+	fmi_xml_section_annotations = 2,
+	/** \brief ModelStructure for FMI 2.0, the DirectDependency of variables for FMI 1.0 */
+	fmi_xml_section_model_structure = 4,
+	/** \brief UnitDefinitions together with the unit and displayUnit attributes that refer to them */
+	fmi_xml_section_units = 8,
+	/** \brief All the sections above */
+	fmi_xml_section_all = 15
+} fmi_xml_section_enu_t;
+
+/** \brief Options for parsing model descriptions */
+typedef struct fmi_xml_parse_options_t {
+	/** \brief Sections that are not parsed, a combination of ::fmi_xml_section_enu_t flags. 0 parses everything. */
+	unsigned int skipSections;
+	/** \brief Number of threads used for sorting the variables after they are parsed. 0 and 1 sort on the calling thread.
+
+		The variables end up in the same order for any number of threads. */
+	unsigned int numThreads;
+} fmi_xml_parse_options_t;
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* FMI_XML_PARSE_OPTIONS_H */
+#endif
@@ -17,6 +17,8 @@
 #define FMI2_XML_CALLBACKS_H
 
 #include <fmilib_config.h>
+#include <FMI2/fmi2_types.h>
+#include <FMI2/fmi2_enums.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +72,47 @@ struct fmi2_xml_callbacks_t {
 	fmi2_xml_element_end_handle_ft   endHandle;   /** \brief Handle end of an XML element within tool annotation in a SAX parser. */
 	void* context;	/** \breif Context ponter is forwarded to the handle functions. */
 };
+
+/** \brief Value of a start, min or max attribute. The member is given by the base type of the variable. */
+typedef union fmi2_xml_variable_value_t {
+	fmi2_real_t real;     /** \brief Real variables */
+	fmi2_integer_t integer; /** \brief Integer and Enumeration variables */
+	fmi2_boolean_t boolean; /** \brief Boolean variables */
+	fmi2_string_t string; /** \brief String variables */
+} fmi2_xml_variable_value_t;
+
+/** \brief Decoded ScalarVariable as passed to ::fmi2_xml_variable_handle_ft.
+
+	The strings are only valid during the call of the handle.
+*/
+typedef struct fmi2_xml_variable_record_t {
+	const char* name;        /** \brief Variable name */
+	const char* description; /** \brief Description or NULL if not given */
+	fmi2_value_reference_t vr; /** \brief Value reference */
+	size_t index;            /** \brief One based index in ModelVariables as used by the derivative and previous attributes */
+	fmi2_base_type_enu_t baseType;
+	fmi2_causality_enu_t causality;
+	fmi2_variability_enu_t variability;
+	fmi2_initial_enu_t initial;
+	const char* declaredType; /** \brief Name of the declared type or NULL */
+	const char* unit;        /** \brief Unit of Real variables or NULL */
+	int hasStart;            /** \brief Non-zero if the start value is given */
+	fmi2_xml_variable_value_t start; /** \brief Start value if given */
+	fmi2_xml_variable_value_t min; /** \brief Minimum value of Real, Integer and Enumeration variables */
+	fmi2_xml_variable_value_t max; /** \brief Maximum value of Real, Integer and Enumeration variables */
+	size_t derivativeOf;     /** \brief Index of the variable this one is the derivative of or 0 */
+	size_t previous;         /** \brief Index given by the previous attribute or 0 */
+} fmi2_xml_variable_record_t;
+
+/** \brief Handle a ScalarVariable when the model variables are streamed.
+
+	The handle is called as each ScalarVariable element ends, with all attributes decoded and the
+	declared type applied. Nothing is kept of the variable after the call.
+	@param context as specified when setting up the handle,
+	@param variable - the decoded variable.
+	The function should return 0 on success or error code on exit (in which case parsing will be aborted).
+*/
+typedef int (*fmi2_xml_variable_handle_ft)(void* context, const fmi2_xml_variable_record_t* variable);
 /* @}
 */
 
@@ -0,0 +1,96 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_ARENA_H
+#define JM_ARENA_H
+
+#include <stddef.h>
+#include "jm_callbacks.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_arena.h Definition of ::jm_arena_t and supporting functions
+	*
+	* \addtogroup jm_utils
+	* @{
+		\addtogroup jm_arena
+	* @}
+*/
+/** \addtogroup jm_arena Arena allocator
+ @{
+*/
+
+/** \brief Default size of the blocks requested from the callbacks */
+#define JM_ARENA_DEFAULT_BLOCK_SIZE 16384
+
+/** \brief A block of memory owned by an arena */
+typedef struct jm_arena_block_t jm_arena_block_t;
+
+/**
+ \brief Arena allocator.
+
+ Memory is handed out from large blocks allocated with the callbacks and is only released all at once
+ with jm_arena_free_data(). Allocations never move, so pointers into the arena stay valid until then.
+ The structure is intended to be embedded into other structures and initialized with jm_arena_init().
+*/
+typedef struct jm_arena_t {
+    jm_callbacks* callbacks; /** \brief Callbacks used to allocate the blocks */
+    jm_arena_block_t* blocks; /** \brief List of blocks, the current one first */
+    char* next; /** \brief Free memory in the current block */
+    size_t left; /** \brief Number of free bytes in the current block */
+    size_t block_size; /** \brief Size of the blocks */
+} jm_arena_t;
+
+/**
+ \brief Initialize an arena. No memory is allocated until the first allocation.
+ \param a The arena.
+ \param block_size Size of the blocks to allocate. Zero means #JM_ARENA_DEFAULT_BLOCK_SIZE.
+ \param c Callbacks for memory allocation. Default callbacks are used if NULL.
+*/
+void jm_arena_init(jm_arena_t* a, size_t block_size, jm_callbacks* c);
+
+/**
+ \brief Allocate memory suitably aligned for any type.
+ \return Pointer to the memory or NULL if out of memory.
+*/
+void* jm_arena_alloc(jm_arena_t* a, size_t size);
+
+/**
+ \brief Copy a string into the arena.
+ \param a The arena.
+ \param str The string to copy. Only the first len characters are copied.
+ \param len Length of the string not including the terminating zero.
+ \return Pointer to the zero terminated copy or NULL if out of memory.
+*/
+char* jm_arena_strndup(jm_arena_t* a, const char* str, size_t len);
+
+/** \brief Release all the memory allocated in the arena. The arena can be used again afterwards. */
+void jm_arena_free_data(jm_arena_t* a);
+
+/**
+ \brief Release all the memory allocated in the arena but keep the current block for reuse.
+
+ Intended for arenas that hold short lived data which is dropped over and over again.
+*/
+void jm_arena_clear(jm_arena_t* a);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_ARENA_H */
+#endif
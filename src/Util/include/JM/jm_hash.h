@@ -0,0 +1,49 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_HASH_H
+#define JM_HASH_H
+
+#include <stddef.h>
+#include "jm_types.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_hash.h Hashing of strings for the hash tables of the library
+	*
+	* \addtogroup jm_utils
+	* @{
+*/
+
+/** \brief Default seed of jm_hash_string(), the FNV-1a offset basis */
+#define JM_HASH_SEED 2166136261U
+
+/**
+ \brief Compute the 32 bit FNV-1a hash of a string.
+ \param str A zero terminated string.
+ \param seed Offset basis, ::JM_HASH_SEED or another value to get a different hash function.
+ \param len If not NULL, receives the length of the string.
+ \return The hash value.
+*/
+unsigned int jm_hash_string(jm_string str, unsigned int seed, size_t* len);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_HASH_H */
+#endif
@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_NAMED_INDEX_H
+#define JM_NAMED_INDEX_H
+
+#include "jm_types.h"
+#include "jm_callbacks.h"
+#include "jm_named_ptr.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_named_index.h Definition of ::jm_named_index_t and supporting functions
+	*
+	* \addtogroup jm_utils
+	* @{
+		\addtogroup jm_named_index
+	* @}
+*/
+/** \addtogroup jm_named_index Hash index of named objects
+ @{
+*/
+
+/** \brief Slot of the hash table */
+typedef struct jm_named_index_slot_t {
+    jm_named_ptr item; /** \brief Indexed object, the name is NULL for an empty slot */
+    unsigned int hash; /** \brief Hash value of the name */
+} jm_named_index_slot_t;
+
+/**
+ \brief Lookup of named objects by name in constant time on average.
+
+ The index is built once from a vector of named objects, which is usually kept sorted by name for
+ ordered iteration. Lookup uses a hash table with open addressing (linear probing). The names are
+ not copied and must stay valid as long as the index is used.
+*/
+typedef struct jm_named_index_t {
+    jm_callbacks* callbacks; /** \brief Callbacks used for memory allocation */
+    jm_named_index_slot_t* slots; /** \brief Hash table, the size is a power of two */
+    size_t capacity; /** \brief Number of slots */
+} jm_named_index_t;
+
+/**
+ \brief Initialize an empty index. No memory is allocated.
+ \param x The index.
+ \param c Callbacks for memory allocation. Default callbacks are used if NULL.
+*/
+void jm_named_index_init(jm_named_index_t* x, jm_callbacks* c);
+
+/**
+ \brief Index the objects in a vector, replacing the previous contents of the index.
+
+ If several objects have the same name, the first one in the vector is found.
+ \param x The index.
+ \param items Objects to index.
+ \return jm_status_success or jm_status_error if out of memory, in which case the index is empty.
+*/
+jm_status_enu_t jm_named_index_build(jm_named_index_t* x, jm_vector(jm_named_ptr)* items);
+
+/**
+ \brief Find an object by name.
+ \return The object or NULL if there is no object with this name.
+*/
+jm_voidp jm_named_index_find(jm_named_index_t* x, jm_string name);
+
+/** \brief Release the hash table. The index is empty afterwards and can be built again. */
+void jm_named_index_free_data(jm_named_index_t* x);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_NAMED_INDEX_H */
+#endif
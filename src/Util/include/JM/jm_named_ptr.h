@@ -18,6 +18,7 @@
 
 #include "jm_vector.h"
 #include "jm_callbacks.h"
+#include "jm_arena.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -62,6 +63,16 @@ jm_named_ptr jm_named_alloc(jm_string name, size_t size, size_t nameoffset, jm_c
 /** \brief Same as jm_named_alloc() but name is given as a jm_vector(char) pointer */
 jm_named_ptr jm_named_alloc_v(jm_vector(char)* name, size_t size, size_t nameoffset, jm_callbacks* c);
 
+/**
+\brief Same as jm_named_alloc() but the memory is taken from an arena.
+
+The object is released together with the arena and must not be passed to jm_named_free().
+*/
+jm_named_ptr jm_named_alloc_arena(jm_string name, size_t size, size_t nameoffset, jm_arena_t* a);
+
+/** \brief Same as jm_named_alloc_arena() but name is given as a jm_vector(char) pointer */
+jm_named_ptr jm_named_alloc_v_arena(jm_vector(char)* name, size_t size, size_t nameoffset, jm_arena_t* a);
+
 /** \brief Free the memory allocated for the object pointed by jm_named_ptr */
 static void jm_named_free(jm_named_ptr np, jm_callbacks* c) { c->free(np.ptr); }
 
@@ -72,6 +83,17 @@ jm_vector_declare_template(jm_named_ptr)
 
 jm_define_comp_f(jm_compare_named, jm_named_ptr, jm_diff_named)
 
+/** \brief Sort a vector by the names of the objects.
+
+  Gives the same order as jm_vector_qsort() with jm_compare_named() but compares the names without function pointer calls.
+*/
+void jm_named_vector_sort(jm_vector(jm_named_ptr)* v);
+
+/** \brief Find an object by name in a vector sorted with jm_named_vector_sort().
+  \return Pointer to the first item with the given name or NULL if not found.
+*/
+jm_named_ptr* jm_named_vector_search(jm_vector(jm_named_ptr)* v, jm_string name);
+
 /** \brief Release the data allocated by the items
   in a vector and then clears the memory used by the vector as well.
 
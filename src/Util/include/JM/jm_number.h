@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_NUMBER_H
+#define JM_NUMBER_H
+
+#include <fmilib_config.h>
+#include "jm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_number.h Conversion of strings to numbers
+	*
+	* \addtogroup jm_utils
+	* @{
+		\addtogroup jm_number
+	* @}
+*/
+/** \addtogroup jm_number Number parsing
+ @{
+ The functions parse numbers as written in XML documents and do not depend on the current locale.
+ Leading and trailing white space is allowed, any other character after the number is an error.
+*/
+
+/**
+ \brief Parse an unsigned decimal integer. An optional '+' sign is accepted.
+ \param str The string to parse.
+ \param val Output value, only set on success.
+ \return jm_status_error if the string is not a number or the value does not fit into an unsigned int.
+*/
+FMILIB_EXPORT
+jm_status_enu_t jm_parse_uint(const char* str, unsigned int* val);
+
+/**
+ \brief Parse a signed decimal integer.
+ \param str The string to parse.
+ \param val Output value, only set on success.
+ \return jm_status_error if the string is not a number or the value does not fit into an int.
+*/
+FMILIB_EXPORT
+jm_status_enu_t jm_parse_int(const char* str, int* val);
+
+/**
+ \brief Parse a floating point number.
+
+ The accepted syntax is the one of xs:double: an optional sign, digits with an optional decimal point
+ and an optional exponent, as well as INF and NaN (case is ignored).
+ Numbers with at most 15 significant digits and a moderate exponent are converted with a single
+ correctly rounded floating point operation. When the build has 64-bit integers, numbers with up to
+ 19 significant digits and any exponent in the normal double range are converted with the Eisel-Lemire
+ algorithm. The remaining numbers (subnormal results, exact halfway cases and the rare cases
+ that need more than 64 bits of the power of ten) are passed to strtod() after the decimal point is
+ translated for the current locale, so the result is as accurate as the C library.
+ \param str The string to parse.
+ \param val Output value, only set on success. Values out of range give +/-HUGE_VAL or zero.
+ \return jm_status_error if the string is not a number.
+*/
+FMILIB_EXPORT
+jm_status_enu_t jm_parse_double(const char* str, double* val);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_NUMBER_H */
+#endif
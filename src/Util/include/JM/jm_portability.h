@@ -42,6 +42,35 @@
 /** \brief Load a dll/so library into the process and return a handle. */
 DLL_HANDLE		jm_portability_load_dll_handle		(const char* dll_file_path);
 
+/**
+	\brief Write the contents of a shared library file, see jm_portability_load_dll_handle_from_memory().
+	\param image Memory to write the size bytes of the file into.
+	\param size Size of the file.
+	\param data The data given to jm_portability_load_dll_handle_from_memory().
+	\return Error status. The library is not loaded if the status is not jm_status_success.
+*/
+typedef jm_status_enu_t (*jm_dll_image_fill_ft)(char* image, size_t size, void* data);
+
+/**
+	\brief Load a shared library from memory without writing it to the file system.
+
+	An anonymous memory file (memfd_create, Linux only) of the given size is mapped and filled by the
+	callback, and the library is loaded from there. No other copy of the library is made.
+	Libraries loaded this way cannot find dependencies relative to their own location.
+	\param name Name used for the memory file, shown in /proc/self/maps.
+	\param size Size of the shared library file.
+	\param fill Function writing the shared library file.
+	\param data Passed to the fill function.
+	\param memory_file Receives the memory file the library was loaded from, or -1. It identifies the
+	library to the loader and must be closed with jm_portability_close_memory_file() after the
+	library is freed.
+	\return A handle to the library or NULL if loading failed or is not supported on this platform.
+*/
+DLL_HANDLE		jm_portability_load_dll_handle_from_memory(const char* name, size_t size, jm_dll_image_fill_ft fill, void* data, int* memory_file);
+
+/** \brief Close a memory file returned by jm_portability_load_dll_handle_from_memory(). Does nothing for -1. */
+void			jm_portability_close_memory_file(int memory_file);
+
 /** \brief Unload a Dll and release the handle*/
 jm_status_enu_t jm_portability_free_dll_handle		(DLL_HANDLE dll_handle);
 
@@ -116,6 +145,58 @@ jm_status_enu_t jm_mkdir(jm_callbacks* cb, const char* dir);
 */
 jm_status_enu_t jm_rmdir(jm_callbacks* cb, const char* dir);
 
+/**
+	\brief Remove directory and all it contents in a background thread.
+
+	The directories are removed one by one by a single cleanup thread that is started when needed.
+	Errors are reported to the default logger since the callbacks given may not be valid any more.
+	\param cb - callbacks for logging. Default callbacks are used if this parameter is NULL.
+	\param dir - path to be removed.
+	\return Status success or error.
+*/
+jm_status_enu_t jm_rmdir_async(jm_callbacks* cb, const char* dir);
+
+/** \brief Wait until all the directories passed to jm_rmdir_async() have been removed. */
+void jm_rmdir_async_wait(void);
+
+/** \brief Function executed in a thread started with jm_thread_create() */
+typedef void (*jm_thread_func_ft)(void* data);
+
+/** \brief Opaque thread handle */
+typedef struct jm_thread_t jm_thread_t;
+
+/** \brief Opaque mutex */
+typedef struct jm_mutex_t jm_mutex_t;
+
+/**
+	\brief Start a new thread running func(data).
+	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
+	\return Thread handle that must be released with jm_thread_join(), NULL on error.
+*/
+jm_thread_t* jm_thread_create(jm_callbacks* cb, jm_thread_func_ft func, void* data);
+
+/** \brief Wait for the thread to finish and release the handle */
+jm_status_enu_t jm_thread_join(jm_thread_t* thread);
+
+/**
+	\brief Create a (non-recursive) mutex.
+	\param cb - callbacks for memory allocation and logging. Default callbacks are used if this parameter is NULL.
+	\return A new mutex or NULL on error.
+*/
+jm_mutex_t* jm_mutex_create(jm_callbacks* cb);
+
+/** \brief Lock a mutex */
+void jm_mutex_lock(jm_mutex_t* mutex);
+
+/** \brief Unlock a mutex */
+void jm_mutex_unlock(jm_mutex_t* mutex);
+
+/** \brief Release a mutex created with jm_mutex_create() */
+void jm_mutex_free(jm_mutex_t* mutex);
+
+/** \brief Get the number of processors available in the system (at least 1) */
+unsigned int jm_get_number_of_processors(void);
+
 /**
 \brief C89 compatible implementation of C99 vsnprintf. 
 */
@@ -0,0 +1,202 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/**
+* \file jm_sort_template.h
+* \brief Sorting and binary search template for vectors with an inlined comparison.
+*
+* This file is supposed to be included into a C-file that needs to sort or search a vector in a specific order.
+* jm_vector.h must be included before this file and the vector template for the item type must be declared.
+* The following macros must be defined before including the file, they are undefined at the end of it:
+*  - JM_SORT_TEMPLATE_TYPE - the item type;
+*  - JM_SORT_TEMPLATE_NAME - the name of the order, used to construct the function names;
+*  - JM_SORT_TEMPLATE_LESS(a, b) - an expression that is non-zero if the item pointed by "a" is ordered before the one pointed by "b".
+*
+* Unlike jm_vector_qsort() and jm_vector_bsearch() the comparison is expanded inside the generated
+* functions instead of being called through a function pointer. The generated functions are static:
+*
+*  void jm_vector_sort(NAME)(jm_vector(T)* v) sorts the vector with introsort, the sort is not stable;
+*
+*  size_t jm_vector_lower_bound(NAME)(jm_vector(T)* v, const T* key) returns the index of the first item
+*  in a sorted vector that is not ordered before the key, or the vector size if there is no such item;
+*
+*  T* jm_vector_search(NAME)(jm_vector(T)* v, const T* key) returns a pointer to the first item equal
+*  to the key in a sorted vector, or NULL if not found;
+*
+*  void jm_sort_array(NAME)(void* items, void* scratch, size_t n, void* context) and
+*  void jm_sort_merge(NAME)(const void* a, size_t na, const void* b, size_t nb, void* out, void* context)
+*  sort an array and merge two sorted arrays. They can be used as the jm_parallel_sort_t callbacks of
+*  jm_thread_pool_sort(), the scratch area and the context are not used. The merge is stable.
+*/
+
+#include "jm_vector.h"
+
+/** \addtogroup jm_vector  A vector of items (dynamic array)*/
+/** @{
+*/
+
+#ifndef JM_SORT_TEMPLATE_TYPE
+#error "JM_SORT_TEMPLATE_TYPE must be defined before including this file"
+#endif
+#ifndef JM_SORT_TEMPLATE_NAME
+#error "JM_SORT_TEMPLATE_NAME must be defined before including this file"
+#endif
+#ifndef JM_SORT_TEMPLATE_LESS
+#error "JM_SORT_TEMPLATE_LESS must be defined before including this file"
+#endif
+
+#ifndef jm_vector_sort
+#define jm_vector_sort(NAME) jm_mangle(jm_vector_sort, NAME)
+#define jm_vector_lower_bound(NAME) jm_mangle(jm_vector_lower_bound, NAME)
+#define jm_vector_search(NAME) jm_mangle(jm_vector_search, NAME)
+
+#define jm_sort_insertion(NAME) jm_mangle(jm_sort_insertion, NAME)
+#define jm_sort_sift_down(NAME) jm_mangle(jm_sort_sift_down, NAME)
+#define jm_sort_heap(NAME) jm_mangle(jm_sort_heap, NAME)
+#define jm_sort_intro(NAME) jm_mangle(jm_sort_intro, NAME)
+#define jm_sort_array(NAME) jm_mangle(jm_sort_array, NAME)
+#define jm_sort_merge(NAME) jm_mangle(jm_sort_merge, NAME)
+
+/** Partitions up to this size are finished with insertion sort */
+#define JM_SORT_INSERTION_THRESHOLD 16
+#endif
+
+#define JM_SORT_SWAP(a, b) { JM_SORT_TEMPLATE_TYPE tmp = (a); (a) = (b); (b) = tmp; }
+
+static void jm_sort_insertion(JM_SORT_TEMPLATE_NAME)(JM_SORT_TEMPLATE_TYPE* items, size_t n) {
+    size_t i, j;
+    for(i = 1; i < n; i++) {
+        JM_SORT_TEMPLATE_TYPE item = items[i];
+        for(j = i; (j > 0) && JM_SORT_TEMPLATE_LESS(&item, &items[j - 1]); j--)
+            items[j] = items[j - 1];
+        items[j] = item;
+    }
+}
+
+static void jm_sort_sift_down(JM_SORT_TEMPLATE_NAME)(JM_SORT_TEMPLATE_TYPE* items, size_t root, size_t n) {
+    JM_SORT_TEMPLATE_TYPE item = items[root];
+    size_t child;
+    while((child = 2 * root + 1) < n) {
+        if((child + 1 < n) && JM_SORT_TEMPLATE_LESS(&items[child], &items[child + 1])) child++;
+        if(!JM_SORT_TEMPLATE_LESS(&item, &items[child])) break;
+        items[root] = items[child];
+        root = child;
+    }
+    items[root] = item;
+}
+
+/* Fallback that keeps the worst case at O(n log n) */
+static void jm_sort_heap(JM_SORT_TEMPLATE_NAME)(JM_SORT_TEMPLATE_TYPE* items, size_t n) {
+    size_t i;
+    for(i = n / 2; i-- > 0;)
+        jm_sort_sift_down(JM_SORT_TEMPLATE_NAME)(items, i, n);
+    for(i = n; i-- > 1;) {
+        JM_SORT_SWAP(items[0], items[i]);
+        jm_sort_sift_down(JM_SORT_TEMPLATE_NAME)(items, 0, i);
+    }
+}
+
+static void jm_sort_intro(JM_SORT_TEMPLATE_NAME)(JM_SORT_TEMPLATE_TYPE* items, size_t n, size_t depth) {
+    while(n > JM_SORT_INSERTION_THRESHOLD) {
+        JM_SORT_TEMPLATE_TYPE pivot;
+        size_t i = 0, j = n - 1, mid = n / 2;
+
+        if(depth-- == 0) {
+            jm_sort_heap(JM_SORT_TEMPLATE_NAME)(items, n);
+            return;
+        }
+        /* median of three, the first and last items then stop the scans below */
+        if(JM_SORT_TEMPLATE_LESS(&items[mid], &items[0])) JM_SORT_SWAP(items[mid], items[0]);
+        if(JM_SORT_TEMPLATE_LESS(&items[j], &items[mid])) {
+            JM_SORT_SWAP(items[j], items[mid]);
+            if(JM_SORT_TEMPLATE_LESS(&items[mid], &items[0])) JM_SORT_SWAP(items[mid], items[0]);
+        }
+        pivot = items[mid];
+
+        /* Hoare partitioning: [0, j] is not after the pivot and [j + 1, n) is not before it */
+        for(;;) {
+            while(JM_SORT_TEMPLATE_LESS(&items[i], &pivot)) i++;
+            while(JM_SORT_TEMPLATE_LESS(&pivot, &items[j])) j--;
+            if(i >= j) break;
+            JM_SORT_SWAP(items[i], items[j]);
+            i++;
+            j--;
+        }
+        j++;
+
+        /* recurse into the smaller part to bound the stack depth */
+        if(j < n - j) {
+            jm_sort_intro(JM_SORT_TEMPLATE_NAME)(items, j, depth);
+            items += j;
+            n -= j;
+        }
+        else {
+            jm_sort_intro(JM_SORT_TEMPLATE_NAME)(items + j, n - j, depth);
+            n = j;
+        }
+    }
+    jm_sort_insertion(JM_SORT_TEMPLATE_NAME)(items, n);
+}
+
+static void jm_sort_array(JM_SORT_TEMPLATE_NAME)(void* items, void* scratch, size_t n, void* context) {
+    size_t depth = 0, k;
+    for(k = n; k > 1; k /= 2) depth += 2;
+    jm_sort_intro(JM_SORT_TEMPLATE_NAME)((JM_SORT_TEMPLATE_TYPE*)items, n, depth);
+}
+
+static void jm_sort_merge(JM_SORT_TEMPLATE_NAME)(const void* a, size_t na, const void* b, size_t nb, void* out, void* context) {
+    const JM_SORT_TEMPLATE_TYPE* x = (const JM_SORT_TEMPLATE_TYPE*)a;
+    const JM_SORT_TEMPLATE_TYPE* xEnd = x + na;
+    const JM_SORT_TEMPLATE_TYPE* y = (const JM_SORT_TEMPLATE_TYPE*)b;
+    const JM_SORT_TEMPLATE_TYPE* yEnd = y + nb;
+    JM_SORT_TEMPLATE_TYPE* o = (JM_SORT_TEMPLATE_TYPE*)out;
+    /* an item of b is taken only when it is ordered before the item of a */
+    while((x < xEnd) && (y < yEnd))
+        *o++ = JM_SORT_TEMPLATE_LESS(y, x) ? *y++ : *x++;
+    while(x < xEnd) *o++ = *x++;
+    while(y < yEnd) *o++ = *y++;
+}
+
+static void jm_vector_sort(JM_SORT_TEMPLATE_NAME)(jm_vector(JM_SORT_TEMPLATE_TYPE)* v) {
+    jm_sort_array(JM_SORT_TEMPLATE_NAME)(v->items, 0, jm_vector_get_size(JM_SORT_TEMPLATE_TYPE)(v), 0);
+}
+
+static size_t jm_vector_lower_bound(JM_SORT_TEMPLATE_NAME)(jm_vector(JM_SORT_TEMPLATE_TYPE)* v, const JM_SORT_TEMPLATE_TYPE* key) {
+    JM_SORT_TEMPLATE_TYPE* base = v->items;
+    size_t n = jm_vector_get_size(JM_SORT_TEMPLATE_TYPE)(v);
+    if(!n) return 0;
+    /* the loop runs log2(n) times and the selection is done with a conditional move rather than a branch */
+    while(n > 1) {
+        size_t half = n / 2;
+        base = JM_SORT_TEMPLATE_LESS(&base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return (size_t)(base - v->items) + (JM_SORT_TEMPLATE_LESS(base, key) ? 1 : 0);
+}
+
+static JM_SORT_TEMPLATE_TYPE* jm_vector_search(JM_SORT_TEMPLATE_NAME)(jm_vector(JM_SORT_TEMPLATE_TYPE)* v, const JM_SORT_TEMPLATE_TYPE* key) {
+    size_t i = jm_vector_lower_bound(JM_SORT_TEMPLATE_NAME)(v, key);
+    if((i < jm_vector_get_size(JM_SORT_TEMPLATE_TYPE)(v)) && !JM_SORT_TEMPLATE_LESS(key, &v->items[i]))
+        return &v->items[i];
+    return 0;
+}
+
+#undef JM_SORT_SWAP
+#undef JM_SORT_TEMPLATE_TYPE
+#undef JM_SORT_TEMPLATE_NAME
+#undef JM_SORT_TEMPLATE_LESS
+
+/** @}
+*/
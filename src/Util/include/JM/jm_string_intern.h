@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_STRING_INTERN_H
+#define JM_STRING_INTERN_H
+
+#include "jm_types.h"
+#include "jm_callbacks.h"
+#include "jm_arena.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_string_intern.h Definition of ::jm_string_intern_t and supporting functions
+	*
+	* \addtogroup jm_utils
+	* @{
+		\addtogroup jm_string_intern
+	* @}
+*/
+/** \addtogroup jm_string_intern String interning
+ @{
+*/
+
+/** \brief Slot of the hash table */
+typedef struct jm_string_intern_slot_t {
+    jm_string str; /** \brief Interned string or NULL for an empty slot */
+    unsigned int hash; /** \brief Hash value of the string */
+} jm_string_intern_slot_t;
+
+/**
+ \brief A set of unique strings.
+
+ Each distinct string is stored once, so interned strings can be compared by pointer.
+ Lookup uses a hash table with open addressing (linear probing) and the strings are
+ copied into an arena, so both insertion and lookup take constant time on average.
+ The strings stay valid until jm_string_intern_free_data() is called.
+*/
+typedef struct jm_string_intern_t {
+    jm_callbacks* callbacks; /** \brief Callbacks used for memory allocation */
+    jm_arena_t strings; /** \brief Storage for the strings */
+    jm_string_intern_slot_t* slots; /** \brief Hash table, the size is a power of two */
+    size_t capacity; /** \brief Number of slots */
+    size_t count; /** \brief Number of strings */
+} jm_string_intern_t;
+
+/**
+ \brief Initialize an empty set. No memory is allocated until the first string is added.
+ \param s The set.
+ \param c Callbacks for memory allocation. Default callbacks are used if NULL.
+*/
+void jm_string_intern_init(jm_string_intern_t* s, jm_callbacks* c);
+
+/**
+ \brief Find a string.
+ \return The interned copy of the string or NULL if the string is not in the set.
+*/
+jm_string jm_string_intern_find(jm_string_intern_t* s, jm_string str);
+
+/**
+ \brief Add a string to the set unless it is already there.
+ \return The interned copy of the string or NULL if out of memory.
+*/
+jm_string jm_string_intern_put(jm_string_intern_t* s, jm_string str);
+
+/** \brief Get the number of strings in the set */
+static size_t jm_string_intern_get_size(jm_string_intern_t* s) { return s->count; }
+
+/** \brief Release the strings and the hash table. The set is empty afterwards and can be used again. */
+void jm_string_intern_free_data(jm_string_intern_t* s);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_STRING_INTERN_H */
+#endif
@@ -38,9 +38,37 @@ extern "C" {
 /** 
 	\brief Set of string is based on a vector	
 
+	The vector is kept sorted so that lookups use binary search, but every new string is inserted
+	in place, which moves the tail of the vector. The strings are allocated with the callbacks of
+	the vector and must be freed by the owner. The library itself deduplicates strings with
+	::jm_string_intern_t, which adds strings in constant time; the set is kept for compatibility with
+	code that needs the strings in sorted order.
 */
 typedef struct jm_vector_jm_string jm_string_set; /* equivalent to "typedef jm_vector(jm_string) jm_string_set" which Doxygen does not understand */
 
+/**
+\brief Find the position of a string in a set.
+
+\param s A string set.
+\param str Search string.
+\param found Set to non-zero if the string is in the set.
+\return Index of the string or of the position where it should be inserted.
+*/
+static size_t jm_string_set_lower_bound(jm_string_set* s, jm_string str, int* found) {
+    size_t lo = 0, hi = jm_vector_get_size(jm_string)(s);
+    *found = 0;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(jm_vector_get_item(jm_string)(s, mid), str);
+        if(cmp < 0) lo = mid + 1;
+        else {
+            if(cmp == 0) *found = 1;
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
 /**
 \brief Find a string in a set.
 
@@ -49,8 +77,9 @@ typedef struct jm_vector_jm_string jm_string_set; /* equivalent to "typedef jm_v
 \return If found returns a pointer to the string saved in the set. If not found returns NULL.
 */
 static jm_string jm_string_set_find(jm_string_set* s, jm_string str) {
-    jm_string* found = jm_vector_find(jm_string)(s,&str,jm_compare_string);
-    if(found) return *found;
+    int found;
+    size_t index = jm_string_set_lower_bound(s, str, &found);
+    if(found) return jm_vector_get_item(jm_string)(s, index);
     return 0;
 }
 
@@ -62,19 +91,23 @@ static jm_string jm_string_set_find(jm_string_set* s, jm_string str) {
 *  @return A pointer to the inserted (or found) element or zero pointer if failed.
 */
 static jm_string jm_string_set_put(jm_string_set* s, jm_string str) {
-    jm_string found = jm_string_set_find(s, str);
-    if(found) return found;
+    int found;
+    size_t index = jm_string_set_lower_bound(s, str, &found);
+    if(found) return jm_vector_get_item(jm_string)(s, index);
     {
-        char* newstr = 0;
         size_t len = strlen(str) + 1;
-        jm_string* pnewstr = jm_vector_push_back(jm_string)(s, newstr);
-        if(pnewstr) *pnewstr = newstr = s->callbacks->malloc(len);
-        if(!pnewstr || !newstr) return 0;
+        char* newstr = (char*)s->callbacks->malloc(len);
+        jm_string* pnewstr;
+        if(!newstr) return 0;
         memcpy(newstr, str, len);
-        jm_vector_qsort(jm_string)(s, jm_compare_string);
-        found = newstr;
+        pnewstr = (index < jm_vector_get_size(jm_string)(s)) ?
+            jm_vector_insert(jm_string)(s, index, newstr) : jm_vector_push_back(jm_string)(s, newstr);
+        if(!pnewstr) {
+            s->callbacks->free(newstr);
+            return 0;
+        }
+        return newstr;
     }
-    return found;
 }
 /** @}
 	*/
@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef JM_THREAD_POOL_H
+#define JM_THREAD_POOL_H
+
+#include "jm_types.h"
+#include "jm_callbacks.h"
+#include "jm_portability.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file jm_thread_pool.h Definition of ::jm_thread_pool_t and supporting functions
+	*
+	* \addtogroup jm_utils
+	* @{
+		\addtogroup jm_thread_pool
+	* @}
+*/
+/** \addtogroup jm_thread_pool Running independent tasks on several threads
+ @{
+*/
+
+/**
+ \brief A set of threads that run batches of independent tasks.
+
+ The worker threads are started for each batch and joined before jm_thread_pool_run() returns,
+ since the portability layer has no condition variables to keep idle threads waiting. The calling
+ thread takes part in running the tasks. The tasks are picked in order, so a batch with more tasks
+ than threads is balanced dynamically. Nothing is allocated or logged in the worker threads.
+ A pool runs one batch at a time and must not be shared by threads that run batches concurrently.
+*/
+typedef struct jm_thread_pool_t jm_thread_pool_t;
+
+/** \brief A task: func(data) is called once on one of the threads of the pool */
+typedef struct jm_task_t {
+    jm_thread_func_ft func; /** \brief Function to call */
+    void* data; /** \brief Argument of the function */
+} jm_task_t;
+
+/**
+ \brief Create a thread pool.
+ \param cb Callbacks for memory allocation. Default callbacks are used if NULL.
+ \param numThreads Number of threads including the calling one, 0 uses one thread per processor.
+ \return A new pool or NULL if out of memory.
+*/
+jm_thread_pool_t* jm_thread_pool_create(jm_callbacks* cb, unsigned int numThreads);
+
+/** \brief Release a pool created with jm_thread_pool_create() */
+void jm_thread_pool_free(jm_thread_pool_t* pool);
+
+/** \brief Get the number of threads of the pool including the calling one, 1 for a NULL pool */
+unsigned int jm_thread_pool_get_size(jm_thread_pool_t* pool);
+
+/**
+ \brief Run the tasks and wait for all of them to finish.
+
+ The tasks must be independent of each other. If a worker thread cannot be started the tasks are
+ run on the remaining threads, so all the tasks are always run. A NULL pool runs the tasks in order
+ on the calling thread.
+*/
+void jm_thread_pool_run(jm_thread_pool_t* pool, jm_task_t* tasks, size_t numTasks);
+
+/**
+ \brief Sort the items [0, n) in place. The scratch area has room for n items.
+ \param context The jm_parallel_sort_t::context.
+*/
+typedef void (*jm_sort_chunk_ft)(void* items, void* scratch, size_t n, void* context);
+
+/**
+ \brief Merge the sorted items a[0, na) and b[0, nb) into out. Equal items must be taken from a first.
+ \param context The jm_parallel_sort_t::context.
+*/
+typedef void (*jm_sort_merge_ft)(const void* a, size_t na, const void* b, size_t nb, void* out, void* context);
+
+/** \brief An array sorted with jm_thread_pool_sort() */
+typedef struct jm_parallel_sort_t {
+    void* items; /** \brief Items to sort */
+    size_t numItems; /** \brief Number of items */
+    size_t itemSize; /** \brief Size of an item in bytes */
+    jm_sort_chunk_ft sortChunk; /** \brief Sorts a part of the array */
+    jm_sort_merge_ft merge; /** \brief Merges two sorted parts */
+    void* context; /** \brief Passed to sortChunk and merge */
+} jm_parallel_sort_t;
+
+#ifndef JM_PARALLEL_SORT_MIN_CHUNK
+/** \brief Arrays are not split into parts smaller than this number of items */
+#define JM_PARALLEL_SORT_MIN_CHUNK 1024
+#endif
+
+/**
+ \brief Sort several arrays at the same time with a parallel merge sort.
+
+ Each array is split into up to one part per thread. The parts of all the arrays are sorted as one
+ batch of tasks and then merged pairwise, again as one batch per round. The split only depends on the
+ number of threads, and the result does not depend on it at all when the order is total or when
+ sortChunk is stable.
+ \param pool The pool. The arrays are sorted with sortChunk on the calling thread if NULL.
+ The scratch memory is allocated with the callbacks of the pool, or the default callbacks if NULL.
+ \param sorts The arrays to sort.
+ \param numSorts Number of arrays.
+ \return jm_status_success or jm_status_error if out of memory, in which case the arrays are left unchanged.
+*/
+jm_status_enu_t jm_thread_pool_sort(jm_thread_pool_t* pool, jm_parallel_sort_t* sorts, size_t numSorts);
+
+/** @} */
+#ifdef __cplusplus
+}
+#endif
+
+/* JM_THREAD_POOL_H */
+#endif
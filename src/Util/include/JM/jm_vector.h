@@ -212,6 +212,14 @@ Default definition below is jm_diff and is implemented as (int)(first-second)
 */
 #define jm_vector_reserve(T) jm_mangle(jm_vector_reserve, T)
 
+/**
+*  jm_vector_shrink_to_fit releases the memory that is allocated but not used by the vector items.
+*  Useful for vectors that are not modified anymore after they were filled.
+*  Returns: the capacity after the operation. It is larger than the size if the memory could not be reallocated.
+*  size_t jm_vector_shrink_to_fit(T)(jm_vector(T)* a)
+*/
+#define jm_vector_shrink_to_fit(T) jm_mangle(jm_vector_shrink_to_fit, T)
+
 /**
 *  jm_vector_copy copies source vector into destination.
 *  Returns the number of elements actually copied (may be less than the source size if allocation failed).
@@ -275,9 +283,19 @@ Default definition below is jm_diff and is implemented as (int)(first-second)
 /** number of items always allocated on the stack */
 #define JM_VECTOR_MINIMAL_CAPACITY 16
 
-/** maximum memory chunk (in items) to be allocated in push_back. */
+/** maximum memory chunk (in items) to be allocated in push_back.
+    Not used by the vector anymore since the capacity grows by ::JM_VECTOR_GROWTH_FACTOR_NUM / ::JM_VECTOR_GROWTH_FACTOR_DEN. */
 #define JM_VECTOR_MAX_MEMORY_CHUNK 1024
 
+/** \brief The capacity of a full vector is multiplied by JM_VECTOR_GROWTH_FACTOR_NUM / JM_VECTOR_GROWTH_FACTOR_DEN
+    when it grows. Can be defined for the whole build, the factor must be larger than one. */
+#ifndef JM_VECTOR_GROWTH_FACTOR_NUM
+#define JM_VECTOR_GROWTH_FACTOR_NUM 3
+#endif
+#ifndef JM_VECTOR_GROWTH_FACTOR_DEN
+#define JM_VECTOR_GROWTH_FACTOR_DEN 2
+#endif
+
 /** Declare the struct and functions for the specified type. */
 #define jm_vector_declare_template(T)		\
 typedef struct  jm_vector(T) {                \
@@ -335,6 +353,7 @@ static T* jm_vector_get_lastp(T)(jm_vector(T)* a) { \
 } \
 extern size_t jm_vector_resize(T)(jm_vector(T)* a, size_t size); \
 extern size_t jm_vector_reserve(T)(jm_vector(T)* a, size_t capacity); \
+extern size_t jm_vector_shrink_to_fit(T)(jm_vector(T)* a); \
 extern size_t jm_vector_append(T)(jm_vector(T)* destination, jm_vector(T)* source); \
 extern T* jm_vector_insert(T)(jm_vector(T)* a, size_t index, T item);\
 extern T* jm_vector_push_back(T)(jm_vector(T)* a, T item);\
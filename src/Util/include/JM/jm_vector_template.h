@@ -83,9 +83,19 @@ size_t jm_vector_init(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_
         return 0;
 }
 
+#define jm_vector_grow(T) jm_mangle(jm_vector_grow, T)
+
+/* Grow the capacity geometrically so that repeated growth takes amortized constant time per item.
+   Returns the capacity after the operation, which is at least "size" unless memory allocation failed. */
+static size_t jm_vector_grow(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* a, size_t size) {
+        size_t reserve = a->capacity / JM_VECTOR_GROWTH_FACTOR_DEN * JM_VECTOR_GROWTH_FACTOR_NUM;
+        if(reserve < size) reserve = size;
+        return jm_vector_reserve(JM_TEMPLATE_INSTANCE_TYPE)(a, reserve);
+}
+
 size_t jm_vector_resize(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* a, size_t size) {
         if(size > a->capacity)  {
-            if(jm_vector_reserve(JM_TEMPLATE_INSTANCE_TYPE)(a, size) < size) {
+            if(jm_vector_grow(JM_TEMPLATE_INSTANCE_TYPE)(a, size) < size) {
                 a->size = a->capacity;
                 return a->capacity;
             }
@@ -97,15 +107,38 @@ size_t jm_vector_resize(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANC
 size_t jm_vector_reserve(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* a, size_t size) {
         void* newmem;
         if(size <= a->capacity) return a->capacity;
-        newmem = a->callbacks->malloc(size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
-        if(!newmem) return a->capacity;
-        memcpy(newmem, a->items, a->size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
-        if(a->items !=  a->preallocated) a->callbacks->free((void*)(a->items));
+        if(a->items != a->preallocated) {
+            /* realloc can often extend the block in place */
+            newmem = a->callbacks->realloc((void*)(a->items), size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
+            if(!newmem) return a->capacity;
+        }
+        else {
+            newmem = a->callbacks->malloc(size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
+            if(!newmem) return a->capacity;
+            memcpy(newmem, a->items, a->size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
+        }
         a->items = newmem;
         a->capacity = size;
         return a->capacity;
 }
 
+size_t jm_vector_shrink_to_fit(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* a) {
+        void* newmem;
+        if((a->items == a->preallocated) || (a->size == a->capacity)) return a->capacity;
+        if(a->size <= JM_VECTOR_MINIMAL_CAPACITY) {
+            memcpy((void*)a->preallocated, (void*)a->items, a->size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
+            a->callbacks->free((void*)(a->items));
+            a->items = a->preallocated;
+            a->capacity = JM_VECTOR_MINIMAL_CAPACITY;
+            return a->capacity;
+        }
+        newmem = a->callbacks->realloc((void*)(a->items), a->size * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
+        if(!newmem) return a->capacity;
+        a->items = newmem;
+        a->capacity = a->size;
+        return a->capacity;
+}
+
 size_t jm_vector_copy(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* destination, jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* source) {
         size_t destsize = jm_vector_resize(JM_TEMPLATE_INSTANCE_TYPE)(destination, source->size);
         if(destsize > 0) {
@@ -123,18 +156,13 @@ size_t jm_vector_append(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANC
 }
 
 JM_TEMPLATE_INSTANCE_TYPE* jm_vector_insert(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector(JM_TEMPLATE_INSTANCE_TYPE)* a, size_t index, JM_TEMPLATE_INSTANCE_TYPE item) {
-        size_t reserve;
         JM_TEMPLATE_INSTANCE_TYPE* pitem;
         if(index >= a->size) return 0;
         if(a->size == a->capacity) {
-                if(a->capacity > JM_VECTOR_MAX_MEMORY_CHUNK)
-                        reserve = JM_VECTOR_MAX_MEMORY_CHUNK + a->capacity;
-                else
-                        reserve = a->capacity * 2;
-                if( jm_vector_reserve(JM_TEMPLATE_INSTANCE_TYPE)(a, reserve) != reserve) return 0;
+                if(jm_vector_grow(JM_TEMPLATE_INSTANCE_TYPE)(a, a->size + 1) <= a->size) return 0;
         }
         assert(a->size < a->capacity);
-        memmove((void*)(a->items+index+1),(void*)(a->items+index), a->size - index);
+        memmove((void*)(a->items+index+1),(void*)(a->items+index), (a->size - index) * sizeof(JM_TEMPLATE_INSTANCE_TYPE));
         a->items[index] = item;
         pitem = &(a->items[index]);
         a->size++;
@@ -142,14 +170,9 @@ JM_TEMPLATE_INSTANCE_TYPE* jm_vector_insert(JM_TEMPLATE_INSTANCE_TYPE)(jm_vector
 }
 
 JM_TEMPLATE_INSTANCE_TYPE* jm_vector_resize1(JM_TEMPLATE_INSTANCE_TYPE) (jm_vector(JM_TEMPLATE_INSTANCE_TYPE) * a) {
-        size_t reserve;
         JM_TEMPLATE_INSTANCE_TYPE* pitem;
         if(a->size == a->capacity) {
-                if(a->capacity > JM_VECTOR_MAX_MEMORY_CHUNK)
-                        reserve = JM_VECTOR_MAX_MEMORY_CHUNK + a->capacity;
-                else
-                        reserve = a->capacity * 2;
-                if( jm_vector_reserve(JM_TEMPLATE_INSTANCE_TYPE)(a, reserve) != reserve) return 0;
+                if(jm_vector_grow(JM_TEMPLATE_INSTANCE_TYPE)(a, a->size + 1) <= a->size) return 0;
         }
         assert(a->size < a->capacity);
         pitem = &(a->items[a->size]);
@@ -0,0 +1,131 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <string.h>
+#include "JM/jm_arena.h"
+
+/* Alignment sufficient for any of the types stored in the arena */
+typedef union jm_arena_align_t {
+    double d;
+    void* p;
+    long l;
+    void (*f)(void);
+} jm_arena_align_t;
+
+#define JM_ARENA_ALIGNMENT sizeof(jm_arena_align_t)
+
+/* The header is padded so that the data following it is aligned */
+struct jm_arena_block_t {
+    union {
+        jm_arena_block_t* next;
+        jm_arena_align_t align;
+    } header;
+};
+
+void jm_arena_init(jm_arena_t* a, size_t block_size, jm_callbacks* c) {
+    a->callbacks = c ? c : jm_get_default_callbacks();
+    a->blocks = 0;
+    a->next = 0;
+    a->left = 0;
+    if(!block_size) block_size = JM_ARENA_DEFAULT_BLOCK_SIZE;
+    a->block_size = (block_size + JM_ARENA_ALIGNMENT - 1) / JM_ARENA_ALIGNMENT * JM_ARENA_ALIGNMENT;
+}
+
+/* Get unaligned memory */
+static char* jm_arena_get(jm_arena_t* a, size_t size) {
+    jm_arena_block_t* block;
+    char* out;
+
+    if(size <= a->left) {
+        out = a->next;
+        a->next += size;
+        a->left -= size;
+        return out;
+    }
+    /* Large requests get a block of their own placed after the current one so that its free space is kept */
+    if(size > a->block_size / 4) {
+        block = (jm_arena_block_t*)a->callbacks->malloc(sizeof(jm_arena_block_t) + size);
+        if(!block) return 0;
+        if(a->blocks) {
+            block->header.next = a->blocks->header.next;
+            a->blocks->header.next = block;
+        }
+        else {
+            block->header.next = 0;
+            a->blocks = block;
+        }
+        return (char*)(block + 1);
+    }
+    block = (jm_arena_block_t*)a->callbacks->malloc(sizeof(jm_arena_block_t) + a->block_size);
+    if(!block) return 0;
+    block->header.next = a->blocks;
+    a->blocks = block;
+    out = (char*)(block + 1);
+    a->next = out + size;
+    a->left = a->block_size - size;
+    return out;
+}
+
+void* jm_arena_alloc(jm_arena_t* a, size_t size) {
+    /* Blocks start aligned and their size is a multiple of the alignment, so the distance
+       to the next aligned address is given by the free space left */
+    size_t padding = a->left % JM_ARENA_ALIGNMENT;
+    if(padding) {
+        a->next += padding;
+        a->left -= padding;
+    }
+    if(size == 0) size = 1;
+    return jm_arena_get(a, (size + JM_ARENA_ALIGNMENT - 1) / JM_ARENA_ALIGNMENT * JM_ARENA_ALIGNMENT);
+}
+
+char* jm_arena_strndup(jm_arena_t* a, const char* str, size_t len) {
+    char* out = jm_arena_get(a, len + 1);
+    if(!out) return 0;
+    memcpy(out, str, len);
+    out[len] = 0;
+    return out;
+}
+
+void jm_arena_free_data(jm_arena_t* a) {
+    jm_arena_block_t* block = a->blocks;
+    while(block) {
+        jm_arena_block_t* next = block->header.next;
+        a->callbacks->free(block);
+        block = next;
+    }
+    a->blocks = 0;
+    a->next = 0;
+    a->left = 0;
+}
+
+void jm_arena_clear(jm_arena_t* a) {
+    jm_arena_block_t* block;
+
+    /* Without a current block the list only holds large blocks */
+    if(!a->next) {
+        jm_arena_free_data(a);
+        return;
+    }
+    /* The current block is first, the large blocks and the full ones follow it */
+    block = a->blocks->header.next;
+    while(block) {
+        jm_arena_block_t* next = block->header.next;
+        a->callbacks->free(block);
+        block = next;
+    }
+    a->blocks->header.next = 0;
+    a->next = (char*)(a->blocks + 1);
+    a->left = a->block_size;
+}
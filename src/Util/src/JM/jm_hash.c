@@ -0,0 +1,27 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include "JM/jm_hash.h"
+
+unsigned int jm_hash_string(jm_string str, unsigned int seed, size_t* len) {
+    const unsigned char* p = (const unsigned char*)str;
+    unsigned int hash = seed;
+    while(*p) {
+        hash ^= *p++;
+        hash *= 16777619U;
+    }
+    if(len) *len = (const char*)p - str;
+    return hash & 0xFFFFFFFFU;
+}
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <string.h>
+#include "JM/jm_named_index.h"
+#include "JM/jm_hash.h"
+
+void jm_named_index_init(jm_named_index_t* x, jm_callbacks* c) {
+    x->callbacks = c ? c : jm_get_default_callbacks();
+    x->slots = 0;
+    x->capacity = 0;
+}
+
+/* Slot holding the name or the empty slot where it should be inserted */
+static jm_named_index_slot_t* jm_named_index_lookup(jm_named_index_t* x, jm_string name, unsigned int hash) {
+    size_t mask = x->capacity - 1;
+    size_t i = hash & mask;
+    while(x->slots[i].item.name) {
+        if((x->slots[i].hash == hash) && (strcmp(x->slots[i].item.name, name) == 0)) break;
+        i = (i + 1) & mask;
+    }
+    return &x->slots[i];
+}
+
+jm_status_enu_t jm_named_index_build(jm_named_index_t* x, jm_vector(jm_named_ptr)* items) {
+    size_t i, n = jm_vector_get_size(jm_named_ptr)(items);
+    size_t capacity = 16;
+
+    jm_named_index_free_data(x);
+    if(!n) return jm_status_success;
+    /* The table is kept at most half full */
+    while(capacity < 2 * n) capacity *= 2;
+    x->slots = (jm_named_index_slot_t*)x->callbacks->calloc(capacity, sizeof(jm_named_index_slot_t));
+    if(!x->slots) return jm_status_error;
+    x->capacity = capacity;
+    for(i = 0; i < n; i++) {
+        jm_named_ptr item = jm_vector_get_item(jm_named_ptr)(items, i);
+        unsigned int hash = jm_hash_string(item.name, JM_HASH_SEED, 0);
+        jm_named_index_slot_t* slot = jm_named_index_lookup(x, item.name, hash);
+        if(!slot->item.name) {
+            slot->item = item;
+            slot->hash = hash;
+        }
+    }
+    return jm_status_success;
+}
+
+jm_voidp jm_named_index_find(jm_named_index_t* x, jm_string name) {
+    if(!x->capacity) return 0;
+    return jm_named_index_lookup(x, name, jm_hash_string(name, JM_HASH_SEED, 0))->item.ptr;
+}
+
+void jm_named_index_free_data(jm_named_index_t* x) {
+    x->callbacks->free(x->slots);
+    x->slots = 0;
+    x->capacity = 0;
+}
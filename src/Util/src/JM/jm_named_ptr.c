@@ -52,5 +52,45 @@ jm_named_ptr jm_named_alloc_v(jm_vector(char)* name, size_t size, size_t nameoff
     return out;
 }
 
+static jm_named_ptr jm_named_init_arena(const char* name, size_t namelen, size_t size, size_t nameoffset, jm_arena_t* a) {
+    jm_named_ptr out;
+    out.ptr = jm_arena_alloc(a, size + namelen);
+    out.name = 0;
+    if(out.ptr) {
+        char* outname = out.ptr;
+        outname += nameoffset;
+        if(namelen)
+            memcpy(outname, name, namelen);
+        outname[namelen] = 0;
+        out.name = outname;
+    }
+    return out;
+}
+
+jm_named_ptr jm_named_alloc_arena(const char* name, size_t size, size_t nameoffset, jm_arena_t* a) {
+    return jm_named_init_arena(name, strlen(name), size, nameoffset, a);
+}
+
+jm_named_ptr jm_named_alloc_v_arena(jm_vector(char)* name, size_t size, size_t nameoffset, jm_arena_t* a) {
+    size_t namelen = jm_vector_get_size(char)(name);
+    return jm_named_init_arena(namelen ? jm_vector_get_itemp(char)(name,0) : "", namelen, size, nameoffset, a);
+}
+
 #define JM_TEMPLATE_INSTANCE_TYPE jm_named_ptr
 #include "JM/jm_vector_template.h"
+
+#define JM_SORT_TEMPLATE_TYPE jm_named_ptr
+#define JM_SORT_TEMPLATE_NAME jm_named_ptr_by_name
+#define JM_SORT_TEMPLATE_LESS(a, b) (strcmp((a)->name, (b)->name) < 0)
+#include "JM/jm_sort_template.h"
+
+void jm_named_vector_sort(jm_vector(jm_named_ptr)* v) {
+    jm_vector_sort(jm_named_ptr_by_name)(v);
+}
+
+jm_named_ptr* jm_named_vector_search(jm_vector(jm_named_ptr)* v, jm_string name) {
+    jm_named_ptr key;
+    key.ptr = 0;
+    key.name = name;
+    return jm_vector_search(jm_named_ptr_by_name)(v, &key);
+}
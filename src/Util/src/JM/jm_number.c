@@ -0,0 +1,603 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <locale.h>
+
+#include "JM/jm_number.h"
+#include "JM/jm_callbacks.h"
+
+/* The Eisel-Lemire conversion needs 64-bit integers and IEEE doubles. JM_HAVE_UINT64 is
+   defined by the build when <stdint.h> provides uint64_t. */
+#if defined(JM_HAVE_UINT64) && (FLT_RADIX == 2) && (DBL_MANT_DIG == 53) && (DBL_MAX_EXP == 1024)
+#include <stdint.h>
+#define JM_NUMBER_EISEL_LEMIRE 1
+#else
+#define JM_NUMBER_EISEL_LEMIRE 0
+#endif
+
+/* The fast path for doubles relies on each operation being rounded to double precision.
+   This is not the case for the x87 FPU that keeps intermediate results in extended precision. */
+#if defined(FLT_EVAL_METHOD)
+#define JM_NUMBER_FAST_PATH (FLT_EVAL_METHOD == 0)
+#elif defined(__FLT_EVAL_METHOD__)
+#define JM_NUMBER_FAST_PATH (__FLT_EVAL_METHOD__ == 0)
+#elif defined(_M_X64) || defined(_M_ARM) || defined(_M_ARM64)
+#define JM_NUMBER_FAST_PATH 1
+#else
+#define JM_NUMBER_FAST_PATH 0
+#endif
+
+#if JM_NUMBER_EISEL_LEMIRE
+/* Significant digits that are collected into a 64-bit integer (10^19 < 2^64) */
+#define JM_NUMBER_MAX_DIGITS 19
+typedef uint64_t jm_number_mantissa_t;
+#else
+/* Significant digits that are collected into a double without rounding (10^15 < 2^53) */
+#define JM_NUMBER_MAX_DIGITS 15
+typedef double jm_number_mantissa_t;
+#endif
+
+/* Exponents beyond this are out of range for any number of digits the slow path accepts */
+#define JM_NUMBER_MAX_EXPONENT 100000
+
+/* Numbers up to this length are copied to the stack for strtod() */
+#define JM_NUMBER_BUFFER_SIZE 128
+
+/* Powers of ten that are exact in double precision */
+static const double jm_number_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#define JM_NUMBER_MAX_POW10 22
+
+#if JM_NUMBER_EISEL_LEMIRE
+/* Range of the powers of ten in jm_number_pow10_64. Smaller powers give zero and larger ones infinity
+   for any mantissa with at most 19 digits. */
+#define JM_NUMBER_MIN_POW10_64 (-342)
+#define JM_NUMBER_MAX_POW10_64 308
+
+/* Powers of ten 10^-342 ... 10^308 as 64-bit mantissas normalized to have the top bit set, rounded down.
+   The binary exponent of 10^q is floor(q * log2(10)) - 63. */
+static const uint64_t jm_number_pow10_64[] = {
+    UINT64_C(0xEEF453D6923BD65A), UINT64_C(0x9558B4661B6565F8), UINT64_C(0xBAAEE17FA23EBF76),
+    UINT64_C(0xE95A99DF8ACE6F53), UINT64_C(0x91D8A02BB6C10594), UINT64_C(0xB64EC836A47146F9),
+    UINT64_C(0xE3E27A444D8D98B7), UINT64_C(0x8E6D8C6AB0787F72), UINT64_C(0xB208EF855C969F4F),
+    UINT64_C(0xDE8B2B66B3BC4723), UINT64_C(0x8B16FB203055AC76), UINT64_C(0xADDCB9E83C6B1793),
+    UINT64_C(0xD953E8624B85DD78), UINT64_C(0x87D4713D6F33AA6B), UINT64_C(0xA9C98D8CCB009506),
+    UINT64_C(0xD43BF0EFFDC0BA48), UINT64_C(0x84A57695FE98746D), UINT64_C(0xA5CED43B7E3E9188),
+    UINT64_C(0xCF42894A5DCE35EA), UINT64_C(0x818995CE7AA0E1B2), UINT64_C(0xA1EBFB4219491A1F),
+    UINT64_C(0xCA66FA129F9B60A6), UINT64_C(0xFD00B897478238D0), UINT64_C(0x9E20735E8CB16382),
+    UINT64_C(0xC5A890362FDDBC62), UINT64_C(0xF712B443BBD52B7B), UINT64_C(0x9A6BB0AA55653B2D),
+    UINT64_C(0xC1069CD4EABE89F8), UINT64_C(0xF148440A256E2C76), UINT64_C(0x96CD2A865764DBCA),
+    UINT64_C(0xBC807527ED3E12BC), UINT64_C(0xEBA09271E88D976B), UINT64_C(0x93445B8731587EA3),
+    UINT64_C(0xB8157268FDAE9E4C), UINT64_C(0xE61ACF033D1A45DF), UINT64_C(0x8FD0C16206306BAB),
+    UINT64_C(0xB3C4F1BA87BC8696), UINT64_C(0xE0B62E2929ABA83C), UINT64_C(0x8C71DCD9BA0B4925),
+    UINT64_C(0xAF8E5410288E1B6F), UINT64_C(0xDB71E91432B1A24A), UINT64_C(0x892731AC9FAF056E),
+    UINT64_C(0xAB70FE17C79AC6CA), UINT64_C(0xD64D3D9DB981787D), UINT64_C(0x85F0468293F0EB4E),
+    UINT64_C(0xA76C582338ED2621), UINT64_C(0xD1476E2C07286FAA), UINT64_C(0x82CCA4DB847945CA),
+    UINT64_C(0xA37FCE126597973C), UINT64_C(0xCC5FC196FEFD7D0C), UINT64_C(0xFF77B1FCBEBCDC4F),
+    UINT64_C(0x9FAACF3DF73609B1), UINT64_C(0xC795830D75038C1D), UINT64_C(0xF97AE3D0D2446F25),
+    UINT64_C(0x9BECCE62836AC577), UINT64_C(0xC2E801FB244576D5), UINT64_C(0xF3A20279ED56D48A),
+    UINT64_C(0x9845418C345644D6), UINT64_C(0xBE5691EF416BD60C), UINT64_C(0xEDEC366B11C6CB8F),
+    UINT64_C(0x94B3A202EB1C3F39), UINT64_C(0xB9E08A83A5E34F07), UINT64_C(0xE858AD248F5C22C9),
+    UINT64_C(0x91376C36D99995BE), UINT64_C(0xB58547448FFFFB2D), UINT64_C(0xE2E69915B3FFF9F9),
+    UINT64_C(0x8DD01FAD907FFC3B), UINT64_C(0xB1442798F49FFB4A), UINT64_C(0xDD95317F31C7FA1D),
+    UINT64_C(0x8A7D3EEF7F1CFC52), UINT64_C(0xAD1C8EAB5EE43B66), UINT64_C(0xD863B256369D4A40),
+    UINT64_C(0x873E4F75E2224E68), UINT64_C(0xA90DE3535AAAE202), UINT64_C(0xD3515C2831559A83),
+    UINT64_C(0x8412D9991ED58091), UINT64_C(0xA5178FFF668AE0B6), UINT64_C(0xCE5D73FF402D98E3),
+    UINT64_C(0x80FA687F881C7F8E), UINT64_C(0xA139029F6A239F72), UINT64_C(0xC987434744AC874E),
+    UINT64_C(0xFBE9141915D7A922), UINT64_C(0x9D71AC8FADA6C9B5), UINT64_C(0xC4CE17B399107C22),
+    UINT64_C(0xF6019DA07F549B2B), UINT64_C(0x99C102844F94E0FB), UINT64_C(0xC0314325637A1939),
+    UINT64_C(0xF03D93EEBC589F88), UINT64_C(0x96267C7535B763B5), UINT64_C(0xBBB01B9283253CA2),
+    UINT64_C(0xEA9C227723EE8BCB), UINT64_C(0x92A1958A7675175F), UINT64_C(0xB749FAED14125D36),
+    UINT64_C(0xE51C79A85916F484), UINT64_C(0x8F31CC0937AE58D2), UINT64_C(0xB2FE3F0B8599EF07),
+    UINT64_C(0xDFBDCECE67006AC9), UINT64_C(0x8BD6A141006042BD), UINT64_C(0xAECC49914078536D),
+    UINT64_C(0xDA7F5BF590966848), UINT64_C(0x888F99797A5E012D), UINT64_C(0xAAB37FD7D8F58178),
+    UINT64_C(0xD5605FCDCF32E1D6), UINT64_C(0x855C3BE0A17FCD26), UINT64_C(0xA6B34AD8C9DFC06F),
+    UINT64_C(0xD0601D8EFC57B08B), UINT64_C(0x823C12795DB6CE57), UINT64_C(0xA2CB1717B52481ED),
+    UINT64_C(0xCB7DDCDDA26DA268), UINT64_C(0xFE5D54150B090B02), UINT64_C(0x9EFA548D26E5A6E1),
+    UINT64_C(0xC6B8E9B0709F109A), UINT64_C(0xF867241C8CC6D4C0), UINT64_C(0x9B407691D7FC44F8),
+    UINT64_C(0xC21094364DFB5636), UINT64_C(0xF294B943E17A2BC4), UINT64_C(0x979CF3CA6CEC5B5A),
+    UINT64_C(0xBD8430BD08277231), UINT64_C(0xECE53CEC4A314EBD), UINT64_C(0x940F4613AE5ED136),
+    UINT64_C(0xB913179899F68584), UINT64_C(0xE757DD7EC07426E5), UINT64_C(0x9096EA6F3848984F),
+    UINT64_C(0xB4BCA50B065ABE63), UINT64_C(0xE1EBCE4DC7F16DFB), UINT64_C(0x8D3360F09CF6E4BD),
+    UINT64_C(0xB080392CC4349DEC), UINT64_C(0xDCA04777F541C567), UINT64_C(0x89E42CAAF9491B60),
+    UINT64_C(0xAC5D37D5B79B6239), UINT64_C(0xD77485CB25823AC7), UINT64_C(0x86A8D39EF77164BC),
+    UINT64_C(0xA8530886B54DBDEB), UINT64_C(0xD267CAA862A12D66), UINT64_C(0x8380DEA93DA4BC60),
+    UINT64_C(0xA46116538D0DEB78), UINT64_C(0xCD795BE870516656), UINT64_C(0x806BD9714632DFF6),
+    UINT64_C(0xA086CFCD97BF97F3), UINT64_C(0xC8A883C0FDAF7DF0), UINT64_C(0xFAD2A4B13D1B5D6C),
+    UINT64_C(0x9CC3A6EEC6311A63), UINT64_C(0xC3F490AA77BD60FC), UINT64_C(0xF4F1B4D515ACB93B),
+    UINT64_C(0x991711052D8BF3C5), UINT64_C(0xBF5CD54678EEF0B6), UINT64_C(0xEF340A98172AACE4),
+    UINT64_C(0x9580869F0E7AAC0E), UINT64_C(0xBAE0A846D2195712), UINT64_C(0xE998D258869FACD7),
+    UINT64_C(0x91FF83775423CC06), UINT64_C(0xB67F6455292CBF08), UINT64_C(0xE41F3D6A7377EECA),
+    UINT64_C(0x8E938662882AF53E), UINT64_C(0xB23867FB2A35B28D), UINT64_C(0xDEC681F9F4C31F31),
+    UINT64_C(0x8B3C113C38F9F37E), UINT64_C(0xAE0B158B4738705E), UINT64_C(0xD98DDAEE19068C76),
+    UINT64_C(0x87F8A8D4CFA417C9), UINT64_C(0xA9F6D30A038D1DBC), UINT64_C(0xD47487CC8470652B),
+    UINT64_C(0x84C8D4DFD2C63F3B), UINT64_C(0xA5FB0A17C777CF09), UINT64_C(0xCF79CC9DB955C2CC),
+    UINT64_C(0x81AC1FE293D599BF), UINT64_C(0xA21727DB38CB002F), UINT64_C(0xCA9CF1D206FDC03B),
+    UINT64_C(0xFD442E4688BD304A), UINT64_C(0x9E4A9CEC15763E2E), UINT64_C(0xC5DD44271AD3CDBA),
+    UINT64_C(0xF7549530E188C128), UINT64_C(0x9A94DD3E8CF578B9), UINT64_C(0xC13A148E3032D6E7),
+    UINT64_C(0xF18899B1BC3F8CA1), UINT64_C(0x96F5600F15A7B7E5), UINT64_C(0xBCB2B812DB11A5DE),
+    UINT64_C(0xEBDF661791D60F56), UINT64_C(0x936B9FCEBB25C995), UINT64_C(0xB84687C269EF3BFB),
+    UINT64_C(0xE65829B3046B0AFA), UINT64_C(0x8FF71A0FE2C2E6DC), UINT64_C(0xB3F4E093DB73A093),
+    UINT64_C(0xE0F218B8D25088B8), UINT64_C(0x8C974F7383725573), UINT64_C(0xAFBD2350644EEACF),
+    UINT64_C(0xDBAC6C247D62A583), UINT64_C(0x894BC396CE5DA772), UINT64_C(0xAB9EB47C81F5114F),
+    UINT64_C(0xD686619BA27255A2), UINT64_C(0x8613FD0145877585), UINT64_C(0xA798FC4196E952E7),
+    UINT64_C(0xD17F3B51FCA3A7A0), UINT64_C(0x82EF85133DE648C4), UINT64_C(0xA3AB66580D5FDAF5),
+    UINT64_C(0xCC963FEE10B7D1B3), UINT64_C(0xFFBBCFE994E5C61F), UINT64_C(0x9FD561F1FD0F9BD3),
+    UINT64_C(0xC7CABA6E7C5382C8), UINT64_C(0xF9BD690A1B68637B), UINT64_C(0x9C1661A651213E2D),
+    UINT64_C(0xC31BFA0FE5698DB8), UINT64_C(0xF3E2F893DEC3F126), UINT64_C(0x986DDB5C6B3A76B7),
+    UINT64_C(0xBE89523386091465), UINT64_C(0xEE2BA6C0678B597F), UINT64_C(0x94DB483840B717EF),
+    UINT64_C(0xBA121A4650E4DDEB), UINT64_C(0xE896A0D7E51E1566), UINT64_C(0x915E2486EF32CD60),
+    UINT64_C(0xB5B5ADA8AAFF80B8), UINT64_C(0xE3231912D5BF60E6), UINT64_C(0x8DF5EFABC5979C8F),
+    UINT64_C(0xB1736B96B6FD83B3), UINT64_C(0xDDD0467C64BCE4A0), UINT64_C(0x8AA22C0DBEF60EE4),
+    UINT64_C(0xAD4AB7112EB3929D), UINT64_C(0xD89D64D57A607744), UINT64_C(0x87625F056C7C4A8B),
+    UINT64_C(0xA93AF6C6C79B5D2D), UINT64_C(0xD389B47879823479), UINT64_C(0x843610CB4BF160CB),
+    UINT64_C(0xA54394FE1EEDB8FE), UINT64_C(0xCE947A3DA6A9273E), UINT64_C(0x811CCC668829B887),
+    UINT64_C(0xA163FF802A3426A8), UINT64_C(0xC9BCFF6034C13052), UINT64_C(0xFC2C3F3841F17C67),
+    UINT64_C(0x9D9BA7832936EDC0), UINT64_C(0xC5029163F384A931), UINT64_C(0xF64335BCF065D37D),
+    UINT64_C(0x99EA0196163FA42E), UINT64_C(0xC06481FB9BCF8D39), UINT64_C(0xF07DA27A82C37088),
+    UINT64_C(0x964E858C91BA2655), UINT64_C(0xBBE226EFB628AFEA), UINT64_C(0xEADAB0ABA3B2DBE5),
+    UINT64_C(0x92C8AE6B464FC96F), UINT64_C(0xB77ADA0617E3BBCB), UINT64_C(0xE55990879DDCAABD),
+    UINT64_C(0x8F57FA54C2A9EAB6), UINT64_C(0xB32DF8E9F3546564), UINT64_C(0xDFF9772470297EBD),
+    UINT64_C(0x8BFBEA76C619EF36), UINT64_C(0xAEFAE51477A06B03), UINT64_C(0xDAB99E59958885C4),
+    UINT64_C(0x88B402F7FD75539B), UINT64_C(0xAAE103B5FCD2A881), UINT64_C(0xD59944A37C0752A2),
+    UINT64_C(0x857FCAE62D8493A5), UINT64_C(0xA6DFBD9FB8E5B88E), UINT64_C(0xD097AD07A71F26B2),
+    UINT64_C(0x825ECC24C873782F), UINT64_C(0xA2F67F2DFA90563B), UINT64_C(0xCBB41EF979346BCA),
+    UINT64_C(0xFEA126B7D78186BC), UINT64_C(0x9F24B832E6B0F436), UINT64_C(0xC6EDE63FA05D3143),
+    UINT64_C(0xF8A95FCF88747D94), UINT64_C(0x9B69DBE1B548CE7C), UINT64_C(0xC24452DA229B021B),
+    UINT64_C(0xF2D56790AB41C2A2), UINT64_C(0x97C560BA6B0919A5), UINT64_C(0xBDB6B8E905CB600F),
+    UINT64_C(0xED246723473E3813), UINT64_C(0x9436C0760C86E30B), UINT64_C(0xB94470938FA89BCE),
+    UINT64_C(0xE7958CB87392C2C2), UINT64_C(0x90BD77F3483BB9B9), UINT64_C(0xB4ECD5F01A4AA828),
+    UINT64_C(0xE2280B6C20DD5232), UINT64_C(0x8D590723948A535F), UINT64_C(0xB0AF48EC79ACE837),
+    UINT64_C(0xDCDB1B2798182244), UINT64_C(0x8A08F0F8BF0F156B), UINT64_C(0xAC8B2D36EED2DAC5),
+    UINT64_C(0xD7ADF884AA879177), UINT64_C(0x86CCBB52EA94BAEA), UINT64_C(0xA87FEA27A539E9A5),
+    UINT64_C(0xD29FE4B18E88640E), UINT64_C(0x83A3EEEEF9153E89), UINT64_C(0xA48CEAAAB75A8E2B),
+    UINT64_C(0xCDB02555653131B6), UINT64_C(0x808E17555F3EBF11), UINT64_C(0xA0B19D2AB70E6ED6),
+    UINT64_C(0xC8DE047564D20A8B), UINT64_C(0xFB158592BE068D2E), UINT64_C(0x9CED737BB6C4183D),
+    UINT64_C(0xC428D05AA4751E4C), UINT64_C(0xF53304714D9265DF), UINT64_C(0x993FE2C6D07B7FAB),
+    UINT64_C(0xBF8FDB78849A5F96), UINT64_C(0xEF73D256A5C0F77C), UINT64_C(0x95A8637627989AAD),
+    UINT64_C(0xBB127C53B17EC159), UINT64_C(0xE9D71B689DDE71AF), UINT64_C(0x9226712162AB070D),
+    UINT64_C(0xB6B00D69BB55C8D1), UINT64_C(0xE45C10C42A2B3B05), UINT64_C(0x8EB98A7A9A5B04E3),
+    UINT64_C(0xB267ED1940F1C61C), UINT64_C(0xDF01E85F912E37A3), UINT64_C(0x8B61313BBABCE2C6),
+    UINT64_C(0xAE397D8AA96C1B77), UINT64_C(0xD9C7DCED53C72255), UINT64_C(0x881CEA14545C7575),
+    UINT64_C(0xAA242499697392D2), UINT64_C(0xD4AD2DBFC3D07787), UINT64_C(0x84EC3C97DA624AB4),
+    UINT64_C(0xA6274BBDD0FADD61), UINT64_C(0xCFB11EAD453994BA), UINT64_C(0x81CEB32C4B43FCF4),
+    UINT64_C(0xA2425FF75E14FC31), UINT64_C(0xCAD2F7F5359A3B3E), UINT64_C(0xFD87B5F28300CA0D),
+    UINT64_C(0x9E74D1B791E07E48), UINT64_C(0xC612062576589DDA), UINT64_C(0xF79687AED3EEC551),
+    UINT64_C(0x9ABE14CD44753B52), UINT64_C(0xC16D9A0095928A27), UINT64_C(0xF1C90080BAF72CB1),
+    UINT64_C(0x971DA05074DA7BEE), UINT64_C(0xBCE5086492111AEA), UINT64_C(0xEC1E4A7DB69561A5),
+    UINT64_C(0x9392EE8E921D5D07), UINT64_C(0xB877AA3236A4B449), UINT64_C(0xE69594BEC44DE15B),
+    UINT64_C(0x901D7CF73AB0ACD9), UINT64_C(0xB424DC35095CD80F), UINT64_C(0xE12E13424BB40E13),
+    UINT64_C(0x8CBCCC096F5088CB), UINT64_C(0xAFEBFF0BCB24AAFE), UINT64_C(0xDBE6FECEBDEDD5BE),
+    UINT64_C(0x89705F4136B4A597), UINT64_C(0xABCC77118461CEFC), UINT64_C(0xD6BF94D5E57A42BC),
+    UINT64_C(0x8637BD05AF6C69B5), UINT64_C(0xA7C5AC471B478423), UINT64_C(0xD1B71758E219652B),
+    UINT64_C(0x83126E978D4FDF3B), UINT64_C(0xA3D70A3D70A3D70A), UINT64_C(0xCCCCCCCCCCCCCCCC),
+    UINT64_C(0x8000000000000000), UINT64_C(0xA000000000000000), UINT64_C(0xC800000000000000),
+    UINT64_C(0xFA00000000000000), UINT64_C(0x9C40000000000000), UINT64_C(0xC350000000000000),
+    UINT64_C(0xF424000000000000), UINT64_C(0x9896800000000000), UINT64_C(0xBEBC200000000000),
+    UINT64_C(0xEE6B280000000000), UINT64_C(0x9502F90000000000), UINT64_C(0xBA43B74000000000),
+    UINT64_C(0xE8D4A51000000000), UINT64_C(0x9184E72A00000000), UINT64_C(0xB5E620F480000000),
+    UINT64_C(0xE35FA931A0000000), UINT64_C(0x8E1BC9BF04000000), UINT64_C(0xB1A2BC2EC5000000),
+    UINT64_C(0xDE0B6B3A76400000), UINT64_C(0x8AC7230489E80000), UINT64_C(0xAD78EBC5AC620000),
+    UINT64_C(0xD8D726B7177A8000), UINT64_C(0x878678326EAC9000), UINT64_C(0xA968163F0A57B400),
+    UINT64_C(0xD3C21BCECCEDA100), UINT64_C(0x84595161401484A0), UINT64_C(0xA56FA5B99019A5C8),
+    UINT64_C(0xCECB8F27F4200F3A), UINT64_C(0x813F3978F8940984), UINT64_C(0xA18F07D736B90BE5),
+    UINT64_C(0xC9F2C9CD04674EDE), UINT64_C(0xFC6F7C4045812296), UINT64_C(0x9DC5ADA82B70B59D),
+    UINT64_C(0xC5371912364CE305), UINT64_C(0xF684DF56C3E01BC6), UINT64_C(0x9A130B963A6C115C),
+    UINT64_C(0xC097CE7BC90715B3), UINT64_C(0xF0BDC21ABB48DB20), UINT64_C(0x96769950B50D88F4),
+    UINT64_C(0xBC143FA4E250EB31), UINT64_C(0xEB194F8E1AE525FD), UINT64_C(0x92EFD1B8D0CF37BE),
+    UINT64_C(0xB7ABC627050305AD), UINT64_C(0xE596B7B0C643C719), UINT64_C(0x8F7E32CE7BEA5C6F),
+    UINT64_C(0xB35DBF821AE4F38B), UINT64_C(0xE0352F62A19E306E), UINT64_C(0x8C213D9DA502DE45),
+    UINT64_C(0xAF298D050E4395D6), UINT64_C(0xDAF3F04651D47B4C), UINT64_C(0x88D8762BF324CD0F),
+    UINT64_C(0xAB0E93B6EFEE0053), UINT64_C(0xD5D238A4ABE98068), UINT64_C(0x85A36366EB71F041),
+    UINT64_C(0xA70C3C40A64E6C51), UINT64_C(0xD0CF4B50CFE20765), UINT64_C(0x82818F1281ED449F),
+    UINT64_C(0xA321F2D7226895C7), UINT64_C(0xCBEA6F8CEB02BB39), UINT64_C(0xFEE50B7025C36A08),
+    UINT64_C(0x9F4F2726179A2245), UINT64_C(0xC722F0EF9D80AAD6), UINT64_C(0xF8EBAD2B84E0D58B),
+    UINT64_C(0x9B934C3B330C8577), UINT64_C(0xC2781F49FFCFA6D5), UINT64_C(0xF316271C7FC3908A),
+    UINT64_C(0x97EDD871CFDA3A56), UINT64_C(0xBDE94E8E43D0C8EC), UINT64_C(0xED63A231D4C4FB27),
+    UINT64_C(0x945E455F24FB1CF8), UINT64_C(0xB975D6B6EE39E436), UINT64_C(0xE7D34C64A9C85D44),
+    UINT64_C(0x90E40FBEEA1D3A4A), UINT64_C(0xB51D13AEA4A488DD), UINT64_C(0xE264589A4DCDAB14),
+    UINT64_C(0x8D7EB76070A08AEC), UINT64_C(0xB0DE65388CC8ADA8), UINT64_C(0xDD15FE86AFFAD912),
+    UINT64_C(0x8A2DBF142DFCC7AB), UINT64_C(0xACB92ED9397BF996), UINT64_C(0xD7E77A8F87DAF7FB),
+    UINT64_C(0x86F0AC99B4E8DAFD), UINT64_C(0xA8ACD7C0222311BC), UINT64_C(0xD2D80DB02AABD62B),
+    UINT64_C(0x83C7088E1AAB65DB), UINT64_C(0xA4B8CAB1A1563F52), UINT64_C(0xCDE6FD5E09ABCF26),
+    UINT64_C(0x80B05E5AC60B6178), UINT64_C(0xA0DC75F1778E39D6), UINT64_C(0xC913936DD571C84C),
+    UINT64_C(0xFB5878494ACE3A5F), UINT64_C(0x9D174B2DCEC0E47B), UINT64_C(0xC45D1DF942711D9A),
+    UINT64_C(0xF5746577930D6500), UINT64_C(0x9968BF6ABBE85F20), UINT64_C(0xBFC2EF456AE276E8),
+    UINT64_C(0xEFB3AB16C59B14A2), UINT64_C(0x95D04AEE3B80ECE5), UINT64_C(0xBB445DA9CA61281F),
+    UINT64_C(0xEA1575143CF97226), UINT64_C(0x924D692CA61BE758), UINT64_C(0xB6E0C377CFA2E12E),
+    UINT64_C(0xE498F455C38B997A), UINT64_C(0x8EDF98B59A373FEC), UINT64_C(0xB2977EE300C50FE7),
+    UINT64_C(0xDF3D5E9BC0F653E1), UINT64_C(0x8B865B215899F46C), UINT64_C(0xAE67F1E9AEC07187),
+    UINT64_C(0xDA01EE641A708DE9), UINT64_C(0x884134FE908658B2), UINT64_C(0xAA51823E34A7EEDE),
+    UINT64_C(0xD4E5E2CDC1D1EA96), UINT64_C(0x850FADC09923329E), UINT64_C(0xA6539930BF6BFF45),
+    UINT64_C(0xCFE87F7CEF46FF16), UINT64_C(0x81F14FAE158C5F6E), UINT64_C(0xA26DA3999AEF7749),
+    UINT64_C(0xCB090C8001AB551C), UINT64_C(0xFDCB4FA002162A63), UINT64_C(0x9E9F11C4014DDA7E),
+    UINT64_C(0xC646D63501A1511D), UINT64_C(0xF7D88BC24209A565), UINT64_C(0x9AE757596946075F),
+    UINT64_C(0xC1A12D2FC3978937), UINT64_C(0xF209787BB47D6B84), UINT64_C(0x9745EB4D50CE6332),
+    UINT64_C(0xBD176620A501FBFF), UINT64_C(0xEC5D3FA8CE427AFF), UINT64_C(0x93BA47C980E98CDF),
+    UINT64_C(0xB8A8D9BBE123F017), UINT64_C(0xE6D3102AD96CEC1D), UINT64_C(0x9043EA1AC7E41392),
+    UINT64_C(0xB454E4A179DD1877), UINT64_C(0xE16A1DC9D8545E94), UINT64_C(0x8CE2529E2734BB1D),
+    UINT64_C(0xB01AE745B101E9E4), UINT64_C(0xDC21A1171D42645D), UINT64_C(0x899504AE72497EBA),
+    UINT64_C(0xABFA45DA0EDBDE69), UINT64_C(0xD6F8D7509292D603), UINT64_C(0x865B86925B9BC5C2),
+    UINT64_C(0xA7F26836F282B732), UINT64_C(0xD1EF0244AF2364FF), UINT64_C(0x8335616AED761F1F),
+    UINT64_C(0xA402B9C5A8D3A6E7), UINT64_C(0xCD036837130890A1), UINT64_C(0x802221226BE55A64),
+    UINT64_C(0xA02AA96B06DEB0FD), UINT64_C(0xC83553C5C8965D3D), UINT64_C(0xFA42A8B73ABBF48C),
+    UINT64_C(0x9C69A97284B578D7), UINT64_C(0xC38413CF25E2D70D), UINT64_C(0xF46518C2EF5B8CD1),
+    UINT64_C(0x98BF2F79D5993802), UINT64_C(0xBEEEFB584AFF8603), UINT64_C(0xEEAABA2E5DBF6784),
+    UINT64_C(0x952AB45CFA97A0B2), UINT64_C(0xBA756174393D88DF), UINT64_C(0xE912B9D1478CEB17),
+    UINT64_C(0x91ABB422CCB812EE), UINT64_C(0xB616A12B7FE617AA), UINT64_C(0xE39C49765FDF9D94),
+    UINT64_C(0x8E41ADE9FBEBC27D), UINT64_C(0xB1D219647AE6B31C), UINT64_C(0xDE469FBD99A05FE3),
+    UINT64_C(0x8AEC23D680043BEE), UINT64_C(0xADA72CCC20054AE9), UINT64_C(0xD910F7FF28069DA4),
+    UINT64_C(0x87AA9AFF79042286), UINT64_C(0xA99541BF57452B28), UINT64_C(0xD3FA922F2D1675F2),
+    UINT64_C(0x847C9B5D7C2E09B7), UINT64_C(0xA59BC234DB398C25), UINT64_C(0xCF02B2C21207EF2E),
+    UINT64_C(0x8161AFB94B44F57D), UINT64_C(0xA1BA1BA79E1632DC), UINT64_C(0xCA28A291859BBF93),
+    UINT64_C(0xFCB2CB35E702AF78), UINT64_C(0x9DEFBF01B061ADAB), UINT64_C(0xC56BAEC21C7A1916),
+    UINT64_C(0xF6C69A72A3989F5B), UINT64_C(0x9A3C2087A63F6399), UINT64_C(0xC0CB28A98FCF3C7F),
+    UINT64_C(0xF0FDF2D3F3C30B9F), UINT64_C(0x969EB7C47859E743), UINT64_C(0xBC4665B596706114),
+    UINT64_C(0xEB57FF22FC0C7959), UINT64_C(0x9316FF75DD87CBD8), UINT64_C(0xB7DCBF5354E9BECE),
+    UINT64_C(0xE5D3EF282A242E81), UINT64_C(0x8FA475791A569D10), UINT64_C(0xB38D92D760EC4455),
+    UINT64_C(0xE070F78D3927556A), UINT64_C(0x8C469AB843B89562), UINT64_C(0xAF58416654A6BABB),
+    UINT64_C(0xDB2E51BFE9D0696A), UINT64_C(0x88FCF317F22241E2), UINT64_C(0xAB3C2FDDEEAAD25A),
+    UINT64_C(0xD60B3BD56A5586F1), UINT64_C(0x85C7056562757456), UINT64_C(0xA738C6BEBB12D16C),
+    UINT64_C(0xD106F86E69D785C7), UINT64_C(0x82A45B450226B39C), UINT64_C(0xA34D721642B06084),
+    UINT64_C(0xCC20CE9BD35C78A5), UINT64_C(0xFF290242C83396CE), UINT64_C(0x9F79A169BD203E41),
+    UINT64_C(0xC75809C42C684DD1), UINT64_C(0xF92E0C3537826145), UINT64_C(0x9BBCC7A142B17CCB),
+    UINT64_C(0xC2ABF989935DDBFE), UINT64_C(0xF356F7EBF83552FE), UINT64_C(0x98165AF37B2153DE),
+    UINT64_C(0xBE1BF1B059E9A8D6), UINT64_C(0xEDA2EE1C7064130C), UINT64_C(0x9485D4D1C63E8BE7),
+    UINT64_C(0xB9A74A0637CE2EE1), UINT64_C(0xE8111C87C5C1BA99), UINT64_C(0x910AB1D4DB9914A0),
+    UINT64_C(0xB54D5E4A127F59C8), UINT64_C(0xE2A0B5DC971F303A), UINT64_C(0x8DA471A9DE737E24),
+    UINT64_C(0xB10D8E1456105DAD), UINT64_C(0xDD50F1996B947518), UINT64_C(0x8A5296FFE33CC92F),
+    UINT64_C(0xACE73CBFDC0BFB7B), UINT64_C(0xD8210BEFD30EFA5A), UINT64_C(0x8714A775E3E95C78),
+    UINT64_C(0xA8D9D1535CE3B396), UINT64_C(0xD31045A8341CA07C), UINT64_C(0x83EA2B892091E44D),
+    UINT64_C(0xA4E4B66B68B65D60), UINT64_C(0xCE1DE40642E3F4B9), UINT64_C(0x80D2AE83E9CE78F3),
+    UINT64_C(0xA1075A24E4421730), UINT64_C(0xC94930AE1D529CFC), UINT64_C(0xFB9B7CD9A4A7443C),
+    UINT64_C(0x9D412E0806E88AA5), UINT64_C(0xC491798A08A2AD4E), UINT64_C(0xF5B5D7EC8ACB58A2),
+    UINT64_C(0x9991A6F3D6BF1765), UINT64_C(0xBFF610B0CC6EDD3F), UINT64_C(0xEFF394DCFF8A948E),
+    UINT64_C(0x95F83D0A1FB69CD9), UINT64_C(0xBB764C4CA7A4440F), UINT64_C(0xEA53DF5FD18D5513),
+    UINT64_C(0x92746B9BE2F8552C), UINT64_C(0xB7118682DBB66A77), UINT64_C(0xE4D5E82392A40515),
+    UINT64_C(0x8F05B1163BA6832D), UINT64_C(0xB2C71D5BCA9023F8), UINT64_C(0xDF78E4B2BD342CF6),
+    UINT64_C(0x8BAB8EEFB6409C1A), UINT64_C(0xAE9672ABA3D0C320), UINT64_C(0xDA3C0F568CC4F3E8),
+    UINT64_C(0x8865899617FB1871), UINT64_C(0xAA7EEBFB9DF9DE8D), UINT64_C(0xD51EA6FA85785631),
+    UINT64_C(0x8533285C936B35DE), UINT64_C(0xA67FF273B8460356), UINT64_C(0xD01FEF10A657842C),
+    UINT64_C(0x8213F56A67F6B29B), UINT64_C(0xA298F2C501F45F42), UINT64_C(0xCB3F2F7642717713),
+    UINT64_C(0xFE0EFB53D30DD4D7), UINT64_C(0x9EC95D1463E8A506), UINT64_C(0xC67BB4597CE2CE48),
+    UINT64_C(0xF81AA16FDC1B81DA), UINT64_C(0x9B10A4E5E9913128), UINT64_C(0xC1D4CE1F63F57D72),
+    UINT64_C(0xF24A01A73CF2DCCF), UINT64_C(0x976E41088617CA01), UINT64_C(0xBD49D14AA79DBC82),
+    UINT64_C(0xEC9C459D51852BA2), UINT64_C(0x93E1AB8252F33B45), UINT64_C(0xB8DA1662E7B00A17),
+    UINT64_C(0xE7109BFBA19C0C9D), UINT64_C(0x906A617D450187E2), UINT64_C(0xB484F9DC9641E9DA),
+    UINT64_C(0xE1A63853BBD26451), UINT64_C(0x8D07E33455637EB2), UINT64_C(0xB049DC016ABC5E5F),
+    UINT64_C(0xDC5C5301C56B75F7), UINT64_C(0x89B9B3E11B6329BA), UINT64_C(0xAC2820D9623BF429),
+    UINT64_C(0xD732290FBACAF133), UINT64_C(0x867F59A9D4BED6C0), UINT64_C(0xA81F301449EE8C70),
+    UINT64_C(0xD226FC195C6A2F8C), UINT64_C(0x83585D8FD9C25DB7), UINT64_C(0xA42E74F3D032F525),
+    UINT64_C(0xCD3A1230C43FB26F), UINT64_C(0x80444B5E7AA7CF85), UINT64_C(0xA0555E361951C366),
+    UINT64_C(0xC86AB5C39FA63440), UINT64_C(0xFA856334878FC150), UINT64_C(0x9C935E00D4B9D8D2),
+    UINT64_C(0xC3B8358109E84F07), UINT64_C(0xF4A642E14C6262C8), UINT64_C(0x98E7E9CCCFBD7DBD),
+    UINT64_C(0xBF21E44003ACDD2C), UINT64_C(0xEEEA5D5004981478), UINT64_C(0x95527A5202DF0CCB),
+    UINT64_C(0xBAA718E68396CFFD), UINT64_C(0xE950DF20247C83FD), UINT64_C(0x91D28B7416CDD27E),
+    UINT64_C(0xB6472E511C81471D), UINT64_C(0xE3D8F9E563A198E5), UINT64_C(0x8E679C2F5E44FF8F)
+};
+#endif
+
+#define JM_NUMBER_IS_SPACE(c) (((c) == ' ') || ((c) == '\t') || ((c) == '\n') || ((c) == '\r'))
+
+/* Value of a decimal digit or a number larger than 9 for any other character */
+#define JM_NUMBER_DIGIT(c) ((unsigned)(unsigned char)(c) - (unsigned)'0')
+
+static const char* jm_number_skip_space(const char* p) {
+    while(JM_NUMBER_IS_SPACE(*p)) p++;
+    return p;
+}
+
+/* Case insensitive match of a lower case word. Returns the end of the word in str or NULL. */
+static const char* jm_number_match_word(const char* str, const char* word) {
+    while(*word) {
+        char c = *str;
+        if((c >= 'A') && (c <= 'Z')) c = (char)(c - 'A' + 'a');
+        if(c != *word) return 0;
+        str++;
+        word++;
+    }
+    return str;
+}
+
+/* Parse the digits of an integer. The first nine digits cannot overflow and are
+   collected without any checks. Returns the end of the digits or NULL if the value
+   is above limit. */
+static const char* jm_number_parse_digits(const char* p, unsigned long limit, unsigned long* val) {
+    unsigned long v = 0;
+    unsigned d;
+    int i;
+
+    for(i = 0; i < 9; i++) {
+        d = JM_NUMBER_DIGIT(*p);
+        if(d > 9) break;
+        v = v * 10 + d;
+        p++;
+    }
+    if(i == 9) {
+        while((d = JM_NUMBER_DIGIT(*p)) <= 9) {
+            if(v > (limit - d) / 10) return 0;
+            v = v * 10 + d;
+            p++;
+        }
+    }
+    if(v > limit) return 0;
+    *val = v;
+    return p;
+}
+
+jm_status_enu_t jm_parse_uint(const char* str, unsigned int* val) {
+    const char* p = jm_number_skip_space(str);
+    const char* start;
+    unsigned long v;
+
+    if(*p == '+') p++;
+    start = p;
+    p = jm_number_parse_digits(p, UINT_MAX, &v);
+    if(!p || (p == start)) return jm_status_error;
+    if(*jm_number_skip_space(p)) return jm_status_error;
+    *val = (unsigned int)v;
+    return jm_status_success;
+}
+
+jm_status_enu_t jm_parse_int(const char* str, int* val) {
+    const char* p = jm_number_skip_space(str);
+    const char* start;
+    unsigned long v;
+    int negative = 0;
+
+    if((*p == '-') || (*p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    start = p;
+    p = jm_number_parse_digits(p, negative ? (unsigned long)INT_MAX + 1 : (unsigned long)INT_MAX, &v);
+    if(!p || (p == start)) return jm_status_error;
+    if(*jm_number_skip_space(p)) return jm_status_error;
+    if(negative) {
+        /* -INT_MIN does not fit in an int */
+        *val = (v == (unsigned long)INT_MAX + 1) ? INT_MIN : -(int)v;
+    }
+    else {
+        *val = (int)v;
+    }
+    return jm_status_success;
+}
+
+#if JM_NUMBER_EISEL_LEMIRE
+/* Full 128-bit product of two 64-bit integers from 32-bit halves */
+static void jm_number_mul64(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+    uint64_t aLo = a & 0xFFFFFFFFU, aHi = a >> 32;
+    uint64_t bLo = b & 0xFFFFFFFFU, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFU) + (hl & 0xFFFFFFFFU);
+
+    *lo = (mid << 32) | (ll & 0xFFFFFFFFU);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/*
+    Eisel-Lemire conversion of a non-zero w * 10^q to the nearest double. Only the upper 64 bits of the
+    power of ten are used: the cases that would need the lower bits to be decided, as well as halfway
+    cases, subnormal results and overflow, return 0 and are left to strtod().
+*/
+static int jm_number_eisel_lemire(uint64_t w, long q, double* val) {
+    uint64_t hi, lo, mantissa, bits;
+    long exp2;
+    int lz = 0, msb;
+
+    if((q < JM_NUMBER_MIN_POW10_64) || (q > JM_NUMBER_MAX_POW10_64)) return 0;
+
+    /* normalize the mantissa */
+    if(!(w >> 32)) { w <<= 32; lz += 32; }
+    if(!(w >> 48)) { w <<= 16; lz += 16; }
+    if(!(w >> 56)) { w <<= 8; lz += 8; }
+    if(!(w >> 60)) { w <<= 4; lz += 4; }
+    if(!(w >> 62)) { w <<= 2; lz += 2; }
+    if(!(w >> 63)) { w <<= 1; lz += 1; }
+    /* floor(q * log2(10)) for the range of the table */
+    exp2 = (q >= 0) ? ((217706L * q) >> 16) : -((-217706L * q + 65535L) >> 16);
+    exp2 += 64 + 1023 - lz;
+
+    jm_number_mul64(w, jm_number_pow10_64[q - JM_NUMBER_MIN_POW10_64], &hi, &lo);
+    /* the lower bits of the power of ten could carry into the bits that decide the rounding */
+    if(((hi & 0x1FF) == 0x1FF) && (lo + w < w)) return 0;
+
+    /* 54 bits, one more than the result for the rounding */
+    msb = (int)(hi >> 63);
+    mantissa = hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+    /* possibly halfway between two doubles */
+    if((lo == 0) && ((hi & 0x1FF) == 0) && ((mantissa & 3) == 1)) return 0;
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if(mantissa >> 53) {
+        mantissa >>= 1;
+        exp2++;
+    }
+    if((exp2 < 1) || (exp2 >= 0x7FF)) return 0;
+
+    bits = ((uint64_t)exp2 << 52) | (mantissa & ((UINT64_C(1) << 52) - 1));
+    memcpy(val, &bits, sizeof(double));
+    return 1;
+}
+#endif
+
+/* Convert with strtod(). The syntax is already checked, only the decimal point is replaced
+   by the one of the current locale. */
+static jm_status_enu_t jm_number_strtod(const char* start, const char* end, double* val) {
+    char buffer[JM_NUMBER_BUFFER_SIZE];
+    const char* point = localeconv()->decimal_point;
+    size_t pointLen = strlen(point);
+    size_t len = 0, size = (size_t)(end - start) + pointLen + 1;
+    char* copy = buffer;
+    char* copyEnd;
+    jm_callbacks* cb = 0;
+    const char* p;
+
+    if(size > JM_NUMBER_BUFFER_SIZE) {
+        cb = jm_get_default_callbacks();
+        copy = (char*)cb->malloc(size);
+        if(!copy) return jm_status_error;
+    }
+    for(p = start; p < end; p++) {
+        if(*p == '.') {
+            memcpy(copy + len, point, pointLen);
+            len += pointLen;
+        }
+        else {
+            copy[len++] = *p;
+        }
+    }
+    copy[len] = 0;
+    *val = strtod(copy, &copyEnd);
+    if(cb) cb->free(copy);
+    return (copyEnd == copy + len) ? jm_status_success : jm_status_error;
+}
+
+jm_status_enu_t jm_parse_double(const char* str, double* val) {
+    const char* p = jm_number_skip_space(str);
+    const char* start = p;
+    const char* end;
+    jm_number_mantissa_t mantissa = 0;
+    double result;
+    int negative = 0, exact = 1, hasDigits = 0, nDigits = 0;
+    long exponent = 0;
+    unsigned d;
+
+    if((*p == '-') || (*p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    /* special values */
+    end = jm_number_match_word(p, "inf");
+    if(end) {
+        const char* longer = jm_number_match_word(end, "inity");
+        if(longer) end = longer;
+        if(*jm_number_skip_space(end)) return jm_status_error;
+        *val = negative ? -HUGE_VAL : HUGE_VAL;
+        return jm_status_success;
+    }
+    end = jm_number_match_word(p, "nan");
+    if(end) {
+        volatile double inf = HUGE_VAL;
+        if(*jm_number_skip_space(end)) return jm_status_error;
+        *val = inf - inf;
+        return jm_status_success;
+    }
+
+    /* integer part, leading zeros are skipped */
+    while((d = JM_NUMBER_DIGIT(*p)) <= 9) {
+        hasDigits = 1;
+        if(nDigits < JM_NUMBER_MAX_DIGITS) {
+            if(nDigits || d) {
+                mantissa = mantissa * 10 + d;
+                nDigits++;
+            }
+        }
+        else {
+            if(d) exact = 0;
+            exponent++;
+        }
+        p++;
+    }
+    /* fraction */
+    if(*p == '.') {
+        p++;
+        while((d = JM_NUMBER_DIGIT(*p)) <= 9) {
+            hasDigits = 1;
+            if(nDigits < JM_NUMBER_MAX_DIGITS) {
+                if(nDigits || d) {
+                    mantissa = mantissa * 10 + d;
+                    nDigits++;
+                }
+                exponent--;
+            }
+            else if(d) {
+                exact = 0;
+            }
+            p++;
+        }
+    }
+    if(!hasDigits) return jm_status_error;
+    /* exponent */
+    if((*p == 'e') || (*p == 'E')) {
+        long e = 0;
+        int negativeExp = 0;
+        p++;
+        if((*p == '-') || (*p == '+')) {
+            negativeExp = (*p == '-');
+            p++;
+        }
+        if(JM_NUMBER_DIGIT(*p) > 9) return jm_status_error;
+        while((d = JM_NUMBER_DIGIT(*p)) <= 9) {
+            if(e < JM_NUMBER_MAX_EXPONENT) e = e * 10 + (long)d;
+            p++;
+        }
+        exponent += negativeExp ? -e : e;
+    }
+    end = p;
+    if(*jm_number_skip_space(p)) return jm_status_error;
+
+    if(mantissa == 0) {
+        *val = negative ? -0.0 : 0.0;
+        return jm_status_success;
+    }
+
+    /* Clinger's fast path: the mantissa and the power of ten are exact so the single
+       multiplication or division is correctly rounded */
+    if(JM_NUMBER_FAST_PATH && exact && (mantissa <= (jm_number_mantissa_t)9007199254740992.0)) {
+        double m = (double)mantissa;
+        if((exponent >= 0) && (exponent <= JM_NUMBER_MAX_POW10)) {
+            result = m * jm_number_pow10[exponent];
+            *val = negative ? -result : result;
+            return jm_status_success;
+        }
+        if((exponent < 0) && (exponent >= -JM_NUMBER_MAX_POW10)) {
+            result = m / jm_number_pow10[-exponent];
+            *val = negative ? -result : result;
+            return jm_status_success;
+        }
+        if((exponent > JM_NUMBER_MAX_POW10) && (exponent <= JM_NUMBER_MAX_POW10 + JM_NUMBER_MAX_DIGITS)) {
+            /* move some of the exponent into the mantissa if it stays exact */
+            m *= jm_number_pow10[exponent - JM_NUMBER_MAX_POW10];
+            if(m < 9007199254740992.0) {
+                result = m * jm_number_pow10[JM_NUMBER_MAX_POW10];
+                *val = negative ? -result : result;
+                return jm_status_success;
+            }
+        }
+    }
+#if JM_NUMBER_EISEL_LEMIRE
+    /* With dropped digits the value lies between mantissa and mantissa + 1 units, the
+       result is known if both round to the same double */
+    if(jm_number_eisel_lemire(mantissa, exponent, &result)) {
+        double upper;
+        if(exact || (jm_number_eisel_lemire(mantissa + 1, exponent, &upper) && (upper == result))) {
+            *val = negative ? -result : result;
+            return jm_status_success;
+        }
+    }
+#endif
+    return jm_number_strtod(start, end, val);
+}
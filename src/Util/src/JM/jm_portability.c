@@ -13,6 +13,11 @@
     along with this program. If not, contact Modelon AB <http://www.modelon.com>.
 */
 
+/* memfd_create and nftw are not visible in strict C89 mode otherwise */
+#if !defined(WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <locale.h>
@@ -48,6 +53,52 @@ DLL_HANDLE jm_portability_load_dll_handle(const char* dll_file_path)
 #endif
 }
 
+#ifdef JM_HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+
+DLL_HANDLE jm_portability_load_dll_handle_from_memory(const char* name, size_t size, jm_dll_image_fill_ft fill, void* data, int* memory_file)
+{
+	char path[100];
+	void* image;
+	DLL_HANDLE handle = 0;
+	int fd = memfd_create(name, MFD_CLOEXEC);
+
+	*memory_file = -1;
+	if(fd < 0) return 0;
+	/* The library is written straight into the pages of the memory file */
+	image = (size && (ftruncate(fd, (off_t)size) == 0)) ? mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	if(image != MAP_FAILED) {
+		jm_status_enu_t status = fill((char*)image, size, data);
+		munmap(image, size);
+		if(status == jm_status_success) {
+			jm_snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+			handle = dlopen(path, RTLD_NOW|RTLD_LOCAL);
+		}
+	}
+	/* The loader identifies libraries by path, so the descriptor is kept open while the library
+	   is loaded. Otherwise the next memory file would get the same path and dlopen would return
+	   the library that is already loaded from it. */
+	if(handle) *memory_file = fd;
+	else close(fd);
+	return handle;
+}
+
+void jm_portability_close_memory_file(int memory_file)
+{
+	if(memory_file >= 0) close(memory_file);
+}
+#else
+DLL_HANDLE jm_portability_load_dll_handle_from_memory(const char* name, size_t size, jm_dll_image_fill_ft fill, void* data, int* memory_file)
+{
+	*memory_file = -1;
+	return 0;
+}
+
+void jm_portability_close_memory_file(int memory_file)
+{
+}
+#endif
+
 jm_status_enu_t jm_portability_free_dll_handle(DLL_HANDLE dll_handle)
 {	
 #ifdef WIN32		
@@ -163,36 +214,84 @@ jm_status_enu_t jm_mkdir(jm_callbacks* cb, const char* dir) {
 }
 
 
+#ifdef WIN32
+/* Remove the contents of a directory depth first. path has room for MAX_PATH characters and is restored on return. */
+static int jm_rmdir_contents(char* path) {
+	WIN32_FIND_DATAA data;
+	HANDLE h;
+	size_t len = strlen(path);
+	int ret = 0;
+
+	if(len + 3 > MAX_PATH) return -1;
+	strcpy(path + len, "\\*");
+	h = FindFirstFileA(path, &data);
+	path[len] = 0;
+	if(h == INVALID_HANDLE_VALUE) return 0;
+	do {
+		if(!strcmp(data.cFileName, ".") || !strcmp(data.cFileName, "..")) continue;
+		if(len + strlen(data.cFileName) + 2 > MAX_PATH) {
+			ret = -1;
+			break;
+		}
+		path[len] = '\\';
+		strcpy(path + len + 1, data.cFileName);
+		if(data.dwFileAttributes & FILE_ATTRIBUTE_READONLY) {
+			SetFileAttributesA(path, data.dwFileAttributes & ~FILE_ATTRIBUTE_READONLY);
+		}
+		if((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && !(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+			if(jm_rmdir_contents(path) || !RemoveDirectoryA(path)) ret = -1;
+		}
+		else if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			/* Junctions are removed without following them */
+			if(!RemoveDirectoryA(path)) ret = -1;
+		}
+		else if(!DeleteFileA(path)) ret = -1;
+		path[len] = 0;
+	} while(!ret && FindNextFileA(h, &data));
+	FindClose(h);
+	return ret;
+}
+#else
+#include <ftw.h>
+
+static int jm_rmdir_entry(const char* path, const struct stat* st, int type, struct FTW* ftw) {
+	return remove(path);
+}
+#endif
+
 jm_status_enu_t jm_rmdir(jm_callbacks* cb, const char* dir) {
-#ifdef WIN32
-	const char* fmt_cmd = "rmdir /s /q %s";
-#else
-    const char* fmt_cmd = "rm -rf %s";
-#endif
-    char * buf = (char*)cb->calloc(sizeof(char), strlen(dir)+strlen(fmt_cmd)+1);
+	int failed;
 	if(!cb) {
 		cb = jm_get_default_callbacks();
 	}
-	if(!buf) {
-	    jm_log_error(cb,module,"Could not allocate memory");
-		return jm_status_error;
-	}
-    sprintf(buf, fmt_cmd, dir);/*safe*/
-#ifdef WIN32
-	{
-		char* ch = buf+strlen(fmt_cmd) - 2;
-		while(*ch) {
-			if(*ch == '/') *ch = '\\';
-			ch++;
-		}
-	}
-#endif
-    jm_log_verbose(cb,module,"Removing %s", dir);
-    if(system(buf)) {
-	    jm_log_error(cb,module,"Error removing %s (%s)", dir, strerror(errno));
+	jm_log_verbose(cb,module,"Removing %s", dir);
+#ifdef WIN32
+	{
+		char path[MAX_PATH + 1];
+		char* ch;
+		if(strlen(dir) > MAX_PATH - 3) {
+			jm_log_error(cb,module,"Error removing %s (path is too long)", dir);
+			return jm_status_error;
+		}
+		strcpy(path, dir);
+		for(ch = path; *ch; ch++) {
+			if(*ch == '/') *ch = '\\';
+		}
+		if(GetFileAttributesA(path) == INVALID_FILE_ATTRIBUTES) return jm_status_success;
+		failed = jm_rmdir_contents(path) || !RemoveDirectoryA(path);
+	}
+#else
+	/* Depth first without following symbolic links. Like rm -rf, a missing directory is not an error. */
+	failed = nftw(dir, jm_rmdir_entry, 16, FTW_DEPTH | FTW_PHYS) && (errno != ENOENT);
+#endif
+	if(failed) {
+#ifdef WIN32
+		jm_log_error(cb,module,"Error removing %s (error code %lu)", dir, (unsigned long)GetLastError());
+#else
+		jm_log_error(cb,module,"Error removing %s (%s)", dir, strerror(errno));
+#endif
 		return jm_status_error;
 	}
-    cb->free(buf);
 	return jm_status_success;
 }
 
@@ -344,4 +443,232 @@ char* jm_create_URL_from_abs_path(jm_callbacks* cb, const char* path) {
     ret = rpl_vsnprintf(str, size, fmt, args);
     va_end (args);
     return ret;
- }
\ No newline at end of file
+ }
+
+#ifdef WIN32
+struct jm_thread_t {
+	jm_callbacks* cb;
+	HANDLE handle;
+	jm_thread_func_ft func;
+	void* data;
+};
+
+struct jm_mutex_t {
+	jm_callbacks* cb;
+	CRITICAL_SECTION cs;
+};
+
+static DWORD WINAPI jm_thread_start_routine(LPVOID arg) {
+	jm_thread_t* thread = (jm_thread_t*)arg;
+	thread->func(thread->data);
+	return 0;
+}
+#else
+#include <pthread.h>
+
+struct jm_thread_t {
+	jm_callbacks* cb;
+	pthread_t handle;
+	jm_thread_func_ft func;
+	void* data;
+};
+
+struct jm_mutex_t {
+	jm_callbacks* cb;
+	pthread_mutex_t mutex;
+};
+
+static void* jm_thread_start_routine(void* arg) {
+	jm_thread_t* thread = (jm_thread_t*)arg;
+	thread->func(thread->data);
+	return 0;
+}
+#endif
+
+jm_thread_t* jm_thread_create(jm_callbacks* cb, jm_thread_func_ft func, void* data) {
+	jm_thread_t* thread;
+	int failed;
+	if(!cb) {
+		cb = jm_get_default_callbacks();
+	}
+	thread = (jm_thread_t*)cb->malloc(sizeof(jm_thread_t));
+	if(!thread) {
+		jm_log_error(cb, module, "Could not allocate memory");
+		return 0;
+	}
+	thread->cb = cb;
+	thread->func = func;
+	thread->data = data;
+#ifdef WIN32
+	thread->handle = CreateThread(NULL, 0, jm_thread_start_routine, thread, 0, NULL);
+	failed = (thread->handle == NULL);
+#else
+	failed = pthread_create(&thread->handle, 0, jm_thread_start_routine, thread);
+#endif
+	if(failed) {
+		jm_log_error(cb, module, "Could not start a new thread");
+		cb->free(thread);
+		return 0;
+	}
+	return thread;
+}
+
+jm_status_enu_t jm_thread_join(jm_thread_t* thread) {
+	jm_status_enu_t status = jm_status_success;
+#ifdef WIN32
+	if(WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) status = jm_status_error;
+	CloseHandle(thread->handle);
+#else
+	if(pthread_join(thread->handle, 0)) status = jm_status_error;
+#endif
+	thread->cb->free(thread);
+	return status;
+}
+
+jm_mutex_t* jm_mutex_create(jm_callbacks* cb) {
+	jm_mutex_t* mutex;
+	if(!cb) {
+		cb = jm_get_default_callbacks();
+	}
+	mutex = (jm_mutex_t*)cb->malloc(sizeof(jm_mutex_t));
+	if(!mutex) {
+		jm_log_error(cb, module, "Could not allocate memory");
+		return 0;
+	}
+	mutex->cb = cb;
+#ifdef WIN32
+	InitializeCriticalSection(&mutex->cs);
+#else
+	if(pthread_mutex_init(&mutex->mutex, 0)) {
+		jm_log_error(cb, module, "Could not initialize a mutex");
+		cb->free(mutex);
+		return 0;
+	}
+#endif
+	return mutex;
+}
+
+void jm_mutex_lock(jm_mutex_t* mutex) {
+#ifdef WIN32
+	EnterCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+void jm_mutex_unlock(jm_mutex_t* mutex) {
+#ifdef WIN32
+	LeaveCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+void jm_mutex_free(jm_mutex_t* mutex) {
+	if(!mutex) return;
+#ifdef WIN32
+	DeleteCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_destroy(&mutex->mutex);
+#endif
+	mutex->cb->free(mutex);
+}
+
+/* Directories waiting to be removed by the cleanup thread */
+typedef struct jm_rmdir_queue_item_t {
+	struct jm_rmdir_queue_item_t* next;
+	char dir[1];
+} jm_rmdir_queue_item_t;
+
+static jm_rmdir_queue_item_t* jm_rmdir_queue_head = 0;
+static jm_rmdir_queue_item_t* jm_rmdir_queue_tail = 0;
+static jm_thread_t* jm_rmdir_queue_thread = 0;
+static int jm_rmdir_queue_running = 0;
+
+/* The queue lock is statically initialized since the queue may be first used from several threads */
+#ifdef WIN32
+static SRWLOCK jm_rmdir_queue_lock = SRWLOCK_INIT;
+#define jm_rmdir_queue_lock() AcquireSRWLockExclusive(&jm_rmdir_queue_lock)
+#define jm_rmdir_queue_unlock() ReleaseSRWLockExclusive(&jm_rmdir_queue_lock)
+#else
+static pthread_mutex_t jm_rmdir_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define jm_rmdir_queue_lock() pthread_mutex_lock(&jm_rmdir_queue_mutex)
+#define jm_rmdir_queue_unlock() pthread_mutex_unlock(&jm_rmdir_queue_mutex)
+#endif
+
+/* Remove queued directories until the queue is empty */
+static void jm_rmdir_queue_worker(void* data) {
+	jm_callbacks* cb = jm_get_default_callbacks();
+	while(1) {
+		jm_rmdir_queue_item_t* item;
+		jm_rmdir_queue_lock();
+		item = jm_rmdir_queue_head;
+		if(item) {
+			jm_rmdir_queue_head = item->next;
+			if(!jm_rmdir_queue_head) jm_rmdir_queue_tail = 0;
+		}
+		else {
+			jm_rmdir_queue_running = 0;
+		}
+		jm_rmdir_queue_unlock();
+		if(!item) break;
+		jm_rmdir(cb, item->dir);
+		cb->free(item);
+	}
+}
+
+jm_status_enu_t jm_rmdir_async(jm_callbacks* cb, const char* dir) {
+	jm_callbacks* defaultCb = jm_get_default_callbacks();
+	jm_rmdir_queue_item_t* item;
+	int runHere = 0;
+
+	if(!cb) {
+		cb = defaultCb;
+	}
+	/* Items outlive the callbacks of the caller so the default ones are used */
+	item = (jm_rmdir_queue_item_t*)defaultCb->malloc(sizeof(jm_rmdir_queue_item_t) + strlen(dir));
+	if(!item) {
+		return jm_rmdir(cb, dir);
+	}
+	item->next = 0;
+	strcpy(item->dir, dir);
+	jm_log_verbose(cb,module,"Scheduling removal of %s", dir);
+
+	jm_rmdir_queue_lock();
+	if(jm_rmdir_queue_tail) jm_rmdir_queue_tail->next = item;
+	else jm_rmdir_queue_head = item;
+	jm_rmdir_queue_tail = item;
+	if(!jm_rmdir_queue_running) {
+		/* The previous worker has emptied the queue and is about to exit */
+		if(jm_rmdir_queue_thread) jm_thread_join(jm_rmdir_queue_thread);
+		jm_rmdir_queue_thread = jm_thread_create(defaultCb, jm_rmdir_queue_worker, 0);
+		jm_rmdir_queue_running = 1;
+		runHere = (jm_rmdir_queue_thread == 0);
+	}
+	jm_rmdir_queue_unlock();
+
+	if(runHere) {
+		jm_rmdir_queue_worker(0);
+	}
+	return jm_status_success;
+}
+
+void jm_rmdir_async_wait(void) {
+	jm_thread_t* thread;
+	jm_rmdir_queue_lock();
+	thread = jm_rmdir_queue_thread;
+	jm_rmdir_queue_thread = 0;
+	jm_rmdir_queue_unlock();
+	if(thread) jm_thread_join(thread);
+}
+
+unsigned int jm_get_number_of_processors(void) {
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0) ? (unsigned int)info.dwNumberOfProcessors : 1;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (unsigned int)n : 1;
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <string.h>
+#include "JM/jm_string_intern.h"
+#include "JM/jm_hash.h"
+
+/* Initial number of slots. The table is kept at most half full. */
+#define JM_STRING_INTERN_MIN_CAPACITY 64
+
+void jm_string_intern_init(jm_string_intern_t* s, jm_callbacks* c) {
+    s->callbacks = c ? c : jm_get_default_callbacks();
+    jm_arena_init(&s->strings, 0, s->callbacks);
+    s->slots = 0;
+    s->capacity = 0;
+    s->count = 0;
+}
+
+/* Slot holding the string or the empty slot where it should be inserted */
+static jm_string_intern_slot_t* jm_string_intern_lookup(jm_string_intern_t* s, jm_string str, unsigned int hash) {
+    size_t mask = s->capacity - 1;
+    size_t i = hash & mask;
+    while(s->slots[i].str) {
+        if((s->slots[i].hash == hash) && (strcmp(s->slots[i].str, str) == 0)) break;
+        i = (i + 1) & mask;
+    }
+    return &s->slots[i];
+}
+
+static int jm_string_intern_grow(jm_string_intern_t* s) {
+    size_t capacity = s->capacity ? 2 * s->capacity : JM_STRING_INTERN_MIN_CAPACITY;
+    jm_string_intern_slot_t* old = s->slots;
+    size_t old_capacity = s->capacity;
+    size_t i;
+
+    s->slots = (jm_string_intern_slot_t*)s->callbacks->calloc(capacity, sizeof(jm_string_intern_slot_t));
+    if(!s->slots) {
+        s->slots = old;
+        return 0;
+    }
+    s->capacity = capacity;
+    for(i = 0; i < old_capacity; i++) {
+        if(old[i].str) {
+            *jm_string_intern_lookup(s, old[i].str, old[i].hash) = old[i];
+        }
+    }
+    s->callbacks->free(old);
+    return 1;
+}
+
+jm_string jm_string_intern_find(jm_string_intern_t* s, jm_string str) {
+    size_t len;
+    if(!s->count) return 0;
+    return jm_string_intern_lookup(s, str, jm_hash_string(str, JM_HASH_SEED, &len))->str;
+}
+
+jm_string jm_string_intern_put(jm_string_intern_t* s, jm_string str) {
+    size_t len;
+    unsigned int hash = jm_hash_string(str, JM_HASH_SEED, &len);
+    jm_string_intern_slot_t* slot;
+
+    if((2 * (s->count + 1) > s->capacity) && !jm_string_intern_grow(s)) return 0;
+    slot = jm_string_intern_lookup(s, str, hash);
+    if(!slot->str) {
+        char* copy = jm_arena_strndup(&s->strings, str, len);
+        if(!copy) return 0;
+        slot->str = copy;
+        slot->hash = hash;
+        s->count++;
+    }
+    return slot->str;
+}
+
+void jm_string_intern_free_data(jm_string_intern_t* s) {
+    s->callbacks->free(s->slots);
+    jm_arena_free_data(&s->strings);
+    s->slots = 0;
+    s->capacity = 0;
+    s->count = 0;
+}
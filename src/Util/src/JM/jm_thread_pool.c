@@ -0,0 +1,244 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#include <string.h>
+#include "JM/jm_thread_pool.h"
+
+static const char* module = "JMPOOL";
+
+struct jm_thread_pool_t {
+    jm_callbacks* callbacks;
+    unsigned int numThreads;
+    jm_mutex_t* lock; /* protects next, NULL when there is a single thread */
+    jm_thread_t** threads; /* the worker threads of the running batch, numThreads - 1 */
+
+    /* the running batch */
+    jm_task_t* tasks;
+    size_t numTasks;
+    size_t next;
+};
+
+jm_thread_pool_t* jm_thread_pool_create(jm_callbacks* cb, unsigned int numThreads) {
+    jm_thread_pool_t* pool;
+    if(!cb) {
+        cb = jm_get_default_callbacks();
+    }
+    if(numThreads == 0) numThreads = jm_get_number_of_processors();
+    pool = (jm_thread_pool_t*)cb->calloc(1, sizeof(jm_thread_pool_t));
+    if(!pool) {
+        jm_log_fatal(cb, module, "Could not allocate memory");
+        return 0;
+    }
+    pool->callbacks = cb;
+    pool->numThreads = 1;
+    if(numThreads > 1) {
+        pool->threads = (jm_thread_t**)cb->calloc(numThreads - 1, sizeof(jm_thread_t*));
+        pool->lock = pool->threads ? jm_mutex_create(cb) : 0;
+        if(!pool->lock) {
+            jm_thread_pool_free(pool);
+            jm_log_fatal(cb, module, "Could not allocate memory");
+            return 0;
+        }
+        pool->numThreads = numThreads;
+    }
+    return pool;
+}
+
+void jm_thread_pool_free(jm_thread_pool_t* pool) {
+    if(!pool) return;
+    if(pool->lock) jm_mutex_free(pool->lock);
+    pool->callbacks->free(pool->threads);
+    pool->callbacks->free(pool);
+}
+
+unsigned int jm_thread_pool_get_size(jm_thread_pool_t* pool) {
+    return pool ? pool->numThreads : 1;
+}
+
+/* Body of the worker threads, also run by the calling thread */
+static void jm_thread_pool_worker(void* data) {
+    jm_thread_pool_t* pool = (jm_thread_pool_t*)data;
+    for(;;) {
+        jm_task_t* task = 0;
+        jm_mutex_lock(pool->lock);
+        if(pool->next < pool->numTasks) {
+            task = &pool->tasks[pool->next++];
+        }
+        jm_mutex_unlock(pool->lock);
+        if(!task) break;
+        task->func(task->data);
+    }
+}
+
+void jm_thread_pool_run(jm_thread_pool_t* pool, jm_task_t* tasks, size_t numTasks) {
+    size_t i, numWorkers;
+
+    if(!pool || (pool->numThreads < 2) || (numTasks < 2)) {
+        for(i = 0; i < numTasks; i++) {
+            tasks[i].func(tasks[i].data);
+        }
+        return;
+    }
+    pool->tasks = tasks;
+    pool->numTasks = numTasks;
+    pool->next = 0;
+
+    numWorkers = ((numTasks < pool->numThreads) ? numTasks : pool->numThreads) - 1;
+    for(i = 0; i < numWorkers; i++) {
+        pool->threads[i] = jm_thread_create(pool->callbacks, jm_thread_pool_worker, pool);
+        if(!pool->threads[i]) break;
+    }
+    /* The calling thread acts as the first worker */
+    jm_thread_pool_worker(pool);
+    while(i-- > 0) {
+        jm_thread_join(pool->threads[i]);
+    }
+    pool->tasks = 0;
+    pool->numTasks = 0;
+}
+
+/* One task of jm_thread_pool_sort(): sorting or merging the items [begin, end) of an array from src into dst */
+typedef struct jm_parallel_sort_task_t {
+    jm_parallel_sort_t* sort;
+    char* src;
+    char* dst;
+    size_t begin, middle, end; /* the merged parts are [begin, middle) and [middle, end) */
+} jm_parallel_sort_task_t;
+
+/* Progress of one array in jm_thread_pool_sort() */
+typedef struct jm_parallel_sort_state_t {
+    char* buffer;
+    char* src; /* where the sorted parts are */
+    char* dst;
+    size_t numChunks;
+} jm_parallel_sort_state_t;
+
+/* Start of the chunk number i of n items split into numChunks parts: i * n / numChunks without overflow */
+static size_t jm_parallel_sort_bound(size_t n, size_t numChunks, size_t i) {
+    if(i >= numChunks) return n;
+    return (n / numChunks) * i + (n % numChunks) * i / numChunks;
+}
+
+static void jm_parallel_sort_chunk_task(void* data) {
+    jm_parallel_sort_task_t* t = (jm_parallel_sort_task_t*)data;
+    size_t size = t->sort->itemSize;
+    t->sort->sortChunk(t->src + t->begin * size, t->dst + t->begin * size, t->end - t->begin, t->sort->context);
+}
+
+static void jm_parallel_sort_merge_task(void* data) {
+    jm_parallel_sort_task_t* t = (jm_parallel_sort_task_t*)data;
+    size_t size = t->sort->itemSize;
+    if(t->middle == t->end) {
+        /* an odd part without a pair is moved as is */
+        memcpy(t->dst + t->begin * size, t->src + t->begin * size, (t->end - t->begin) * size);
+    }
+    else {
+        t->sort->merge(t->src + t->begin * size, t->middle - t->begin, t->src + t->middle * size, t->end - t->middle,
+                       t->dst + t->begin * size, t->sort->context);
+    }
+}
+
+jm_status_enu_t jm_thread_pool_sort(jm_thread_pool_t* pool, jm_parallel_sort_t* sorts, size_t numSorts) {
+    jm_callbacks* cb = pool ? pool->callbacks : jm_get_default_callbacks();
+    size_t numThreads = jm_thread_pool_get_size(pool);
+    jm_parallel_sort_state_t* states;
+    jm_parallel_sort_task_t* runs;
+    jm_task_t* tasks;
+    size_t s, i, width, numTasks, totalChunks = 0;
+    jm_status_enu_t status = jm_status_success;
+
+    if(!numSorts) return jm_status_success;
+    states = (jm_parallel_sort_state_t*)cb->calloc(numSorts, sizeof(jm_parallel_sort_state_t));
+    if(!states) {
+        jm_log_fatal(cb, module, "Could not allocate memory");
+        return jm_status_error;
+    }
+    for(s = 0; s < numSorts; s++) {
+        size_t numChunks = sorts[s].numItems / JM_PARALLEL_SORT_MIN_CHUNK;
+        if(numChunks > numThreads) numChunks = numThreads;
+        if(numChunks < 1) numChunks = 1;
+        states[s].numChunks = numChunks;
+        states[s].src = (char*)sorts[s].items;
+        states[s].buffer = (char*)cb->malloc(sorts[s].numItems * sorts[s].itemSize + 1);
+        states[s].dst = states[s].buffer;
+        if(!states[s].buffer) status = jm_status_error;
+        totalChunks += numChunks;
+    }
+    runs = (jm_parallel_sort_task_t*)cb->malloc(totalChunks * sizeof(jm_parallel_sort_task_t));
+    tasks = (jm_task_t*)cb->malloc(totalChunks * sizeof(jm_task_t));
+    if(!runs || !tasks || (status != jm_status_success)) {
+        jm_log_fatal(cb, module, "Could not allocate memory");
+        status = jm_status_error;
+        goto release;
+    }
+
+    /* sort the chunks of all the arrays, using the buffer as scratch */
+    numTasks = 0;
+    for(s = 0; s < numSorts; s++) {
+        size_t n = sorts[s].numItems;
+        for(i = 0; i < states[s].numChunks; i++) {
+            jm_parallel_sort_task_t* t = &runs[numTasks];
+            t->sort = &sorts[s];
+            t->src = states[s].src;
+            t->dst = states[s].dst;
+            t->begin = jm_parallel_sort_bound(n, states[s].numChunks, i);
+            t->end = jm_parallel_sort_bound(n, states[s].numChunks, i + 1);
+            t->middle = t->end;
+            tasks[numTasks].func = jm_parallel_sort_chunk_task;
+            tasks[numTasks].data = t;
+            numTasks++;
+        }
+    }
+    jm_thread_pool_run(pool, tasks, numTasks);
+
+    /* merge the sorted parts pairwise, moving the items between the array and the buffer */
+    for(width = 1;; width *= 2) {
+        numTasks = 0;
+        for(s = 0; s < numSorts; s++) {
+            size_t n = sorts[s].numItems, numChunks = states[s].numChunks;
+            if(numChunks <= width) continue;
+            for(i = 0; i < numChunks; i += 2 * width) {
+                jm_parallel_sort_task_t* t = &runs[numTasks];
+                t->sort = &sorts[s];
+                t->src = states[s].src;
+                t->dst = states[s].dst;
+                t->begin = jm_parallel_sort_bound(n, numChunks, i);
+                t->middle = jm_parallel_sort_bound(n, numChunks, i + width);
+                t->end = jm_parallel_sort_bound(n, numChunks, i + 2 * width);
+                tasks[numTasks].func = jm_parallel_sort_merge_task;
+                tasks[numTasks].data = t;
+                numTasks++;
+            }
+            states[s].dst = states[s].src;
+            states[s].src = (char*)runs[numTasks - 1].dst;
+        }
+        if(!numTasks) break;
+        jm_thread_pool_run(pool, tasks, numTasks);
+    }
+
+    for(s = 0; s < numSorts; s++) {
+        if(states[s].src != (char*)sorts[s].items)
+            memcpy(sorts[s].items, states[s].src, sorts[s].numItems * sorts[s].itemSize);
+    }
+
+release:
+    for(s = 0; s < numSorts; s++) {
+        cb->free(states[s].buffer);
+    }
+    cb->free(states);
+    cb->free(runs);
+    cb->free(tasks);
+    return status;
+}
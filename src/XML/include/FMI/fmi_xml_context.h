@@ -50,6 +50,9 @@ void fmi_xml_free_context(fmi_xml_context_t *context);
 /** \brief Parse XML file to identify FMI standard version (only beginning of the file is parsed). */
 fmi_version_enu_t fmi_xml_get_fmi_version( fmi_xml_context_t*, const char* fileName);
 
+/** \brief Parse XML data in a memory buffer to identify FMI standard version (only beginning of the buffer is parsed). */
+fmi_version_enu_t fmi_xml_get_fmi_version_from_buffer( fmi_xml_context_t*, const char* buffer, size_t size);
+
 /** ModelDescription is the entry point for the package*/
 typedef struct fmi1_xml_model_description_t fmi1_xml_model_description_t;
 typedef struct fmi2_xml_model_description_t fmi2_xml_model_description_t;
@@ -26,6 +26,7 @@
 #include <JM/jm_callbacks.h>
 #include <JM/jm_named_ptr.h>
 #include <FMI/fmi_xml_context.h>
+#include <FMI/fmi_xml_parse_options.h>
 #include <FMI1/fmi1_types.h>
 #include <FMI1/fmi1_enums.h>
 
@@ -114,6 +115,40 @@ fmi1_xml_model_description_t* fmi1_xml_allocate_model_description( jm_callbacks*
 */
 int fmi1_xml_parse_model_description( fmi1_xml_model_description_t* md, const char* fileName);
 
+/**
+   \brief Parse XML data that is already loaded into memory
+   The behaviour is the same as for fmi1_xml_parse_model_description() but no file is accessed.
+
+    @param md A model description object as returned by fmi1_xml_allocate_model_description.
+    @param buffer XML data to be parsed.
+    @param size Size of the XML data in bytes.
+   @return 0 if parsing was successfull. Non-zero value indicates an error.
+*/
+int fmi1_xml_parse_model_description_from_buffer( fmi1_xml_model_description_t* md, const char* buffer, size_t size);
+
+/**
+   \brief Leave sections of the model description out when parsing
+   The elements of the skipped sections are passed over without being processed and the attributes
+   that belong to them are ignored. The setting applies to the following parse calls.
+
+    @param md A model description object as returned by fmi1_xml_allocate_model_description.
+    @param skipSections A combination of ::fmi_xml_section_enu_t flags, 0 parses everything.
+*/
+void fmi1_xml_set_skipped_sections( fmi1_xml_model_description_t* md, unsigned int skipSections);
+
+/**
+   \brief Set the number of threads used for sorting the variables once they are parsed
+   The variables are sorted by name and by value reference at the same time with a parallel merge sort.
+   The resulting order does not depend on the number of threads. The setting applies to the following parse calls.
+
+    @param md A model description object as returned by fmi1_xml_allocate_model_description.
+    @param numThreads Number of threads including the calling one. 0 and 1 sort on the calling thread, which is the default.
+*/
+void fmi1_xml_set_parse_threads( fmi1_xml_model_description_t* md, unsigned int numThreads);
+
+/** \brief Get the sections that are available in the model description, a combination of ::fmi_xml_section_enu_t flags */
+unsigned int fmi1_xml_get_parsed_sections( fmi1_xml_model_description_t* md);
+
 /**
    Clears the data associated with the model description. This is useful if the same object
    instance is used repeatedly to work with different XML files.
@@ -26,6 +26,7 @@
 #include <JM/jm_callbacks.h>
 #include <JM/jm_named_ptr.h>
 #include <FMI/fmi_xml_context.h>
+#include <FMI/fmi_xml_parse_options.h>
 #include <FMI2/fmi2_types.h>
 #include <FMI2/fmi2_enums.h>
 #include <FMI2/fmi2_xml_callbacks.h>
@@ -111,6 +112,85 @@ fmi2_xml_model_description_t* fmi2_xml_allocate_model_description( jm_callbacks*
 */
 int fmi2_xml_parse_model_description( fmi2_xml_model_description_t* md, const char* fileName, fmi2_xml_callbacks_t* xml_callbacks);
 
+/**
+   \brief Parse XML data that is already loaded into memory
+   The behaviour is the same as for fmi2_xml_parse_model_description() but no file is accessed.
+
+    @param md A model description object as returned by fmi2_xml_allocate_model_description.
+    @param buffer XML data to be parsed.
+    @param size Size of the XML data in bytes.
+	@param xml_callbacks Callbacks to use for processing annotations (may be NULL).
+   @return 0 if parsing was successfull. Non-zero value indicates an error.
+*/
+int fmi2_xml_parse_model_description_from_buffer( fmi2_xml_model_description_t* md, const char* buffer, size_t size, fmi2_xml_callbacks_t* xml_callbacks);
+
+/**
+   \brief Leave sections of the model description out when parsing
+   The elements of the skipped sections are passed over without being processed and the attributes
+   that belong to them are ignored. The setting applies to the following parse calls.
+
+    @param md A model description object as returned by fmi2_xml_allocate_model_description.
+    @param skipSections A combination of ::fmi_xml_section_enu_t flags, 0 parses everything.
+*/
+void fmi2_xml_set_skipped_sections( fmi2_xml_model_description_t* md, unsigned int skipSections);
+
+/**
+   \brief Set the number of threads used for sorting the variables once they are parsed
+   The variables are sorted by name and by value reference at the same time with a parallel merge sort.
+   The resulting order does not depend on the number of threads. The setting applies to the following parse calls.
+
+    @param md A model description object as returned by fmi2_xml_allocate_model_description.
+    @param numThreads Number of threads including the calling one. 0 and 1 sort on the calling thread, which is the default.
+*/
+void fmi2_xml_set_parse_threads( fmi2_xml_model_description_t* md, unsigned int numThreads);
+
+/** \brief Get the sections that are available in the model description, a combination of ::fmi_xml_section_enu_t flags */
+unsigned int fmi2_xml_get_parsed_sections( fmi2_xml_model_description_t* md);
+
+/**
+   \brief Stream the model variables to a handle instead of keeping them
+   Each ScalarVariable is passed to the handle as it ends and is dropped afterwards, so the variable
+   lists of the model description stay empty and the memory needed does not grow with the number of
+   variables. The model structure refers to the variables and is skipped. The setting applies to the
+   following parse calls.
+
+    @param md A model description object as returned by fmi2_xml_allocate_model_description.
+    @param handle The handle to call for each variable, NULL keeps the variables as usual.
+    @param context Forwarded to the handle.
+*/
+void fmi2_xml_set_variable_handle( fmi2_xml_model_description_t* md, fmi2_xml_variable_handle_ft handle, void* context);
+
+/** \brief Longest key stored in a model description image */
+#define FMI2_XML_IMAGE_KEY_SIZE 128
+
+/**
+   \brief Save a parsed model description as a binary image
+   The image holds everything that was parsed and can be loaded with fmi2_xml_load_model_description_image()
+   by a process running the same build of the library, which is much faster than parsing the XML file again.
+   The file is written directly, so callers that share it with other processes should write to a temporary
+   name and rename the file.
+
+    @param md A model description that was parsed successfully.
+    @param fileName A name (full path) of the image file.
+    @param key A string of less than #FMI2_XML_IMAGE_KEY_SIZE characters that identifies the XML file, e.g., its GUID, size and modification time.
+   @return 0 if the image was written. Non-zero value indicates an error.
+*/
+int fmi2_xml_write_model_description_image( fmi2_xml_model_description_t* md, const char* fileName, const char* key);
+
+/**
+   \brief Load a model description from a binary image
+   The image is memory mapped and the strings of the model description point into it until the model
+   description is cleared. Annotations are not part of the image.
+
+    @param md An empty model description object as returned by fmi2_xml_allocate_model_description.
+    @param fileName A name (full path) of the image file.
+    @param key The key that was given when the image was written.
+   @return 0 if the model description was loaded. 1 if there is no usable image (missing or damaged file, different key
+       or an incompatible build of the library): md is not modified. -1 if the image turned out to be corrupt while
+       loading: md must be freed.
+*/
+int fmi2_xml_load_model_description_image( fmi2_xml_model_description_t* md, const char* fileName, const char* key);
+
 /**
    Clears the data associated with the model description. This is useful if the same object
    instance is used repeatedly to work with different XML files.
@@ -41,6 +41,11 @@ fmi_xml_context_t* fmi_xml_allocate_context( jm_callbacks* callbacks) {
 	c->callbacks = callbacks;
 	c->parser = 0;
 	c->fmi_version = fmi_version_unknown_enu;
+	c->modelDescriptionCacheDir = 0;
+	c->parseOptions.skipSections = 0;
+	c->parseOptions.numThreads = 0;
+	c->fmi2VariableHandle = 0;
+	c->fmi2VariableHandleContext = 0;
 	jm_log_debug(callbacks, MODULE, "Returning allocated context");
     return c;
 }
@@ -52,6 +57,7 @@ void fmi_xml_free_context(fmi_xml_context_t *context) {
         XML_ParserFree(context->parser);
         context->parser = 0;
     }
+    context->callbacks->free(context->modelDescriptionCacheDir);
     context->callbacks->free(context);
 }
 
@@ -111,13 +117,17 @@ void XMLCALL fmi_xml_parse_element_end(void* c, const char *elm) {
 void XMLCALL fmi_xml_parse_element_data(void* c, const XML_Char *s, int len) {
 }
 
-fmi_version_enu_t fmi_xml_get_fmi_version(fmi_xml_context_t* context, const char* filename) {
+static XML_Parser fmi_xml_create_version_parser(fmi_xml_context_t* context) {
     XML_Memory_Handling_Suite memsuite;
     XML_Parser parser = NULL;
-    FILE* file;
 
 	jm_log_verbose(context->callbacks, MODULE, "Parsing XML to detect FMI standard version");
 
+	if(context->parser) {
+		XML_ParserFree(context->parser);
+		context->parser = 0;
+	}
+
 	memsuite.malloc_fcn = context->callbacks->malloc;
     memsuite.realloc_fcn = context->callbacks->realloc;
     memsuite.free_fcn = context->callbacks->free;
@@ -125,8 +135,7 @@ fmi_version_enu_t fmi_xml_get_fmi_version(fmi_xml_context_t* context, const char
 
     if(! parser) {
         fmi_xml_fatal(context, "Could not initialize XML parsing library.");
-        fmi_xml_free_context(context);
-        return fmi_version_unknown_enu;
+        return 0;
     }
 
     XML_SetUserData( parser, context);
@@ -135,14 +144,24 @@ fmi_version_enu_t fmi_xml_get_fmi_version(fmi_xml_context_t* context, const char
 
     XML_SetCharacterDataHandler(parser, fmi_xml_parse_element_data);
 
+	context->fmi_version = fmi_version_unknown_enu;
+
+	return parser;
+}
+
+fmi_version_enu_t fmi_xml_get_fmi_version(fmi_xml_context_t* context, const char* filename) {
+    XML_Parser parser = NULL;
+    FILE* file;
+
+	parser = fmi_xml_create_version_parser(context);
+	if(!parser) return fmi_version_unknown_enu;
+
     file = fopen(filename, "rb");
     if (file == NULL) {
         fmi_xml_fatal(context, "Cannot open file '%s' for parsing", filename);
         return fmi_version_unknown_enu;
     }
 
-	context->fmi_version = fmi_version_unknown_enu;
-
 #define XML_BLOCK_SIZE 1000
 
     while (!feof(file)) {
@@ -170,3 +189,30 @@ fmi_version_enu_t fmi_xml_get_fmi_version(fmi_xml_context_t* context, const char
 
     return context->fmi_version;
 }
+
+fmi_version_enu_t fmi_xml_get_fmi_version_from_buffer(fmi_xml_context_t* context, const char* buffer, size_t size) {
+    XML_Parser parser = NULL;
+	size_t offset = 0;
+
+	parser = fmi_xml_create_version_parser(context);
+	if(!parser) return fmi_version_unknown_enu;
+
+	/* Only the root element is needed, so the buffer is fed in small blocks */
+    while (offset < size) {
+        int n = (int)((size - offset > XML_BLOCK_SIZE) ? XML_BLOCK_SIZE : (size - offset));
+        if (!XML_Parse(parser, buffer + offset, n, offset + n == size) && (context->fmi_version == fmi_version_unknown_enu)) {
+             fmi_xml_fatal(context, "Parse error at line %d:\n%s",
+                         (int)XML_GetCurrentLineNumber(parser),
+                         XML_ErrorString(XML_GetErrorCode(parser)));
+             return fmi_version_unknown_enu; /* failure */
+        }
+		if(context->fmi_version != fmi_version_unknown_enu) break;
+		offset += n;
+    }
+
+	if(context->fmi_version == fmi_version_unknown_enu) {
+             fmi_xml_fatal(context, "Could not detect FMI standard version");
+	}
+
+    return context->fmi_version;
+}
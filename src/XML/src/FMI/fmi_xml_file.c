@@ -0,0 +1,165 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* mmap, madvise and fileno are not visible in strict mode otherwise */
+#if !defined(WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+
+#include "fmi_xml_file.h"
+
+#ifndef WIN32
+#define FMI_XML_HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* Size of the file or -1 if it is not known */
+static long fmi_xml_file_size(FILE* file) {
+	long size;
+	if(fseek(file, 0, SEEK_END)) return -1;
+	size = ftell(file);
+	if(fseek(file, 0, SEEK_SET)) return -1;
+	return size;
+}
+
+#ifdef FMI_XML_HAVE_MMAP
+/* Parse a mapping of the file. Returns read_error if the file could not be mapped so that the caller can read it instead. */
+static fmi_xml_parse_file_enu_t fmi_xml_parse_mapped_file(XML_Parser parser, FILE* file, size_t size) {
+	const char* data = (const char*)mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+	size_t offset = 0;
+	fmi_xml_parse_file_enu_t ret = fmi_xml_parse_file_ok;
+
+	if(data == (const char*)MAP_FAILED) return fmi_xml_parse_file_read_error;
+#ifdef MADV_SEQUENTIAL
+	madvise((void*)data, size, MADV_SEQUENTIAL);
+#endif
+	/* XML_Parse copies every slice into the parser buffer, bounded slices keep that buffer small */
+	do {
+		int n = (int)((size - offset > FMI_XML_MMAP_SLICE_SIZE) ? FMI_XML_MMAP_SLICE_SIZE : (size - offset));
+		if(!XML_Parse(parser, data + offset, n, offset + n == size)) {
+			ret = fmi_xml_parse_file_xml_error;
+			break;
+		}
+		offset += n;
+	} while(offset < size);
+	munmap((void*)data, size);
+	return ret;
+}
+#endif
+
+fmi_xml_parse_file_enu_t fmi_xml_parse_file(XML_Parser parser, const char* filename) {
+	FILE* file = fopen(filename, "rb");
+	long size;
+	int blockSize, isFinal;
+	fmi_xml_parse_file_enu_t ret = fmi_xml_parse_file_ok;
+
+	if(!file) return fmi_xml_parse_file_open_error;
+	size = fmi_xml_file_size(file);
+
+#ifdef FMI_XML_HAVE_MMAP
+	if(size >= FMI_XML_MMAP_THRESHOLD) {
+		ret = fmi_xml_parse_mapped_file(parser, file, (size_t)size);
+		if(ret != fmi_xml_parse_file_read_error) {
+			fclose(file);
+			return ret;
+		}
+		ret = fmi_xml_parse_file_ok;
+	}
+#endif
+
+	/* One extra byte lets fread see the end of a file with a known size in the same call */
+	if((size < 0) || (size >= FMI_XML_MAX_BLOCK_SIZE)) blockSize = FMI_XML_MAX_BLOCK_SIZE;
+	else if(size < FMI_XML_MIN_BLOCK_SIZE) blockSize = FMI_XML_MIN_BLOCK_SIZE;
+	else blockSize = (int)size + 1;
+
+	do {
+		void* buffer = XML_GetBuffer(parser, blockSize);
+		int n;
+		if(!buffer) {
+			ret = fmi_xml_parse_file_read_error;
+			break;
+		}
+		n = (int)fread(buffer, 1, (size_t)blockSize, file);
+		if(ferror(file)) {
+			ret = fmi_xml_parse_file_read_error;
+			break;
+		}
+		isFinal = feof(file) ? 1 : 0;
+		if(!XML_ParseBuffer(parser, n, isFinal)) {
+			ret = fmi_xml_parse_file_xml_error;
+			break;
+		}
+	} while(!isFinal);
+
+	fclose(file);
+	return ret;
+}
+
+fmi_xml_parse_file_enu_t fmi_xml_map_file(const char* filename, fmi_xml_file_map_t* map, jm_callbacks* cb) {
+	FILE* file = fopen(filename, "rb");
+	long size;
+	char* buffer;
+
+	map->data = 0;
+	map->size = 0;
+	map->isMapped = 0;
+	if(!file) return fmi_xml_parse_file_open_error;
+	size = fmi_xml_file_size(file);
+	if(size <= 0) {
+		fclose(file);
+		return fmi_xml_parse_file_read_error;
+	}
+
+#ifdef FMI_XML_HAVE_MMAP
+	{
+		char* data = (char*)mmap(0, (size_t)size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+		if(data != (char*)MAP_FAILED) {
+			fclose(file);
+			map->data = data;
+			map->size = (size_t)size;
+			map->isMapped = 1;
+			return fmi_xml_parse_file_ok;
+		}
+	}
+#endif
+
+	buffer = (char*)cb->malloc((size_t)size);
+	if(!buffer || (fread(buffer, 1, (size_t)size, file) != (size_t)size)) {
+		if(buffer) cb->free(buffer);
+		fclose(file);
+		return fmi_xml_parse_file_read_error;
+	}
+	fclose(file);
+	map->data = buffer;
+	map->size = (size_t)size;
+	return fmi_xml_parse_file_ok;
+}
+
+void fmi_xml_unmap_file(fmi_xml_file_map_t* map, jm_callbacks* cb) {
+	if(!map->data) return;
+#ifdef FMI_XML_HAVE_MMAP
+	if(map->isMapped) munmap(map->data, map->size);
+	else
+#endif
+	cb->free(map->data);
+	map->data = 0;
+	map->size = 0;
+	map->isMapped = 0;
+}
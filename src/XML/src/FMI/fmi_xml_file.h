@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef FMI_XML_FILE_H
+#define FMI_XML_FILE_H
+
+#include <expat.h>
+#include <JM/jm_callbacks.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Outcome of fmi_xml_parse_file() */
+typedef enum fmi_xml_parse_file_enu_t {
+	fmi_xml_parse_file_ok = 0,
+	fmi_xml_parse_file_open_error, /* the file could not be opened */
+	fmi_xml_parse_file_read_error, /* reading failed or expat could not allocate its buffer */
+	fmi_xml_parse_file_xml_error /* expat reported an error, see XML_GetErrorCode() */
+} fmi_xml_parse_file_enu_t;
+
+/** \brief Files at least this large are memory mapped where supported */
+#define FMI_XML_MMAP_THRESHOLD (1 << 20)
+
+/** \brief Largest slice of a mapped file handed to expat in one call */
+#define FMI_XML_MMAP_SLICE_SIZE (1 << 18)
+
+/** \brief Smallest and largest block read into the expat buffer */
+#define FMI_XML_MIN_BLOCK_SIZE (1 << 14)
+#define FMI_XML_MAX_BLOCK_SIZE (1 << 20)
+
+/**
+	\brief Feed a whole file to an expat parser.
+
+	Large files are memory mapped and handed to expat in slices of FMI_XML_MMAP_SLICE_SIZE.
+	Expat copies each slice into its own buffer (the bundled build keeps XML_CONTEXT_BYTES of
+	context), so the slices keep that buffer small whatever the size of the file, and no
+	separate read buffer is needed. Other files are read straight into the buffer of the parser
+	(XML_GetBuffer() and XML_ParseBuffer()) in blocks sized after the file: small files
+	are read with a single call.
+	\param parser The parser with all handlers set up.
+	\param filename The file to parse.
+*/
+fmi_xml_parse_file_enu_t fmi_xml_parse_file(XML_Parser parser, const char* filename);
+
+/** \brief Read only view of the contents of a whole file */
+typedef struct fmi_xml_file_map_t {
+	char* data; /* contents of the file, NULL if nothing is mapped */
+	size_t size;
+	int isMapped; /* the data is a mapping of the file rather than a copy allocated with the callbacks */
+} fmi_xml_file_map_t;
+
+/**
+	\brief Make the contents of a file available in memory.
+
+	The file is memory mapped where supported and read into a buffer otherwise. The data
+	is suitably aligned for any type and stays valid until fmi_xml_unmap_file() is called.
+	It is a private copy that may be modified: a mapping is copy on write and changes are
+	never written to the file.
+	\param filename The file to map.
+	\param map Receives the data. It is zeroed if the call fails.
+	\param cb Callbacks used for the buffer.
+	\return fmi_xml_parse_file_ok, fmi_xml_parse_file_open_error or fmi_xml_parse_file_read_error.
+*/
+fmi_xml_parse_file_enu_t fmi_xml_map_file(const char* filename, fmi_xml_file_map_t* map, jm_callbacks* cb);
+
+/** \brief Release the data of fmi_xml_map_file(). Zeroed maps are accepted and left as they are. */
+void fmi_xml_unmap_file(fmi_xml_file_map_t* map, jm_callbacks* cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMI_XML_FILE_H */
@@ -0,0 +1,42 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifndef FMI_XML_HASH_H
+#define FMI_XML_HASH_H
+
+#include <JM/jm_hash.h>
+
+/*
+	Element and attribute names are looked up in perfect hash tables: the seed for each
+	table is chosen so that all the known names fall into different slots. A lookup is
+	then one hash and one string compare against the single candidate in the slot.
+
+	The tables are generated into fmi1_xml_parser_hash.h and fmi2_xml_parser_hash.h from
+	the name lists in the parser headers. After changing a list, regenerate the tables with
+		fmi_xml_hash_test --generate fmi1 > src/XML/src/FMI1/fmi1_xml_parser_hash.h
+		fmi_xml_hash_test --generate fmi2 > src/XML/src/FMI2/fmi2_xml_parser_hash.h
+	The test fails when a table does not match the lists.
+*/
+
+/* Slot value for names that are not in the table */
+#define FMI_XML_HASH_EMPTY 0xFF
+
+/* FNV-1a with the seed as offset basis. The upper bits are folded in since the tables are indexed with a mask. */
+static unsigned int fmi_xml_hash(const char* str, unsigned int seed) {
+	unsigned int h = jm_hash_string(str, seed, 0);
+	return h ^ (h >> 16);
+}
+
+#endif /* FMI_XML_HASH_H */
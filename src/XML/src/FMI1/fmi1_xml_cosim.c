@@ -112,7 +112,7 @@ int fmi1_xml_handle_File(fmi1_xml_parser_context_t *context, const char* data) {
                 return -1;
             len = jm_vector_get_size_char(bufFileName);
             pname = jm_vector_push_back(jm_string)(&md->additionalModels,fileName);
-            if(pname) *pname = fileName =  md->callbacks->malloc(len + 1);
+            if(pname) *pname = fileName = jm_arena_alloc(&md->arena, len + 1);
             if(!pname || !fileName) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
                 return -1;
@@ -41,7 +41,11 @@ fmi1_xml_model_description_t * fmi1_xml_allocate_model_description( jm_callbacks
 
     md->callbacks = cb;
 
+    jm_arena_init(&md->arena, 0, cb);
+
     md->status = fmi1_xml_model_description_enu_empty;
+    md->skippedSections = 0;
+    md->numThreads = 0;
 
     jm_vector_init(char)( & md->fmi1_xml_standard_version, 0,cb);
     jm_vector_init(char)(&md->modelName, 0,cb);
@@ -69,7 +73,7 @@ fmi1_xml_model_description_t * fmi1_xml_allocate_model_description( jm_callbacks
     jm_vector_init(jm_named_ptr)(&md->unitDefinitions, 0, cb);
     jm_vector_init(jm_named_ptr)(&md->displayUnitDefinitions, 0, cb);
 
-    fmi1_xml_init_type_definitions(&md->typeDefinitions, cb);
+    fmi1_xml_init_type_definitions(&md->typeDefinitions, &md->arena, cb);
 
     jm_vector_init(jm_named_ptr)(&md->variablesByName, 0, cb);
 
@@ -81,7 +85,7 @@ fmi1_xml_model_description_t * fmi1_xml_allocate_model_description( jm_callbacks
 
 	md->outputVariables = 0;
 
-    jm_vector_init(jm_string)(&md->descriptions, 0, cb);
+    jm_string_intern_init(&md->descriptions, cb);
 
     md->fmuKind = fmi1_fmu_kind_enu_me;
 
@@ -123,13 +127,22 @@ void fmi1_xml_clear_model_description( fmi1_xml_model_description_t* md) {
     jm_vector_foreach(jm_voidp)(&md->vendorList, (void(*)(void*))fmi1_xml_vendor_free);
     jm_vector_free_data(jm_voidp)(&md->vendorList);
 
-    jm_named_vector_free_data(&md->unitDefinitions);
-    jm_named_vector_free_data(&md->displayUnitDefinitions);
+    /* The units, types, variables and strings live in the arena, so only the vectors are released here */
+    {
+        size_t i, n = jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions);
+        for(i = 0; i < n; i++) {
+            fmi1_xml_unit_t* unit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+            /* the entry is added before the unit is allocated, so it may be empty after a failure */
+            if(unit) jm_vector_free_data(jm_voidp)(&unit->displayUnits);
+        }
+    }
+    jm_vector_free_data(jm_named_ptr)(&md->unitDefinitions);
+    jm_vector_free_data(jm_named_ptr)(&md->displayUnitDefinitions);
 
     fmi1_xml_free_type_definitions_data(&md->typeDefinitions);
 
     jm_vector_foreach(jm_named_ptr)(&md->variablesByName, fmi1_xml_free_direct_dependencies);
-    jm_named_vector_free_data(&md->variablesByName);
+    jm_vector_free_data(jm_named_ptr)(&md->variablesByName);
 	if(md->variablesOrigOrder) {
 		jm_vector_free(jm_voidp)(md->variablesOrigOrder);
 		md->variablesOrigOrder = 0;
@@ -150,21 +163,33 @@ void fmi1_xml_clear_model_description( fmi1_xml_model_description_t* md) {
 	}
 
 
-    jm_vector_foreach(jm_string)(&md->descriptions, (void(*)(const char*))md->callbacks->free);
-    jm_vector_free_data(jm_string)(&md->descriptions);
+    jm_string_intern_free_data(&md->descriptions);
 
-    jm_vector_foreach(jm_string)(&md->additionalModels, (void(*)(const char*))md->callbacks->free);
     jm_vector_free_data(jm_string)(&md->additionalModels);
 
     jm_vector_free_data(char)(&md->entryPoint);
     jm_vector_free_data(char)(&md->mimeType);
 
+    jm_arena_free_data(&md->arena);
+
 }
 
 int fmi1_xml_is_model_description_empty(fmi1_xml_model_description_t* md) {
     return (md->status == fmi1_xml_model_description_enu_empty);
 }
 
+void fmi1_xml_set_skipped_sections(fmi1_xml_model_description_t* md, unsigned int skipSections) {
+    md->skippedSections = skipSections & fmi_xml_section_all;
+}
+
+void fmi1_xml_set_parse_threads(fmi1_xml_model_description_t* md, unsigned int numThreads) {
+    md->numThreads = numThreads;
+}
+
+unsigned int fmi1_xml_get_parsed_sections(fmi1_xml_model_description_t* md) {
+    return fmi_xml_section_all & ~md->skippedSections;
+}
+
 const char* fmi1_xml_get_last_error(fmi1_xml_model_description_t* md) {
 	return jm_get_last_error(md->callbacks);
 }
@@ -378,7 +403,7 @@ jm_vector(jm_voidp)* fmi1_xml_get_variables_vr_order(fmi1_xml_model_description_
 fmi1_xml_variable_t* fmi1_xml_get_variable_by_name(fmi1_xml_model_description_t* md, const char* name) {
 	jm_named_ptr key, *found;
     key.name = name;
-    found = jm_vector_bsearch(jm_named_ptr)(&md->variablesByName, &key, jm_compare_named);
+    found = jm_named_vector_search(&md->variablesByName, key.name);
 	if(!found) return 0;
 	return found->ptr;
 }
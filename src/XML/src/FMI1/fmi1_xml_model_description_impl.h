@@ -6,7 +6,7 @@
 #include <JM/jm_callbacks.h>
 #include <JM/jm_vector.h>
 #include <JM/jm_named_ptr.h>
-#include <JM/jm_string_set.h>
+#include <JM/jm_string_intern.h>
 #include <FMI1/fmi1_xml_model_description.h>
 
 #include "fmi1_xml_unit_impl.h"
@@ -29,6 +29,9 @@ struct fmi1_xml_model_description_t {
 
     jm_callbacks* callbacks;
 
+    /* Storage for the objects created during parsing. They are all released at once in fmi1_xml_clear_model_description(). */
+    jm_arena_t arena;
+
     fmi1_xml_model_description_status_enu_t status;
 
     jm_vector(char) fmi1_xml_standard_version;
@@ -68,7 +71,7 @@ struct fmi1_xml_model_description_t {
 
     fmi1_xml_type_definitions_t typeDefinitions;
 
-    jm_string_set descriptions;
+    jm_string_intern_t descriptions;
 
 	jm_vector(jm_named_ptr) variablesByName;
 
@@ -88,6 +91,10 @@ struct fmi1_xml_model_description_t {
     jm_vector(char) mimeType;
     int manual_start;
     jm_vector(jm_string) additionalModels;
+
+    unsigned int skippedSections; /* sections left out when parsing, see fmi1_xml_set_skipped_sections() */
+
+    unsigned int numThreads; /* threads sorting the variables, see fmi1_xml_set_parse_threads() */
 };
 
 void fmi1_xml_report_error(fmi1_xml_model_description_t* md, const char* module, const char* fmt, ...);
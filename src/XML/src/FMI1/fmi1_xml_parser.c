@@ -15,9 +15,15 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
+
+#include <JM/jm_number.h>
 
 #include "fmi1_xml_model_description_impl.h"
 #include "fmi1_xml_parser.h"
+#include "fmi1_xml_parser_hash.h"
+#include "../FMI/fmi_xml_file.h"
+#include "../FMI/fmi_xml_hash.h"
 
 static const char * module = "FMI1XML";
 
@@ -83,14 +89,6 @@ void fmi1_xml_parse_free_context(fmi1_xml_parser_context_t *context) {
         context->parser = 0;
     }
     fmi1_xml_free_parse_buffer(context);
-    if(context->attrMap) {
-        jm_vector_free(jm_named_ptr)(context->attrMap);
-        context->attrMap = 0;
-    }
-    if(context->elmMap) {
-        jm_vector_free(fmi1_xml_element_handle_map_t)(context->elmMap);
-        context->elmMap = 0;
-    }
     if(context->attrBuffer) {
         jm_vector_free(jm_string)(context->attrBuffer);
         context->attrBuffer = 0;
@@ -190,7 +188,7 @@ int fmi1_xml_set_attr_uint(fmi1_xml_parser_context_t *context, fmi1_xml_elm_enu_
     elmName = fmi1_element_handle_map[elmID].elementName;
     attrName = fmi1_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%u", field) != 1) {
+    if(jm_parse_uint(strVal, field) != jm_status_success) {
         fmi1_xml_parse_error(context, "XML element '%s': could not parse value for attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -241,7 +239,7 @@ int fmi1_xml_set_attr_int(fmi1_xml_parser_context_t *context, fmi1_xml_elm_enu_t
     elmName = fmi1_element_handle_map[elmID].elementName;
     attrName = fmi1_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%d", field) != 1) {
+    if(jm_parse_int(strVal, field) != jm_status_success) {
         fmi1_xml_parse_error(context, "XML element '%s': could not parse value for attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -264,7 +262,7 @@ int fmi1_xml_set_attr_double(fmi1_xml_parser_context_t *context, fmi1_xml_elm_en
     elmName = fmi1_element_handle_map[elmID].elementName;
     attrName = fmi1_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%lf", field) != 1) {
+    if(jm_parse_double(strVal, field) != jm_status_success) {
         fmi1_xml_parse_fatal(context, "XML element '%s': could not parse value for attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -322,40 +320,62 @@ jm_vector(char) * fmi1_xml_get_parse_buffer(fmi1_xml_parser_context_t *context,
 
 
 
-int fmi1_create_attr_map(fmi1_xml_parser_context_t* context) {
+int fmi1_create_attr_buffer(fmi1_xml_parser_context_t* context) {
     int i;
     context->attrBuffer = jm_vector_alloc(jm_string)(fmi1_xml_attr_number, fmi1_xml_attr_number, context->callbacks);
     if(!context->attrBuffer) return -1;
-    context->attrMap = jm_vector_alloc(jm_named_ptr)(fmi1_xml_attr_number, fmi1_xml_attr_number, context->callbacks);
-    if(!context->attrMap) return -1;
     for(i = 0; i < fmi1_xml_attr_number; i++) {
-        jm_named_ptr map;
         jm_vector_set_item(jm_string)(context->attrBuffer, i, 0);
-        map.name = fmi1_xmlAttrNames[i];
-        map.ptr = (void*)(jm_vector_get_itemp(jm_string)(context->attrBuffer, i));
-        jm_vector_set_item(jm_named_ptr)(context->attrMap, i, map);
     }
-    jm_vector_qsort(jm_named_ptr)(context->attrMap, jm_compare_named);
+    context->attrSetSize = 0;
     return 0;
 }
 
-int fmi1_create_elm_map(fmi1_xml_parser_context_t* context) {
-    size_t i;
-    context->elmMap = jm_vector_alloc(fmi1_xml_element_handle_map_t)(fmi1_xml_elm_number, fmi1_xml_elm_number, context->callbacks);
-    if(!context->elmMap) return -1;
-    for(i = 0; i < fmi1_xml_elm_number; i++) {
-        fmi1_xml_element_handle_map_t item = fmi1_element_handle_map[i];
-        jm_vector_set_item(fmi1_xml_element_handle_map_t)(context->elmMap, i, item);
+/* Reset the attributes stored for the current element. Only the slots listed in attrSet can be non-NULL. */
+static void fmi1_xml_clear_attr_buffer(fmi1_xml_parser_context_t* context) {
+    size_t k;
+    for(k = 0; k < context->attrSetSize; k++) {
+        jm_vector_set_item(jm_string)(context->attrBuffer, context->attrSet[k], 0);
     }
-    jm_vector_qsort(fmi1_xml_element_handle_map_t)(context->elmMap, fmi1_xml_compare_elmName);
-    return 0;
+    context->attrSetSize = 0;
+}
+
+/* Find the attribute with the given name. Returns fmi1_xml_attr_number if there is no such attribute. */
+static fmi1_xml_attr_enu_t fmi1_xml_lookup_attr(const char* name) {
+    unsigned int id = fmi1_xml_attr_hash_table[fmi_xml_hash(name, FMI1_XML_ATTR_HASH_SEED) & FMI1_XML_ATTR_HASH_MASK];
+    if((id != FMI_XML_HASH_EMPTY) && (strcmp(fmi1_xmlAttrNames[id], name) == 0))
+        return (fmi1_xml_attr_enu_t)id;
+    return fmi1_xml_attr_number;
+}
+
+/* Find the element with the given name. Returns fmi1_xml_elmID_none for unknown elements. */
+static fmi1_xml_elm_enu_t fmi1_xml_lookup_elm(const char* name) {
+    unsigned int id = fmi1_xml_elm_hash_table[fmi_xml_hash(name, FMI1_XML_ELM_HASH_SEED) & FMI1_XML_ELM_HASH_MASK];
+    if((id != FMI_XML_HASH_EMPTY) && (strcmp(fmi1_element_handle_map[id].elementName, name) == 0))
+        return (fmi1_xml_elm_enu_t)id;
+    return fmi1_xml_elmID_none;
+}
+
+static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const char **attr);
+static void XMLCALL fmi1_parse_element_end(void* c, const char *elm);
+static void XMLCALL fmi1_parse_element_data(void* c, const XML_Char *s, int len);
+
+/* Handlers installed while a skipped section is passed over: only the nesting depth is tracked */
+static void XMLCALL fmi1_skip_element_start(void *c, const char *elm, const char **attr) {
+    fmi1_xml_parser_context_t *context = c;
+    context->skipSectionDepth++;
+}
+
+static void XMLCALL fmi1_skip_element_end(void *c, const char *elm) {
+    fmi1_xml_parser_context_t *context = c;
+    if(--context->skipSectionDepth) return;
+    /* the skipped element counts as a parsed sibling for the order checks */
+    context->lastElmID = context->skipSectionID;
+    XML_SetElementHandler(context->parser, fmi1_parse_element_start, fmi1_parse_element_end);
+    XML_SetCharacterDataHandler(context->parser, fmi1_parse_element_data);
 }
 
 static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const char **attr) {
-    jm_named_ptr key;
-    fmi1_xml_element_handle_map_t keyEl;
-    fmi1_xml_element_handle_map_t* currentElMap;
-    jm_named_ptr* currentMap;
 	fmi1_xml_elm_enu_t currentID;
     int i;
     fmi1_xml_parser_context_t *context = c;
@@ -367,10 +387,9 @@ static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const cha
 		return;
 	}
 	
-	keyEl.elementName = elm;
 	/* find the element handle by name */
-    currentElMap = jm_vector_bsearch(fmi1_xml_element_handle_map_t)(context->elmMap, &keyEl, fmi1_xml_compare_elmName);
-    if(!currentElMap) {
+    currentID = fmi1_xml_lookup_elm(elm);
+    if(currentID == fmi1_xml_elmID_none) {
         /* not found error*/
         jm_log_error(context->callbacks, module, "[Line:%u] Unknown element '%s' in XML, skipping",
 			XML_GetCurrentLineNumber(context->parser), elm);
@@ -378,7 +397,6 @@ static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const cha
         return;
     }
 
-    currentID = currentElMap->elemID;
 	/* Check that parent-child & siblings are fine */
 	{
 		fmi1_xml_elm_enu_t parentID = context->currentElmID;
@@ -418,37 +436,51 @@ static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const cha
 		context->lastElmID = fmi1_xml_elmID_none;
 	}
 
+	if(context->skipElm[currentID]) {
+		/* pass the whole section over without looking at it */
+		context->skipSectionID = currentID;
+		context->skipSectionDepth = 1;
+		XML_SetElementHandler(context->parser, fmi1_skip_element_start, fmi1_skip_element_end);
+		XML_SetCharacterDataHandler(context->parser, 0);
+		return;
+	}
+
+    /* clear the attributes left over when the handle of the previous element failed */
+    fmi1_xml_clear_attr_buffer(context);
+
     /* process the attributes  */
     i = 0;
     while(attr[i]) {
-        key.name = attr[i];
         /* find attribute by name  */
-        currentMap = jm_vector_bsearch(jm_named_ptr)(context->attrMap, &key, jm_compare_named);
-        if(!currentMap) {
+        fmi1_xml_attr_enu_t attrID = fmi1_xml_lookup_attr(attr[i]);
+        if(attrID == fmi1_xml_attr_number) {
             /* not found error*/
 			jm_log_error(context->callbacks, module, "Unknown attribute '%s' in XML", attr[i]);
         }
-		else  {
+		else if(!context->skipAttr[attrID]) {
             /* save attr value (still as string) for further handling  */
-            const char** mapItem = (const char**)currentMap->ptr;
-            *mapItem = attr[i+1];
+            if(!jm_vector_get_item(jm_string)(context->attrBuffer, attrID))
+                context->attrSet[context->attrSetSize++] = attrID;
+            jm_vector_set_item(jm_string)(context->attrBuffer, attrID, attr[i+1]);
         }
         i += 2;
     }
 
     /* handle the element */
-	if( currentElMap->elementHandle(context, 0) ) {
+	if( fmi1_element_handle_map[currentID].elementHandle(context, 0) ) {
         return;
     }
 	if(context->skipElementCnt) return;
     /* check that the element handle had process all the attributes */
-    for(i = 0; i < fmi1_xml_attr_number; i++) {
-        if(jm_vector_get_item(jm_string)(context->attrBuffer, i)) {
-            if(!context->skipOneVariableFlag)
-                jm_log_warning(context->callbacks,module, "Attribute '%s' not processed by element '%s' handle", fmi1_xmlAttrNames[i], elm);
-            jm_vector_set_item(jm_string)(context->attrBuffer, i,0);
+    if(!context->skipOneVariableFlag) {
+        size_t k;
+        for(k = 0; k < context->attrSetSize; k++) {
+            fmi1_xml_attr_enu_t attrID = context->attrSet[k];
+            if(jm_vector_get_item(jm_string)(context->attrBuffer, attrID))
+                jm_log_warning(context->callbacks,module, "Attribute '%s' not processed by element '%s' handle", fmi1_xmlAttrNames[attrID], elm);
         }
     }
+    fmi1_xml_clear_attr_buffer(context);
     if(context -> currentElmID != fmi1_xml_elmID_none) { /* with nested elements: put the parent on the stack*/
         jm_stack_push(int)(&context->elmStack, context -> currentElmID);
     }
@@ -457,8 +489,6 @@ static void XMLCALL fmi1_parse_element_start(void *c, const char *elm, const cha
 
 static void XMLCALL fmi1_parse_element_end(void* c, const char *elm) {
 
-    fmi1_xml_element_handle_map_t keyEl;
-    fmi1_xml_element_handle_map_t* currentElMap;
 	fmi1_xml_elm_enu_t currentID;
     fmi1_xml_parser_context_t *context = c;
 
@@ -467,14 +497,12 @@ static void XMLCALL fmi1_parse_element_end(void* c, const char *elm) {
 		return;
 	}
 
-    keyEl.elementName = elm;
-    currentElMap = jm_vector_bsearch(fmi1_xml_element_handle_map_t)(context->elmMap, &keyEl, fmi1_xml_compare_elmName);
-    if(!currentElMap) {
+    currentID = fmi1_xml_lookup_elm(elm);
+    if(currentID == fmi1_xml_elmID_none) {
         /* not found error*/
         fmi1_xml_parse_fatal(context, "Unknown element end in XML (element: %s)", elm);
         return;
     }
-    currentID = currentElMap->elemID;
 
     if(currentID != context -> currentElmID) {
         /* missmatch error*/
@@ -485,7 +513,7 @@ static void XMLCALL fmi1_parse_element_end(void* c, const char *elm) {
 
     jm_vector_push_back(char)(&context->elmData, 0);
 
-	if( currentElMap->elementHandle(context, jm_vector_get_itemp(char)(&context->elmData, 0) )) {
+	if( fmi1_element_handle_map[currentID].elementHandle(context, jm_vector_get_itemp(char)(&context->elmData, 0) )) {
         return;
     }
     jm_vector_resize(char)(&context->elmData, 0);
@@ -521,23 +549,41 @@ static void XMLCALL fmi1_parse_element_data(void* c, const XML_Char *s, int len)
         }
 }
 
-int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const char* filename) {
+/* Mark the elements and attributes of the sections that are left out */
+static void fmi1_xml_init_skipped_sections(fmi1_xml_parser_context_t* context, unsigned int skipSections) {
+    if(skipSections & fmi_xml_section_descriptions) {
+        context->skipAttr[fmi_attr_id_description] = 1;
+    }
+    if(skipSections & fmi_xml_section_annotations) {
+        context->skipElm[fmi1_xml_elmID_VendorAnnotations] = 1;
+    }
+    if(skipSections & fmi_xml_section_model_structure) {
+        context->skipElm[fmi1_xml_elmID_DirectDependency] = 1;
+    }
+    if(skipSections & fmi_xml_section_units) {
+        context->skipElm[fmi1_xml_elmID_UnitDefinitions] = 1;
+        context->skipAttr[fmi_attr_id_unit] = 1;
+        context->skipAttr[fmi_attr_id_displayUnit] = 1;
+    }
+}
+
+static fmi1_xml_parser_context_t* fmi1_xml_parse_create_context(fmi1_xml_model_description_t* md) {
     XML_Memory_Handling_Suite memsuite;
     fmi1_xml_parser_context_t* context;
     XML_Parser parser = NULL;
-    FILE* file;
 
     context = (fmi1_xml_parser_context_t*)md->callbacks->calloc(1, sizeof(fmi1_xml_parser_context_t));
     if(!context) {
         jm_log_fatal(md->callbacks, "FMIXML", "Could not allocate memory for XML parser context");
+        return 0;
     }
     context->callbacks = md->callbacks;
     context->modelDescription = md;
-    if(fmi1_xml_alloc_parse_buffer(context, 16)) return -1;
-    if(fmi1_create_attr_map(context) || fmi1_create_elm_map(context)) {
+    if(fmi1_xml_alloc_parse_buffer(context, 16)) return 0;
+    if(fmi1_create_attr_buffer(context)) {
         fmi1_xml_parse_fatal(context, "Error in parsing initialization");
         fmi1_xml_parse_free_context(context);
-        return -1;
+        return 0;
     }
     context->lastBaseUnit = 0;
     jm_vector_init(jm_voidp)(&context->directDependencyBuf, 0, context->callbacks);
@@ -548,6 +594,7 @@ int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const cha
     jm_vector_init(char)(&context->elmData, 0, context->callbacks);
     context->lastElmID = fmi1_xml_elmID_none;
     context->currentElmID = fmi1_xml_elmID_none;
+    fmi1_xml_init_skipped_sections(context, md->skippedSections);
 
     memsuite.malloc_fcn = context->callbacks->malloc;
     memsuite.realloc_fcn = context->callbacks->realloc;
@@ -557,7 +604,7 @@ int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const cha
     if(! parser) {
         fmi1_xml_parse_fatal(context, "Could not initialize XML parsing library.");
         fmi1_xml_parse_free_context(context);
-        return -1;
+        return 0;
     }
 
     XML_SetUserData( parser, context);
@@ -566,35 +613,22 @@ int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const cha
 
     XML_SetCharacterDataHandler(parser, fmi1_parse_element_data);
 
-    file = fopen(filename, "rb");
-    if (file == NULL) {
-        fmi1_xml_parse_fatal(context, "Cannot open file '%s' for parsing", filename);
-        fmi1_xml_parse_free_context(context);
-        return -1;
-    }
+    return context;
+}
 
-    while (!feof(file)) {
-        char * text = jm_vector_get_itemp(char)(fmi1_xml_reserve_parse_buffer(context,0,XML_BLOCK_SIZE),0);
-        int n = (int)fread(text, sizeof(char), XML_BLOCK_SIZE, file);
-        if(ferror(file)) {
-            fmi1_xml_parse_fatal(context, "Error reading from file %s", filename);
-            fclose(file);
-	        fmi1_xml_parse_free_context(context);
-            return -1;
-        }
-        if (!XML_Parse(parser, text, n, feof(file))) {
-             fmi1_xml_parse_fatal(context, "Parse error at line %d:\n%s",
-                         (int)XML_GetCurrentLineNumber(parser),
-                         XML_ErrorString(XML_GetErrorCode(parser)));
-             fclose(file);
-		     fmi1_xml_parse_free_context(context);
-             return -1; /* failure */
-        }        
-    }
-    fclose(file);
+static int fmi1_xml_parse_report_error(fmi1_xml_parser_context_t* context) {
+    fmi1_xml_parse_fatal(context, "Parse error at line %d:\n%s",
+                (int)XML_GetCurrentLineNumber(context->parser),
+                XML_ErrorString(XML_GetErrorCode(context->parser)));
+    fmi1_xml_parse_free_context(context);
+    return -1; /* failure */
+}
+
+static int fmi1_xml_parse_finish(fmi1_xml_parser_context_t* context, const char* source) {
+    fmi1_xml_model_description_t* md = context->modelDescription;
     /* done later XML_ParserFree(parser);*/
     if(!jm_stack_is_empty(int)(&context->elmStack)) {
-        fmi1_xml_parse_fatal(context, "Unexpected end of file (not all elements ended) when parsing %s", filename);
+        fmi1_xml_parse_fatal(context, "Unexpected end of file (not all elements ended) when parsing %s", source);
         fmi1_xml_parse_free_context(context);
         return -1;
     }
@@ -606,5 +640,46 @@ int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const cha
     return 0;
 }
 
-#define JM_TEMPLATE_INSTANCE_TYPE fmi1_xml_element_handle_map_t
-#include "JM/jm_vector_template.h"
+int fmi1_xml_parse_model_description(fmi1_xml_model_description_t* md, const char* filename) {
+    fmi1_xml_parser_context_t* context;
+
+    context = fmi1_xml_parse_create_context(md);
+    if(!context) return -1;
+
+    switch(fmi_xml_parse_file(context->parser, filename)) {
+    case fmi_xml_parse_file_ok:
+        break;
+    case fmi_xml_parse_file_open_error:
+        fmi1_xml_parse_fatal(context, "Cannot open file '%s' for parsing", filename);
+        fmi1_xml_parse_free_context(context);
+        return -1;
+    case fmi_xml_parse_file_read_error:
+        fmi1_xml_parse_fatal(context, "Error reading from file %s", filename);
+        fmi1_xml_parse_free_context(context);
+        return -1;
+    default:
+        return fmi1_xml_parse_report_error(context);
+    }
+
+    return fmi1_xml_parse_finish(context, filename);
+}
+
+int fmi1_xml_parse_model_description_from_buffer(fmi1_xml_model_description_t* md, const char* buffer, size_t size) {
+    fmi1_xml_parser_context_t* context;
+    size_t offset = 0;
+
+    context = fmi1_xml_parse_create_context(md);
+    if(!context) return -1;
+
+    /* The data is already in memory, so it is handed to expat directly without copying */
+    do {
+        int n = (int)((size - offset > INT_MAX) ? INT_MAX : (size - offset));
+        if (!XML_Parse(context->parser, buffer + offset, n, offset + n == size)) {
+             return fmi1_xml_parse_report_error(context);
+        }
+        offset += n;
+    } while (offset < size);
+
+    return fmi1_xml_parse_finish(context, "memory buffer");
+}
+
@@ -144,14 +144,6 @@ struct fmi1_xml_element_handle_map_t {
 };
 
 
-jm_vector_declare_template(fmi1_xml_element_handle_map_t)
-
-#define fmi1_xml_diff_elmName(a, b) strcmp(a.elementName,b.elementName)
-
-jm_define_comp_f(fmi1_xml_compare_elmName, fmi1_xml_element_handle_map_t, fmi1_xml_diff_elmName)
-
-#define XML_BLOCK_SIZE 16000
-
 struct fmi1_xml_parser_context_t {
     fmi1_xml_model_description_t* modelDescription;
     jm_callbacks* callbacks;
@@ -159,9 +151,10 @@ struct fmi1_xml_parser_context_t {
     XML_Parser parser;
     jm_vector(jm_voidp) parseBuffer;
 
-    jm_vector(jm_named_ptr)* attrMap;
-    jm_vector(fmi1_xml_element_handle_map_t)* elmMap;
     jm_vector(jm_string)* attrBuffer;
+    /* IDs of the attributes stored in attrBuffer for the current element */
+    fmi1_xml_attr_enu_t attrSet[fmi1_xml_attr_number];
+    size_t attrSetSize;
 
     fmi1_xml_unit_t* lastBaseUnit;
 
@@ -177,6 +170,13 @@ struct fmi1_xml_parser_context_t {
 
 	fmi1_xml_elm_enu_t lastElmID;
 	fmi1_xml_elm_enu_t currentElmID;
+
+    /* Elements and attributes of the sections that are not parsed, see fmi1_xml_set_skipped_sections() */
+    char skipElm[fmi1_xml_elm_number];
+    char skipAttr[fmi1_xml_attr_number];
+    /* Depth within a skipped element and its ID while the skip handlers are installed */
+    int skipSectionDepth;
+    fmi1_xml_elm_enu_t skipSectionID;
 };
 
 jm_vector(char) * fmi1_xml_reserve_parse_buffer(fmi1_xml_parser_context_t *context, size_t index, size_t size);
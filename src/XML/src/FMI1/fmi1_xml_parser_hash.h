@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* Generated by fmi_xml_hash_test --generate fmi1, see FMI/fmi_xml_hash.h. Do not edit. */
+
+#ifndef FMI1_XML_PARSER_HASH_H
+#define FMI1_XML_PARSER_HASH_H
+
+#define FMI1_XML_ELM_HASH_SEED 0x328BBA1FU
+#define FMI1_XML_ELM_HASH_MASK 63
+
+static const unsigned char fmi1_xml_elm_hash_table[64] = {
+	255, 23, 255, 255, 2, 255, 1, 9, 26, 255, 17, 255, 255, 29, 255, 255,
+	255, 21, 3, 28, 0, 5, 10, 255, 14, 24, 20, 19, 18, 255, 25, 255,
+	30, 255, 255, 255, 8, 7, 255, 255, 255, 13, 255, 255, 15, 255, 255, 16,
+	11, 255, 22, 255, 4, 27, 255, 255, 6, 255, 255, 255, 255, 255, 12, 255
+};
+
+#define FMI1_XML_ATTR_HASH_SEED 0x4459BF80U
+#define FMI1_XML_ATTR_HASH_MASK 127
+
+static const unsigned char fmi1_xml_attr_hash_table[128] = {
+	255, 255, 255, 15, 0, 255, 255, 4, 255, 255, 37, 255, 255, 13, 255, 33,
+	255, 255, 255, 255, 255, 255, 255, 255, 11, 10, 18, 8, 17, 255, 255, 27,
+	255, 19, 255, 255, 255, 30, 31, 255, 14, 255, 255, 255, 255, 16, 255, 255,
+	255, 255, 255, 255, 255, 255, 9, 255, 40, 255, 255, 44, 255, 22, 46, 3,
+	7, 255, 255, 24, 1, 255, 255, 255, 255, 41, 38, 255, 255, 34, 42, 26,
+	255, 45, 43, 255, 255, 29, 255, 255, 255, 255, 12, 255, 5, 32, 39, 255,
+	255, 255, 35, 20, 255, 255, 25, 255, 255, 255, 255, 255, 2, 28, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 6, 21, 255, 255, 23, 255, 255, 36
+};
+
+#endif /* FMI1_XML_PARSER_HASH_H */
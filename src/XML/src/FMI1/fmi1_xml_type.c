@@ -205,14 +205,16 @@ void fmi1_xml_init_enumeration_type_properties(fmi1_xml_enum_type_props_t* type,
 }
 
 void fmi1_xml_free_enumeration_type_props(fmi1_xml_enum_type_props_t* type) {
-    jm_named_vector_free_data(&type->enumItems);
+    /* The items are allocated in the model description arena */
+    jm_vector_free_data(jm_named_ptr)(&type->enumItems);
 }
 
 
-void fmi1_xml_init_type_definitions(fmi1_xml_type_definitions_t* td, jm_callbacks* cb) {
+void fmi1_xml_init_type_definitions(fmi1_xml_type_definitions_t* td, jm_arena_t* arena, jm_callbacks* cb) {
+    td->arena = arena;
     jm_vector_init(jm_named_ptr)(&td->typeDefinitions,0,cb);
 
-    jm_vector_init(jm_string)(&td->quantities, 0, cb);
+    jm_string_intern_init(&td->quantities, cb);
 
     fmi1_xml_init_real_type_properties(&td->defaultRealType);
     td->defaultRealType.typeBase.structKind = fmi1_xml_type_struct_enu_base;
@@ -228,10 +230,7 @@ void fmi1_xml_init_type_definitions(fmi1_xml_type_definitions_t* td, jm_callback
 }
 
 void fmi1_xml_free_type_definitions_data(fmi1_xml_type_definitions_t* td) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-
-    jm_vector_foreach(jm_string)(&td->quantities,(void(*)(const char*))cb->free);
-    jm_vector_free_data(jm_string)(&td->quantities);
+    jm_string_intern_free_data(&td->quantities);
 
     {
         fmi1_xml_variable_type_base_t* next;
@@ -242,13 +241,12 @@ void fmi1_xml_free_type_definitions_data(fmi1_xml_type_definitions_t* td) {
                 fmi1_xml_enum_type_props_t* props = (fmi1_xml_enum_type_props_t*)cur;
                 fmi1_xml_free_enumeration_type_props(props);
             }
-            cb->free(cur);
             cur = next;
         }
 		td->typePropsList = 0;
     }
 
-    jm_named_vector_free_data(&td->typeDefinitions);
+    jm_vector_free_data(jm_named_ptr)(&td->typeDefinitions);
 }
 
 int fmi1_xml_handle_TypeDefinitions(fmi1_xml_parser_context_t *context, const char* data) {
@@ -258,7 +256,7 @@ int fmi1_xml_handle_TypeDefinitions(fmi1_xml_parser_context_t *context, const ch
     else {
         fmi1_xml_type_definitions_t* defs =  &context->modelDescription->typeDefinitions;
 
-        jm_vector_qsort(jm_named_ptr)(&defs->typeDefinitions, jm_compare_named);
+        jm_named_vector_sort(&defs->typeDefinitions);
         /* might give out a warning if(data[0] != 0) */
         return 0;
     }
@@ -285,7 +283,7 @@ int fmi1_xml_handle_Type(fmi1_xml_parser_context_t *context, const char* data) {
             pnamed = jm_vector_push_back(jm_named_ptr)(&td->typeDefinitions,named);
             if(pnamed) {
                 fmi1_xml_variable_typedef_t dummy;
-                *pnamed = named = jm_named_alloc_v(bufName, sizeof(fmi1_xml_variable_typedef_t), dummy.typeName - (char*)&dummy,  context->callbacks);
+                *pnamed = named = jm_named_alloc_v_arena(bufName, sizeof(fmi1_xml_variable_typedef_t), dummy.typeName - (char*)&dummy, td->arena);
             }
             if(!pnamed || !named.ptr) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
@@ -295,7 +293,7 @@ int fmi1_xml_handle_Type(fmi1_xml_parser_context_t *context, const char* data) {
                 fmi1_xml_variable_typedef_t* type = named.ptr;
                 fmi1_xml_init_variable_type_base(&type->typeBase,fmi1_xml_type_struct_enu_typedef,fmi1_base_type_real);
                 if(jm_vector_get_size(char)(bufDescr)) {
-                    const char* description = jm_string_set_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
+                    const char* description = jm_string_intern_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
                     type->description = description;
                 }
                 else type->description = "";
@@ -329,8 +327,7 @@ int fmi1_check_last_elem_is_specific_type(fmi1_xml_parser_context_t *context) {
 }
 
 fmi1_xml_variable_type_base_t* fmi1_xml_alloc_variable_type_props(fmi1_xml_type_definitions_t* td, fmi1_xml_variable_type_base_t* base, size_t typeSize) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-    fmi1_xml_variable_type_base_t* type = cb->malloc(typeSize);
+    fmi1_xml_variable_type_base_t* type = jm_arena_alloc(td->arena, typeSize);
     if(!type) return 0;
     fmi1_xml_init_variable_type_base(type,fmi1_xml_type_struct_enu_props,base->baseType);
     type->baseTypeStruct = base;
@@ -340,8 +337,7 @@ fmi1_xml_variable_type_base_t* fmi1_xml_alloc_variable_type_props(fmi1_xml_type_
 }
 
 fmi1_xml_variable_type_base_t* fmi1_xml_alloc_variable_type_start(fmi1_xml_type_definitions_t* td,fmi1_xml_variable_type_base_t* base, size_t typeSize) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-    fmi1_xml_variable_type_base_t* type = cb->malloc(typeSize);
+    fmi1_xml_variable_type_base_t* type = jm_arena_alloc(td->arena, typeSize);
     if(!type) return 0;
     fmi1_xml_init_variable_type_base(type,fmi1_xml_type_struct_enu_start,base->baseType);
     type->baseTypeStruct = base;
@@ -378,13 +374,13 @@ fmi1_xml_real_type_props_t* fmi1_xml_parse_real_type_properties(fmi1_xml_parser_
         return 0;
     }
     if(jm_vector_get_size(char)(bufQuantity))
-        quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+        quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
     props->quantity = quantity;
     props->displayUnit = 0;
     if(jm_vector_get_size(char)(bufDispUnit)) {
         named.name = jm_vector_get_itemp(char)(bufDispUnit, 0);
-        pnamed = jm_vector_bsearch(jm_named_ptr)(&(md->displayUnitDefinitions), &named, jm_compare_named);
+        pnamed = jm_named_vector_search(&(md->displayUnitDefinitions), named.name);
         if(!pnamed) {
             fmi1_xml_parse_fatal(context, "Unknown display unit %s in real type definition", jm_vector_get_itemp(char)(bufDispUnit, 0));
             return 0;
@@ -449,7 +445,7 @@ fmi1_xml_integer_type_props_t * fmi1_xml_parse_integer_type_properties(fmi1_xml_
             )
         return 0;
     if(jm_vector_get_size(char)(bufQuantity))
-        quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+        quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
     props->quantity = quantity;
 
@@ -544,7 +540,7 @@ int fmi1_xml_handle_EnumerationType(fmi1_xml_parser_context_t *context, const ch
                 )
             return -1;
         if(jm_vector_get_size(char)(bufQuantity))
-            quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+            quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
         props->quantity = quantity;
 
@@ -594,7 +590,7 @@ int fmi1_xml_handle_Item(fmi1_xml_parser_context_t *context, const char* data) {
 			named.name = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&enumProps->enumItems, named);
 
-            if(pnamed) *pnamed = named = jm_named_alloc_v(bufName,sizeof(fmi1_xml_enum_type_item_t)+descrlen+1,sizeof(fmi1_xml_enum_type_item_t)+descrlen,context->callbacks);
+            if(pnamed) *pnamed = named = jm_named_alloc_v_arena(bufName,sizeof(fmi1_xml_enum_type_item_t)+descrlen+1,sizeof(fmi1_xml_enum_type_item_t)+descrlen,&md->arena);
             item = named.ptr;
             if( !pnamed || !item ) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
@@ -620,7 +616,7 @@ fmi1_xml_variable_type_base_t* fmi1_get_declared_type(fmi1_xml_parser_context_t
     fmi1_xml_set_attr_string(context, elmID, fmi_attr_id_declaredType, 0, bufDeclaredType);
     if(! jm_vector_get_size(char)(bufDeclaredType) ) return defaultType;
     key.name = jm_vector_get_itemp(char)(bufDeclaredType,0);
-    found = jm_vector_bsearch(jm_named_ptr)(&(context->modelDescription->typeDefinitions.typeDefinitions),&key, jm_compare_named);
+    found = jm_named_vector_search(&(context->modelDescription->typeDefinitions.typeDefinitions), key.name);
     if(!found) {
         jm_log_error(context->callbacks, module, "Declared type %s not found in type definitions. Ignoring.", key.name);
         return defaultType;
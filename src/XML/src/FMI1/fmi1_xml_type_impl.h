@@ -17,7 +17,7 @@
 #define FMI1_XML_TYPEIMPL_H
 
 #include <JM/jm_named_ptr.h>
-#include <JM/jm_string_set.h>
+#include <JM/jm_string_intern.h>
 #include <FMI1/fmi1_xml_model_description.h>
 
 #include "fmi1_xml_parser.h"
@@ -149,10 +149,12 @@ static fmi1_xml_variable_type_base_t* fmi1_xml_find_type_props(fmi1_xml_variable
 struct fmi1_xml_type_definitions_t {
     jm_vector(jm_named_ptr) typeDefinitions;
 
-    jm_string_set quantities;
+    jm_string_intern_t quantities;
 
     fmi1_xml_variable_type_base_t* typePropsList;
 
+    jm_arena_t* arena;
+
     fmi1_xml_real_type_props_t defaultRealType;
     fmi1_xml_enum_type_props_t defaultEnumType;
     fmi1_xml_integer_type_props_t defaultIntegerType;
@@ -160,7 +162,7 @@ struct fmi1_xml_type_definitions_t {
     fmi1_xml_string_type_props_t defaultStringType;
 };
 
-extern void fmi1_xml_init_type_definitions(fmi1_xml_type_definitions_t* td, jm_callbacks* cb) ;
+extern void fmi1_xml_init_type_definitions(fmi1_xml_type_definitions_t* td, jm_arena_t* arena, jm_callbacks* cb) ;
 
 extern void fmi1_xml_free_type_definitions_data(fmi1_xml_type_definitions_t* td);
 
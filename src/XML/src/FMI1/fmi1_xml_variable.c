@@ -17,6 +17,7 @@
 #include <stdio.h>
 
 #include <JM/jm_vector.h>
+#include <JM/jm_thread_pool.h>
 
 #include "fmi1_xml_parser.h"
 #include "fmi1_xml_type_impl.h"
@@ -332,14 +333,14 @@ int fmi1_xml_handle_ScalarVariable(fmi1_xml_parser_context_t *context, const cha
                 return 0;
             }
             if(jm_vector_get_size(char)(bufDescr)) {
-                description = jm_string_set_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
+                description = jm_string_intern_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
             }
 
             named.ptr = 0;
 			named.name = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&md->variablesByName, named);
 
-            if(pnamed) *pnamed = named = jm_named_alloc_v(bufName,sizeof(fmi1_xml_variable_t), dummyV.name - (char*)&dummyV, context->callbacks);
+            if(pnamed) *pnamed = named = jm_named_alloc_v_arena(bufName,sizeof(fmi1_xml_variable_t), dummyV.name - (char*)&dummyV, &md->arena);
             variable = named.ptr;
             if( !pnamed || !variable ) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
@@ -843,7 +844,6 @@ void fmi1_xml_eliminate_bad_alias(fmi1_xml_parser_context_t *context, size_t ind
 		jm_vector_remove_item(jm_voidp)(md->variablesOrigOrder,index);
 		
 		jm_log_error(context->callbacks, module,"Removing incorrect alias variable '%s'", v->name);
-        md->callbacks->free(v);
     }
 }
 
@@ -861,6 +861,62 @@ static int fmi1_xml_compare_vr_and_original_index (const void* first, const void
 	return ret;
 }
 
+#define JM_SORT_TEMPLATE_TYPE jm_voidp
+#define JM_SORT_TEMPLATE_NAME fmi1_xml_vr
+#define JM_SORT_TEMPLATE_LESS(a, b) (fmi1_xml_compare_vr_and_original_index(a, b) < 0)
+#include <JM/jm_sort_template.h>
+
+/* The variables in variablesByName are ordered by name and then by original index, so that the order does not depend on the sorting */
+static int fmi1_xml_is_name_less(const jm_named_ptr* a, const jm_named_ptr* b) {
+    int c = strcmp(a->name, b->name);
+    return (c < 0) || ((c == 0) &&
+        (((fmi1_xml_variable_t*)a->ptr)->originalIndex < ((fmi1_xml_variable_t*)b->ptr)->originalIndex));
+}
+
+#define JM_SORT_TEMPLATE_TYPE jm_named_ptr
+#define JM_SORT_TEMPLATE_NAME fmi1_xml_name
+#define JM_SORT_TEMPLATE_LESS(a, b) fmi1_xml_is_name_less(a, b)
+#include <JM/jm_sort_template.h>
+
+/*
+    Sort variablesByName and variablesByVR. With several threads the two vectors are sorted at the same time
+    with a parallel merge sort. Both the orders are total, so the result is the same for any number of threads.
+    Returns 0 on success.
+*/
+static int fmi1_xml_sort_variables(fmi1_xml_model_description_t* md) {
+    size_t n = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+    jm_thread_pool_t* pool = 0;
+
+    if((md->numThreads > 1) && (n >= 2 * JM_PARALLEL_SORT_MIN_CHUNK)) {
+        pool = jm_thread_pool_create(md->callbacks, md->numThreads);
+    }
+    if(pool) {
+        jm_parallel_sort_t sorts[2];
+        jm_status_enu_t status;
+
+        jm_log_verbose(md->callbacks, module, "Sorting %u variables using %u threads", (unsigned)n, md->numThreads);
+        sorts[0].items = jm_vector_get_itemp(jm_named_ptr)(&md->variablesByName, 0);
+        sorts[0].numItems = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
+        sorts[0].itemSize = sizeof(jm_named_ptr);
+        sorts[0].sortChunk = jm_sort_array(fmi1_xml_name);
+        sorts[0].merge = jm_sort_merge(fmi1_xml_name);
+        sorts[0].context = 0;
+        sorts[1].items = jm_vector_get_itemp(jm_voidp)(md->variablesByVR, 0);
+        sorts[1].numItems = n;
+        sorts[1].itemSize = sizeof(jm_voidp);
+        sorts[1].sortChunk = jm_sort_array(fmi1_xml_vr);
+        sorts[1].merge = jm_sort_merge(fmi1_xml_vr);
+        sorts[1].context = 0;
+        status = jm_thread_pool_sort(pool, sorts, 2);
+        jm_thread_pool_free(pool);
+        return (status == jm_status_success) ? 0 : -1;
+    }
+
+    jm_vector_sort(fmi1_xml_name)(&md->variablesByName);
+    jm_vector_sort(fmi1_xml_vr)(md->variablesByVR);
+    return 0;
+}
+
 int fmi1_xml_handle_ModelVariables(fmi1_xml_parser_context_t *context, const char* data) {
     if(!data) {
 		jm_log_verbose(context->callbacks, module,"Parsing XML element ModelVariables");
@@ -890,7 +946,6 @@ int fmi1_xml_handle_ModelVariables(fmi1_xml_parser_context_t *context, const cha
                 jm_vector_remove_item(jm_named_ptr)(&md->variablesByName,i);
                 numvar--; i--;
                 fmi1_xml_free_direct_dependencies(named);
-                md->callbacks->free(v);
                 assert(0);
             }
 			if (v->causality == fmi1_causality_enu_input){
@@ -941,9 +996,6 @@ int fmi1_xml_handle_ModelVariables(fmi1_xml_parser_context_t *context, const cha
 		jm_vector_free(jm_voidp)(inputVars);
 		jm_vector_free(jm_voidp)(outputVars);
 		
-		/* sort the variables by names */
-        jm_vector_qsort(jm_named_ptr)(&md->variablesByName,jm_compare_named);
-
         /* create VR index */
         md->status = fmi1_xml_model_description_enu_ok;
 		{
@@ -964,7 +1016,12 @@ int fmi1_xml_handle_ModelVariables(fmi1_xml_parser_context_t *context, const cha
             return -1;
         }
         varByVR = md->variablesByVR;
-        jm_vector_qsort(jm_voidp)(varByVR, fmi1_xml_compare_vr_and_original_index);
+
+        /* sort the variables by names and by VR */
+        if(fmi1_xml_sort_variables(md)) {
+            fmi1_xml_parse_fatal(context, "Could not allocate memory");
+            return -1;
+        }
         numvar = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
 
         if(numvar > 0) {
@@ -1058,7 +1115,7 @@ int fmi1_xml_handle_ModelVariables(fmi1_xml_parser_context_t *context, const cha
                 fmi1_xml_variable_t* depvar;
                 key.name = name;
 				key.ptr = 0;
-				found = jm_vector_bsearch(jm_named_ptr)(&md->variablesByName, &key, jm_compare_named);
+				found = jm_named_vector_search(&md->variablesByName, key.name);
 				if(found)
 					depvar = found->ptr;
 				else
@@ -22,8 +22,8 @@
 static const char* module = "FMI1XML";
 
 void fmi1_xml_vendor_free(fmi1_xml_vendor_t* v) {
-    jm_named_vector_free_data(&v->annotations);
-    v->annotations.callbacks->free(v);
+    /* The vendor and the annotations are allocated in the model description arena */
+    jm_vector_free_data(jm_named_ptr)(&v->annotations);
 }
 
 const char* fmi1_xml_get_vendor_name(fmi1_xml_vendor_t* v) {
@@ -70,7 +70,7 @@ int fmi1_xml_handle_Tool(fmi1_xml_parser_context_t *context, const char* data) {
             if( fmi1_xml_set_attr_string(context, fmi1_xml_elmID_Tool, fmi_attr_id_name, 1, bufName)) return -1;
             pvendor = jm_vector_push_back(jm_voidp)(&md->vendorList, vendor);
             if(pvendor )
-                *pvendor = vendor = jm_named_alloc_v(bufName,sizeof(fmi1_xml_vendor_t), dummyV.name - (char*)&dummyV, context->callbacks).ptr;
+                *pvendor = vendor = jm_named_alloc_v_arena(bufName,sizeof(fmi1_xml_vendor_t), dummyV.name - (char*)&dummyV, &md->arena).ptr;
             if(!pvendor || !vendor) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
                 return -1;
@@ -106,7 +106,7 @@ int fmi1_xml_handle_Annotation(fmi1_xml_parser_context_t *context, const char* d
 			named.name = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&vendor->annotations, named);
 
-            if(pnamed) *pnamed = named = jm_named_alloc_v(bufName,sizeof(fmi1_xml_annotation_t)+vallen+1,sizeof(fmi1_xml_annotation_t)+vallen,context->callbacks);
+            if(pnamed) *pnamed = named = jm_named_alloc_v_arena(bufName,sizeof(fmi1_xml_annotation_t)+vallen+1,sizeof(fmi1_xml_annotation_t)+vallen,&md->arena);
             annotation = named.ptr;
             if( !pnamed || !annotation ) {
                 fmi1_xml_parse_fatal(context, "Could not allocate memory");
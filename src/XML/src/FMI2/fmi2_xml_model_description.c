@@ -41,6 +41,8 @@ fmi2_xml_model_description_t * fmi2_xml_allocate_model_description( jm_callbacks
 
     md->callbacks = cb;
 
+    jm_arena_init(&md->arena, 0, cb);
+
     md->status = fmi2_xml_model_description_enu_empty;
 
     jm_vector_init(char)( & md->fmi2_xml_standard_version, 0,cb);
@@ -79,7 +81,7 @@ fmi2_xml_model_description_t * fmi2_xml_allocate_model_description( jm_callbacks
     jm_vector_init(jm_named_ptr)(&md->unitDefinitions, 0, cb);
     jm_vector_init(jm_named_ptr)(&md->displayUnitDefinitions, 0, cb);
 
-    fmi2_xml_init_type_definitions(&md->typeDefinitions, cb);
+    fmi2_xml_init_type_definitions(&md->typeDefinitions, &md->arena, cb);
 
     jm_vector_init(jm_named_ptr)(&md->variablesByName, 0, cb);
 
@@ -87,7 +89,9 @@ fmi2_xml_model_description_t * fmi2_xml_allocate_model_description( jm_callbacks
 
 	md->variablesByVR = 0;
 
-    jm_vector_init(jm_string)(&md->descriptions, 0, cb);
+    jm_named_index_init(&md->variablesByNameIndex, cb);
+
+    jm_string_intern_init(&md->descriptions, cb);
 
     md->fmuKind = fmi2_fmu_kind_unknown;
 
@@ -130,27 +134,27 @@ void fmi2_xml_clear_model_description( fmi2_xml_model_description_t* md) {
 
     md->defaultExperimentStepSize = 0;
 
-    jm_vector_foreach(jm_string)(&md->sourceFilesME, (void(*)(const char*))md->callbacks->free);
+    /* The strings, units, types and variables live in the arena, so only the vectors are released here */
     jm_vector_free_data(jm_string)(&md->sourceFilesME);	
-
-    jm_vector_foreach(jm_string)(&md->sourceFilesCS, (void(*)(const char*))md->callbacks->free);
     jm_vector_free_data(jm_string)(&md->sourceFilesCS);	
-
-    jm_vector_foreach(jm_string)(&md->vendorList, (void(*)(const char*))md->callbacks->free);
     jm_vector_free_data(jm_string)(&md->vendorList);
-
-    jm_vector_foreach(jm_string)(&md->logCategories, (void(*)(const char*))md->callbacks->free);
     jm_vector_free_data(jm_string)(&md->logCategories);	
-
-    jm_vector_foreach(jm_string)(&md->logCategoryDescriptions, (void(*)(const char*))md->callbacks->free);
     jm_vector_free_data(jm_string)(&md->logCategoryDescriptions);	
 
-    jm_named_vector_free_data(&md->unitDefinitions);
-    jm_named_vector_free_data(&md->displayUnitDefinitions);
+    {
+        size_t i, n = jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions);
+        for(i = 0; i < n; i++) {
+            fmi2_xml_unit_t* unit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+            /* the entry is added before the unit is allocated, so it may be empty after a failure */
+            if(unit) jm_vector_free_data(jm_voidp)(&unit->displayUnits);
+        }
+    }
+    jm_vector_free_data(jm_named_ptr)(&md->unitDefinitions);
+    jm_vector_free_data(jm_named_ptr)(&md->displayUnitDefinitions);
 
     fmi2_xml_free_type_definitions_data(&md->typeDefinitions);
 
-    jm_named_vector_free_data(&md->variablesByName);
+    jm_vector_free_data(jm_named_ptr)(&md->variablesByName);
 	if(md->variablesOrigOrder) {
 		jm_vector_free(jm_voidp)(md->variablesOrigOrder);
 		md->variablesOrigOrder = 0;
@@ -159,18 +163,47 @@ void fmi2_xml_clear_model_description( fmi2_xml_model_description_t* md) {
 		jm_vector_free(jm_voidp)(md->variablesByVR);
 		md->variablesByVR = 0;
 	}
+    jm_named_index_free_data(&md->variablesByNameIndex);
+    {
+        int i;
+        for(i = 0; i < FMI2_XML_VR_INDEX_NUM; i++) {
+            md->callbacks->free(md->variablesByVRIndex[i].slots);
+            md->variablesByVRIndex[i].slots = 0;
+            md->variablesByVRIndex[i].size = 0;
+        }
+    }
 
-    jm_vector_foreach(jm_string)(&md->descriptions, (void(*)(const char*))md->callbacks->free);
-    jm_vector_free_data(jm_string)(&md->descriptions);
+    jm_string_intern_free_data(&md->descriptions);
 
 	fmi2_xml_free_model_structure(md->modelStructure);
 	md->modelStructure = 0;
+
+    jm_arena_free_data(&md->arena);
+
+    fmi_xml_unmap_file(&md->image, md->callbacks);
 }
 
 int fmi2_xml_is_model_description_empty(fmi2_xml_model_description_t* md) {
     return (md->status == fmi2_xml_model_description_enu_empty);
 }
 
+void fmi2_xml_set_skipped_sections(fmi2_xml_model_description_t* md, unsigned int skipSections) {
+    md->skippedSections = skipSections & fmi_xml_section_all;
+}
+
+void fmi2_xml_set_parse_threads(fmi2_xml_model_description_t* md, unsigned int numThreads) {
+    md->numThreads = numThreads;
+}
+
+unsigned int fmi2_xml_get_parsed_sections(fmi2_xml_model_description_t* md) {
+    return fmi_xml_section_all & ~md->skippedSections;
+}
+
+void fmi2_xml_set_variable_handle(fmi2_xml_model_description_t* md, fmi2_xml_variable_handle_ft handle, void* context) {
+    md->variableHandle = handle;
+    md->variableHandleContext = context;
+}
+
 const char* fmi2_xml_get_last_error(fmi2_xml_model_description_t* md) {
 	return jm_get_last_error(md->callbacks);
 }
@@ -407,11 +440,21 @@ int fmi2_xml_handle_fmiModelDescription(fmi2_xml_parser_context_t *context, cons
 			fmi2_xml_parse_error(context, "Model identifier '%s' is not valid (must be a valid C-identifier)", fmi2_xml_get_model_identifier_CS(md));
 			return -1;
 		}
+		if((md->skippedSections & fmi_xml_section_model_structure) && md->variablesOrigOrder && !md->variableHandle) {
+			/* the states are listed under Derivatives, which holds every variable with a derivative attribute;
+			   streamed variables are counted as they are parsed */
+			size_t i, n = jm_vector_get_size(jm_voidp)(md->variablesOrigOrder);
+			md->numberOfContinuousStates = 0;
+			for(i = 0; i < n; i++) {
+				fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesOrigOrder, i);
+				if(v->derivativeOf) md->numberOfContinuousStates++;
+			}
+		}
 		if( (md->fmuKind == fmi2_fmu_kind_me_and_cs) && (strcmp(fmi2_xml_get_model_identifier_CS(md), fmi2_xml_get_model_identifier_ME(md)) == 0)) {
 			jm_log_info(context->callbacks,module, "Found model identifiers for ModelExchange and CoSimulation");
 			return 1;
 		}
-		if(!md->modelStructure) {
+		if(!md->modelStructure && !(md->skippedSections & fmi_xml_section_model_structure)) {
 			fmi2_xml_parse_fatal(context, "No model structure information available. Cannot continue.");
 			return -1;
 		}
@@ -425,8 +468,8 @@ int fmi2_xml_handle_ModelExchange(fmi2_xml_parser_context_t *context, const char
 		jm_log_verbose(context->callbacks, module, "Parsing XML element ModelExchange");
 
         /*  reset handles for the elements that are specific under ModelExchange */
-        fmi2_xml_set_element_handle(context, "SourceFiles", FMI2_XML_ELM_ID(SourceFiles));
-        fmi2_xml_set_element_handle(context, "File", FMI2_XML_ELM_ID(File));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(SourceFiles), FMI2_XML_ELM_ID(SourceFiles));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(File), FMI2_XML_ELM_ID(File));
 
 		md->fmuKind = fmi2_fmu_kind_me;
         /* process the attributes */
@@ -476,8 +519,8 @@ int fmi2_xml_handle_CoSimulation(fmi2_xml_parser_context_t *context, const char*
 		jm_log_verbose(context->callbacks, module, "Parsing XML element CoSimulation");
 
         /*  reset handles for the elements that are specific under CoSimulation */
-        fmi2_xml_set_element_handle(context, "SourceFiles", FMI2_XML_ELM_ID(SourceFilesCS));
-        fmi2_xml_set_element_handle(context, "File", FMI2_XML_ELM_ID(FileCS));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(SourceFiles), FMI2_XML_ELM_ID(SourceFilesCS));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(File), FMI2_XML_ELM_ID(FileCS));
 
 		if(md->fmuKind == fmi2_fmu_kind_me)
 			md->fmuKind = fmi2_fmu_kind_me_and_cs;
@@ -545,7 +588,7 @@ static int push_back_jm_string(fmi2_xml_parser_context_t *context, jm_vector(jm_
     pstring = jm_vector_push_back(jm_string)(stringvector, string);
 	len = jm_vector_get_size(char)(buf);
     if(pstring )
-        *pstring = string = (char*)(context->callbacks->malloc(len + 1));
+        *pstring = string = (char*)jm_arena_alloc(&context->modelDescription->arena, len + 1);
 	if(!pstring || !string) {
 	    fmi2_xml_parse_fatal(context, "Could not allocate memory");
 		return -1;
@@ -665,31 +708,104 @@ jm_vector(jm_voidp)* fmi2_xml_get_variables_vr_order(fmi2_xml_model_description_
 
 
 fmi2_xml_variable_t* fmi2_xml_get_variable_by_name(fmi2_xml_model_description_t* md, const char* name) {
-	jm_named_ptr key, *found;
-    key.name = name;
-    found = jm_vector_bsearch(jm_named_ptr)(&md->variablesByName, &key, jm_compare_named);
-	if(!found) return 0;
-	return found->ptr;
+	return (fmi2_xml_variable_t*)jm_named_index_find(&md->variablesByNameIndex, name);
 }
 
+/* Integer and Enumeration variables share the value references */
+static fmi2_xml_vr_index_t* fmi2_xml_get_vr_index(fmi2_xml_model_description_t* md, fmi2_base_type_enu_t baseType) {
+	return &md->variablesByVRIndex[(baseType == fmi2_base_type_enum) ? fmi2_base_type_int : baseType];
+}
+
+/* Home slot of a value reference in a hash table (Fibonacci hashing) */
+static size_t fmi2_xml_vr_hash(fmi2_value_reference_t vr, size_t size) {
+	unsigned int h = (vr * 2654435769U) & 0xFFFFFFFFU;
+	return (h ^ (h >> 16)) & (size - 1);
+}
 
 fmi2_xml_variable_t* fmi2_xml_get_variable_by_vr(fmi2_xml_model_description_t* md, fmi2_base_type_enu_t baseType, fmi2_value_reference_t vr) {
-    fmi2_xml_variable_t key;
-    fmi2_xml_variable_t *pkey = &key;
-	fmi2_xml_variable_type_base_t keyType;
-	fmi2_xml_variable_t *v = 0;
-    void ** found;
+	fmi2_xml_vr_index_t* x;
+	size_t i;
+	if(baseType > fmi2_base_type_enum) return 0;
+	x = fmi2_xml_get_vr_index(md, baseType);
+	if(!x->size) return 0;
+	if(x->isDense) {
+		if((vr < x->minVR) || ((size_t)(vr - x->minVR) >= x->size)) return 0;
+		return x->slots[vr - x->minVR];
+	}
+	for(i = fmi2_xml_vr_hash(vr, x->size); x->slots[i]; i = (i + 1) & (x->size - 1)) {
+		if(x->slots[i]->vr == vr) return x->slots[i];
+	}
+	return 0;
+}
+
+int fmi2_xml_build_variable_index(fmi2_xml_model_description_t* md) {
+	size_t count[FMI2_XML_VR_INDEX_NUM] = {0, 0, 0, 0};
+	fmi2_value_reference_t minVR[FMI2_XML_VR_INDEX_NUM], maxVR[FMI2_XML_VR_INDEX_NUM];
+	size_t i, k, n;
+
+	if(jm_named_index_build(&md->variablesByNameIndex, &md->variablesByName) != jm_status_success) return -1;
 	if(!md->variablesByVR) return 0;
-	keyType.structKind = fmi2_xml_type_struct_enu_props;
-	keyType.baseType = baseType;
-	key.typeBase = &keyType;
-	key.vr = vr;
-    key.aliasKind = fmi2_variable_is_not_alias;
-
-    found = jm_vector_bsearch(jm_voidp)(md->variablesByVR,(void**)&pkey, fmi2_xml_compare_vr);
-    if(!found) return 0;
-    v = (fmi2_xml_variable_t*)(*found);
-    return v;
+
+	/* only the base variables are indexed, aliases are found through them */
+	n = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+	for(i = 0; i < n; i++) {
+		fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
+		size_t t = fmi2_xml_get_vr_index(md, fmi2_xml_get_variable_base_type(v)) - md->variablesByVRIndex;
+		if(v->aliasKind != fmi2_variable_is_not_alias) continue;
+		if(!count[t] || (v->vr < minVR[t])) minVR[t] = v->vr;
+		if(!count[t] || (v->vr > maxVR[t])) maxVR[t] = v->vr;
+		count[t]++;
+	}
+	for(k = 0; k < FMI2_XML_VR_INDEX_NUM; k++) {
+		fmi2_xml_vr_index_t* x = &md->variablesByVRIndex[k];
+		size_t span;
+		md->callbacks->free(x->slots);
+		x->slots = 0;
+		x->size = 0;
+		if(!count[k]) continue;
+		span = (size_t)(maxVR[k] - minVR[k]);
+		/* a direct table is used while about a quarter of it is filled, a half full hash table otherwise */
+		x->isDense = (span / 4 < count[k]);
+		x->minVR = minVR[k];
+		if(x->isDense) {
+			x->size = span + 1;
+		}
+		else {
+			x->size = 16;
+			while(x->size < 2 * count[k]) x->size *= 2;
+		}
+		x->slots = (fmi2_xml_variable_t**)md->callbacks->calloc(x->size, sizeof(fmi2_xml_variable_t*));
+		if(!x->slots) {
+			x->size = 0;
+			return -1;
+		}
+	}
+	for(i = 0; i < n; i++) {
+		fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
+		fmi2_xml_vr_index_t* x = fmi2_xml_get_vr_index(md, fmi2_xml_get_variable_base_type(v));
+		fmi2_xml_variable_t** slot;
+		if(v->aliasKind != fmi2_variable_is_not_alias) continue;
+		if(x->isDense) {
+			slot = &x->slots[v->vr - x->minVR];
+		}
+		else {
+			size_t j = fmi2_xml_vr_hash(v->vr, x->size);
+			while(x->slots[j] && (x->slots[j]->vr != v->vr)) j = (j + 1) & (x->size - 1);
+			slot = &x->slots[j];
+		}
+		/* the first base variable wins when Integer and Enumeration variables share a reference */
+		if(!*slot) *slot = v;
+	}
+	return 0;
+}
+
+void fmi2_xml_shrink_model_description(fmi2_xml_model_description_t* md) {
+	jm_vector_shrink_to_fit(jm_named_ptr)(&md->variablesByName);
+	if(md->variablesOrigOrder) jm_vector_shrink_to_fit(jm_voidp)(md->variablesOrigOrder);
+	if(md->variablesByVR) jm_vector_shrink_to_fit(jm_voidp)(md->variablesByVR);
+	jm_vector_shrink_to_fit(jm_named_ptr)(&md->unitDefinitions);
+	jm_vector_shrink_to_fit(jm_named_ptr)(&md->displayUnitDefinitions);
+	if(md->modelStructure) fmi2_xml_shrink_model_structure(md->modelStructure);
 }
 
 
@@ -6,12 +6,14 @@
 #include <JM/jm_callbacks.h>
 #include <JM/jm_vector.h>
 #include <JM/jm_named_ptr.h>
-#include <JM/jm_string_set.h>
+#include <JM/jm_string_intern.h>
+#include <JM/jm_named_index.h>
 #include <FMI2/fmi2_xml_model_description.h>
 
 #include "fmi2_xml_unit_impl.h"
 #include "fmi2_xml_type_impl.h"
 #include "fmi2_xml_variable_impl.h"
+#include "../FMI/fmi_xml_file.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,11 +25,29 @@ typedef enum fmi2_xml_model_description_status_enu_t {
     fmi2_xml_model_description_enu_error
 } fmi2_xml_model_description_status_enu_t;
 
+/* Number of value reference indices: Real, Integer and Enumeration, Boolean, String */
+#define FMI2_XML_VR_INDEX_NUM 4
+
+/*
+    Lookup of the base variables by value reference for one base type. The slots are addressed
+    directly with vr - minVR when the references are dense, otherwise they form a hash table with
+    linear probing where empty slots are NULL.
+*/
+typedef struct fmi2_xml_vr_index_t {
+    fmi2_xml_variable_t** slots;
+    size_t size; /* number of slots, a power of two for a hash table */
+    fmi2_value_reference_t minVR;
+    int isDense;
+} fmi2_xml_vr_index_t;
+
 /*  ModelDescription is the entry point for the package*/
 struct fmi2_xml_model_description_t {
 
     jm_callbacks* callbacks;
 
+    /* Storage for the objects created during parsing. They are all released at once in fmi2_xml_clear_model_description(). */
+    jm_arena_t arena;
+
     fmi2_xml_model_description_status_enu_t status;
 
     jm_vector(char) fmi2_xml_standard_version;
@@ -82,7 +102,7 @@ struct fmi2_xml_model_description_t {
 
     fmi2_xml_type_definitions_t typeDefinitions;
 
-    jm_string_set descriptions;
+    jm_string_intern_t descriptions;
 
 	jm_vector(jm_named_ptr) variablesByName;
 
@@ -90,13 +110,34 @@ struct fmi2_xml_model_description_t {
 
 	jm_vector(jm_voidp)* variablesByVR;
 
+    /* Constant time lookups, see fmi2_xml_build_variable_index() */
+    jm_named_index_t variablesByNameIndex;
+    fmi2_xml_vr_index_t variablesByVRIndex[FMI2_XML_VR_INDEX_NUM];
+
     fmi2_fmu_kind_enu_t fmuKind;
 
     unsigned int capabilities[fmi2_capabilities_Num];
 
 	fmi2_xml_model_structure_t* modelStructure;
+
+    unsigned int skippedSections; /* sections left out when parsing, see fmi2_xml_set_skipped_sections() */
+
+    unsigned int numThreads; /* threads sorting the variables, see fmi2_xml_set_parse_threads() */
+
+    /* Handle the variables are streamed to, see fmi2_xml_set_variable_handle() */
+    fmi2_xml_variable_handle_ft variableHandle;
+    void* variableHandleContext;
+
+    /* Image the model description was loaded from. Strings of the model point into it. */
+    fmi_xml_file_map_t image;
 };
 
+/* Build the name and value reference indices once the variable lists are complete. Returns 0 on success. */
+int fmi2_xml_build_variable_index(fmi2_xml_model_description_t* md);
+
+/* Release the unused capacity of the large vectors once parsing is complete */
+void fmi2_xml_shrink_model_description(fmi2_xml_model_description_t* md);
+
 void fmi2_xml_report_error(fmi2_xml_model_description_t* md, const char* module, const char* fmt, ...);
 
 void fmi2_xml_report_error_v(fmi2_xml_model_description_t* md, const char* module, const char* fmt, va_list ap);
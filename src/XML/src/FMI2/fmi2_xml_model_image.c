@@ -0,0 +1,1391 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/** \file fmi2_xml_model_image.c
+*  \brief Binary images of parsed model descriptions.
+*
+*  An image consists of a header followed by sections of records. Objects refer to each other by indices
+*  and to strings by offsets into the string pool, so the image does not depend on where it is loaded.
+*  Variables, which make up most of a model description, are stored as fmi2_xml_variable_t structures
+*  with their names and are used in place: the image is mapped privately and loading only replaces the
+*  indices in their reference fields with pointers. Units and types are rebuilt in the arena of the model
+*  description from their records, while descriptions and other strings are used in place.
+*/
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "fmi2_xml_model_description_impl.h"
+#include "fmi2_xml_model_structure_impl.h"
+
+static const char* module = "FMI2XML";
+
+#define FMI2_XML_IMAGE_MAGIC "FMI2MDI"
+#define FMI2_XML_IMAGE_VERSION 2
+#define FMI2_XML_IMAGE_BYTE_ORDER 0x01020304u
+/* Images are only compatible between builds that agree on the sizes of the basic types */
+#define FMI2_XML_IMAGE_ABI ((unsigned int)(sizeof(size_t) | (sizeof(double) << 8) | (sizeof(int) << 16) | (sizeof(void*) << 24)))
+
+/* Sections start at multiples of this so that records can be accessed in place */
+#define FMI2_XML_IMAGE_ALIGN 8
+
+/* Reference to a string (offset into the string pool) or an object (index into its section) */
+typedef unsigned int fmi2_xml_image_ref_t;
+#define FMI2_XML_IMAGE_NONE 0xFFFFFFFFu
+
+typedef enum fmi2_xml_image_section_enu_t {
+    fmi2_xml_image_strings,
+    fmi2_xml_image_model,
+    fmi2_xml_image_lists,
+    fmi2_xml_image_units,
+    fmi2_xml_image_display_units,
+    fmi2_xml_image_unit_display_units,
+    fmi2_xml_image_types,
+    fmi2_xml_image_typedefs,
+    fmi2_xml_image_items,
+    fmi2_xml_image_variables,
+    fmi2_xml_image_variable_offsets,
+    fmi2_xml_image_by_name,
+    fmi2_xml_image_by_vr,
+    fmi2_xml_image_structure,
+    fmi2_xml_image_dep_start,
+    fmi2_xml_image_dep_index,
+    fmi2_xml_image_dep_kind,
+    fmi2_xml_image_sections_Num
+} fmi2_xml_image_section_enu_t;
+
+typedef struct fmi2_xml_image_section_t {
+    size_t offset;
+    size_t count; /* number of records */
+} fmi2_xml_image_section_t;
+
+typedef struct fmi2_xml_image_header_t {
+    char magic[8];
+    unsigned int version;
+    unsigned int byteOrder;
+    unsigned int abi;
+    unsigned int variableLayout; /* offset of the name in fmi2_xml_variable_t */
+    size_t imageSize;
+    char key[FMI2_XML_IMAGE_KEY_SIZE];
+    fmi2_xml_image_section_t sections[fmi2_xml_image_sections_Num];
+} fmi2_xml_image_header_t;
+
+/* Strings of the model description in the order of the record */
+typedef enum fmi2_xml_image_string_enu_t {
+    fmi2_xml_image_str_standard_version,
+    fmi2_xml_image_str_model_name,
+    fmi2_xml_image_str_guid,
+    fmi2_xml_image_str_description,
+    fmi2_xml_image_str_author,
+    fmi2_xml_image_str_copyright,
+    fmi2_xml_image_str_license,
+    fmi2_xml_image_str_version,
+    fmi2_xml_image_str_generation_tool,
+    fmi2_xml_image_str_generation_date,
+    fmi2_xml_image_str_model_identifier_me,
+    fmi2_xml_image_str_model_identifier_cs,
+    fmi2_xml_image_str_Num
+} fmi2_xml_image_string_enu_t;
+
+/* String lists, stored one after the other in the lists section */
+typedef enum fmi2_xml_image_list_enu_t {
+    fmi2_xml_image_list_source_files_me,
+    fmi2_xml_image_list_source_files_cs,
+    fmi2_xml_image_list_log_categories,
+    fmi2_xml_image_list_log_category_descriptions,
+    fmi2_xml_image_list_vendors,
+    fmi2_xml_image_list_Num
+} fmi2_xml_image_list_enu_t;
+
+/* Outputs, derivatives, discrete states and initial unknowns */
+#define FMI2_XML_IMAGE_STRUCTURE_LISTS 4
+
+typedef struct fmi2_xml_image_dependencies_t {
+    int present;
+    int isRowMajor;
+    size_t numStart;
+    size_t numIndex;
+    size_t numKind;
+} fmi2_xml_image_dependencies_t;
+
+typedef struct fmi2_xml_image_model_t {
+    fmi2_xml_image_ref_t strings[fmi2_xml_image_str_Num];
+    fmi2_xml_image_ref_t listSize[fmi2_xml_image_list_Num];
+    int namingConvension;
+    int fmuKind;
+    unsigned int capabilities[fmi2_capabilities_Num];
+    size_t numberOfContinuousStates;
+    size_t numberOfEventIndicators;
+    double defaultExperimentStartTime;
+    double defaultExperimentStopTime;
+    double defaultExperimentTolerance;
+    double defaultExperimentStepSize;
+    size_t numVariables; /* variables of the model, the records after them are only referenced by other variables */
+    int hasVariableLists;
+    int hasStructure;
+    int isValidStructure;
+    size_t structureSize[FMI2_XML_IMAGE_STRUCTURE_LISTS];
+    fmi2_xml_image_dependencies_t deps[FMI2_XML_IMAGE_STRUCTURE_LISTS];
+} fmi2_xml_image_model_t;
+
+typedef struct fmi2_xml_image_unit_t {
+    fmi2_xml_image_ref_t name;
+    fmi2_xml_image_ref_t firstDisplayUnit; /* in the unit display units section */
+    fmi2_xml_image_ref_t numDisplayUnits;
+    int SI_base_unit_exp[fmi2_SI_base_units_Num];
+    double factor;
+    double offset;
+} fmi2_xml_image_unit_t;
+
+typedef struct fmi2_xml_image_display_unit_t {
+    fmi2_xml_image_ref_t name;
+    fmi2_xml_image_ref_t unit;
+    double factor;
+    double offset;
+} fmi2_xml_image_display_unit_t;
+
+/* One record per fmi2_xml_variable_type_base_t. The default types come first and a record always
+   comes after its base. */
+typedef struct fmi2_xml_image_type_t {
+    fmi2_xml_image_ref_t base;
+    fmi2_xml_image_ref_t name; /* type definitions */
+    fmi2_xml_image_ref_t text; /* description, quantity or string start value */
+    fmi2_xml_image_ref_t displayUnit; /* display unit or, after them, default display unit of a unit */
+    fmi2_xml_image_ref_t firstItem; /* enumeration items */
+    fmi2_xml_image_ref_t numItems;
+    int intValues[2]; /* min and max or start */
+    double realValues[3]; /* min, max and nominal or start */
+    char structKind;
+    char baseType;
+    char isRelativeQuantity;
+    char isUnbounded;
+} fmi2_xml_image_type_t;
+
+#define FMI2_XML_IMAGE_DEFAULT_TYPES 5
+
+typedef struct fmi2_xml_image_item_t {
+    fmi2_xml_image_ref_t name;
+    fmi2_xml_image_ref_t description;
+    int value;
+} fmi2_xml_image_item_t;
+
+/* Variables are fmi2_xml_variable_t structures followed by their names, each record starting at a
+   multiple of FMI2_XML_IMAGE_ALIGN. In the image typeBase, description, derivativeOf and previous hold
+   references cast to pointers, like the parser does for derivativeOf and previous until they can be
+   looked up. The offsets of the records are stored in a section of their own. */
+#define FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET offsetof(fmi2_xml_variable_t, name)
+
+static const size_t fmi2_xml_image_record_size[fmi2_xml_image_sections_Num] = {
+    1,
+    sizeof(fmi2_xml_image_model_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(fmi2_xml_image_unit_t),
+    sizeof(fmi2_xml_image_display_unit_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(fmi2_xml_image_type_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(fmi2_xml_image_item_t),
+    1,
+    sizeof(size_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(fmi2_xml_image_ref_t),
+    sizeof(size_t),
+    sizeof(size_t),
+    1
+};
+
+static size_t fmi2_xml_image_align(size_t offset) {
+    return (offset + FMI2_XML_IMAGE_ALIGN - 1) & ~(size_t)(FMI2_XML_IMAGE_ALIGN - 1);
+}
+
+/* Open addressing map from object addresses to their references in the image */
+typedef struct fmi2_xml_image_map_t {
+    const void** keys;
+    fmi2_xml_image_ref_t* values;
+    size_t mask;
+    size_t count;
+} fmi2_xml_image_map_t;
+
+static size_t fmi2_xml_image_hash(const void* key) {
+    size_t h = (size_t)key;
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static int fmi2_xml_image_map_alloc(fmi2_xml_image_map_t* map, size_t capacity, jm_callbacks* cb) {
+    map->keys = (const void**)cb->calloc(capacity, sizeof(void*));
+    map->values = (fmi2_xml_image_ref_t*)cb->malloc(capacity * sizeof(fmi2_xml_image_ref_t));
+    map->mask = capacity - 1;
+    map->count = 0;
+    if(!map->keys || !map->values) {
+        cb->free((void*)map->keys);
+        cb->free(map->values);
+        map->keys = 0;
+        map->values = 0;
+        return -1;
+    }
+    return 0;
+}
+
+static void fmi2_xml_image_map_free(fmi2_xml_image_map_t* map, jm_callbacks* cb) {
+    cb->free((void*)map->keys);
+    cb->free(map->values);
+    map->keys = 0;
+    map->values = 0;
+}
+
+static fmi2_xml_image_ref_t fmi2_xml_image_map_find(fmi2_xml_image_map_t* map, const void* key) {
+    size_t i = fmi2_xml_image_hash(key) & map->mask;
+    while(map->keys[i]) {
+        if(map->keys[i] == key) return map->values[i];
+        i = (i + 1) & map->mask;
+    }
+    return FMI2_XML_IMAGE_NONE;
+}
+
+/* The key must not be in the map. The map is kept at most half full. */
+static int fmi2_xml_image_map_insert(fmi2_xml_image_map_t* map, const void* key, fmi2_xml_image_ref_t value, jm_callbacks* cb) {
+    size_t i;
+    if(2 * (map->count + 1) > map->mask + 1) {
+        fmi2_xml_image_map_t grown;
+        size_t j;
+        if(fmi2_xml_image_map_alloc(&grown, 2 * (map->mask + 1), cb)) return -1;
+        for(j = 0; j <= map->mask; j++) {
+            if(!map->keys[j]) continue;
+            i = fmi2_xml_image_hash(map->keys[j]) & grown.mask;
+            while(grown.keys[i]) i = (i + 1) & grown.mask;
+            grown.keys[i] = map->keys[j];
+            grown.values[i] = map->values[j];
+        }
+        grown.count = map->count;
+        fmi2_xml_image_map_free(map, cb);
+        *map = grown;
+    }
+    i = fmi2_xml_image_hash(key) & map->mask;
+    while(map->keys[i]) i = (i + 1) & map->mask;
+    map->keys[i] = key;
+    map->values[i] = value;
+    map->count++;
+    return 0;
+}
+
+typedef struct fmi2_xml_image_writer_t {
+    fmi2_xml_model_description_t* md;
+    jm_callbacks* callbacks;
+    jm_vector(char) sections[fmi2_xml_image_sections_Num];
+    size_t counts[fmi2_xml_image_sections_Num];
+    fmi2_xml_image_map_t strings;
+    fmi2_xml_image_map_t displayUnits;
+    fmi2_xml_image_map_t types;
+    fmi2_xml_image_map_t variables;
+    jm_vector(jm_voidp) variableList; /* variables in the order of their records */
+    size_t numUnits;
+    size_t numDisplayUnits;
+    int failed;
+} fmi2_xml_image_writer_t;
+
+/* Add zero filled records to a section. Returns the first one or NULL if out of memory. */
+static void* fmi2_xml_image_append(fmi2_xml_image_writer_t* w, fmi2_xml_image_section_enu_t section, size_t count) {
+    jm_vector(char)* v = &w->sections[section];
+    size_t size = jm_vector_get_size(char)(v);
+    size_t add = count * fmi2_xml_image_record_size[section];
+    char* rec;
+
+    if(w->failed) return 0;
+    if(jm_vector_resize(char)(v, size + add) != size + add) {
+        w->failed = 1;
+        return 0;
+    }
+    w->counts[section] += count;
+    if(!add) return 0;
+    rec = jm_vector_get_itemp(char)(v, size);
+    memset(rec, 0, add);
+    return rec;
+}
+
+static fmi2_xml_image_ref_t* fmi2_xml_image_append_ref(fmi2_xml_image_writer_t* w, fmi2_xml_image_section_enu_t section) {
+    return (fmi2_xml_image_ref_t*)fmi2_xml_image_append(w, section, 1);
+}
+
+/* Strings are shared by address, so interned strings stay shared in the image */
+static fmi2_xml_image_ref_t fmi2_xml_image_string(fmi2_xml_image_writer_t* w, const char* str) {
+    fmi2_xml_image_ref_t ref;
+    size_t offset, len;
+    char* copy;
+
+    if(!str) return FMI2_XML_IMAGE_NONE;
+    if(!*str) return 0;
+    ref = fmi2_xml_image_map_find(&w->strings, str);
+    if(ref != FMI2_XML_IMAGE_NONE) return ref;
+    offset = w->counts[fmi2_xml_image_strings];
+    len = strlen(str) + 1;
+    if(offset + len >= FMI2_XML_IMAGE_NONE) {
+        w->failed = 1;
+        return FMI2_XML_IMAGE_NONE;
+    }
+    copy = (char*)fmi2_xml_image_append(w, fmi2_xml_image_strings, len);
+    if(!copy || fmi2_xml_image_map_insert(&w->strings, str, (fmi2_xml_image_ref_t)offset, w->callbacks)) {
+        w->failed = 1;
+        return FMI2_XML_IMAGE_NONE;
+    }
+    memcpy(copy, str, len);
+    return (fmi2_xml_image_ref_t)offset;
+}
+
+static fmi2_xml_image_ref_t fmi2_xml_image_display_unit_ref(fmi2_xml_image_writer_t* w, fmi2_xml_display_unit_t* du) {
+    fmi2_xml_image_ref_t ref;
+    if(!du) return FMI2_XML_IMAGE_NONE;
+    if(du == &du->baseUnit->defaultDisplay) {
+        ref = fmi2_xml_image_map_find(&w->displayUnits, du->baseUnit);
+        if(ref != FMI2_XML_IMAGE_NONE) return (fmi2_xml_image_ref_t)(w->numDisplayUnits + ref);
+    }
+    else {
+        ref = fmi2_xml_image_map_find(&w->displayUnits, du);
+        if(ref != FMI2_XML_IMAGE_NONE) return ref;
+    }
+    w->failed = 1;
+    return FMI2_XML_IMAGE_NONE;
+}
+
+/* Record of a type struct, written after the records of its base */
+static fmi2_xml_image_ref_t fmi2_xml_image_type(fmi2_xml_image_writer_t* w, fmi2_xml_variable_type_base_t* type) {
+    fmi2_xml_image_ref_t ref, base = FMI2_XML_IMAGE_NONE;
+    fmi2_xml_image_type_t* rec;
+
+    ref = fmi2_xml_image_map_find(&w->types, type);
+    if(ref != FMI2_XML_IMAGE_NONE) return ref;
+    if(type->baseTypeStruct) base = fmi2_xml_image_type(w, type->baseTypeStruct);
+    if(w->failed) return FMI2_XML_IMAGE_NONE;
+
+    ref = (fmi2_xml_image_ref_t)w->counts[fmi2_xml_image_types];
+    if(fmi2_xml_image_map_insert(&w->types, type, ref, w->callbacks)) {
+        w->failed = 1;
+        return FMI2_XML_IMAGE_NONE;
+    }
+    rec = (fmi2_xml_image_type_t*)fmi2_xml_image_append(w, fmi2_xml_image_types, 1);
+    if(!rec) return FMI2_XML_IMAGE_NONE;
+    rec->base = base;
+    rec->name = FMI2_XML_IMAGE_NONE;
+    rec->text = FMI2_XML_IMAGE_NONE;
+    rec->displayUnit = FMI2_XML_IMAGE_NONE;
+    rec->structKind = type->structKind;
+    rec->baseType = type->baseType;
+    rec->isRelativeQuantity = type->isRelativeQuantity;
+    rec->isUnbounded = type->isUnbounded;
+
+    /* only the other sections grow below, so rec stays in place */
+    if(type->structKind == fmi2_xml_type_struct_enu_typedef) {
+        fmi2_xml_variable_typedef_t* t = (fmi2_xml_variable_typedef_t*)type;
+        rec->name = fmi2_xml_image_string(w, t->typeName);
+        rec->text = fmi2_xml_image_string(w, t->description);
+    }
+    else if(type->structKind == fmi2_xml_type_struct_enu_props) {
+        switch(type->baseType) {
+        case fmi2_base_type_real: {
+            fmi2_xml_real_type_props_t* props = (fmi2_xml_real_type_props_t*)type;
+            rec->text = fmi2_xml_image_string(w, props->quantity);
+            rec->displayUnit = fmi2_xml_image_display_unit_ref(w, props->displayUnit);
+            rec->realValues[0] = props->typeMin;
+            rec->realValues[1] = props->typeMax;
+            rec->realValues[2] = props->typeNominal;
+            break;
+        }
+        case fmi2_base_type_int: {
+            fmi2_xml_integer_type_props_t* props = (fmi2_xml_integer_type_props_t*)type;
+            rec->text = fmi2_xml_image_string(w, props->quantity);
+            rec->intValues[0] = props->typeMin;
+            rec->intValues[1] = props->typeMax;
+            break;
+        }
+        case fmi2_base_type_enum: {
+            fmi2_xml_enum_variable_props_t* props = (fmi2_xml_enum_variable_props_t*)type;
+            rec->text = fmi2_xml_image_string(w, props->quantity);
+            rec->intValues[0] = props->typeMin;
+            rec->intValues[1] = props->typeMax;
+            if(!type->baseTypeStruct) {
+                /* properties of an enumeration type with the list of items */
+                jm_vector(jm_named_ptr)* items = &((fmi2_xml_enum_typedef_props_t*)type)->enumItems;
+                size_t i, n = jm_vector_get_size(jm_named_ptr)(items);
+                rec->firstItem = (fmi2_xml_image_ref_t)w->counts[fmi2_xml_image_items];
+                rec->numItems = (fmi2_xml_image_ref_t)n;
+                for(i = 0; i < n; i++) {
+                    fmi2_xml_enum_type_item_t* item = jm_vector_get_item(jm_named_ptr)(items, i).ptr;
+                    fmi2_xml_image_ref_t itemName = fmi2_xml_image_string(w, item->itemName);
+                    fmi2_xml_image_ref_t itemDescription = fmi2_xml_image_string(w, item->itemDesciption);
+                    fmi2_xml_image_item_t* itemRec = (fmi2_xml_image_item_t*)fmi2_xml_image_append(w, fmi2_xml_image_items, 1);
+                    if(!itemRec) return FMI2_XML_IMAGE_NONE;
+                    itemRec->name = itemName;
+                    itemRec->description = itemDescription;
+                    itemRec->value = item->value;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    else {
+        switch(type->baseType) {
+        case fmi2_base_type_real:
+            rec->realValues[0] = ((fmi2_xml_variable_start_real_t*)type)->start;
+            break;
+        case fmi2_base_type_str:
+            rec->text = fmi2_xml_image_string(w, ((fmi2_xml_variable_start_string_t*)type)->start);
+            break;
+        default:
+            rec->intValues[0] = ((fmi2_xml_variable_start_integer_t*)type)->start;
+            break;
+        }
+    }
+    return w->failed ? FMI2_XML_IMAGE_NONE : ref;
+}
+
+/* Variables that are not in the model (e.g. removed aliases that are still referenced) are added at the end */
+static fmi2_xml_image_ref_t fmi2_xml_image_variable(fmi2_xml_image_writer_t* w, fmi2_xml_variable_t* v) {
+    fmi2_xml_image_ref_t ref;
+    if(!v) return FMI2_XML_IMAGE_NONE;
+    ref = fmi2_xml_image_map_find(&w->variables, v);
+    if(ref != FMI2_XML_IMAGE_NONE) return ref;
+    ref = (fmi2_xml_image_ref_t)jm_vector_get_size(jm_voidp)(&w->variableList);
+    if(!jm_vector_push_back(jm_voidp)(&w->variableList, v) ||
+        fmi2_xml_image_map_insert(&w->variables, v, ref, w->callbacks)) {
+        w->failed = 1;
+        return FMI2_XML_IMAGE_NONE;
+    }
+    return ref;
+}
+
+static void fmi2_xml_image_write_units(fmi2_xml_image_writer_t* w) {
+    fmi2_xml_model_description_t* md = w->md;
+    size_t i, j;
+
+    w->numUnits = jm_vector_get_size(jm_named_ptr)(&md->unitDefinitions);
+    w->numDisplayUnits = jm_vector_get_size(jm_named_ptr)(&md->displayUnitDefinitions);
+    /* units and display units share the map, units are only looked up for their default display */
+    for(i = 0; i < w->numUnits; i++) {
+        if(fmi2_xml_image_map_insert(&w->displayUnits, jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr, (fmi2_xml_image_ref_t)i, w->callbacks)) {
+            w->failed = 1;
+            return;
+        }
+    }
+    for(i = 0; i < w->numDisplayUnits; i++) {
+        fmi2_xml_display_unit_t* du = jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, i).ptr;
+        fmi2_xml_image_ref_t unit = fmi2_xml_image_map_find(&w->displayUnits, du->baseUnit);
+        fmi2_xml_image_ref_t name = fmi2_xml_image_string(w, du->displayUnit);
+        fmi2_xml_image_display_unit_t* rec;
+        if((unit == FMI2_XML_IMAGE_NONE) || fmi2_xml_image_map_insert(&w->displayUnits, du, (fmi2_xml_image_ref_t)i, w->callbacks)) {
+            w->failed = 1;
+            return;
+        }
+        rec = (fmi2_xml_image_display_unit_t*)fmi2_xml_image_append(w, fmi2_xml_image_display_units, 1);
+        if(!rec) return;
+        rec->name = name;
+        rec->unit = unit;
+        rec->factor = du->factor;
+        rec->offset = du->offset;
+    }
+    for(i = 0; i < w->numUnits; i++) {
+        fmi2_xml_unit_t* unit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+        size_t n = jm_vector_get_size(jm_voidp)(&unit->displayUnits);
+        fmi2_xml_image_ref_t name = fmi2_xml_image_string(w, unit->baseUnit);
+        fmi2_xml_image_ref_t first = (fmi2_xml_image_ref_t)w->counts[fmi2_xml_image_unit_display_units];
+        fmi2_xml_image_unit_t* rec;
+
+        for(j = 0; j < n; j++) {
+            fmi2_xml_image_ref_t* du = fmi2_xml_image_append_ref(w, fmi2_xml_image_unit_display_units);
+            if(!du) return;
+            *du = fmi2_xml_image_map_find(&w->displayUnits, jm_vector_get_item(jm_voidp)(&unit->displayUnits, j));
+        }
+        rec = (fmi2_xml_image_unit_t*)fmi2_xml_image_append(w, fmi2_xml_image_units, 1);
+        if(!rec) return;
+        rec->name = name;
+        rec->firstDisplayUnit = first;
+        rec->numDisplayUnits = (fmi2_xml_image_ref_t)n;
+        memcpy(rec->SI_base_unit_exp, unit->SI_base_unit_exp, sizeof(rec->SI_base_unit_exp));
+        rec->factor = unit->factor;
+        rec->offset = unit->offset;
+    }
+}
+
+static void fmi2_xml_image_write_variable_list(fmi2_xml_image_writer_t* w, fmi2_xml_image_section_enu_t section, jm_vector(jm_voidp)* list) {
+    size_t i, n = jm_vector_get_size(jm_voidp)(list);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_image_ref_t ref = fmi2_xml_image_variable(w, jm_vector_get_item(jm_voidp)(list, i));
+        fmi2_xml_image_ref_t* rec = fmi2_xml_image_append_ref(w, section);
+        if(!rec) return;
+        *rec = ref;
+    }
+}
+
+static void fmi2_xml_image_write_model(fmi2_xml_image_writer_t* w) {
+    fmi2_xml_model_description_t* md = w->md;
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    fmi2_xml_image_model_t model;
+    jm_vector(char)* strings[fmi2_xml_image_str_Num];
+    jm_vector(jm_string)* lists[fmi2_xml_image_list_Num];
+    fmi2_xml_dependencies_t* deps[FMI2_XML_IMAGE_STRUCTURE_LISTS] = {0, 0, 0, 0};
+    size_t i, j, n;
+
+    memset(&model, 0, sizeof(model));
+    strings[fmi2_xml_image_str_standard_version] = &md->fmi2_xml_standard_version;
+    strings[fmi2_xml_image_str_model_name] = &md->modelName;
+    strings[fmi2_xml_image_str_guid] = &md->GUID;
+    strings[fmi2_xml_image_str_description] = &md->description;
+    strings[fmi2_xml_image_str_author] = &md->author;
+    strings[fmi2_xml_image_str_copyright] = &md->copyright;
+    strings[fmi2_xml_image_str_license] = &md->license;
+    strings[fmi2_xml_image_str_version] = &md->version;
+    strings[fmi2_xml_image_str_generation_tool] = &md->generationTool;
+    strings[fmi2_xml_image_str_generation_date] = &md->generationDateAndTime;
+    strings[fmi2_xml_image_str_model_identifier_me] = &md->modelIdentifierME;
+    strings[fmi2_xml_image_str_model_identifier_cs] = &md->modelIdentifierCS;
+    lists[fmi2_xml_image_list_source_files_me] = &md->sourceFilesME;
+    lists[fmi2_xml_image_list_source_files_cs] = &md->sourceFilesCS;
+    lists[fmi2_xml_image_list_log_categories] = &md->logCategories;
+    lists[fmi2_xml_image_list_log_category_descriptions] = &md->logCategoryDescriptions;
+    lists[fmi2_xml_image_list_vendors] = &md->vendorList;
+
+    /* the string pool starts with the empty string */
+    fmi2_xml_image_append(w, fmi2_xml_image_strings, 1);
+
+    for(i = 0; i < fmi2_xml_image_str_Num; i++)
+        model.strings[i] = fmi2_xml_image_string(w, jm_vector_char2string(strings[i]));
+    for(i = 0; i < fmi2_xml_image_list_Num; i++) {
+        n = jm_vector_get_size(jm_string)(lists[i]);
+        model.listSize[i] = (fmi2_xml_image_ref_t)n;
+        for(j = 0; j < n; j++) {
+            fmi2_xml_image_ref_t ref = fmi2_xml_image_string(w, jm_vector_get_item(jm_string)(lists[i], j));
+            fmi2_xml_image_ref_t* rec = fmi2_xml_image_append_ref(w, fmi2_xml_image_lists);
+            if(!rec) return;
+            *rec = ref;
+        }
+    }
+    model.namingConvension = md->namingConvension;
+    model.fmuKind = md->fmuKind;
+    memcpy(model.capabilities, md->capabilities, sizeof(model.capabilities));
+    model.numberOfContinuousStates = md->numberOfContinuousStates;
+    model.numberOfEventIndicators = md->numberOfEventIndicators;
+    model.defaultExperimentStartTime = md->defaultExperimentStartTime;
+    model.defaultExperimentStopTime = md->defaultExperimentStopTime;
+    model.defaultExperimentTolerance = md->defaultExperimentTolerance;
+    model.defaultExperimentStepSize = md->defaultExperimentStepSize;
+
+    fmi2_xml_image_write_units(w);
+
+    /* the default types get fixed indices */
+    fmi2_xml_image_type(w, &td->defaultRealType.typeBase);
+    fmi2_xml_image_type(w, &td->defaultIntegerType.typeBase);
+    fmi2_xml_image_type(w, &td->defaultEnumType.base.typeBase);
+    fmi2_xml_image_type(w, &td->defaultBooleanType);
+    fmi2_xml_image_type(w, &td->defaultStringType);
+    n = jm_vector_get_size(jm_named_ptr)(&td->typeDefinitions);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_image_ref_t ref = fmi2_xml_image_type(w, jm_vector_get_item(jm_named_ptr)(&td->typeDefinitions, i).ptr);
+        fmi2_xml_image_ref_t* rec = fmi2_xml_image_append_ref(w, fmi2_xml_image_typedefs);
+        if(!rec) return;
+        *rec = ref;
+    }
+
+    if(md->variablesOrigOrder) {
+        model.hasVariableLists = 1;
+        n = jm_vector_get_size(jm_voidp)(md->variablesOrigOrder);
+        for(i = 0; i < n; i++)
+            fmi2_xml_image_variable(w, jm_vector_get_item(jm_voidp)(md->variablesOrigOrder, i));
+    }
+    else {
+        n = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
+        for(i = 0; i < n; i++)
+            fmi2_xml_image_variable(w, jm_vector_get_item(jm_named_ptr)(&md->variablesByName, i).ptr);
+    }
+    model.numVariables = jm_vector_get_size(jm_voidp)(&w->variableList);
+
+    n = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
+    for(i = 0; i < n; i++) {
+        fmi2_xml_image_ref_t ref = fmi2_xml_image_variable(w, jm_vector_get_item(jm_named_ptr)(&md->variablesByName, i).ptr);
+        fmi2_xml_image_ref_t* rec = fmi2_xml_image_append_ref(w, fmi2_xml_image_by_name);
+        if(!rec) return;
+        *rec = ref;
+    }
+    if(md->variablesByVR)
+        fmi2_xml_image_write_variable_list(w, fmi2_xml_image_by_vr, md->variablesByVR);
+
+    if(md->modelStructure) {
+        fmi2_xml_model_structure_t* ms = md->modelStructure;
+        jm_vector(jm_voidp)* structureLists[FMI2_XML_IMAGE_STRUCTURE_LISTS];
+
+        structureLists[0] = &ms->outputs;
+        structureLists[1] = &ms->derivatives;
+        structureLists[2] = &ms->discreteStates;
+        structureLists[3] = &ms->initialUnknowns;
+        deps[0] = ms->outputDeps;
+        deps[1] = ms->derivativeDeps;
+        deps[2] = ms->discreteStateDeps;
+        deps[3] = ms->initialUnknownDeps;
+        model.hasStructure = 1;
+        model.isValidStructure = ms->isValidFlag;
+        for(i = 0; i < FMI2_XML_IMAGE_STRUCTURE_LISTS; i++) {
+            model.structureSize[i] = jm_vector_get_size(jm_voidp)(structureLists[i]);
+            fmi2_xml_image_write_variable_list(w, fmi2_xml_image_structure, structureLists[i]);
+        }
+        for(i = 0; i < FMI2_XML_IMAGE_STRUCTURE_LISTS; i++) {
+            fmi2_xml_image_dependencies_t* d = &model.deps[i];
+            void* rec;
+            if(!deps[i]) continue;
+            d->present = 1;
+            d->isRowMajor = deps[i]->isRowMajor;
+            d->numStart = jm_vector_get_size(size_t)(&deps[i]->startIndex);
+            d->numIndex = jm_vector_get_size(size_t)(&deps[i]->dependencyIndex);
+            d->numKind = jm_vector_get_size(char)(&deps[i]->dependencyFactorKind);
+            rec = fmi2_xml_image_append(w, fmi2_xml_image_dep_start, d->numStart);
+            if(rec) memcpy(rec, jm_vector_get_itemp(size_t)(&deps[i]->startIndex, 0), d->numStart * sizeof(size_t));
+            rec = fmi2_xml_image_append(w, fmi2_xml_image_dep_index, d->numIndex);
+            if(rec) memcpy(rec, jm_vector_get_itemp(size_t)(&deps[i]->dependencyIndex, 0), d->numIndex * sizeof(size_t));
+            rec = fmi2_xml_image_append(w, fmi2_xml_image_dep_kind, d->numKind);
+            if(rec) memcpy(rec, jm_vector_get_itemp(char)(&deps[i]->dependencyFactorKind, 0), d->numKind);
+        }
+    }
+
+    /* variables referenced from other variables are added while the records are written */
+    for(i = 0; !w->failed && (i < jm_vector_get_size(jm_voidp)(&w->variableList)); i++) {
+        fmi2_xml_variable_t* v = jm_vector_get_item(jm_voidp)(&w->variableList, i);
+        size_t len = strlen(v->name) + 1;
+        size_t offset = w->counts[fmi2_xml_image_variables];
+        fmi2_xml_image_ref_t type = v->typeBase ? fmi2_xml_image_type(w, v->typeBase) : FMI2_XML_IMAGE_NONE;
+        fmi2_xml_variable_t rec;
+        char* prec;
+        size_t* poffset;
+
+        /* the padding of the structure is zeroed as well */
+        memset(&rec, 0, sizeof(rec));
+        rec.typeBase = (fmi2_xml_variable_type_base_t*)(size_t)type;
+        rec.description = (const char*)(size_t)fmi2_xml_image_string(w, v->description);
+        rec.originalIndex = v->originalIndex;
+        rec.derivativeOf = (fmi2_xml_variable_t*)(size_t)fmi2_xml_image_variable(w, v->derivativeOf);
+        rec.previous = (fmi2_xml_variable_t*)(size_t)fmi2_xml_image_variable(w, v->previous);
+        rec.vr = v->vr;
+        rec.aliasKind = v->aliasKind;
+        rec.initial = v->initial;
+        rec.variability = v->variability;
+        rec.causality = v->causality;
+        rec.reinit = v->reinit;
+        rec.canHandleMultipleSetPerTimeInstant = v->canHandleMultipleSetPerTimeInstant;
+        if(type == FMI2_XML_IMAGE_NONE) w->failed = 1;
+        prec = (char*)fmi2_xml_image_append(w, fmi2_xml_image_variables, fmi2_xml_image_align(FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET + len));
+        poffset = (size_t*)fmi2_xml_image_append(w, fmi2_xml_image_variable_offsets, 1);
+        if(!prec || !poffset) return;
+        /* the section buffer is not aligned for the structure, so the record is copied in */
+        memcpy(prec, &rec, FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET);
+        memcpy(prec + FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET, v->name, len);
+        memcpy(poffset, &offset, sizeof(offset));
+    }
+    if(jm_vector_get_size(jm_voidp)(&w->variableList) >= FMI2_XML_IMAGE_NONE) w->failed = 1;
+
+    {
+        fmi2_xml_image_model_t* rec = (fmi2_xml_image_model_t*)fmi2_xml_image_append(w, fmi2_xml_image_model, 1);
+        if(rec) *rec = model;
+    }
+}
+
+static int fmi2_xml_image_write_file(fmi2_xml_image_writer_t* w, const char* fileName, const char* key) {
+    fmi2_xml_image_header_t header;
+    static const char padding[FMI2_XML_IMAGE_ALIGN] = {0};
+    size_t offset = fmi2_xml_image_align(sizeof(header));
+    FILE* file;
+    int i, failed = 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FMI2_XML_IMAGE_MAGIC, sizeof(FMI2_XML_IMAGE_MAGIC));
+    header.version = FMI2_XML_IMAGE_VERSION;
+    header.byteOrder = FMI2_XML_IMAGE_BYTE_ORDER;
+    header.abi = FMI2_XML_IMAGE_ABI;
+    header.variableLayout = (unsigned int)FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET;
+    strcpy(header.key, key);
+    for(i = 0; i < fmi2_xml_image_sections_Num; i++) {
+        header.sections[i].offset = offset;
+        header.sections[i].count = w->counts[i];
+        offset = fmi2_xml_image_align(offset + jm_vector_get_size(char)(&w->sections[i]));
+    }
+    header.imageSize = offset;
+
+    file = fopen(fileName, "wb");
+    if(!file) {
+        jm_log_error(w->callbacks, module, "Could not create model description image %s", fileName);
+        return -1;
+    }
+    offset = sizeof(header);
+    if(fwrite(&header, sizeof(header), 1, file) != 1) failed = 1;
+    for(i = 0; !failed && (i < fmi2_xml_image_sections_Num); i++) {
+        size_t size = jm_vector_get_size(char)(&w->sections[i]);
+        size_t pad = header.sections[i].offset - offset;
+        if((pad && (fwrite(padding, 1, pad, file) != pad)) ||
+            (size && (fwrite(jm_vector_get_itemp(char)(&w->sections[i], 0), 1, size, file) != size)))
+            failed = 1;
+        offset = header.sections[i].offset + size;
+    }
+    if(!failed && (header.imageSize > offset) && (fwrite(padding, 1, header.imageSize - offset, file) != header.imageSize - offset))
+        failed = 1;
+    if(fclose(file)) failed = 1;
+    if(failed) {
+        jm_log_error(w->callbacks, module, "Could not write model description image %s", fileName);
+        remove(fileName);
+        return -1;
+    }
+    return 0;
+}
+
+int fmi2_xml_write_model_description_image(fmi2_xml_model_description_t* md, const char* fileName, const char* key) {
+    fmi2_xml_image_writer_t w;
+    jm_callbacks* cb = md->callbacks;
+    int i, ret = -1;
+
+    if(md->status != fmi2_xml_model_description_enu_ok) {
+        jm_log_error(cb, module, "Only successfully parsed model descriptions can be saved as images");
+        return -1;
+    }
+    if(md->skippedSections) {
+        jm_log_error(cb, module, "Model descriptions parsed with skipped sections cannot be saved as images");
+        return -1;
+    }
+    if(strlen(key) >= FMI2_XML_IMAGE_KEY_SIZE) {
+        jm_log_error(cb, module, "Model description image key is too long");
+        return -1;
+    }
+
+    memset(&w, 0, sizeof(w));
+    w.md = md;
+    w.callbacks = cb;
+    for(i = 0; i < fmi2_xml_image_sections_Num; i++)
+        jm_vector_init(char)(&w.sections[i], 0, cb);
+    jm_vector_init(jm_voidp)(&w.variableList, 0, cb);
+    if(fmi2_xml_image_map_alloc(&w.strings, 1024, cb) ||
+        fmi2_xml_image_map_alloc(&w.displayUnits, 64, cb) ||
+        fmi2_xml_image_map_alloc(&w.types, 256, cb) ||
+        fmi2_xml_image_map_alloc(&w.variables, 256, cb)) {
+        w.failed = 1;
+    }
+
+    if(!w.failed) fmi2_xml_image_write_model(&w);
+    if(w.failed)
+        jm_log_error(cb, module, "Could not build the model description image");
+    else
+        ret = fmi2_xml_image_write_file(&w, fileName, key);
+
+    fmi2_xml_image_map_free(&w.strings, cb);
+    fmi2_xml_image_map_free(&w.displayUnits, cb);
+    fmi2_xml_image_map_free(&w.types, cb);
+    fmi2_xml_image_map_free(&w.variables, cb);
+    jm_vector_free_data(jm_voidp)(&w.variableList);
+    for(i = 0; i < fmi2_xml_image_sections_Num; i++)
+        jm_vector_free_data(char)(&w.sections[i]);
+    if(!ret) jm_log_verbose(cb, module, "Saved model description image %s", fileName);
+    return ret;
+}
+
+typedef struct fmi2_xml_image_reader_t {
+    fmi2_xml_model_description_t* md;
+    const fmi2_xml_image_header_t* header;
+    const char* data;
+    const char* strings;
+    size_t stringsSize;
+    size_t numUnits;
+    size_t numDisplayUnits;
+    size_t numTypes;
+    size_t numVariables; /* including the ones only referenced by other variables */
+    fmi2_xml_variable_type_base_t** types;
+    char* variables; /* the variable records, writable */
+    const size_t* variableOffsets;
+} fmi2_xml_image_reader_t;
+
+static const void* fmi2_xml_image_section(fmi2_xml_image_reader_t* r, fmi2_xml_image_section_enu_t section) {
+    return r->data + r->header->sections[section].offset;
+}
+
+static size_t fmi2_xml_image_count(fmi2_xml_image_reader_t* r, fmi2_xml_image_section_enu_t section) {
+    return r->header->sections[section].count;
+}
+
+/* Checks that the records [first, first+num) are in the section */
+static int fmi2_xml_image_in_section(fmi2_xml_image_reader_t* r, fmi2_xml_image_section_enu_t section, size_t first, size_t num) {
+    size_t count = fmi2_xml_image_count(r, section);
+    return (first <= count) && (num <= count - first);
+}
+
+/* The string at ref or NULL. Returns -1 if the reference is invalid. */
+static int fmi2_xml_image_get_string(fmi2_xml_image_reader_t* r, fmi2_xml_image_ref_t ref, const char** str) {
+    if(ref == FMI2_XML_IMAGE_NONE) {
+        *str = 0;
+        return 0;
+    }
+    if(ref >= r->stringsSize) return -1;
+    *str = r->strings + ref;
+    return 0;
+}
+
+/* Same as fmi2_xml_image_get_string() but NULL is invalid */
+static int fmi2_xml_image_get_name(fmi2_xml_image_reader_t* r, fmi2_xml_image_ref_t ref, const char** str) {
+    return ((ref == FMI2_XML_IMAGE_NONE) || fmi2_xml_image_get_string(r, ref, str)) ? -1 : 0;
+}
+
+static int fmi2_xml_image_set_string(jm_vector(char)* v, const char* str) {
+    size_t len = str ? strlen(str) : 0;
+    if(!len) return 0;
+    /* the terminating zero is kept after the items as for parsed strings */
+    if(jm_vector_resize(char)(v, len + 1) != len + 1) return -1;
+    memcpy(jm_vector_get_itemp(char)(v, 0), str, len + 1);
+    jm_vector_resize(char)(v, len);
+    return 0;
+}
+
+/* Checks the header and the layout of the sections. Returns 1 if the image cannot be used. */
+static int fmi2_xml_image_check_header(fmi2_xml_image_reader_t* r, size_t size, const char* key, const char* fileName) {
+    const fmi2_xml_image_header_t* header = r->header;
+    jm_callbacks* cb = r->md->callbacks;
+    int i;
+
+    if((size < sizeof(*header)) || memcmp(header->magic, FMI2_XML_IMAGE_MAGIC, sizeof(FMI2_XML_IMAGE_MAGIC))) {
+        jm_log_warning(cb, module, "File %s is not a model description image", fileName);
+        return 1;
+    }
+    if((header->version != FMI2_XML_IMAGE_VERSION) || (header->byteOrder != FMI2_XML_IMAGE_BYTE_ORDER) || (header->abi != FMI2_XML_IMAGE_ABI) ||
+        (header->variableLayout != FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET)) {
+        jm_log_verbose(cb, module, "Model description image %s was written by an incompatible build", fileName);
+        return 1;
+    }
+    if(!memchr(header->key, 0, sizeof(header->key)) || strcmp(header->key, key)) {
+        jm_log_verbose(cb, module, "Model description image %s was written for another model description", fileName);
+        return 1;
+    }
+    if(header->imageSize != size) {
+        jm_log_warning(cb, module, "Model description image %s is truncated", fileName);
+        return 1;
+    }
+    for(i = 0; i < fmi2_xml_image_sections_Num; i++) {
+        size_t offset = header->sections[i].offset;
+        if((offset % FMI2_XML_IMAGE_ALIGN) || (offset < sizeof(*header)) || (offset > size) ||
+            (header->sections[i].count > (size - offset) / fmi2_xml_image_record_size[i])) {
+            jm_log_warning(cb, module, "Model description image %s is corrupt", fileName);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int fmi2_xml_image_load_model(fmi2_xml_image_reader_t* r, const fmi2_xml_image_model_t* model) {
+    fmi2_xml_model_description_t* md = r->md;
+    jm_vector(char)* strings[fmi2_xml_image_str_Num];
+    jm_vector(jm_string)* lists[fmi2_xml_image_list_Num];
+    const fmi2_xml_image_ref_t* listItems = (const fmi2_xml_image_ref_t*)fmi2_xml_image_section(r, fmi2_xml_image_lists);
+    size_t i, j, k = 0;
+
+    strings[fmi2_xml_image_str_standard_version] = &md->fmi2_xml_standard_version;
+    strings[fmi2_xml_image_str_model_name] = &md->modelName;
+    strings[fmi2_xml_image_str_guid] = &md->GUID;
+    strings[fmi2_xml_image_str_description] = &md->description;
+    strings[fmi2_xml_image_str_author] = &md->author;
+    strings[fmi2_xml_image_str_copyright] = &md->copyright;
+    strings[fmi2_xml_image_str_license] = &md->license;
+    strings[fmi2_xml_image_str_version] = &md->version;
+    strings[fmi2_xml_image_str_generation_tool] = &md->generationTool;
+    strings[fmi2_xml_image_str_generation_date] = &md->generationDateAndTime;
+    strings[fmi2_xml_image_str_model_identifier_me] = &md->modelIdentifierME;
+    strings[fmi2_xml_image_str_model_identifier_cs] = &md->modelIdentifierCS;
+    lists[fmi2_xml_image_list_source_files_me] = &md->sourceFilesME;
+    lists[fmi2_xml_image_list_source_files_cs] = &md->sourceFilesCS;
+    lists[fmi2_xml_image_list_log_categories] = &md->logCategories;
+    lists[fmi2_xml_image_list_log_category_descriptions] = &md->logCategoryDescriptions;
+    lists[fmi2_xml_image_list_vendors] = &md->vendorList;
+
+    for(i = 0; i < fmi2_xml_image_str_Num; i++) {
+        const char* str;
+        if(fmi2_xml_image_get_string(r, model->strings[i], &str) || fmi2_xml_image_set_string(strings[i], str)) return -1;
+    }
+    for(i = 0; i < fmi2_xml_image_list_Num; i++) {
+        size_t n = model->listSize[i];
+        if(!fmi2_xml_image_in_section(r, fmi2_xml_image_lists, k, n)) return -1;
+        for(j = 0; j < n; j++) {
+            const char* str;
+            if(fmi2_xml_image_get_string(r, listItems[k++], &str) || !jm_vector_push_back(jm_string)(lists[i], str)) return -1;
+        }
+    }
+
+    md->namingConvension = (fmi2_variable_naming_convension_enu_t)model->namingConvension;
+    md->fmuKind = (fmi2_fmu_kind_enu_t)model->fmuKind;
+    memcpy(md->capabilities, model->capabilities, sizeof(md->capabilities));
+    md->numberOfContinuousStates = model->numberOfContinuousStates;
+    md->numberOfEventIndicators = model->numberOfEventIndicators;
+    md->defaultExperimentStartTime = model->defaultExperimentStartTime;
+    md->defaultExperimentStopTime = model->defaultExperimentStopTime;
+    md->defaultExperimentTolerance = model->defaultExperimentTolerance;
+    md->defaultExperimentStepSize = model->defaultExperimentStepSize;
+    return 0;
+}
+
+static int fmi2_xml_image_load_units(fmi2_xml_image_reader_t* r) {
+    fmi2_xml_model_description_t* md = r->md;
+    const fmi2_xml_image_unit_t* units = (const fmi2_xml_image_unit_t*)fmi2_xml_image_section(r, fmi2_xml_image_units);
+    const fmi2_xml_image_display_unit_t* displayUnits = (const fmi2_xml_image_display_unit_t*)fmi2_xml_image_section(r, fmi2_xml_image_display_units);
+    const fmi2_xml_image_ref_t* unitDisplayUnits = (const fmi2_xml_image_ref_t*)fmi2_xml_image_section(r, fmi2_xml_image_unit_display_units);
+    fmi2_xml_unit_t dummy;
+    fmi2_xml_display_unit_t dummyDU;
+    size_t i, j;
+
+    r->numUnits = fmi2_xml_image_count(r, fmi2_xml_image_units);
+    r->numDisplayUnits = fmi2_xml_image_count(r, fmi2_xml_image_display_units);
+    for(i = 0; i < r->numUnits; i++) {
+        const char* name;
+        jm_named_ptr named;
+        fmi2_xml_unit_t* unit;
+
+        if(fmi2_xml_image_get_name(r, units[i].name, &name)) return -1;
+        named = jm_named_alloc_arena(name, sizeof(fmi2_xml_unit_t), dummy.baseUnit - (char*)&dummy, &md->arena);
+        unit = named.ptr;
+        if(!unit) return -1;
+        memcpy(unit->SI_base_unit_exp, units[i].SI_base_unit_exp, sizeof(unit->SI_base_unit_exp));
+        unit->factor = units[i].factor;
+        unit->offset = units[i].offset;
+        unit->defaultDisplay.baseUnit = unit;
+        unit->defaultDisplay.offset = 0;
+        unit->defaultDisplay.factor = 1.0;
+        unit->defaultDisplay.displayUnit[0] = 0;
+        jm_vector_init(jm_voidp)(&unit->displayUnits, 0, md->callbacks);
+        if(!jm_vector_push_back(jm_named_ptr)(&md->unitDefinitions, named)) return -1;
+    }
+    for(i = 0; i < r->numDisplayUnits; i++) {
+        const char* name;
+        jm_named_ptr named;
+        fmi2_xml_display_unit_t* du;
+
+        if(fmi2_xml_image_get_name(r, displayUnits[i].name, &name) || (displayUnits[i].unit >= r->numUnits)) return -1;
+        named = jm_named_alloc_arena(name, sizeof(fmi2_xml_display_unit_t), dummyDU.displayUnit - (char*)&dummyDU, &md->arena);
+        du = named.ptr;
+        if(!du) return -1;
+        du->factor = displayUnits[i].factor;
+        du->offset = displayUnits[i].offset;
+        du->baseUnit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, displayUnits[i].unit).ptr;
+        if(!jm_vector_push_back(jm_named_ptr)(&md->displayUnitDefinitions, named)) return -1;
+    }
+    for(i = 0; i < r->numUnits; i++) {
+        fmi2_xml_unit_t* unit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, i).ptr;
+        if(!fmi2_xml_image_in_section(r, fmi2_xml_image_unit_display_units, units[i].firstDisplayUnit, units[i].numDisplayUnits)) return -1;
+        for(j = 0; j < units[i].numDisplayUnits; j++) {
+            fmi2_xml_image_ref_t du = unitDisplayUnits[units[i].firstDisplayUnit + j];
+            if((du >= r->numDisplayUnits) ||
+                !jm_vector_push_back(jm_voidp)(&unit->displayUnits, jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, du).ptr))
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static fmi2_xml_display_unit_t* fmi2_xml_image_get_display_unit(fmi2_xml_image_reader_t* r, fmi2_xml_image_ref_t ref, int* invalid) {
+    fmi2_xml_model_description_t* md = r->md;
+    if(ref == FMI2_XML_IMAGE_NONE) return 0;
+    if(ref < r->numDisplayUnits) return jm_vector_get_item(jm_named_ptr)(&md->displayUnitDefinitions, ref).ptr;
+    if(ref - r->numDisplayUnits < r->numUnits) {
+        fmi2_xml_unit_t* unit = jm_vector_get_item(jm_named_ptr)(&md->unitDefinitions, ref - r->numDisplayUnits).ptr;
+        return &unit->defaultDisplay;
+    }
+    *invalid = 1;
+    return 0;
+}
+
+static int fmi2_xml_image_load_enum_items(fmi2_xml_image_reader_t* r, const fmi2_xml_image_type_t* rec, fmi2_xml_enum_typedef_props_t* props) {
+    const fmi2_xml_image_item_t* items = (const fmi2_xml_image_item_t*)fmi2_xml_image_section(r, fmi2_xml_image_items);
+    size_t i;
+
+    if(!fmi2_xml_image_in_section(r, fmi2_xml_image_items, rec->firstItem, rec->numItems)) return -1;
+    for(i = 0; i < rec->numItems; i++) {
+        const fmi2_xml_image_item_t* itemRec = &items[rec->firstItem + i];
+        const char *name, *description;
+        size_t descrlen;
+        jm_named_ptr named;
+        fmi2_xml_enum_type_item_t* item;
+
+        if(fmi2_xml_image_get_name(r, itemRec->name, &name) || fmi2_xml_image_get_name(r, itemRec->description, &description)) return -1;
+        descrlen = strlen(description);
+        named = jm_named_alloc_arena(name, sizeof(fmi2_xml_enum_type_item_t) + descrlen + 1, sizeof(fmi2_xml_enum_type_item_t) + descrlen, &r->md->arena);
+        item = named.ptr;
+        if(!item) return -1;
+        item->itemName = named.name;
+        item->value = itemRec->value;
+        memcpy(item->itemDesciption, description, descrlen + 1);
+        if(!jm_vector_push_back(jm_named_ptr)(&props->enumItems, named)) return -1;
+    }
+    return 0;
+}
+
+/* Type structs are created in the order of the records, so the base of a struct always exists already */
+static int fmi2_xml_image_load_types(fmi2_xml_image_reader_t* r) {
+    fmi2_xml_model_description_t* md = r->md;
+    fmi2_xml_type_definitions_t* td = &md->typeDefinitions;
+    const fmi2_xml_image_type_t* types = (const fmi2_xml_image_type_t*)fmi2_xml_image_section(r, fmi2_xml_image_types);
+    const fmi2_xml_image_ref_t* typedefs = (const fmi2_xml_image_ref_t*)fmi2_xml_image_section(r, fmi2_xml_image_typedefs);
+    static const char defaultTypes[FMI2_XML_IMAGE_DEFAULT_TYPES] = {
+        fmi2_base_type_real, fmi2_base_type_int, fmi2_base_type_enum, fmi2_base_type_bool, fmi2_base_type_str
+    };
+    size_t i, n;
+
+    r->numTypes = fmi2_xml_image_count(r, fmi2_xml_image_types);
+    if(r->numTypes < FMI2_XML_IMAGE_DEFAULT_TYPES) return -1;
+    r->types = (fmi2_xml_variable_type_base_t**)md->callbacks->malloc(r->numTypes * sizeof(fmi2_xml_variable_type_base_t*));
+    if(!r->types) return -1;
+    r->types[0] = &td->defaultRealType.typeBase;
+    r->types[1] = &td->defaultIntegerType.typeBase;
+    r->types[2] = &td->defaultEnumType.base.typeBase;
+    r->types[3] = &td->defaultBooleanType;
+    r->types[4] = &td->defaultStringType;
+    for(i = 0; i < FMI2_XML_IMAGE_DEFAULT_TYPES; i++) {
+        if((types[i].structKind != fmi2_xml_type_struct_enu_props) || (types[i].baseType != defaultTypes[i]) || (types[i].base != FMI2_XML_IMAGE_NONE))
+            return -1;
+    }
+
+    for(i = FMI2_XML_IMAGE_DEFAULT_TYPES; i < r->numTypes; i++) {
+        const fmi2_xml_image_type_t* rec = &types[i];
+        fmi2_xml_variable_type_base_t *type, *base = 0;
+        const char* text;
+        int invalid = 0;
+
+        if((rec->baseType < fmi2_base_type_real) || (rec->baseType > fmi2_base_type_enum) ||
+            (rec->base != FMI2_XML_IMAGE_NONE && rec->base >= i) ||
+            fmi2_xml_image_get_string(r, rec->text, &text))
+            return -1;
+        if(rec->base != FMI2_XML_IMAGE_NONE) {
+            base = r->types[rec->base];
+            if(base->baseType != rec->baseType) return -1;
+        }
+
+        switch(rec->structKind) {
+        case fmi2_xml_type_struct_enu_typedef: {
+            fmi2_xml_variable_typedef_t dummy, *t;
+            const char* name;
+            jm_named_ptr named;
+
+            /* the properties of enumeration types are the ones with the list of items */
+            if(!base || (base->structKind != fmi2_xml_type_struct_enu_props) ||
+                ((rec->baseType == fmi2_base_type_enum) && base->baseTypeStruct) ||
+                fmi2_xml_image_get_name(r, rec->name, &name))
+                return -1;
+            named = jm_named_alloc_arena(name, sizeof(fmi2_xml_variable_typedef_t), dummy.typeName - (char*)&dummy, &md->arena);
+            t = named.ptr;
+            if(!t) return -1;
+            t->description = text ? text : "";
+            type = &t->typeBase;
+            fmi2_xml_init_variable_type_base(type, fmi2_xml_type_struct_enu_typedef, (fmi2_base_type_enu_t)rec->baseType);
+            type->baseTypeStruct = base;
+            break;
+        }
+        case fmi2_xml_type_struct_enu_props:
+            switch(rec->baseType) {
+            case fmi2_base_type_real: {
+                fmi2_xml_real_type_props_t* props = (fmi2_xml_real_type_props_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_real_type_props_t));
+                if(!props) return -1;
+                type = &props->typeBase;
+                props->quantity = text;
+                props->displayUnit = fmi2_xml_image_get_display_unit(r, rec->displayUnit, &invalid);
+                props->typeMin = rec->realValues[0];
+                props->typeMax = rec->realValues[1];
+                props->typeNominal = rec->realValues[2];
+                break;
+            }
+            case fmi2_base_type_int: {
+                fmi2_xml_integer_type_props_t* props = (fmi2_xml_integer_type_props_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_integer_type_props_t));
+                if(!props) return -1;
+                type = &props->typeBase;
+                props->quantity = text;
+                props->typeMin = rec->intValues[0];
+                props->typeMax = rec->intValues[1];
+                break;
+            }
+            case fmi2_base_type_enum: {
+                fmi2_xml_enum_variable_props_t* props;
+                if(base) {
+                    props = (fmi2_xml_enum_variable_props_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_enum_variable_props_t));
+                    if(!props) return -1;
+                }
+                else {
+                    fmi2_xml_enum_typedef_props_t* typedefProps = (fmi2_xml_enum_typedef_props_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_enum_typedef_props_t));
+                    if(!typedefProps) return -1;
+                    jm_vector_init(jm_named_ptr)(&typedefProps->enumItems, 0, md->callbacks);
+                    props = &typedefProps->base;
+                }
+                type = &props->typeBase;
+                props->quantity = text;
+                props->typeMin = rec->intValues[0];
+                props->typeMax = rec->intValues[1];
+                break;
+            }
+            default:
+                type = (fmi2_xml_variable_type_base_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_variable_type_base_t));
+                if(!type) return -1;
+                break;
+            }
+            fmi2_xml_init_variable_type_base(type, fmi2_xml_type_struct_enu_props, (fmi2_base_type_enu_t)rec->baseType);
+            break;
+        case fmi2_xml_type_struct_enu_start:
+            if(!base || (base->structKind == fmi2_xml_type_struct_enu_start)) return -1;
+            switch(rec->baseType) {
+            case fmi2_base_type_real: {
+                fmi2_xml_variable_start_real_t* start = (fmi2_xml_variable_start_real_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_variable_start_real_t));
+                if(!start) return -1;
+                start->start = rec->realValues[0];
+                type = &start->typeBase;
+                break;
+            }
+            case fmi2_base_type_str: {
+                size_t len = text ? strlen(text) : 0;
+                fmi2_xml_variable_start_string_t* start = (fmi2_xml_variable_start_string_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_variable_start_string_t) + len);
+                if(!start) return -1;
+                if(len) memcpy(start->start, text, len);
+                start->start[len] = 0;
+                type = &start->typeBase;
+                break;
+            }
+            default: {
+                fmi2_xml_variable_start_integer_t* start = (fmi2_xml_variable_start_integer_t*)jm_arena_alloc(&md->arena, sizeof(fmi2_xml_variable_start_integer_t));
+                if(!start) return -1;
+                start->start = rec->intValues[0];
+                type = &start->typeBase;
+                break;
+            }
+            }
+            fmi2_xml_init_variable_type_base(type, fmi2_xml_type_struct_enu_start, (fmi2_base_type_enu_t)rec->baseType);
+            break;
+        default:
+            return -1;
+        }
+
+        if(rec->structKind != fmi2_xml_type_struct_enu_typedef) {
+            /* properties and start values are released through the list as after parsing */
+            type->baseTypeStruct = base;
+            type->next = td->typePropsList;
+            td->typePropsList = type;
+        }
+        type->isRelativeQuantity = rec->isRelativeQuantity;
+        type->isUnbounded = rec->isUnbounded;
+        r->types[i] = type;
+        if(invalid) return -1;
+        if((rec->structKind == fmi2_xml_type_struct_enu_props) && (rec->baseType == fmi2_base_type_enum) && !base &&
+            fmi2_xml_image_load_enum_items(r, rec, (fmi2_xml_enum_typedef_props_t*)type))
+            return -1;
+    }
+
+    n = fmi2_xml_image_count(r, fmi2_xml_image_typedefs);
+    for(i = 0; i < n; i++) {
+        jm_named_ptr named;
+        fmi2_xml_variable_typedef_t* t;
+        if((typedefs[i] >= r->numTypes) || (r->types[typedefs[i]]->structKind != fmi2_xml_type_struct_enu_typedef)) return -1;
+        t = (fmi2_xml_variable_typedef_t*)r->types[typedefs[i]];
+        named.ptr = t;
+        named.name = t->typeName;
+        if(!jm_vector_push_back(jm_named_ptr)(&td->typeDefinitions, named)) return -1;
+    }
+    return 0;
+}
+
+/* Variable record for a valid reference */
+static fmi2_xml_variable_t* fmi2_xml_image_variable_at(fmi2_xml_image_reader_t* r, size_t ref) {
+    return (fmi2_xml_variable_t*)(r->variables + r->variableOffsets[ref]);
+}
+
+/* Resolve a reference that was stored in a pointer field of a variable record */
+static fmi2_xml_variable_t* fmi2_xml_image_get_variable(fmi2_xml_image_reader_t* r, const void* field, int* invalid) {
+    size_t ref = (size_t)field;
+    if(ref == FMI2_XML_IMAGE_NONE) return 0;
+    if(ref < r->numVariables) return fmi2_xml_image_variable_at(r, ref);
+    *invalid = 1;
+    return 0;
+}
+
+/* Fill a list of variables from consecutive references. Invalid or missing references are errors. */
+static int fmi2_xml_image_load_variable_list(fmi2_xml_image_reader_t* r, fmi2_xml_image_section_enu_t section, size_t first, size_t num, jm_vector(jm_voidp)* list) {
+    const fmi2_xml_image_ref_t* refs = (const fmi2_xml_image_ref_t*)fmi2_xml_image_section(r, section);
+    size_t i;
+
+    if(!fmi2_xml_image_in_section(r, section, first, num) || (jm_vector_resize(jm_voidp)(list, num) != num)) return -1;
+    for(i = 0; i < num; i++) {
+        fmi2_xml_image_ref_t ref = refs[first + i];
+        if(ref >= r->numVariables) return -1;
+        jm_vector_set_item(jm_voidp)(list, i, fmi2_xml_image_variable_at(r, ref));
+    }
+    return 0;
+}
+
+static int fmi2_xml_image_load_variables(fmi2_xml_image_reader_t* r, const fmi2_xml_image_model_t* model) {
+    fmi2_xml_model_description_t* md = r->md;
+    jm_callbacks* cb = md->callbacks;
+    const fmi2_xml_image_ref_t* byName = (const fmi2_xml_image_ref_t*)fmi2_xml_image_section(r, fmi2_xml_image_by_name);
+    size_t size = fmi2_xml_image_count(r, fmi2_xml_image_variables);
+    size_t i, n;
+    int invalid = 0;
+
+    r->variableOffsets = (const size_t*)fmi2_xml_image_section(r, fmi2_xml_image_variable_offsets);
+    r->numVariables = fmi2_xml_image_count(r, fmi2_xml_image_variable_offsets);
+    if(model->numVariables > r->numVariables) return -1;
+    /* the records follow each other and every name ends before the next record */
+    for(i = 0; i < r->numVariables; i++) {
+        size_t offset = r->variableOffsets[i];
+        size_t end = (i + 1 < r->numVariables) ? r->variableOffsets[i + 1] : size;
+        if((offset % FMI2_XML_IMAGE_ALIGN) || (end > size) || (offset >= end) || (end - offset <= FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET) ||
+            !memchr(r->variables + offset + FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET, 0, end - offset - FMI2_XML_IMAGE_VARIABLE_NAME_OFFSET))
+            return -1;
+    }
+    /* the references become pointers in place */
+    for(i = 0; i < r->numVariables; i++) {
+        fmi2_xml_variable_t* v = fmi2_xml_image_variable_at(r, i);
+        size_t type = (size_t)v->typeBase;
+        size_t description = (size_t)v->description;
+
+        if((type >= r->numTypes) || (description > FMI2_XML_IMAGE_NONE) ||
+            fmi2_xml_image_get_string(r, (fmi2_xml_image_ref_t)description, &v->description))
+            return -1;
+        v->typeBase = r->types[type];
+        v->derivativeOf = fmi2_xml_image_get_variable(r, v->derivativeOf, &invalid);
+        v->previous = fmi2_xml_image_get_variable(r, v->previous, &invalid);
+    }
+    if(invalid) return -1;
+
+    n = fmi2_xml_image_count(r, fmi2_xml_image_by_name);
+    if(jm_vector_resize(jm_named_ptr)(&md->variablesByName, n) != n) return -1;
+    for(i = 0; i < n; i++) {
+        jm_named_ptr named;
+        if(byName[i] >= r->numVariables) return -1;
+        named.ptr = fmi2_xml_image_variable_at(r, byName[i]);
+        named.name = ((fmi2_xml_variable_t*)named.ptr)->name;
+        jm_vector_set_item(jm_named_ptr)(&md->variablesByName, i, named);
+    }
+    if(model->hasVariableLists) {
+        md->variablesOrigOrder = jm_vector_alloc(jm_voidp)(model->numVariables, model->numVariables, cb);
+        n = fmi2_xml_image_count(r, fmi2_xml_image_by_vr);
+        md->variablesByVR = jm_vector_alloc(jm_voidp)(n, n, cb);
+        if(!md->variablesOrigOrder || !md->variablesByVR) return -1;
+        for(i = 0; i < model->numVariables; i++)
+            jm_vector_set_item(jm_voidp)(md->variablesOrigOrder, i, fmi2_xml_image_variable_at(r, i));
+        if(fmi2_xml_image_load_variable_list(r, fmi2_xml_image_by_vr, 0, n, md->variablesByVR)) return -1;
+    }
+    return fmi2_xml_build_variable_index(md);
+}
+
+static int fmi2_xml_image_load_dependencies(fmi2_xml_image_reader_t* r, const fmi2_xml_image_dependencies_t* d,
+                                            size_t* start, size_t* index, size_t* kind, fmi2_xml_dependencies_t* dep) {
+    const size_t* starts = (const size_t*)fmi2_xml_image_section(r, fmi2_xml_image_dep_start) + *start;
+    const size_t* indices = (const size_t*)fmi2_xml_image_section(r, fmi2_xml_image_dep_index) + *index;
+    const char* kinds = (const char*)fmi2_xml_image_section(r, fmi2_xml_image_dep_kind) + *kind;
+    size_t i;
+
+    if(!fmi2_xml_image_in_section(r, fmi2_xml_image_dep_start, *start, d->numStart) ||
+        !fmi2_xml_image_in_section(r, fmi2_xml_image_dep_index, *index, d->numIndex) ||
+        !fmi2_xml_image_in_section(r, fmi2_xml_image_dep_kind, *kind, d->numKind))
+        return -1;
+    /* the rows must stay within the dependency data */
+    for(i = 0; i < d->numStart; i++) {
+        if((starts[i] > d->numIndex) || (i && (starts[i] < starts[i - 1]))) return -1;
+    }
+    dep->isRowMajor = d->isRowMajor;
+    if((jm_vector_resize(size_t)(&dep->startIndex, d->numStart) != d->numStart) ||
+        (jm_vector_resize(size_t)(&dep->dependencyIndex, d->numIndex) != d->numIndex) ||
+        (jm_vector_resize(char)(&dep->dependencyFactorKind, d->numKind) != d->numKind))
+        return -1;
+    if(d->numStart) memcpy(jm_vector_get_itemp(size_t)(&dep->startIndex, 0), starts, d->numStart * sizeof(size_t));
+    if(d->numIndex) memcpy(jm_vector_get_itemp(size_t)(&dep->dependencyIndex, 0), indices, d->numIndex * sizeof(size_t));
+    if(d->numKind) memcpy(jm_vector_get_itemp(char)(&dep->dependencyFactorKind, 0), kinds, d->numKind);
+    *start += d->numStart;
+    *index += d->numIndex;
+    *kind += d->numKind;
+    return 0;
+}
+
+static int fmi2_xml_image_load_structure(fmi2_xml_image_reader_t* r, const fmi2_xml_image_model_t* model) {
+    fmi2_xml_model_structure_t* ms;
+    jm_vector(jm_voidp)* lists[FMI2_XML_IMAGE_STRUCTURE_LISTS];
+    fmi2_xml_dependencies_t** deps[FMI2_XML_IMAGE_STRUCTURE_LISTS];
+    size_t i, first = 0, start = 0, index = 0, kind = 0;
+
+    if(!model->hasStructure) return 0;
+    ms = r->md->modelStructure = fmi2_xml_allocate_model_structure(r->md->callbacks);
+    if(!ms) return -1;
+    ms->isValidFlag = model->isValidStructure;
+    lists[0] = &ms->outputs;
+    lists[1] = &ms->derivatives;
+    lists[2] = &ms->discreteStates;
+    lists[3] = &ms->initialUnknowns;
+    deps[0] = &ms->outputDeps;
+    deps[1] = &ms->derivativeDeps;
+    deps[2] = &ms->discreteStateDeps;
+    deps[3] = &ms->initialUnknownDeps;
+    for(i = 0; i < FMI2_XML_IMAGE_STRUCTURE_LISTS; i++) {
+        if(fmi2_xml_image_load_variable_list(r, fmi2_xml_image_structure, first, model->structureSize[i], lists[i])) return -1;
+        first += model->structureSize[i];
+    }
+    for(i = 0; i < FMI2_XML_IMAGE_STRUCTURE_LISTS; i++) {
+        if(!model->deps[i].present) {
+            fmi2_xml_free_dependencies(*deps[i]);
+            *deps[i] = 0;
+        }
+        else if(fmi2_xml_image_load_dependencies(r, &model->deps[i], &start, &index, &kind, *deps[i])) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int fmi2_xml_load_model_description_image(fmi2_xml_model_description_t* md, const char* fileName, const char* key) {
+    fmi2_xml_image_reader_t r;
+    fmi_xml_file_map_t map;
+    jm_callbacks* cb = md->callbacks;
+    const fmi2_xml_image_model_t* model;
+    int ret;
+
+    if(fmi_xml_map_file(fileName, &map, cb) != fmi_xml_parse_file_ok) return 1;
+
+    memset(&r, 0, sizeof(r));
+    r.md = md;
+    r.data = map.data;
+    r.header = (const fmi2_xml_image_header_t*)map.data;
+    if(fmi2_xml_image_check_header(&r, map.size, key, fileName)) {
+        fmi_xml_unmap_file(&map, cb);
+        return 1;
+    }
+
+    r.strings = (const char*)fmi2_xml_image_section(&r, fmi2_xml_image_strings);
+    r.variables = map.data + r.header->sections[fmi2_xml_image_variables].offset;
+    r.stringsSize = fmi2_xml_image_count(&r, fmi2_xml_image_strings);
+    if(!r.stringsSize || r.strings[0] || r.strings[r.stringsSize - 1] || (fmi2_xml_image_count(&r, fmi2_xml_image_model) != 1)) {
+        jm_log_warning(cb, module, "Model description image %s is corrupt", fileName);
+        fmi_xml_unmap_file(&map, cb);
+        return 1;
+    }
+    model = (const fmi2_xml_image_model_t*)fmi2_xml_image_section(&r, fmi2_xml_image_model);
+
+    /* from here on the strings of the model description point into the image */
+    md->image = map;
+    ret = (fmi2_xml_image_load_model(&r, model) ||
+        fmi2_xml_image_load_units(&r) ||
+        fmi2_xml_image_load_types(&r) ||
+        fmi2_xml_image_load_variables(&r, model) ||
+        fmi2_xml_image_load_structure(&r, model)) ? -1 : 0;
+
+    cb->free(r.types);
+    if(ret) {
+        jm_log_error(cb, module, "Model description image %s is corrupt", fileName);
+        return -1;
+    }
+    md->status = fmi2_xml_model_description_enu_ok;
+    jm_log_verbose(cb, module, "Loaded model description from image %s", fileName);
+    return 0;
+}
@@ -18,6 +18,7 @@
 */
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 
 #include "fmi2_xml_parser.h"
 #include "fmi2_xml_model_structure_impl.h"
@@ -25,6 +26,14 @@
 
 static const char * module = "FMI2XML";
 
+/* SSE2 is always available on x86-64 */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define FMI2_XML_LIST_SSE2
+#include <emmintrin.h>
+#endif
+
+#define FMI2_XML_IS_SPACE(c) (((c) == ' ') || ((c) == '\t') || ((c) == '\n') || ((c) == '\r'))
+
 fmi2_xml_model_structure_t* fmi2_xml_allocate_model_structure(jm_callbacks* cb) {
 	fmi2_xml_model_structure_t* ms = (fmi2_xml_model_structure_t*)(cb->calloc(1, sizeof(fmi2_xml_model_structure_t)));
 	if(!ms) return 0;
@@ -161,6 +170,25 @@ void fmi2_xml_free_dependencies(fmi2_xml_dependencies_t* dep) {
     cb->free(dep);
 }
 
+void fmi2_xml_shrink_dependencies(fmi2_xml_dependencies_t* dep) {
+	if(!dep) return;
+	jm_vector_shrink_to_fit(size_t)(&dep->startIndex);
+	jm_vector_shrink_to_fit(size_t)(&dep->dependencyIndex);
+	jm_vector_shrink_to_fit(char)(&dep->dependencyFactorKind);
+}
+
+void fmi2_xml_shrink_model_structure(fmi2_xml_model_structure_t* ms) {
+	jm_vector_shrink_to_fit(jm_voidp)(&ms->outputs);
+	jm_vector_shrink_to_fit(jm_voidp)(&ms->derivatives);
+	jm_vector_shrink_to_fit(jm_voidp)(&ms->discreteStates);
+	jm_vector_shrink_to_fit(jm_voidp)(&ms->initialUnknowns);
+
+	fmi2_xml_shrink_dependencies(ms->outputDeps);
+	fmi2_xml_shrink_dependencies(ms->derivativeDeps);
+	fmi2_xml_shrink_dependencies(ms->discreteStateDeps);
+	fmi2_xml_shrink_dependencies(ms->initialUnknownDeps);
+}
+
 
 int fmi2_xml_check_model_structure(fmi2_xml_model_description_t* md) {
 	fmi2_xml_model_structure_t* ms = md->modelStructure;
@@ -200,8 +228,8 @@ int fmi2_xml_handle_Outputs(fmi2_xml_parser_context_t *context, const char* data
     if (!data) {
         jm_log_verbose(context->callbacks, module, "Parsing XML element Outputs");
         /*  reset handles for the elements that are specific under Outputs */
-/*        fmi2_xml_set_element_handle(context, "Unknown", FMI2_XML_ELM_ID(OutputUnknown));*/
-        fmi2_xml_set_element_handle(context, "Unknown", FMI2_XML_ELM_ID(Unknown));
+/*        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Unknown), FMI2_XML_ELM_ID(OutputUnknown));*/
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Unknown), FMI2_XML_ELM_ID(Unknown));
     }
     return 0;
 }
@@ -209,7 +237,7 @@ int fmi2_xml_handle_Derivatives(fmi2_xml_parser_context_t *context, const char*
     if (!data) {
         jm_log_verbose(context->callbacks, module, "Parsing XML element Derivatives");
         /*  reset handles for the elements that are specific under Derivatives */
-        fmi2_xml_set_element_handle(context, "Unknown", FMI2_XML_ELM_ID(DerivativeUnknown));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Unknown), FMI2_XML_ELM_ID(DerivativeUnknown));
     }
     else {
         fmi2_xml_model_description_t* md = context->modelDescription;
@@ -223,7 +251,7 @@ int fmi2_xml_handle_DiscreteStates(fmi2_xml_parser_context_t *context, const cha
     if (!data) {
         jm_log_verbose(context->callbacks, module, "Parsing XML element DiscreteStates");
         /*  reset handles for the elements that are specific under DiscreteStates */
-        fmi2_xml_set_element_handle(context, "Unknown", FMI2_XML_ELM_ID(DiscreteStateUnknown));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Unknown), FMI2_XML_ELM_ID(DiscreteStateUnknown));
     }
     return 0;
 }
@@ -231,12 +259,52 @@ int fmi2_xml_handle_InitialUnknowns(fmi2_xml_parser_context_t *context, const ch
     if (!data) {
         jm_log_verbose(context->callbacks, module, "Parsing XML element InitialUnknowns");
         /*  reset handles for the elements that are specific under InitialUnknowns */
-        fmi2_xml_set_element_handle(context, "Unknown", FMI2_XML_ELM_ID(InitialUnknown));
+        fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Unknown), FMI2_XML_ELM_ID(InitialUnknown));
     }
     return 0;
 }
 
 
+/* Number of bits set in a 16 bit mask */
+static unsigned int fmi2_xml_popcount16(unsigned int x) {
+    x = x - ((x >> 1) & 0x5555);
+    x = (x & 0x3333) + ((x >> 2) & 0x3333);
+    x = (x + (x >> 4)) & 0x0F0F;
+    return (x + (x >> 8)) & 0x1F;
+}
+
+/* Count the items in a white space separated list. The count is used to reserve memory
+   before the items are parsed. */
+static size_t fmi2_xml_count_list_items(const char* str) {
+    size_t len = strlen(str);
+    size_t count = 0, i = 0;
+    int prevSpace = 1;
+#ifdef FMI2_XML_LIST_SSE2
+    /* An item starts where a non-space character follows a space */
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    unsigned int carry = 1;
+    for(; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(x, lf), _mm_cmpeq_epi8(x, cr)));
+        unsigned int nonSpace = ~(unsigned int)_mm_movemask_epi8(isSpace) & 0xFFFF;
+        unsigned int starts = nonSpace & ~((nonSpace << 1) | (carry ^ 1));
+        count += fmi2_xml_popcount16(starts & 0xFFFF);
+        carry = (nonSpace >> 15) ^ 1;
+    }
+    prevSpace = (int)carry;
+#endif
+    for(; i < len; i++) {
+        int isSpace = FMI2_XML_IS_SPACE(str[i]);
+        if(prevSpace && !isSpace) count++;
+        prevSpace = isSpace;
+    }
+    return count;
+}
+
 int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
                                 fmi2_xml_elm_enu_t parentElmID,
 								fmi2_xml_dependencies_t* deps)
@@ -249,6 +317,7 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
     size_t numDepInd = 0;
     size_t numDepKind = 0;
     size_t totNumDep = jm_vector_get_size(size_t)(&deps->dependencyIndex);
+    size_t k;
     
     /*  <xs:attribute name="dependencies">
             <xs:simpleType>
@@ -260,34 +329,43 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
         return 0;
     }
     if(listInd) {
-         const char* cur = listInd;
-         int ind;
-         while(*cur) {
-             char ch = *cur;
-             while((ch ==' ') || (ch == '\t') || (ch =='\n') || (ch == '\r')) {
-                 cur++; ch = *cur;
-                 if(!ch) break;
-             }
-             if(!ch) break;
-             if(sscanf(cur, "%d", &ind) != 1) {
-                 fmi2_xml_parse_error(context, "XML element 'Unknown': could not parse item %d in the list for attribute 'dependencies'",
-                     numDepInd);
+        const char* cur = listInd;
+        size_t* items;
+        numDepInd = fmi2_xml_count_list_items(listInd);
+        /* the vectors shared by all the Unknown elements grow geometrically */
+        if(jm_vector_resize(size_t)(&deps->dependencyIndex, totNumDep + numDepInd) < totNumDep + numDepInd) {
+            jm_vector_resize(size_t)(&deps->dependencyIndex, totNumDep);
+            fmi2_xml_parse_fatal(context, "Could not allocate memory");
+            return -1;
+        }
+        items = jm_vector_get_itemp(size_t)(&deps->dependencyIndex, totNumDep);
+        for(k = 0; k < numDepInd; k++) {
+            unsigned long ind = 0;
+            unsigned int d;
+            int n;
+            while(FMI2_XML_IS_SPACE(*cur)) cur++;
+            if(*cur == '+') cur++;
+            /* more than nine digits may overflow */
+            for(n = 0; (d = (unsigned int)(unsigned char)*cur - '0') <= 9; n++, cur++) {
+                if((n >= 9) && (ind > (UINT_MAX - d) / 10)) break;
+                ind = ind * 10 + d;
+            }
+            if(!n || (*cur && !FMI2_XML_IS_SPACE(*cur))) {
+                jm_vector_resize(size_t)(&deps->dependencyIndex, totNumDep);
+                fmi2_xml_parse_error(context, "XML element 'Unknown': could not parse item %u in the list for attribute 'dependencies'",
+                    (unsigned)k);
                 ms->isValidFlag = 0;
                 return 0;
-             }
-             if(ind < 1) {
-                 fmi2_xml_parse_error(context, "XML element 'Unknown': item %d=%d is less than one in the list for attribute 'dependencies'", 
-                     numDepInd, ind);
+            }
+            if(ind < 1) {
+                jm_vector_resize(size_t)(&deps->dependencyIndex, totNumDep);
+                fmi2_xml_parse_error(context, "XML element 'Unknown': item %u=%lu is less than one in the list for attribute 'dependencies'",
+                    (unsigned)k, ind);
                 ms->isValidFlag = 0;
                 return 0;
-             }
-             if(!jm_vector_push_back(size_t)(&deps->dependencyIndex, (size_t)ind)) {
-                fmi2_xml_parse_fatal(context, "Could not allocate memory");
-                return -1;
             }
-             while((*cur >= '0') && (*cur <= '9')) cur++;
-             numDepInd++;
-         }
+            items[k] = (size_t)ind;
+        }
     }
 
     /*
@@ -312,57 +390,71 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
         return 0;
     }
     if(listKind) {
-         const char* cur = listKind;
-         char kind;
-         while(*cur) {
-             char ch = *cur;
-             while(ch && ((ch ==' ') || (ch == '\t') || (ch =='\n') || (ch == '\r'))) {
-                 cur++; ch = *cur;
-             }
-             if(!ch) break;
-             if(strncmp("dependent", cur, 9) == 0) {
-                 kind = fmi2_dependency_factor_kind_dependent;
-                 cur+=9;
-             }
-             else if(strncmp("constant", cur, 8) == 0) {
-                 kind = fmi2_dependency_factor_kind_constant;
-                 cur+=8;
-             }
-             else if(strncmp("fixed", cur, 5) == 0) {
-                 kind = fmi2_dependency_factor_kind_fixed;
-                 cur+=5;
-             }
-             else if(strncmp("tunable", cur, 7) == 0) {
-                 kind = fmi2_dependency_factor_kind_tunable;
-                 cur+=7;
-             }
-             else if(strncmp("discrete", cur, 8) == 0) {
-                  kind = fmi2_dependency_factor_kind_discrete;
-                 cur+=8;
-             }
-             else {
-                 fmi2_xml_parse_error(context, "XML element 'Unknown': could not parse item %d in the list for attribute 'dependenciesKind'",
-                     numDepKind);
-                 ms->isValidFlag = 0;
-                 return 0;
-             }
-             if (parentElmID == fmi2_xml_elmID_InitialUnknowns) {
+        const char* cur = listKind;
+        char* kinds;
+        numDepKind = fmi2_xml_count_list_items(listKind);
+        if(jm_vector_resize(char)(&deps->dependencyFactorKind, totNumDep + numDepKind) < totNumDep + numDepKind) {
+            jm_vector_resize(char)(&deps->dependencyFactorKind, totNumDep);
+            fmi2_xml_parse_fatal(context, "Could not allocate memory");
+            return -1;
+        }
+        kinds = jm_vector_get_itemp(char)(&deps->dependencyFactorKind, totNumDep);
+        for(k = 0; k < numDepKind; k++) {
+            char kind = 0;
+            size_t len = 0;
+            while(FMI2_XML_IS_SPACE(*cur)) cur++;
+            switch(*cur) {
+            case 'd':
+                if(strncmp("dependent", cur, 9) == 0) {
+                    kind = fmi2_dependency_factor_kind_dependent;
+                    len = 9;
+                }
+                else if(strncmp("discrete", cur, 8) == 0) {
+                    kind = fmi2_dependency_factor_kind_discrete;
+                    len = 8;
+                }
+                break;
+            case 'c':
+                if(strncmp("constant", cur, 8) == 0) {
+                    kind = fmi2_dependency_factor_kind_constant;
+                    len = 8;
+                }
+                break;
+            case 'f':
+                if(strncmp("fixed", cur, 5) == 0) {
+                    kind = fmi2_dependency_factor_kind_fixed;
+                    len = 5;
+                }
+                break;
+            case 't':
+                if(strncmp("tunable", cur, 7) == 0) {
+                    kind = fmi2_dependency_factor_kind_tunable;
+                    len = 7;
+                }
+                break;
+            }
+            cur += len;
+            if(!len || (*cur && !FMI2_XML_IS_SPACE(*cur))) {
+                jm_vector_resize(char)(&deps->dependencyFactorKind, totNumDep);
+                fmi2_xml_parse_error(context, "XML element 'Unknown': could not parse item %u in the list for attribute 'dependenciesKind'",
+                    (unsigned)k);
+                ms->isValidFlag = 0;
+                return 0;
+            }
+            if (parentElmID == fmi2_xml_elmID_InitialUnknowns) {
                 if (kind == fmi2_dependency_factor_kind_fixed) {
                     fmi2_xml_parse_error(context, "XML element 'Unknown' within 'InitialUnknowns': 'fixed' is not allowed in list for attribute 'dependenciesKind'; setting to 'dependent'");
                     kind = fmi2_dependency_factor_kind_dependent;
                 }
                 else if (!(kind == fmi2_dependency_factor_kind_dependent || kind == fmi2_dependency_factor_kind_constant)) {
+                    jm_vector_resize(char)(&deps->dependencyFactorKind, totNumDep);
                     fmi2_xml_parse_error(context, "XML element 'Unknown' within 'InitialUnknowns': only 'dependent' and 'constant' allowed in list for attribute 'dependenciesKind'");
                     ms->isValidFlag = 0;
-                    return 0;                 
+                    return 0;
                 }
-             }
-             if(!jm_vector_push_back(char)(&deps->dependencyFactorKind, kind)) {
-                fmi2_xml_parse_fatal(context, "Could not allocate memory");
-                return -1;
             }
-             numDepKind++;
-         }
+            kinds[k] = kind;
+        }
     }
     if(listInd && listKind) {
         /* both lists are present - the number of items must match */
@@ -376,12 +468,12 @@ int fmi2_xml_parse_dependencies(fmi2_xml_parser_context_t *context,
     else if(listInd) {
         /* only Dependencies are present, set all kinds to dependent */
         char kind = fmi2_dependency_factor_kind_dependent;
-        if(jm_vector_reserve(char)(&deps->dependencyFactorKind,totNumDep + numDepInd) < totNumDep + numDepInd) {
-            fmi2_xml_parse_fatal(context, "Could not allocate memory");
-            return -1;
+        for(;numDepKind < numDepInd; numDepKind++) {
+            if(!jm_vector_push_back(char)(&deps->dependencyFactorKind, kind)) {
+                fmi2_xml_parse_fatal(context, "Could not allocate memory");
+                return -1;
+            }
         }
-        for(;numDepKind < numDepInd; numDepKind++)
-            jm_vector_push_back(char)(&deps->dependencyFactorKind, kind);
     }
     else if(listKind) {
         fmi2_xml_parse_error(context, "XML element 'Unknown': if `dependenciesKind` attribute is present then the `dependencies` attribute must be present also.");
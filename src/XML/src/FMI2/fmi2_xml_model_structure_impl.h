@@ -43,6 +43,7 @@ typedef struct fmi2_xml_dependencies_t {
 
 fmi2_xml_dependencies_t* fmi2_xml_allocate_dependencies(jm_callbacks* cb);
 void fmi2_xml_free_dependencies(fmi2_xml_dependencies_t* dep);
+void fmi2_xml_shrink_dependencies(fmi2_xml_dependencies_t* dep);
 	
 struct fmi2_xml_model_structure_t {
 	jm_vector(jm_voidp) outputs;
@@ -58,6 +59,9 @@ struct fmi2_xml_model_structure_t {
 	int isValidFlag;  /**\ brief The flag is used to signal if an error was discovered and the model structure is not usable */
 };
 
+/** \brief Release the unused capacity of the model structure vectors once they are complete */
+void fmi2_xml_shrink_model_structure(fmi2_xml_model_structure_t* ms);
+
 #ifdef __cplusplus
 }
 #endif
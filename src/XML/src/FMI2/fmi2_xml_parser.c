@@ -15,9 +15,15 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
+
+#include <JM/jm_number.h>
 
 #include "fmi2_xml_model_description_impl.h"
 #include "fmi2_xml_parser.h"
+#include "fmi2_xml_parser_hash.h"
+#include "../FMI/fmi_xml_file.h"
+#include "../FMI/fmi_xml_hash.h"
 
 static const char * module = "FMI2XML";
 
@@ -91,21 +97,16 @@ fmi2_xml_element_handle_map_t fmi2_element_handle_map[fmi2_xml_elm_number] = {
 
 void fmi2_xml_parse_free_context(fmi2_xml_parser_context_t *context) {
     if(!context) return;
-    if(context->modelDescription)
+    if(context->modelDescription) {
+        fmi2_xml_release_streamed_variable(context);
         fmi2_xml_clear_model_description(context->modelDescription);
+    }
+    jm_arena_free_data(&context->variableArena);
     if(context->parser) {
         XML_ParserFree(context->parser);
         context->parser = 0;
     }
     fmi2_xml_free_parse_buffer(context);
-    if(context->attrMap) {
-        jm_vector_free(jm_named_ptr)(context->attrMap);
-        context->attrMap = 0;
-    }
-    if(context->elmMap) {
-        jm_vector_free(fmi2_xml_element_handle_map_t)(context->elmMap);
-        context->elmMap = 0;
-    }
     if(context->attrBuffer) {
         jm_vector_free(jm_string)(context->attrBuffer);
         context->attrBuffer = 0;
@@ -198,7 +199,7 @@ int fmi2_xml_set_attr_uint(fmi2_xml_parser_context_t *context, fmi2_xml_elm_enu_
     elmName = fmi2_element_handle_map[elmID].elementName;
     attrName = fmi2_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%u", field) != 1) {
+    if(jm_parse_uint(strVal, field) != jm_status_success) {
         fmi2_xml_parse_error(context, "XML element '%s': could not parse value for unsigned attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -249,7 +250,7 @@ int fmi2_xml_set_attr_int(fmi2_xml_parser_context_t *context, fmi2_xml_elm_enu_t
     elmName = fmi2_element_handle_map[elmID].elementName;
     attrName = fmi2_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%d", field) != 1) {
+    if(jm_parse_int(strVal, field) != jm_status_success) {
         fmi2_xml_parse_error(context, "XML element '%s': could not parse value for integer attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -272,7 +273,7 @@ int fmi2_xml_set_attr_double(fmi2_xml_parser_context_t *context, fmi2_xml_elm_en
     elmName = fmi2_element_handle_map[elmID].elementName;
     attrName = fmi2_xmlAttrNames[attrID];
 
-    if(sscanf(strVal, "%lf", field) != 1) {
+    if(jm_parse_double(strVal, field) != jm_status_success) {
         fmi2_xml_parse_error(context, "XML element '%s': could not parse value for real attribute '%s'='%s'", elmName, attrName, strVal);
         return -1;
     }
@@ -330,51 +331,67 @@ jm_vector(char) * fmi2_xml_get_parse_buffer(fmi2_xml_parser_context_t *context,
 
 
 
-int fmi2_create_attr_map(fmi2_xml_parser_context_t* context) {
+int fmi2_create_attr_buffer(fmi2_xml_parser_context_t* context) {
     int i;
     context->attrBuffer = jm_vector_alloc(jm_string)(fmi2_xml_attr_number, fmi2_xml_attr_number, context->callbacks);
     if(!context->attrBuffer) return -1;
-    context->attrMap = jm_vector_alloc(jm_named_ptr)(fmi2_xml_attr_number, fmi2_xml_attr_number, context->callbacks);
-    if(!context->attrMap) return -1;
     for(i = 0; i < fmi2_xml_attr_number; i++) {
-        jm_named_ptr map;
         jm_vector_set_item(jm_string)(context->attrBuffer, i, 0);
-        map.name = fmi2_xmlAttrNames[i];
-        map.ptr = (void*)(jm_vector_get_itemp(jm_string)(context->attrBuffer, i));
-        jm_vector_set_item(jm_named_ptr)(context->attrMap, i, map);
     }
-    jm_vector_qsort(jm_named_ptr)(context->attrMap, jm_compare_named);
+    context->attrSetSize = 0;
     return 0;
 }
 
-int fmi2_create_elm_map(fmi2_xml_parser_context_t* context) {
-    size_t i;
-    context->elmMap = jm_vector_alloc(fmi2_xml_element_handle_map_t)(fmi2_xml_elm_actual_number, fmi2_xml_elm_number, context->callbacks);
-    if(!context->elmMap) return -1;
-    for(i = 0; i < fmi2_xml_elm_actual_number; i++) {
-        fmi2_xml_element_handle_map_t item = fmi2_element_handle_map[i];
-        jm_vector_set_item(fmi2_xml_element_handle_map_t)(context->elmMap, i, item);
+/* Reset the attributes stored for the current element. Only the slots listed in attrSet can be non-NULL. */
+static void fmi2_xml_clear_attr_buffer(fmi2_xml_parser_context_t* context) {
+    size_t k;
+    for(k = 0; k < context->attrSetSize; k++) {
+        jm_vector_set_item(jm_string)(context->attrBuffer, context->attrSet[k], 0);
     }
-    jm_vector_qsort(fmi2_xml_element_handle_map_t)(context->elmMap, fmi2_xml_compare_elmName);
-    return 0;
+    context->attrSetSize = 0;
 }
 
-void fmi2_xml_set_element_handle(fmi2_xml_parser_context_t *context, const char* elm, fmi2_xml_elm_enu_t id) {
-    fmi2_xml_element_handle_map_t keyEl;
-    fmi2_xml_element_handle_map_t* currentElMap;
-	keyEl.elementName = elm;
-    currentElMap = jm_vector_bsearch(fmi2_xml_element_handle_map_t)(context->elmMap, &keyEl, fmi2_xml_compare_elmName);
-	
-	currentElMap->elementHandle = fmi2_element_handle_map[id].elementHandle;;
-	currentElMap->elemID = id;
+/* Find the attribute with the given name. Returns fmi2_xml_attr_number if there is no such attribute. */
+static fmi2_xml_attr_enu_t fmi2_xml_lookup_attr(const char* name) {
+    unsigned int id = fmi2_xml_attr_hash_table[fmi_xml_hash(name, FMI2_XML_ATTR_HASH_SEED) & FMI2_XML_ATTR_HASH_MASK];
+    if((id != FMI_XML_HASH_EMPTY) && (strcmp(fmi2_xmlAttrNames[id], name) == 0))
+        return (fmi2_xml_attr_enu_t)id;
+    return fmi2_xml_attr_number;
 }
 
+/* Find the element with the given name. The ID depends on the context, fmi2_xml_elmID_none is returned for unknown elements. */
+static fmi2_xml_elm_enu_t fmi2_xml_lookup_elm(fmi2_xml_parser_context_t *context, const char* name) {
+    unsigned int id = fmi2_xml_elm_hash_table[fmi_xml_hash(name, FMI2_XML_ELM_HASH_SEED) & FMI2_XML_ELM_HASH_MASK];
+    if((id != FMI_XML_HASH_EMPTY) && (strcmp(fmi2_element_handle_map[id].elementName, name) == 0))
+        return context->elmMap[id];
+    return fmi2_xml_elmID_none;
+}
+
+void fmi2_xml_set_element_handle(fmi2_xml_parser_context_t *context, fmi2_xml_elm_enu_t elm, fmi2_xml_elm_enu_t id) {
+    context->elmMap[elm] = id;
+}
+
+
+static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const char **attr);
+static void XMLCALL fmi2_parse_element_end(void* c, const char *elm);
+static void XMLCALL fmi2_parse_element_data(void* c, const XML_Char *s, int len);
+
+/* Handlers installed while a skipped section is passed over: only the nesting depth is tracked */
+static void XMLCALL fmi2_skip_element_start(void *c, const char *elm, const char **attr) {
+    fmi2_xml_parser_context_t *context = c;
+    context->skipSectionDepth++;
+}
+
+static void XMLCALL fmi2_skip_element_end(void *c, const char *elm) {
+    fmi2_xml_parser_context_t *context = c;
+    if(--context->skipSectionDepth) return;
+    /* the skipped element counts as a parsed sibling for the order checks */
+    context->lastElmID = context->skipSectionID;
+    XML_SetElementHandler(context->parser, fmi2_parse_element_start, fmi2_parse_element_end);
+    XML_SetCharacterDataHandler(context->parser, fmi2_parse_element_data);
+}
 
 static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const char **attr) {
-    jm_named_ptr key;
-    fmi2_xml_element_handle_map_t keyEl;
-    fmi2_xml_element_handle_map_t* currentElMap;
-    jm_named_ptr* currentMap;
 	fmi2_xml_elm_enu_t currentID;
     int i;
     fmi2_xml_parser_context_t *context = c;
@@ -399,10 +416,9 @@ static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const cha
 		return;
 	}
 	
-	keyEl.elementName = elm;
 	/* find the element handle by name */
-    currentElMap = jm_vector_bsearch(fmi2_xml_element_handle_map_t)(context->elmMap, &keyEl, fmi2_xml_compare_elmName);
-    if(!currentElMap) {
+    currentID = fmi2_xml_lookup_elm(context, elm);
+    if(currentID == fmi2_xml_elmID_none) {
         /* not found error*/
         jm_log_error(context->callbacks, module, "[Line:%u] Unknown element '%s' in XML, skipping",
 			XML_GetCurrentLineNumber(context->parser), elm);
@@ -410,7 +426,6 @@ static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const cha
         return;
     }
 
-    currentID = currentElMap->elemID;
 	/* Check that parent-child & siblings are fine */
 	{
 		fmi2_xml_elm_enu_t parentID = context->currentElmID;
@@ -449,13 +464,24 @@ static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const cha
 		context->lastElmID = fmi2_xml_elmID_none;
 	}
 
+	if(context->skipElm[currentID]) {
+		/* pass the whole section over without looking at it */
+		context->skipSectionID = currentID;
+		context->skipSectionDepth = 1;
+		XML_SetElementHandler(context->parser, fmi2_skip_element_start, fmi2_skip_element_end);
+		XML_SetCharacterDataHandler(context->parser, 0);
+		return;
+	}
+
+    /* clear the attributes left over when the handle of the previous element failed */
+    fmi2_xml_clear_attr_buffer(context);
+
     /* process the attributes  */
     i = 0;
     while(attr[i]) {
-        key.name = attr[i];
         /* find attribute by name  */
-        currentMap = jm_vector_bsearch(jm_named_ptr)(context->attrMap, &key, jm_compare_named);
-        if(!currentMap) {
+        fmi2_xml_attr_enu_t attrID = fmi2_xml_lookup_attr(attr[i]);
+        if(attrID == fmi2_xml_attr_number) {
 #define XMLSchema_instance "http://www.w3.org/2001/XMLSchema-instance"
 			const size_t stdNSlen = strlen(XMLSchema_instance);
             const size_t attrStrLen = strlen(attr[i]);
@@ -490,28 +516,31 @@ static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const cha
 				jm_log_error(context->callbacks, module, "Unknown attribute '%s=%s' in XML", attr[i], attr[i+1]);
 			}
         }
-		else  {
+		else if(!context->skipAttr[attrID]) {
             /* save attr value (still as string) for further handling  */
-            const char** mapItem = (const char**)currentMap->ptr;
-            *mapItem = attr[i+1];
+            if(!jm_vector_get_item(jm_string)(context->attrBuffer, attrID))
+                context->attrSet[context->attrSetSize++] = attrID;
+            jm_vector_set_item(jm_string)(context->attrBuffer, attrID, attr[i+1]);
         }
         i += 2;
     }
 
     /* handle the element */
-	if( currentElMap->elementHandle(context, 0) ) {
+	if( fmi2_element_handle_map[currentID].elementHandle(context, 0) ) {
 		/* try to skip and continue anyway */
         if(!context->skipElementCnt) context->skipElementCnt = 1; 
     }
 	if(context->skipElementCnt) return;
     /* check that the element handle had process all the attributes */
-    for(i = 0; i < fmi2_xml_attr_number; i++) {
-        if(jm_vector_get_item(jm_string)(context->attrBuffer, i)) {
-            if(!context->skipOneVariableFlag)
-                jm_log_warning(context->callbacks,module, "Attribute '%s' not processed by element '%s' handle", fmi2_xmlAttrNames[i], elm);
-            jm_vector_set_item(jm_string)(context->attrBuffer, i,0);
+    if(!context->skipOneVariableFlag) {
+        size_t k;
+        for(k = 0; k < context->attrSetSize; k++) {
+            fmi2_xml_attr_enu_t attrID = context->attrSet[k];
+            if(jm_vector_get_item(jm_string)(context->attrBuffer, attrID))
+                jm_log_warning(context->callbacks,module, "Attribute '%s' not processed by element '%s' handle", fmi2_xmlAttrNames[attrID], elm);
         }
     }
+    fmi2_xml_clear_attr_buffer(context);
     if(context -> currentElmID != fmi2_xml_elmID_none) { /* with nested elements: put the parent on the stack*/
         jm_stack_push(int)(&context->elmStack, context -> currentElmID);
     }
@@ -520,8 +549,6 @@ static void XMLCALL fmi2_parse_element_start(void *c, const char *elm, const cha
 
 static void XMLCALL fmi2_parse_element_end(void* c, const char *elm) {
 
-    fmi2_xml_element_handle_map_t keyEl;
-    fmi2_xml_element_handle_map_t* currentElMap;
 	fmi2_xml_elm_enu_t currentID;
     fmi2_xml_parser_context_t *context = c;
 
@@ -542,14 +569,12 @@ static void XMLCALL fmi2_parse_element_end(void* c, const char *elm) {
 		return;
 	}
 
-    keyEl.elementName = elm;
-    currentElMap = jm_vector_bsearch(fmi2_xml_element_handle_map_t)(context->elmMap, &keyEl, fmi2_xml_compare_elmName);
-    if(!currentElMap) {
+    currentID = fmi2_xml_lookup_elm(context, elm);
+    if(currentID == fmi2_xml_elmID_none) {
         /* not found error*/
         fmi2_xml_parse_fatal(context, "Unknown element end in XML (element: %s)", elm);
         return;
     }
-    currentID = currentElMap->elemID;
 
     if(currentID != context -> currentElmID) {
         /* missmatch error*/
@@ -560,7 +585,7 @@ static void XMLCALL fmi2_parse_element_end(void* c, const char *elm) {
 
     jm_vector_push_back(char)(&context->elmData, 0);
 
-	if( currentElMap->elementHandle(context, jm_vector_get_itemp(char)(&context->elmData, 0) )) {
+	if( fmi2_element_handle_map[currentID].elementHandle(context, jm_vector_get_itemp(char)(&context->elmData, 0) )) {
         return;
     }
     jm_vector_resize(char)(&context->elmData, 0);
@@ -614,23 +639,47 @@ static void XMLCALL fmi2_parse_element_data(void* c, const XML_Char *s, int len)
 		}
 }
 
-int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const char* filename, fmi2_xml_callbacks_t* xml_callbacks) {
+/* Mark the elements and attributes of the sections that are left out */
+static void fmi2_xml_init_skipped_sections(fmi2_xml_parser_context_t* context, unsigned int skipSections) {
+    if(skipSections & fmi_xml_section_descriptions) {
+        context->skipAttr[fmi_attr_id_description] = 1;
+    }
+    if(skipSections & fmi_xml_section_annotations) {
+        context->skipElm[fmi2_xml_elmID_VendorAnnotations] = 1;
+        context->skipElm[fmi2_xml_elmID_Annotations] = 1;
+    }
+    if(skipSections & fmi_xml_section_model_structure) {
+        context->skipElm[fmi2_xml_elmID_ModelStructure] = 1;
+    }
+    if(skipSections & fmi_xml_section_units) {
+        context->skipElm[fmi2_xml_elmID_UnitDefinitions] = 1;
+        context->skipAttr[fmi_attr_id_unit] = 1;
+        context->skipAttr[fmi_attr_id_displayUnit] = 1;
+    }
+}
+
+static fmi2_xml_parser_context_t* fmi2_xml_parse_create_context(fmi2_xml_model_description_t* md, fmi2_xml_callbacks_t* xml_callbacks) {
     XML_Memory_Handling_Suite memsuite;
     fmi2_xml_parser_context_t* context;
     XML_Parser parser = NULL;
-    FILE* file;
 
     context = (fmi2_xml_parser_context_t*)md->callbacks->calloc(1, sizeof(fmi2_xml_parser_context_t));
     if(!context) {
         jm_log_fatal(md->callbacks, "FMIXML", "Could not allocate memory for XML parser context");
+        return 0;
     }
     context->callbacks = md->callbacks;
     context->modelDescription = md;
-    if(fmi2_xml_alloc_parse_buffer(context, 16)) return -1;
-    if(fmi2_create_attr_map(context) || fmi2_create_elm_map(context)) {
+    if(fmi2_xml_alloc_parse_buffer(context, 16)) return 0;
+    if(fmi2_create_attr_buffer(context)) {
         fmi2_xml_parse_fatal(context, "Error in parsing initialization");
         fmi2_xml_parse_free_context(context);
-        return -1;
+        return 0;
+    }
+    {
+        int i;
+        for(i = 0; i < fmi2_xml_elm_actual_number; i++)
+            context->elmMap[i] = (fmi2_xml_elm_enu_t)i;
     }
     context->lastBaseUnit = 0;
     context->skipOneVariableFlag = 0;
@@ -643,6 +692,10 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const cha
 	context->useAnyHandleFlg = 0;
     context->anyParent = 0;
 	context->anyHandle = xml_callbacks;
+    /* the model structure refers to the variables, which are not kept when they are streamed */
+    if(md->variableHandle) md->skippedSections |= fmi_xml_section_model_structure;
+    fmi2_xml_init_skipped_sections(context, md->skippedSections);
+    jm_arena_init(&context->variableArena, 0, context->callbacks);
 
     memsuite.malloc_fcn = context->callbacks->malloc;
     memsuite.realloc_fcn = context->callbacks->realloc;
@@ -652,7 +705,7 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const cha
     if(! parser) {
         fmi2_xml_parse_fatal(context, "Could not initialize XML parsing library.");
         fmi2_xml_parse_free_context(context);
-        return -1;
+        return 0;
     }
 
     XML_SetUserData( parser, context);
@@ -661,39 +714,27 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const cha
 
     XML_SetCharacterDataHandler(parser, fmi2_parse_element_data);
 
-    file = fopen(filename, "rb");
-    if (file == NULL) {
-        fmi2_xml_parse_fatal(context, "Cannot open file '%s' for parsing", filename);
-        fmi2_xml_parse_free_context(context);
-        return -1;
-    }
+    return context;
+}
 
-    while (!feof(file)) {
-        char * text = jm_vector_get_itemp(char)(fmi2_xml_reserve_parse_buffer(context,0,XML_BLOCK_SIZE),0);
-        int n = (int)fread(text, sizeof(char), XML_BLOCK_SIZE, file);
-        if(ferror(file)) {
-            fmi2_xml_parse_fatal(context, "Error reading from file %s", filename);
-            fclose(file);
-	        fmi2_xml_parse_free_context(context);
-            return -1;
-        }
-        if (!XML_Parse(parser, text, n, feof(file))) {
-             fmi2_xml_parse_fatal(context, "Parse error at line %d:\n%s",
-                         (int)XML_GetCurrentLineNumber(parser),
-                         XML_ErrorString(XML_GetErrorCode(parser)));
-             fclose(file);
-		     fmi2_xml_parse_free_context(context);
-             return -1; /* failure */
-        }        
-    }
-    fclose(file);
+static int fmi2_xml_parse_report_error(fmi2_xml_parser_context_t* context) {
+    fmi2_xml_parse_fatal(context, "Parse error at line %d:\n%s",
+                (int)XML_GetCurrentLineNumber(context->parser),
+                XML_ErrorString(XML_GetErrorCode(context->parser)));
+    fmi2_xml_parse_free_context(context);
+    return -1; /* failure */
+}
+
+static int fmi2_xml_parse_finish(fmi2_xml_parser_context_t* context, const char* source) {
+    fmi2_xml_model_description_t* md = context->modelDescription;
     /* done later XML_ParserFree(parser);*/
     if(!jm_stack_is_empty(int)(&context->elmStack)) {
-        fmi2_xml_parse_fatal(context, "Unexpected end of file (not all elements ended) when parsing %s", filename);
+        fmi2_xml_parse_fatal(context, "Unexpected end of file (not all elements ended) when parsing %s", source);
         fmi2_xml_parse_free_context(context);
         return -1;
     }
 
+    fmi2_xml_shrink_model_description(md);
     md->status = fmi2_xml_model_description_enu_ok;
     context->modelDescription = 0;
     fmi2_xml_parse_free_context(context);
@@ -701,5 +742,46 @@ int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const cha
     return 0;
 }
 
-#define JM_TEMPLATE_INSTANCE_TYPE fmi2_xml_element_handle_map_t
-#include "JM/jm_vector_template.h"
+int fmi2_xml_parse_model_description(fmi2_xml_model_description_t* md, const char* filename, fmi2_xml_callbacks_t* xml_callbacks) {
+    fmi2_xml_parser_context_t* context;
+
+    context = fmi2_xml_parse_create_context(md, xml_callbacks);
+    if(!context) return -1;
+
+    switch(fmi_xml_parse_file(context->parser, filename)) {
+    case fmi_xml_parse_file_ok:
+        break;
+    case fmi_xml_parse_file_open_error:
+        fmi2_xml_parse_fatal(context, "Cannot open file '%s' for parsing", filename);
+        fmi2_xml_parse_free_context(context);
+        return -1;
+    case fmi_xml_parse_file_read_error:
+        fmi2_xml_parse_fatal(context, "Error reading from file %s", filename);
+        fmi2_xml_parse_free_context(context);
+        return -1;
+    default:
+        return fmi2_xml_parse_report_error(context);
+    }
+
+    return fmi2_xml_parse_finish(context, filename);
+}
+
+int fmi2_xml_parse_model_description_from_buffer(fmi2_xml_model_description_t* md, const char* buffer, size_t size, fmi2_xml_callbacks_t* xml_callbacks) {
+    fmi2_xml_parser_context_t* context;
+    size_t offset = 0;
+
+    context = fmi2_xml_parse_create_context(md, xml_callbacks);
+    if(!context) return -1;
+
+    /* The data is already in memory, so it is handed to expat directly without copying */
+    do {
+        int n = (int)((size - offset > INT_MAX) ? INT_MAX : (size - offset));
+        if (!XML_Parse(context->parser, buffer + offset, n, offset + n == size)) {
+             return fmi2_xml_parse_report_error(context);
+        }
+        offset += n;
+    } while (offset < size);
+
+    return fmi2_xml_parse_finish(context, "memory buffer");
+}
+
@@ -21,6 +21,7 @@
 #include <JM/jm_vector.h>
 #include <JM/jm_stack.h>
 #include <JM/jm_named_ptr.h>
+#include <JM/jm_arena.h>
 #include <FMI2/fmi2_xml_callbacks.h>
 
 #include <FMI2/fmi2_enums.h>
@@ -180,14 +181,6 @@ struct fmi2_xml_element_handle_map_t {
 };
 
 
-jm_vector_declare_template(fmi2_xml_element_handle_map_t)
-
-#define fmi2_xml_diff_elmName(a, b) strcmp(a.elementName,b.elementName)
-
-jm_define_comp_f(fmi2_xml_compare_elmName, fmi2_xml_element_handle_map_t, fmi2_xml_diff_elmName)
-
-#define XML_BLOCK_SIZE 16000
-
 struct fmi2_xml_parser_context_t {
     fmi2_xml_model_description_t* modelDescription;
     jm_callbacks* callbacks;
@@ -195,9 +188,13 @@ struct fmi2_xml_parser_context_t {
     XML_Parser parser;
     jm_vector(jm_voidp) parseBuffer;
 
-    jm_vector(jm_named_ptr)* attrMap;
-    jm_vector(fmi2_xml_element_handle_map_t)* elmMap;
+    /* Element ID for each name in FMI2_XML_ELMLIST. Names that mean different elements
+       in different sections are remapped with fmi2_xml_set_element_handle(). */
+    fmi2_xml_elm_enu_t elmMap[fmi2_xml_elm_actual_number];
     jm_vector(jm_string)* attrBuffer;
+    /* IDs of the attributes stored in attrBuffer for the current element */
+    fmi2_xml_attr_enu_t attrSet[fmi2_xml_attr_number];
+    size_t attrSetSize;
 
     fmi2_xml_unit_t* lastBaseUnit;
 
@@ -216,6 +213,20 @@ struct fmi2_xml_parser_context_t {
 	char* anyToolName;
 	void* anyParent;
 	fmi2_xml_callbacks_t* anyHandle;
+
+    /* Elements and attributes of the sections that are not parsed, see fmi2_xml_set_skipped_sections() */
+    char skipElm[fmi2_xml_elm_number];
+    char skipAttr[fmi2_xml_attr_number];
+    /* Depth within a skipped element and its ID while the skip handlers are installed */
+    int skipSectionDepth;
+    fmi2_xml_elm_enu_t skipSectionID;
+
+    /* Streaming of the variables, see fmi2_xml_set_variable_handle(). The variable being parsed and
+       its type properties are allocated in variableArena, which is cleared after each variable. */
+    jm_arena_t variableArena;
+    struct fmi2_xml_variable_type_base_t* streamTypePropsList; /* typePropsList of the model before the variable */
+    size_t streamedVariables;
+    int streamingVariable; /* a variable is being parsed into variableArena */
 };
 
 jm_vector(char) * fmi2_xml_reserve_parse_buffer(fmi2_xml_parser_context_t *context, size_t index, size_t size);
@@ -236,7 +247,11 @@ int fmi2_xml_set_attr_double(fmi2_xml_parser_context_t *context, fmi2_xml_elm_en
 int fmi2_xml_is_attr_defined(fmi2_xml_parser_context_t *context, fmi2_xml_attr_enu_t attrID);
 int fmi2_xml_get_attr_str(fmi2_xml_parser_context_t *context, fmi2_xml_elm_enu_t elmID, fmi2_xml_attr_enu_t attrID, int required,const char** valp);
 
-void fmi2_xml_set_element_handle(fmi2_xml_parser_context_t *context, const char* elm, fmi2_xml_elm_enu_t id);
+/* Make the element name with ID elm (from FMI2_XML_ELMLIST) be handled as element id from now on */
+void fmi2_xml_set_element_handle(fmi2_xml_parser_context_t *context, fmi2_xml_elm_enu_t elm, fmi2_xml_elm_enu_t id);
+
+/* Drop the streamed variable being parsed, if any, and everything allocated for it */
+void fmi2_xml_release_streamed_variable(fmi2_xml_parser_context_t *context);
 
 
 #ifdef __cplusplus
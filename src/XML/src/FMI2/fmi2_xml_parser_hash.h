@@ -0,0 +1,53 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/* Generated by fmi_xml_hash_test --generate fmi2, see FMI/fmi_xml_hash.h. Do not edit. */
+
+#ifndef FMI2_XML_PARSER_HASH_H
+#define FMI2_XML_PARSER_HASH_H
+
+#define FMI2_XML_ELM_HASH_SEED 0x3C5A454FU
+#define FMI2_XML_ELM_HASH_MASK 63
+
+static const unsigned char fmi2_xml_elm_hash_table[64] = {
+	2, 255, 255, 0, 255, 255, 11, 13, 5, 255, 255, 255, 10, 26, 22, 25,
+	255, 28, 21, 255, 255, 255, 255, 23, 7, 19, 17, 255, 255, 255, 255, 4,
+	1, 255, 255, 24, 255, 15, 29, 3, 12, 255, 16, 14, 255, 20, 255, 255,
+	255, 255, 255, 255, 9, 18, 6, 27, 30, 255, 255, 255, 8, 255, 255, 255
+};
+
+#define FMI2_XML_ATTR_HASH_SEED 0x530433A0U
+#define FMI2_XML_ATTR_HASH_MASK 255
+
+static const unsigned char fmi2_xml_attr_hash_table[256] = {
+	255, 255, 255, 27, 255, 255, 255, 255, 255, 255, 255, 59, 255, 255, 255, 255,
+	55, 255, 255, 255, 255, 255, 255, 255, 21, 255, 255, 255, 255, 41, 44, 33,
+	30, 255, 255, 255, 255, 24, 255, 255, 34, 255, 4, 255, 255, 22, 255, 50,
+	255, 255, 255, 255, 255, 255, 53, 255, 255, 255, 255, 255, 255, 255, 255, 35,
+	255, 255, 255, 255, 255, 255, 255, 255, 47, 255, 255, 255, 255, 255, 255, 255,
+	1, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 15, 255, 255, 255,
+	255, 255, 49, 255, 56, 13, 12, 61, 255, 255, 36, 255, 7, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 18, 255, 255,
+	255, 255, 255, 19, 255, 48, 255, 255, 255, 17, 28, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 42, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 8,
+	37, 255, 255, 255, 255, 255, 57, 255, 255, 255, 255, 255, 255, 255, 6, 255,
+	10, 58, 255, 255, 5, 32, 255, 255, 255, 255, 46, 255, 3, 14, 51, 255,
+	255, 255, 255, 0, 255, 255, 255, 255, 255, 255, 11, 255, 38, 255, 9, 52,
+	40, 255, 255, 255, 255, 255, 60, 255, 255, 2, 39, 255, 255, 62, 23, 255,
+	255, 20, 255, 255, 255, 255, 255, 255, 16, 255, 255, 255, 255, 31, 54, 255,
+	26, 255, 255, 255, 255, 255, 255, 43, 29, 45, 255, 25, 255, 255, 255, 255
+};
+
+#endif /* FMI2_XML_PARSER_HASH_H */
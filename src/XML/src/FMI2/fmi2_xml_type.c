@@ -246,13 +246,15 @@ void fmi2_xml_init_enumeration_type_properties(fmi2_xml_enum_typedef_props_t* ty
 }
 
 void fmi2_xml_free_enumeration_type_props(fmi2_xml_enum_typedef_props_t* type) {
-    jm_named_vector_free_data(&type->enumItems);
+    /* The items are allocated in the model description arena */
+    jm_vector_free_data(jm_named_ptr)(&type->enumItems);
 }
 
-void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_callbacks* cb) {
+void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_arena_t* arena, jm_callbacks* cb) {
+    td->arena = arena;
     jm_vector_init(jm_named_ptr)(&td->typeDefinitions,0,cb);
 
-    jm_vector_init(jm_string)(&td->quantities, 0, cb);
+    jm_string_intern_init(&td->quantities, cb);
 
     fmi2_xml_init_real_type_properties(&td->defaultRealType);
     fmi2_xml_init_enumeration_type_properties(&td->defaultEnumType,cb);
@@ -265,10 +267,7 @@ void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_callback
 }
 
 void fmi2_xml_free_type_definitions_data(fmi2_xml_type_definitions_t* td) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-
-    jm_vector_foreach(jm_string)(&td->quantities,(void(*)(const char*))cb->free);
-    jm_vector_free_data(jm_string)(&td->quantities);
+    jm_string_intern_free_data(&td->quantities);
 
     {
         fmi2_xml_variable_type_base_t* next;
@@ -282,13 +281,12 @@ void fmi2_xml_free_type_definitions_data(fmi2_xml_type_definitions_t* td) {
                 fmi2_xml_enum_typedef_props_t* props = (fmi2_xml_enum_typedef_props_t*)cur;
                 fmi2_xml_free_enumeration_type_props(props);
             }
-            cb->free(cur);
             cur = next;
         }
 		td->typePropsList = 0;
     }
 
-    jm_named_vector_free_data(&td->typeDefinitions);
+    jm_vector_free_data(jm_named_ptr)(&td->typeDefinitions);
 }
 
 int fmi2_xml_handle_TypeDefinitions(fmi2_xml_parser_context_t *context, const char* data) {
@@ -298,7 +296,7 @@ int fmi2_xml_handle_TypeDefinitions(fmi2_xml_parser_context_t *context, const ch
     else {
         fmi2_xml_type_definitions_t* defs =  &context->modelDescription->typeDefinitions;
 
-        jm_vector_qsort(jm_named_ptr)(&defs->typeDefinitions, jm_compare_named);
+        jm_named_vector_sort(&defs->typeDefinitions);
         /* might give out a warning if(data[0] != 0) */
         return 0;
     }
@@ -325,7 +323,7 @@ int fmi2_xml_handle_SimpleType(fmi2_xml_parser_context_t *context, const char* d
             pnamed = jm_vector_push_back(jm_named_ptr)(&td->typeDefinitions,named);
             if(pnamed) {
                 fmi2_xml_variable_typedef_t dummy;
-                *pnamed = named = jm_named_alloc_v(bufName, sizeof(fmi2_xml_variable_typedef_t), dummy.typeName - (char*)&dummy,  context->callbacks);
+                *pnamed = named = jm_named_alloc_v_arena(bufName, sizeof(fmi2_xml_variable_typedef_t), dummy.typeName - (char*)&dummy, td->arena);
             }
             if(!pnamed || !named.ptr) {
                 fmi2_xml_parse_fatal(context, "Could not allocate memory");
@@ -335,7 +333,7 @@ int fmi2_xml_handle_SimpleType(fmi2_xml_parser_context_t *context, const char* d
                 fmi2_xml_variable_typedef_t* type = named.ptr;
                 fmi2_xml_init_variable_type_base(&type->typeBase,fmi2_xml_type_struct_enu_typedef,fmi2_base_type_real);
                 if(jm_vector_get_size(char)(bufDescr)) {
-                    const char* description = jm_string_set_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
+                    const char* description = jm_string_intern_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
                     type->description = description;
                 }
                 else type->description = "";
@@ -355,8 +353,7 @@ int fmi2_xml_handle_SimpleType(fmi2_xml_parser_context_t *context, const char* d
 }
 
 fmi2_xml_variable_type_base_t* fmi2_xml_alloc_variable_type_props(fmi2_xml_type_definitions_t* td, fmi2_xml_variable_type_base_t* base, size_t typeSize) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-    fmi2_xml_variable_type_base_t* type = cb->malloc(typeSize);
+    fmi2_xml_variable_type_base_t* type = jm_arena_alloc(td->arena, typeSize);
     if(!type) return 0;
     fmi2_xml_init_variable_type_base(type,fmi2_xml_type_struct_enu_props,base->baseType);
     type->baseTypeStruct = base;
@@ -366,8 +363,7 @@ fmi2_xml_variable_type_base_t* fmi2_xml_alloc_variable_type_props(fmi2_xml_type_
 }
 
 fmi2_xml_variable_type_base_t* fmi2_xml_alloc_variable_type_start(fmi2_xml_type_definitions_t* td,fmi2_xml_variable_type_base_t* base, size_t typeSize) {
-    jm_callbacks* cb = td->typeDefinitions.callbacks;
-    fmi2_xml_variable_type_base_t* type = cb->malloc(typeSize);
+    fmi2_xml_variable_type_base_t* type = jm_arena_alloc(td->arena, typeSize);
     if(!type) return 0;
     fmi2_xml_init_variable_type_base(type,fmi2_xml_type_struct_enu_start,base->baseType);
     type->baseTypeStruct = base;
@@ -404,13 +400,13 @@ fmi2_xml_real_type_props_t* fmi2_xml_parse_real_type_properties(fmi2_xml_parser_
         return 0;
     }
     if(jm_vector_get_size(char)(bufQuantity))
-        quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+        quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
     props->quantity = quantity;
     props->displayUnit = 0;
     if(jm_vector_get_size(char)(bufDispUnit)) {
         named.name = jm_vector_get_itemp(char)(bufDispUnit, 0);
-        pnamed = jm_vector_bsearch(jm_named_ptr)(&(md->displayUnitDefinitions), &named, jm_compare_named);
+        pnamed = jm_named_vector_search(&(md->displayUnitDefinitions), named.name);
         if(!pnamed) {
             fmi2_xml_parse_fatal(context, "Unknown display unit %s in real type definition", jm_vector_get_itemp(char)(bufDispUnit, 0));
             return 0;
@@ -477,7 +473,7 @@ fmi2_xml_integer_type_props_t * fmi2_xml_parse_integer_type_properties(fmi2_xml_
             )
         return 0;
     if(jm_vector_get_size(char)(bufQuantity))
-        quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+        quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
     props->quantity = quantity;
 
@@ -569,7 +565,7 @@ int fmi2_xml_handle_Enumeration(fmi2_xml_parser_context_t *context, const char*
                 )
             return -1;
         if(jm_vector_get_size(char)(bufQuantity))
-            quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+            quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
         props->base.quantity = quantity;
 
@@ -629,7 +625,7 @@ int fmi2_xml_handle_Item(fmi2_xml_parser_context_t *context, const char* data) {
 			named.name = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&enumProps->enumItems, named);
 
-            if(pnamed) *pnamed = named = jm_named_alloc_v(bufName,sizeof(fmi2_xml_enum_type_item_t)+descrlen+1,sizeof(fmi2_xml_enum_type_item_t)+descrlen,context->callbacks);
+            if(pnamed) *pnamed = named = jm_named_alloc_v_arena(bufName,sizeof(fmi2_xml_enum_type_item_t)+descrlen+1,sizeof(fmi2_xml_enum_type_item_t)+descrlen,&md->arena);
             item = named.ptr;
             if( !pnamed || !item ) {
                 fmi2_xml_parse_fatal(context, "Could not allocate memory");
@@ -656,7 +652,7 @@ fmi2_xml_variable_type_base_t* fmi2_get_declared_type(fmi2_xml_parser_context_t
     fmi2_xml_set_attr_string(context, elmID, fmi_attr_id_declaredType, 0, bufDeclaredType);
     if(! jm_vector_get_size(char)(bufDeclaredType) ) return defaultType;
     key.name = jm_vector_get_itemp(char)(bufDeclaredType,0);
-    found = jm_vector_bsearch(jm_named_ptr)(&(context->modelDescription->typeDefinitions.typeDefinitions),&key, jm_compare_named);
+    found = jm_named_vector_search(&(context->modelDescription->typeDefinitions.typeDefinitions), key.name);
     if(!found) {
         jm_log_error(context->callbacks, module, "Declared type %s not found in type definitions. Ignoring.", key.name);
         return defaultType;
@@ -17,7 +17,7 @@
 #define FMI2_XML_TYPEIMPL_H
 
 #include <JM/jm_named_ptr.h>
-#include <JM/jm_string_set.h>
+#include <JM/jm_string_intern.h>
 #include <FMI2/fmi2_xml_model_description.h>
 
 #include "fmi2_xml_parser.h"
@@ -170,10 +170,12 @@ static fmi2_xml_variable_type_base_t* fmi2_xml_find_type_props(fmi2_xml_variable
 struct fmi2_xml_type_definitions_t {
     jm_vector(jm_named_ptr) typeDefinitions;
 
-    jm_string_set quantities;
+    jm_string_intern_t quantities;
 
     fmi2_xml_variable_type_base_t* typePropsList;
 
+    jm_arena_t* arena;
+
     fmi2_xml_real_type_props_t defaultRealType;
     fmi2_xml_enum_typedef_props_t defaultEnumType;
     fmi2_xml_integer_type_props_t defaultIntegerType;
@@ -181,7 +183,7 @@ struct fmi2_xml_type_definitions_t {
     fmi2_xml_string_type_props_t defaultStringType;
 };
 
-extern void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_callbacks* cb) ;
+extern void fmi2_xml_init_type_definitions(fmi2_xml_type_definitions_t* td, jm_arena_t* arena, jm_callbacks* cb) ;
 
 extern void fmi2_xml_free_type_definitions_data(fmi2_xml_type_definitions_t* td);
 
@@ -191,6 +193,8 @@ extern void fmi2_xml_init_enum_typedef(fmi2_xml_enumeration_typedef_t* type, jm_
 
 extern void fmi2_xml_free_enum_type(jm_named_ptr named);
 
+void fmi2_xml_init_variable_type_base(fmi2_xml_variable_type_base_t* type, fmi2_xml_type_struct_kind_enu_t kind, fmi2_base_type_enu_t baseType);
+
 fmi2_xml_variable_type_base_t* fmi2_xml_alloc_variable_type_props(fmi2_xml_type_definitions_t* td, fmi2_xml_variable_type_base_t* base, size_t typeSize);
 
 fmi2_xml_variable_type_base_t* fmi2_xml_alloc_variable_type_start(fmi2_xml_type_definitions_t* td,fmi2_xml_variable_type_base_t* base, size_t typeSize);
@@ -115,8 +115,8 @@ int fmi2_xml_handle_UnitDefinitions(fmi2_xml_parser_context_t *context, const ch
  		jm_log_verbose(context->callbacks, module, "Parsing XML element UnitDefinitions");
 	}
     else {
-        jm_vector_qsort(jm_named_ptr)(&(md->unitDefinitions),jm_compare_named);
-        jm_vector_qsort(jm_named_ptr)(&(md->displayUnitDefinitions),jm_compare_named);
+        jm_named_vector_sort(&(md->unitDefinitions));
+        jm_named_vector_sort(&(md->displayUnitDefinitions));
         /* might give out a warning if(data[0] != 0) */
     }
     return 0;
@@ -134,7 +134,7 @@ fmi2_xml_display_unit_t* fmi2_xml_get_parsed_unit(fmi2_xml_parser_context_t *con
 		named.name = "";
 
 	if(sorted)
-        pnamed = jm_vector_bsearch(jm_named_ptr)(&(md->unitDefinitions), &named,jm_compare_named);
+        pnamed = jm_named_vector_search(&(md->unitDefinitions), named.name);
     else
         pnamed = jm_vector_find(jm_named_ptr)(&(md->unitDefinitions), &named,jm_compare_named);
 
@@ -145,7 +145,7 @@ fmi2_xml_display_unit_t* fmi2_xml_get_parsed_unit(fmi2_xml_parser_context_t *con
 
     named.ptr = 0;
     pnamed = jm_vector_push_back(jm_named_ptr)(&(md->unitDefinitions),named);
-    if(pnamed) *pnamed = named = jm_named_alloc_v(name,sizeof(fmi2_xml_unit_t),dummy.baseUnit - (char*)&dummy,context->callbacks);
+    if(pnamed) *pnamed = named = jm_named_alloc_v_arena(name,sizeof(fmi2_xml_unit_t),dummy.baseUnit - (char*)&dummy,&md->arena);
 
     if(!pnamed || !named.ptr) {
         fmi2_xml_parse_fatal(context, "Could not allocate memory");
@@ -163,7 +163,7 @@ fmi2_xml_display_unit_t* fmi2_xml_get_parsed_unit(fmi2_xml_parser_context_t *con
     unit->defaultDisplay.displayUnit[0] = 0;
     jm_vector_init(jm_voidp)(&(unit->displayUnits),0,context->callbacks);
 
-    if(sorted) jm_vector_qsort_jm_named_ptr(&(md->unitDefinitions), jm_compare_named);
+    if(sorted) jm_named_vector_sort(&(md->unitDefinitions));
     return &unit->defaultDisplay;
 }
 
@@ -243,7 +243,7 @@ int fmi2_xml_handle_DisplayUnit(fmi2_xml_parser_context_t *context, const char*
             /* alloc memory to the correct size and put display unit on the list for the base unit */
             named.ptr = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&(md->displayUnitDefinitions),named);
-            if(pnamed) *pnamed = jm_named_alloc(jm_vector_get_itemp_char(buf,0),sizeof(fmi2_xml_display_unit_t), dummyDU.displayUnit - (char*)&dummyDU,context->callbacks);
+            if(pnamed) *pnamed = jm_named_alloc_arena(jm_vector_get_itemp_char(buf,0),sizeof(fmi2_xml_display_unit_t), dummyDU.displayUnit - (char*)&dummyDU,&md->arena);
             dispUnit = pnamed->ptr;
             if( !pnamed || !dispUnit ||
                 !jm_vector_push_back(jm_voidp)(&unit->displayUnits, dispUnit) ) {
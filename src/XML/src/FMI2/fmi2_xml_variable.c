@@ -17,6 +17,7 @@
 #include <stdio.h>
 
 #include <JM/jm_vector.h>
+#include <JM/jm_thread_pool.h>
 
 #include "fmi2_xml_parser.h"
 #include "fmi2_xml_type_impl.h"
@@ -26,6 +27,34 @@
 
 static const char* module = "FMI2XML";
 
+/* The variables in variablesByVR are ordered by base type, where Enumeration counts as Integer, and then by value reference */
+static unsigned fmi2_xml_get_vr_class(fmi2_xml_variable_t* v) {
+    fmi2_base_type_enu_t bt = fmi2_xml_get_variable_base_type(v);
+    return (unsigned)((bt == fmi2_base_type_enum) ? fmi2_base_type_int : bt);
+}
+
+static int fmi2_xml_is_vr_less(fmi2_xml_variable_t* a, fmi2_xml_variable_t* b) {
+    unsigned ac = fmi2_xml_get_vr_class(a), bc = fmi2_xml_get_vr_class(b);
+    return (ac < bc) || ((ac == bc) && (a->vr < b->vr));
+}
+
+#define JM_SORT_TEMPLATE_TYPE jm_voidp
+#define JM_SORT_TEMPLATE_NAME fmi2_xml_vr
+#define JM_SORT_TEMPLATE_LESS(a, b) fmi2_xml_is_vr_less((fmi2_xml_variable_t*)*(a), (fmi2_xml_variable_t*)*(b))
+#include <JM/jm_sort_template.h>
+
+/* The variables in variablesByName are ordered by name and then by original index, so that the order does not depend on the sorting */
+static int fmi2_xml_is_name_less(const jm_named_ptr* a, const jm_named_ptr* b) {
+    int c = strcmp(a->name, b->name);
+    return (c < 0) || ((c == 0) &&
+        (((fmi2_xml_variable_t*)a->ptr)->originalIndex < ((fmi2_xml_variable_t*)b->ptr)->originalIndex));
+}
+
+#define JM_SORT_TEMPLATE_TYPE jm_named_ptr
+#define JM_SORT_TEMPLATE_NAME fmi2_xml_name
+#define JM_SORT_TEMPLATE_LESS(a, b) fmi2_xml_is_name_less(a, b)
+#include <JM/jm_sort_template.h>
+
 const char* fmi2_xml_get_variable_name(fmi2_xml_variable_t* v) {
     return v->name;
 }
@@ -47,18 +76,22 @@ fmi2_variable_alias_kind_enu_t fmi2_xml_get_variable_alias_kind(fmi2_xml_variabl
 }
 
 fmi2_xml_variable_t* fmi2_xml_get_variable_alias_base(fmi2_xml_model_description_t* md, fmi2_xml_variable_t* v) {
-    fmi2_xml_variable_t key;
-    fmi2_xml_variable_t *pkey = &key, *base;
-    void ** found;
+    jm_voidp key = v;
+    size_t i, num;
 	if(!md->variablesByVR) return 0;
     if(v->aliasKind == fmi2_variable_is_not_alias) return v;
-    key = *v;
-    key.aliasKind = fmi2_variable_is_not_alias;
 
-    found = jm_vector_bsearch(jm_voidp)(md->variablesByVR,(void**)&pkey, fmi2_xml_compare_vr);
-    assert(found);
-    base = *found;
-    return base;
+    /* the base is the variable of the same type in the run of variables with the value reference that is not an alias */
+    num = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+    for(i = jm_vector_lower_bound(fmi2_xml_vr)(md->variablesByVR, &key); i < num; i++) {
+        fmi2_xml_variable_t* cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
+        if(fmi2_xml_is_vr_less(v, cur)) break;
+        if((cur->aliasKind == fmi2_variable_is_not_alias) &&
+           (fmi2_xml_get_variable_base_type(cur) == fmi2_xml_get_variable_base_type(v)))
+            return cur;
+    }
+    assert(0);
+    return 0;
 }
 
 /*
@@ -66,38 +99,22 @@ fmi2_xml_variable_t* fmi2_xml_get_variable_alias_base(fmi2_xml_model_description
     The list is ordered: base variable, aliases.
 */
 jm_status_enu_t fmi2_xml_get_variable_aliases(fmi2_xml_model_description_t* md,fmi2_xml_variable_t* v, jm_vector(jm_voidp)* list) {
-    fmi2_xml_variable_t key, *cur;
-    fmi2_value_reference_t vr = fmi2_xml_get_variable_vr(v);
-    size_t baseIndex, i, num = jm_vector_get_size(jm_voidp)(md->variablesByVR);
-    key = *v;
-    key.aliasKind = 0;
-    cur = &key;
-    baseIndex = jm_vector_bsearch_index(jm_voidp)(md->variablesByVR,(void**)&cur, fmi2_xml_compare_vr);
-    cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, baseIndex);
-    assert(cur);
-    i = baseIndex + 1;
-    while(fmi2_xml_get_variable_vr(cur) == vr) {
+    fmi2_xml_variable_t *base = fmi2_xml_get_variable_alias_base(md, v);
+    jm_voidp key = v;
+    size_t i, num = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+
+    if(!base) return jm_status_error;
+    if(!jm_vector_push_back(jm_voidp)(list, base)) {
+        jm_log_fatal(md->callbacks,module,"Could not allocate memory");
+        return jm_status_error;
+    }
+    for(i = jm_vector_lower_bound(fmi2_xml_vr)(md->variablesByVR, &key); i < num; i++) {
+        fmi2_xml_variable_t* cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
+        if(fmi2_xml_is_vr_less(v, cur)) break;
+        if(cur == base) continue;
         if(!jm_vector_push_back(jm_voidp)(list, cur)) {
-			jm_log_fatal(md->callbacks,module,"Could not allocate memory");
+            jm_log_fatal(md->callbacks,module,"Could not allocate memory");
             return jm_status_error;
-        };
-        if(i >= num) break;
-        cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
-        assert(cur);
-        i++;
-    }
-    if(baseIndex) {
-        i = baseIndex - 1;
-        cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
-        while(fmi2_xml_get_variable_vr(cur) == vr) {
-            if(!jm_vector_push_back(jm_voidp)(list, cur)) {
-                jm_log_fatal(md->callbacks,module,"Could not allocate memory");                
-                return jm_status_error;
-            };
-            i--;
-            if(!i) break;
-            cur = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i - 1);
-            assert(cur);
         }
     }
     return jm_status_success;
@@ -279,12 +296,88 @@ fmi2_xml_bool_variable_t* fmi2_xml_get_variable_as_boolean(fmi2_xml_variable_t*
     return 0;
 }
 
+void fmi2_xml_release_streamed_variable(fmi2_xml_parser_context_t *context) {
+    fmi2_xml_model_description_t* md = context->modelDescription;
+    if(!context->streamingVariable) return;
+    jm_vector_resize(jm_named_ptr)(&md->variablesByName, 0);
+    md->typeDefinitions.typePropsList = context->streamTypePropsList;
+    md->typeDefinitions.arena = &md->arena;
+    jm_arena_clear(&context->variableArena);
+    context->streamingVariable = 0;
+}
+
+/* Pass a completely parsed variable to the variable handle and drop it */
+static int fmi2_xml_stream_variable(fmi2_xml_parser_context_t *context, fmi2_xml_variable_t* variable) {
+    fmi2_xml_model_description_t* md = context->modelDescription;
+    fmi2_xml_variable_typedef_t* declaredType = fmi2_xml_get_variable_declared_type(variable);
+    fmi2_xml_variable_record_t record;
+    int ret;
+
+    memset(&record, 0, sizeof(record));
+    record.name = variable->name;
+    record.description = variable->description;
+    record.vr = variable->vr;
+    record.index = context->streamedVariables;
+    record.baseType = fmi2_xml_get_variable_base_type(variable);
+    record.causality = (fmi2_causality_enu_t)variable->causality;
+    record.variability = (fmi2_variability_enu_t)variable->variability;
+    record.initial = (fmi2_initial_enu_t)variable->initial;
+    record.declaredType = declaredType ? fmi2_xml_get_type_name(declaredType) : 0;
+    record.hasStart = fmi2_xml_get_variable_has_start(variable);
+    /* the indices are kept as pointers until the variable list is complete */
+    record.derivativeOf = (char*)variable->derivativeOf - (char *)NULL;
+    record.previous = (char*)variable->previous - (char *)NULL;
+
+    switch(record.baseType) {
+    case fmi2_base_type_real: {
+        fmi2_xml_real_variable_t* v = fmi2_xml_get_variable_as_real(variable);
+        fmi2_xml_unit_t* unit = fmi2_xml_get_real_variable_unit(v);
+        record.unit = unit ? fmi2_xml_get_unit_name(unit) : 0;
+        record.start.real = fmi2_xml_get_real_variable_start(v);
+        record.min.real = fmi2_xml_get_real_variable_min(v);
+        record.max.real = fmi2_xml_get_real_variable_max(v);
+        /* every variable with a derivative attribute is listed under Derivatives */
+        if(record.derivativeOf) md->numberOfContinuousStates++;
+        break;
+    }
+    case fmi2_base_type_int: {
+        fmi2_xml_integer_variable_t* v = fmi2_xml_get_variable_as_integer(variable);
+        record.start.integer = fmi2_xml_get_integer_variable_start(v);
+        record.min.integer = fmi2_xml_get_integer_variable_min(v);
+        record.max.integer = fmi2_xml_get_integer_variable_max(v);
+        break;
+    }
+    case fmi2_base_type_enum: {
+        fmi2_xml_enum_variable_t* v = fmi2_xml_get_variable_as_enum(variable);
+        record.start.integer = fmi2_xml_get_enum_variable_start(v);
+        record.min.integer = fmi2_xml_get_enum_variable_min(v);
+        record.max.integer = fmi2_xml_get_enum_variable_max(v);
+        break;
+    }
+    case fmi2_base_type_bool:
+        record.start.boolean = fmi2_xml_get_boolean_variable_start(fmi2_xml_get_variable_as_boolean(variable));
+        break;
+    case fmi2_base_type_str:
+        record.start.string = fmi2_xml_get_string_variable_start(fmi2_xml_get_variable_as_string(variable));
+        break;
+    }
+
+    ret = md->variableHandle(md->variableHandleContext, &record);
+    fmi2_xml_release_streamed_variable(context);
+    if(ret != 0) {
+        fmi2_xml_parse_fatal(context, "User variable handle returned non-zero error code %d", ret);
+        return -1;
+    }
+    return 0;
+}
+
 int fmi2_xml_handle_ScalarVariable(fmi2_xml_parser_context_t *context, const char* data) {
     if(!data) {
             fmi2_xml_model_description_t* md = context->modelDescription;
             fmi2_xml_variable_t* variable;
             fmi2_xml_variable_t dummyV;
             const char* description = 0;
+            jm_arena_t* arena = &md->arena;
             jm_named_ptr named, *pnamed;
             jm_vector(char)* bufName = fmi2_xml_reserve_parse_buffer(context,1,100);
             jm_vector(char)* bufDescr = fmi2_xml_reserve_parse_buffer(context,2,100);
@@ -306,24 +399,36 @@ int fmi2_xml_handle_ScalarVariable(fmi2_xml_parser_context_t *context, const cha
 				jm_log_error(context->callbacks,module, "Ignoring variable with undefined vr '%s'", jm_vector_get_itemp(char)(bufName,0));
                 return 0;
             }
+            if(md->variableHandle) {
+                /* everything allocated for a streamed variable goes into the variable arena */
+                fmi2_xml_release_streamed_variable(context);
+                context->streamTypePropsList = md->typeDefinitions.typePropsList;
+                md->typeDefinitions.arena = arena = &context->variableArena;
+                context->streamingVariable = 1;
+                context->streamedVariables++;
+            }
             if(jm_vector_get_size(char)(bufDescr)) {
-                description = jm_string_set_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
+                if(md->variableHandle)
+                    description = jm_arena_strndup(arena, jm_vector_get_itemp(char)(bufDescr,0), jm_vector_get_size(char)(bufDescr));
+                else
+                    description = jm_string_intern_put(&md->descriptions, jm_vector_get_itemp(char)(bufDescr,0));
             }
 
             named.ptr = 0;
 			named.name = 0;
             pnamed = jm_vector_push_back(jm_named_ptr)(&md->variablesByName, named);
 
-            if(pnamed) *pnamed = named = jm_named_alloc_v(bufName,sizeof(fmi2_xml_variable_t), dummyV.name - (char*)&dummyV, context->callbacks);
+            if(pnamed) *pnamed = named = jm_named_alloc_v_arena(bufName,sizeof(fmi2_xml_variable_t), dummyV.name - (char*)&dummyV, arena);
             variable = named.ptr;
-            if( !pnamed || !variable ) {
+            if( !pnamed || !variable || (jm_vector_get_size(char)(bufDescr) && !description)) {
                 fmi2_xml_parse_fatal(context, "Could not allocate memory");
                 return -1;
             }
             variable->vr = vr;
             variable->description = description;
             variable->typeBase = 0;
-			variable->originalIndex = jm_vector_get_size(jm_named_ptr)(&md->variablesByName) - 1;
+			variable->originalIndex = md->variableHandle ? context->streamedVariables - 1 :
+				jm_vector_get_size(jm_named_ptr)(&md->variablesByName) - 1;
             variable->derivativeOf = 0;
             variable->previous = 0;
             variable->aliasKind = fmi2_variable_is_not_alias;
@@ -410,10 +515,16 @@ int fmi2_xml_handle_ScalarVariable(fmi2_xml_parser_context_t *context, const cha
             fmi2_xml_model_description_t* md = context->modelDescription;
             fmi2_xml_variable_t* variable = jm_vector_get_last(jm_named_ptr)(&md->variablesByName).ptr;
             if(!variable->typeBase) {
+                if(md->variableHandle) {
+                    jm_log_error(context->callbacks, module, "No variable type element for variable %s. Skipping.", variable->name);
+                    fmi2_xml_release_streamed_variable(context);
+                    return 0;
+                }
 				jm_log_error(context->callbacks, module, "No variable type element for variable %s. Assuming Real.", variable->name);
 
 				return fmi2_xml_handle_RealVariable(context, data);
             }
+            if(md->variableHandle) return fmi2_xml_stream_variable(context, variable);
         }
         /* might give out a warning if(data[0] != 0) */
     }
@@ -728,7 +839,7 @@ fmi2_xml_enum_variable_props_t * fmi2_xml_parse_enum_properties(fmi2_xml_parser_
             )
         return 0;
     if(jm_vector_get_size(char)(bufQuantity))
-        quantity = jm_string_set_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
+        quantity = jm_string_intern_put(&md->typeDefinitions.quantities, jm_vector_get_itemp(char)(bufQuantity, 0));
 
 	props->quantity = (quantity == 0) ? declaredType->quantity: quantity;
 
@@ -802,75 +913,217 @@ int fmi2_xml_handle_EnumerationVariable(fmi2_xml_parser_context_t *context, cons
     return 0;
 }
 
-static int fmi2_xml_compare_variable_original_index (const void* first, const void* second) { 
-	size_t a = (*(fmi2_xml_variable_t**)first)->originalIndex;
-	size_t b = (*(fmi2_xml_variable_t**)second)->originalIndex;
-    if(a < b) return -1;
-    if(a > b) return 1;
-	return 0;
+/* Check if two variables have the same value reference. Integer and Enumeration variables share the references. */
+static int fmi2_xml_is_same_vr(fmi2_xml_variable_t* a, fmi2_xml_variable_t* b) {
+    fmi2_base_type_enu_t at = fmi2_xml_get_variable_base_type(a);
+    fmi2_base_type_enu_t bt = fmi2_xml_get_variable_base_type(b);
+    if(at == fmi2_base_type_enum) at = fmi2_base_type_int;
+    if(bt == fmi2_base_type_enum) bt = fmi2_base_type_int;
+    return (at == bt) && (a->vr == b->vr);
 }
 
-void fmi2_xml_eliminate_bad_alias(fmi2_xml_parser_context_t *context, size_t indexVR) {
-    fmi2_xml_model_description_t* md = context->modelDescription;
-    jm_vector(jm_voidp)* varByVR = md->variablesByVR;
-    fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, indexVR);
-    fmi2_value_reference_t vr = v->vr;
-    fmi2_base_type_enu_t vt = fmi2_xml_get_variable_base_type(v);
-    size_t i, n = jm_vector_get_size(jm_voidp)(varByVR);
-    for(i = 0; i< n; i++) {
-        jm_named_ptr key;
-        size_t index;
-        v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, i);
-        if((v->vr != vr)||(vt != fmi2_xml_get_variable_base_type(v))) continue;
-        jm_vector_remove_item_jm_voidp(varByVR,i);
-        n--; i--;
-        key.name = v->name;
-        index = jm_vector_bsearch_index(jm_named_ptr)(&md->variablesByName, &key, jm_compare_named);
-        assert(index <= n);
-        jm_vector_remove_item(jm_named_ptr)(&md->variablesByName,index);
-
-		index = jm_vector_bsearch_index(jm_voidp)(md->variablesOrigOrder, (jm_voidp*)&v, fmi2_xml_compare_variable_original_index);
-        assert(index <= n);
-		
-		jm_vector_remove_item(jm_voidp)(md->variablesOrigOrder,index);
-		
-		jm_log_error(context->callbacks, module,"Removing incorrect alias variable '%s'", v->name);
-        md->callbacks->free(v);
-    }
-}
-
-static int fmi2_xml_compare_vr_and_original_index (const void* first, const void* second) {
-	int ret = fmi2_xml_compare_vr(first, second);
-	if(ret != 0) return ret;
-
-	{
-	    fmi2_xml_variable_t* a = *(fmi2_xml_variable_t**)first;
-		fmi2_xml_variable_t* b = *(fmi2_xml_variable_t**)second;
-		ret = a->causality - b->causality;
-		if(ret != 0 ) return ret;
-		ret = a->variability - b->variability;
-		if(ret != 0) return ret;
-		{
-			size_t ai = a->originalIndex;
-			size_t bi = b->originalIndex;
-			if(ai > bi) return 1;
-			if(ai < bi) return -1;
-		}
-	}
-	
-	return 0;
+/*
+    Mark the aliases among the variables [begin, end) of varByVR, which all have the same value reference.
+    Variables marked in drop are passed over. Returns the index of the first variable found to have a start
+    value together with one of its aliases, or end if there is none.
+*/
+static size_t fmi2_xml_mark_aliases(fmi2_xml_parser_context_t *context, jm_vector(jm_voidp)* varByVR, size_t begin, size_t end, const char* drop) {
+    /* Integer and Enumeration variables share a group but alias only within their own base type */
+    fmi2_xml_variable_t* base[2] = {0, 0};
+    int basePresent[2] = {0, 0};
+    size_t i;
+
+    for(i = begin; i < end; i++) {
+        fmi2_xml_variable_t* b = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, i);
+        int k, b_startPresent;
+        fmi2_xml_variable_t* a;
+        if(drop[b->originalIndex]) continue;
+        k = (fmi2_xml_get_variable_base_type(b) == fmi2_base_type_enum);
+        a = base[k];
+        b_startPresent = fmi2_xml_get_variable_has_start(b);
+        if(a) {
+            /* an alias */
+            jm_log_verbose(context->callbacks,module,"Variables %s and %s reference the same vr %u. Marking '%s' as alias.",
+                            a->name, b->name, b->vr, b->name);
+            b->aliasKind = fmi2_variable_is_alias;
+            if(basePresent[k] && b_startPresent) {
+                jm_log_error(context->callbacks,module,
+                    "Only one variable among aliases is allowed to have start attribute (variables: %s and %s)",
+                        a->name, b->name);
+                return i;
+            }
+            if(b_startPresent) {
+                basePresent[k] = 1;
+                base[k] = b;
+            }
+        }
+        else {
+            b->aliasKind = fmi2_variable_is_not_alias;
+            basePresent[k] = b_startPresent;
+            base[k] = b;
+        }
+    }
+    return end;
+}
+
+/* Drop the variables marked in drop (by original index) from all the variable indices in one sweep, keeping their order */
+static void fmi2_xml_remove_marked_variables(fmi2_xml_model_description_t* md, const char* drop) {
+    size_t i, k, n;
+
+    n = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+    for(i = k = 0; i < n; i++) {
+        fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesByVR, i);
+        if(!drop[v->originalIndex]) jm_vector_set_item(jm_voidp)(md->variablesByVR, k++, v);
+    }
+    jm_vector_resize(jm_voidp)(md->variablesByVR, k);
+
+    n = jm_vector_get_size(jm_voidp)(md->variablesOrigOrder);
+    for(i = k = 0; i < n; i++) {
+        fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(md->variablesOrigOrder, i);
+        if(!drop[v->originalIndex]) jm_vector_set_item(jm_voidp)(md->variablesOrigOrder, k++, v);
+    }
+    jm_vector_resize(jm_voidp)(md->variablesOrigOrder, k);
+
+    n = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
+    for(i = k = 0; i < n; i++) {
+        jm_named_ptr named = jm_vector_get_item(jm_named_ptr)(&md->variablesByName, i);
+        if(!drop[((fmi2_xml_variable_t*)named.ptr)->originalIndex]) jm_vector_set_item(jm_named_ptr)(&md->variablesByName, k++, named);
+    }
+    jm_vector_resize(jm_named_ptr)(&md->variablesByName, k);
+}
+
+/* Number of digits in the radix sort of variablesByVR */
+#define FMI2_XML_VR_SORT_PASSES 6
+
+/*
+    Digits of the variablesByVR order from the least significant one: causality and variability,
+    the four bytes of the value reference and the base type class.
+*/
+static size_t fmi2_xml_get_vr_sort_digit(fmi2_xml_variable_t* v, int pass) {
+    switch(pass) {
+    case 0:
+        return ((size_t)(unsigned char)v->causality << 3) | (size_t)(unsigned char)v->variability;
+    case FMI2_XML_VR_SORT_PASSES - 1:
+        return fmi2_xml_get_vr_class(v);
+    default:
+        return (size_t)((v->vr >> (8 * (pass - 1))) & 0xFF);
+    }
+}
+
+/* The complete order of variablesByVR: the digits of the radix sort from the most significant one, then the original index */
+static int fmi2_xml_is_vr_sort_less(fmi2_xml_variable_t* a, fmi2_xml_variable_t* b) {
+    int pass;
+    for(pass = FMI2_XML_VR_SORT_PASSES; pass-- > 0;) {
+        size_t da = fmi2_xml_get_vr_sort_digit(a, pass), db = fmi2_xml_get_vr_sort_digit(b, pass);
+        if(da != db) return (da < db);
+    }
+    return (a->originalIndex < b->originalIndex);
+}
+
+#define JM_SORT_TEMPLATE_TYPE jm_voidp
+#define JM_SORT_TEMPLATE_NAME fmi2_xml_vr_sort
+#define JM_SORT_TEMPLATE_LESS(a, b) fmi2_xml_is_vr_sort_less((fmi2_xml_variable_t*)*(a), (fmi2_xml_variable_t*)*(b))
+#include <JM/jm_sort_template.h>
+
+/*
+    Sort the n variables in original order by base type class, value reference, causality and variability.
+    LSD radix sort is stable, so the variables with the same key stay in original order. The buffer has room
+    for n variables. Passes where all the variables have the same digit are skipped.
+*/
+static void fmi2_xml_radix_sort_by_vr(jm_voidp* items, jm_voidp* buf, size_t n) {
+    size_t count[256], i;
+    jm_voidp *src = items, *dst = buf;
+    int pass;
+
+    assert((fmi2_causality_enu_unknown < 32) && (fmi2_variability_enu_unknown < 8));
+    if(n < 2) return;
+    for(pass = 0; pass < FMI2_XML_VR_SORT_PASSES; pass++) {
+        size_t sum = 0;
+        memset(count, 0, sizeof(count));
+        for(i = 0; i < n; i++)
+            count[fmi2_xml_get_vr_sort_digit((fmi2_xml_variable_t*)src[i], pass)]++;
+        if(count[fmi2_xml_get_vr_sort_digit((fmi2_xml_variable_t*)src[0], pass)] == n) continue;
+        for(i = 0; i < 256; i++) {
+            size_t c = count[i];
+            count[i] = sum;
+            sum += c;
+        }
+        for(i = 0; i < n; i++)
+            dst[count[fmi2_xml_get_vr_sort_digit((fmi2_xml_variable_t*)src[i], pass)]++] = src[i];
+        {
+            jm_voidp* tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+    }
+    if(src == buf)
+        memcpy(items, buf, n * sizeof(jm_voidp));
+}
+
+/* jm_sort_chunk_ft sorting a part of variablesByVR, which is in original order */
+static void fmi2_xml_sort_vr_chunk(void* items, void* scratch, size_t n, void* context) {
+    fmi2_xml_radix_sort_by_vr((jm_voidp*)items, (jm_voidp*)scratch, n);
+}
+
+/*
+    Sort variablesByName and variablesByVR, which is a copy of variablesOrigOrder. With several threads the two
+    vectors are sorted at the same time with a parallel merge sort. Both the orders are total, so the result is
+    the same for any number of threads. Returns 0 on success.
+*/
+static int fmi2_xml_sort_variables(fmi2_xml_model_description_t* md) {
+    size_t n = jm_vector_get_size(jm_voidp)(md->variablesByVR);
+    jm_thread_pool_t* pool = 0;
+    jm_voidp* buf;
+
+    if((md->numThreads > 1) && (n >= 2 * JM_PARALLEL_SORT_MIN_CHUNK)) {
+        pool = jm_thread_pool_create(md->callbacks, md->numThreads);
+    }
+    if(pool) {
+        jm_parallel_sort_t sorts[2];
+        jm_status_enu_t status;
+
+        jm_log_verbose(md->callbacks, module, "Sorting %u variables using %u threads", (unsigned)n, md->numThreads);
+        sorts[0].items = jm_vector_get_itemp(jm_named_ptr)(&md->variablesByName, 0);
+        sorts[0].numItems = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
+        sorts[0].itemSize = sizeof(jm_named_ptr);
+        sorts[0].sortChunk = jm_sort_array(fmi2_xml_name);
+        sorts[0].merge = jm_sort_merge(fmi2_xml_name);
+        sorts[0].context = 0;
+        sorts[1].items = jm_vector_get_itemp(jm_voidp)(md->variablesByVR, 0);
+        sorts[1].numItems = n;
+        sorts[1].itemSize = sizeof(jm_voidp);
+        sorts[1].sortChunk = fmi2_xml_sort_vr_chunk;
+        sorts[1].merge = jm_sort_merge(fmi2_xml_vr_sort);
+        sorts[1].context = 0;
+        status = jm_thread_pool_sort(pool, sorts, 2);
+        jm_thread_pool_free(pool);
+        return (status == jm_status_success) ? 0 : -1;
+    }
+
+    jm_vector_sort(fmi2_xml_name)(&md->variablesByName);
+    if(n < 2) return 0;
+    buf = (jm_voidp*)md->callbacks->malloc(n * sizeof(jm_voidp));
+    if(!buf) return -1;
+    fmi2_xml_radix_sort_by_vr(jm_vector_get_itemp(jm_voidp)(md->variablesByVR, 0), buf, n);
+    md->callbacks->free(buf);
+    return 0;
 }
 
 int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const char* data) {
     if(!data) {
 		jm_log_verbose(context->callbacks, module,"Parsing XML element ModelVariables");
+		if(context->modelDescription->variableHandle) {
+			/* the states are counted as the variables are streamed */
+			context->modelDescription->numberOfContinuousStates = 0;
+			context->streamedVariables = 0;
+		}
 		/*  reset handles for the elements that are specific under ModelVariables */
-		fmi2_xml_set_element_handle(context, "Real", FMI2_XML_ELM_ID(RealVariable));
-		fmi2_xml_set_element_handle(context, "Integer", FMI2_XML_ELM_ID(IntegerVariable));
-		fmi2_xml_set_element_handle(context, "Enumeration", FMI2_XML_ELM_ID(EnumerationVariable));
-		fmi2_xml_set_element_handle(context, "String", FMI2_XML_ELM_ID(StringVariable));
-		fmi2_xml_set_element_handle(context, "Boolean", FMI2_XML_ELM_ID(BooleanVariable));
-		fmi2_xml_set_element_handle(context, "Tool", FMI2_XML_ELM_ID(VariableTool));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Real), FMI2_XML_ELM_ID(RealVariable));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Integer), FMI2_XML_ELM_ID(IntegerVariable));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Enumeration), FMI2_XML_ELM_ID(EnumerationVariable));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(String), FMI2_XML_ELM_ID(StringVariable));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Boolean), FMI2_XML_ELM_ID(BooleanVariable));
+		fmi2_xml_set_element_handle(context, FMI2_XML_ELM_ID(Tool), FMI2_XML_ELM_ID(VariableTool));
     }
     else {
          /* postprocess variable list */
@@ -929,74 +1182,56 @@ int fmi2_xml_handle_ModelVariables(fmi2_xml_parser_context_t *context, const cha
             }
         }
 
-        /* sort the variables by names */
-        jm_vector_qsort(jm_named_ptr)(&md->variablesByName,jm_compare_named);
-
-        /* create VR index */
-        md->status = fmi2_xml_model_description_enu_ok;
-		{
-			size_t size = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
-			md->variablesByVR = jm_vector_alloc(jm_voidp)(size,size,md->callbacks);
-			if(md->variablesByVR) {
-				size_t i;
-				for(i= 0; i < size; ++i) {
-					jm_vector_set_item(jm_voidp)(md->variablesByVR, i, jm_vector_get_item(jm_named_ptr)(&md->variablesByName,i).ptr);
-				}
-			}
+        /* create VR index, starting from the original order that the sorting keeps for equal keys,
+           and sort the variables by names and by VR */
+		if(md->variablesOrigOrder) {
+			md->variablesByVR = jm_vector_clone(jm_voidp)(md->variablesOrigOrder);
 		}
 
-        md->status = fmi2_xml_model_description_enu_empty;
-		if(!md->variablesByVR || !md->variablesOrigOrder) {
+		if(!md->variablesByVR || !md->variablesOrigOrder || fmi2_xml_sort_variables(md)) {
             fmi2_xml_parse_fatal(context, "Could not allocate memory");
             return -1;
         }
         varByVR = md->variablesByVR;
-        jm_vector_qsort(jm_voidp)(varByVR, fmi2_xml_compare_vr_and_original_index);
 
         numvar = jm_vector_get_size(jm_voidp)(varByVR);
         
         if(numvar > 1){
-            int foundBadAlias;
+            char* drop = (char*)context->callbacks->calloc(numvar, 1);
+            size_t begin = 0, numDropped = 0;
 
+            if(!drop) {
+                fmi2_xml_parse_fatal(context, "Could not allocate memory");
+                return -1;
+            }
 			jm_log_verbose(context->callbacks, module,"Building alias index");
-            do {
-                fmi2_xml_variable_t* a = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, 0);
-				int startPresent = fmi2_xml_get_variable_has_start(a);
-				a->aliasKind = fmi2_variable_is_not_alias;
-
-                foundBadAlias = 0;
-                
-
-                for(i = 1; i< numvar; i++) {
-                    fmi2_xml_variable_t* b = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, i);
-					int b_startPresent = fmi2_xml_get_variable_has_start(b);
-                    if((fmi2_xml_get_variable_base_type(a) == fmi2_xml_get_variable_base_type(b))
-                            && (a->vr == b->vr)) {							
-	                        /* an alias */
-                            jm_log_verbose(context->callbacks,module,"Variables %s and %s reference the same vr %u. Marking '%s' as alias.",
-											      a->name, b->name, b->vr, b->name);
-                            b->aliasKind = fmi2_variable_is_alias;
-							if(startPresent && b_startPresent) {
-								jm_log_error(context->callbacks,module,
-									"Only one variable among aliases is allowed to have start attribute (variables: %s and %s)",
-										a->name, b->name);
-								fmi2_xml_eliminate_bad_alias(context,i);
-                                numvar = jm_vector_get_size(jm_voidp)(varByVR);
-								foundBadAlias = 1;
-								break;
-							}
-							if(b_startPresent) {
-								startPresent = 1;
-								a = b;
-							}
-					}
-					else {
-						b->aliasKind = fmi2_variable_is_not_alias;
-						startPresent = b_startPresent;
-						a = b;
-					}
+            /* the sorting places the variables with the same vr next to each other */
+            while(begin < numvar) {
+                fmi2_xml_variable_t* first = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, begin);
+                size_t end = begin + 1, bad;
+                while((end < numvar) && fmi2_xml_is_same_vr(first, (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, end)))
+                    end++;
+                /* all the variables with a start value conflict are removed, then the rest is marked again */
+                while((bad = fmi2_xml_mark_aliases(context, varByVR, begin, end, drop)) < end) {
+                    fmi2_xml_variable_t* b = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, bad);
+                    fmi2_base_type_enu_t bt = fmi2_xml_get_variable_base_type(b);
+                    for(i = begin; i < end; i++) {
+                        fmi2_xml_variable_t* v = (fmi2_xml_variable_t*)jm_vector_get_item(jm_voidp)(varByVR, i);
+                        if(drop[v->originalIndex] || (bt != fmi2_xml_get_variable_base_type(v))) continue;
+                        drop[v->originalIndex] = 1;
+                        numDropped++;
+                        jm_log_error(context->callbacks, module,"Removing incorrect alias variable '%s'", v->name);
+                    }
                 }
-            } while(foundBadAlias);
+                begin = end;
+            }
+            if(numDropped) fmi2_xml_remove_marked_variables(md, drop);
+            context->callbacks->free(drop);
+        }
+
+        if(fmi2_xml_build_variable_index(md)) {
+            fmi2_xml_parse_fatal(context, "Could not allocate memory");
+            return -1;
         }
 
         numvar = jm_vector_get_size(jm_named_ptr)(&md->variablesByName);
@@ -51,19 +51,6 @@ struct fmi2_xml_variable_t {
     char name[1];
 };
 
-static int fmi2_xml_compare_vr (const void* first, const void* second) {
-    fmi2_xml_variable_t* a = *(fmi2_xml_variable_t**)first;
-    fmi2_xml_variable_t* b = *(fmi2_xml_variable_t**)second;
-    fmi2_base_type_enu_t at = fmi2_xml_get_variable_base_type(a);
-    fmi2_base_type_enu_t bt = fmi2_xml_get_variable_base_type(b);
-	if(at == fmi2_base_type_enum) at = fmi2_base_type_int;
-	if(bt == fmi2_base_type_enum) bt = fmi2_base_type_int;
-    if(at!=bt) return at - bt;
-    if(a->vr < b->vr) return -1;
-    if(a->vr > b->vr) return 1;
-    return ((int)a->aliasKind - (int)b->aliasKind);
-}
-
 #ifdef __cplusplus
 }
 #endif
@@ -56,7 +56,7 @@ int fmi2_xml_handle_VariableTool(fmi2_xml_parser_context_t *context, const char*
             pvendor = jm_vector_push_back(jm_string)(&md->vendorList, vendor);
 			len = jm_vector_get_size(char)(bufName);
             if(pvendor )
-                *pvendor = vendor = (char*)(context->callbacks->malloc(len + 1));
+                *pvendor = vendor = (char*)jm_arena_alloc(&md->arena, len + 1);
 	        if(!pvendor || !vendor) {
 	            fmi2_xml_parse_fatal(context, "Could not allocate memory");
 		        return -1;
@@ -91,7 +91,7 @@ int fmi2_xml_handle_Tool(fmi2_xml_parser_context_t *context, const char* data) {
             pvendor = jm_vector_push_back(jm_string)(&md->vendorList, vendor);
 			len = jm_vector_get_size(char)(bufName);
             if(pvendor )
-                *pvendor = vendor = (char*)(context->callbacks->malloc(len + 1));
+                *pvendor = vendor = (char*)jm_arena_alloc(&md->arena, len + 1);
 	        if(!pvendor || !vendor) {
 	            fmi2_xml_parse_fatal(context, "Could not allocate memory");
 		        return -1;
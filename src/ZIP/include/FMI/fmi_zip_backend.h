@@ -0,0 +1,107 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+
+#ifndef FMI_ZIP_BACKEND_H_
+#define FMI_ZIP_BACKEND_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <JM/jm_types.h>
+/**
+ \file fmi_zip_backend.h
+ Selection of the checksum and inflate implementations used when unpacking archives.
+
+ \addtogroup fmi_zip
+ @{
+*/
+
+/** \brief Implementations of the CRC-32 checksum used by zip archives */
+typedef enum fmi_zip_crc32_backend_enu_t {
+	fmi_zip_crc32_backend_auto = 0, /**< The fastest implementation supported by the processor */
+	fmi_zip_crc32_backend_zlib,     /**< crc32() of the bundled zlib */
+	fmi_zip_crc32_backend_slice8,   /**< Portable table driven implementation processing 8 bytes per step */
+	fmi_zip_crc32_backend_pclmul    /**< Folding with carry-less multiplication (x86 with PCLMULQDQ and SSE4.1) */
+} fmi_zip_crc32_backend_enu_t;
+
+/** \brief Implementations used to inflate the compressed entries */
+typedef enum fmi_zip_inflate_backend_enu_t {
+	fmi_zip_inflate_backend_minizip = 0, /**< Read the entries through minizip in 64 KB pieces */
+	fmi_zip_inflate_backend_chunked      /**< Inflate directly from the archive file in large chunks (POSIX only) */
+} fmi_zip_inflate_backend_enu_t;
+
+/**
+ * \brief Update a running CRC-32 with the given data using the selected implementation
+ *
+ * The start value is 0 as for the zlib crc32() function. The function can be called from several threads at
+ * once, the tables are built and the implementation is selected once on the first call.
+ */
+unsigned long fmi_zip_crc32(unsigned long crc, const unsigned char* data, size_t len);
+
+/**
+ * \brief Select the CRC-32 implementation
+ *
+ * The setting is global and should be made before any archive is processed.
+ * @return Error status. An error is returned and the setting is unchanged if the processor does not support the implementation.
+ */
+jm_status_enu_t fmi_zip_set_crc32_backend(fmi_zip_crc32_backend_enu_t backend);
+
+/** \brief Get the CRC-32 implementation in use. #fmi_zip_crc32_backend_auto is resolved to the actual implementation. */
+fmi_zip_crc32_backend_enu_t fmi_zip_get_crc32_backend(void);
+
+/** \brief Check if a CRC-32 implementation can be used on this computer */
+int fmi_zip_crc32_backend_is_supported(fmi_zip_crc32_backend_enu_t backend);
+
+/** \brief Get a short name of a CRC-32 implementation for logging */
+const char* fmi_zip_crc32_backend_to_string(fmi_zip_crc32_backend_enu_t backend);
+
+/**
+ * \brief Select the inflate implementation. The default is #fmi_zip_inflate_backend_chunked.
+ *
+ * The chunked inflate loop is used where the archive can be read directly (POSIX systems).
+ * Other systems always use minizip.
+ */
+void fmi_zip_set_inflate_backend(fmi_zip_inflate_backend_enu_t backend);
+
+/** \brief Get the selected inflate implementation */
+fmi_zip_inflate_backend_enu_t fmi_zip_get_inflate_backend(void);
+
+/** \brief Get a short name of an inflate implementation for logging */
+const char* fmi_zip_inflate_backend_to_string(fmi_zip_inflate_backend_enu_t backend);
+
+/**
+ * \brief Enable or disable deferred CRC verification
+ *
+ * When enabled, the files written by the chunked inflate loop and the stored entry copy are not checked while
+ * they are extracted. Instead a background thread reads the files back (normally from the page cache)
+ * and checks them while the extraction goes on. The unzip functions still wait for the checks and report
+ * mismatches before returning. Entries read through minizip are always checked while inflating.
+ * Disabled by default.
+ */
+void fmi_zip_set_deferred_crc_check(int enable);
+
+/** \brief Check if deferred CRC verification is enabled */
+int fmi_zip_get_deferred_crc_check(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* End of header file FMI_ZIP_BACKEND_H_ */
@@ -23,7 +23,7 @@ extern "C" {
 
 #include <stdlib.h>
 #include <JM/jm_types.h>
-#include "miniunz.h"
+#include <JM/jm_callbacks.h>
 /**
  \file fmi_zip_unzip.h
  Declaration of fmi_zip_unzip() function.
@@ -34,6 +34,11 @@ extern "C" {
 
 /**
  * \brief Uncompress a zip file
+ *
+ * The files are written using absolute paths under output_folder and the current working
+ * directory is never changed. It is therefore safe to unpack several archives in parallel
+ * from different threads provided that each thread uses its own callbacks (or a thread safe logger).
+ * Errors for individual files are reported through the callbacks and the remaining files are still extracted.
  * 
  * @param zip_file_path Full file path of the file to uncompress.
  * @param output_folder Full file path of the directory where the uncompressed files are put. The folder must already exist. Files with the same name are overwritten.
@@ -42,6 +47,116 @@ extern "C" {
  */
 jm_status_enu_t fmi_zip_unzip(const char* zip_file_path, const char* output_folder, jm_callbacks* callbacks);
 
+/**
+ * \brief Filter function used to select files for fmi_zip_unzip_selected()
+ *
+ * @param entry_name Name of the file or directory inside the archive. Directory names end with '/'.
+ * @param data The filter_data pointer given to fmi_zip_unzip_selected().
+ * @return Non-zero if the entry should be extracted.
+ */
+typedef int (*fmi_zip_entry_filter_ft)(const char* entry_name, void* data);
+
+/**
+ * \brief Uncompress the files selected by a filter function from a zip file
+ * 
+ * @param zip_file_path Full file path of the file to uncompress.
+ * @param output_folder Full file path of the directory where the uncompressed files are put. The folder must already exist. Files with the same name are overwritten.
+ * @param filter Function that decides which entries are extracted. If NULL all the entries are extracted.
+ * @param filter_data Pointer passed on to the filter function.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_unzip_selected(const char* zip_file_path, const char* output_folder, fmi_zip_entry_filter_ft filter, void* filter_data, jm_callbacks* callbacks);
+
+/**
+ * \brief Uncompress the files selected by a filter function from a zip file using several threads
+ *
+ * The central directory is read once by the calling thread which also creates the directory tree.
+ * The files are then inflated by a pool of workers, each with its own handle to the archive.
+ * The largest files are scheduled first. Errors are reported after all the workers are done,
+ * in the order of the files in the archive, so the log output does not depend on the thread count.
+ * 
+ * @param zip_file_path Full file path of the file to uncompress.
+ * @param output_folder Full file path of the directory where the uncompressed files are put. The folder must already exist. Files with the same name are overwritten.
+ * @param filter Function that decides which entries are extracted. If NULL all the entries are extracted.
+ * @param filter_data Pointer passed on to the filter function.
+ * @param num_threads Number of threads to use including the calling thread. Zero means one thread per processor.
+ * @param callbacks Callback functions. They are only called from the calling thread.
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_unzip_parallel(const char* zip_file_path, const char* output_folder, fmi_zip_entry_filter_ft filter, void* filter_data, unsigned int num_threads, jm_callbacks* callbacks);
+
+/** \brief Size of the buffer needed for the digest computed by fmi_zip_get_archive_digest() */
+#define FMI_ZIP_DIGEST_SIZE 17
+
+/**
+ * \brief Compute a digest identifying the content of a zip archive
+ *
+ * Only the central directory is read: names, CRCs and sizes of all the entries are hashed.
+ * Archives with the same digest can be expected to unpack into identical directory trees.
+ *
+ * @param zip_file_path Full file path of the zip archive.
+ * @param digest Buffer of at least #FMI_ZIP_DIGEST_SIZE characters that receives the digest as a hex string.
+ * @param total_size Receives the total uncompressed size of the entries (may be NULL).
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_get_archive_digest(const char* zip_file_path, char* digest, size_t* total_size, jm_callbacks* callbacks);
+
+/**
+ * \brief Count the entries of a zip archive accepted by a filter
+ *
+ * Only the central directory is read.
+ *
+ * @param zip_file_path Full file path of the zip archive.
+ * @param filter Function deciding which entries are counted. All entries are counted if NULL.
+ * @param filter_data Data passed to the filter.
+ * @param count Receives the number of entries.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_count_entries(const char* zip_file_path, fmi_zip_entry_filter_ft filter, void* filter_data, size_t* count, jm_callbacks* callbacks);
+
+/**
+ * \brief Uncompress a single file from a zip archive into memory
+ *
+ * Nothing is written to disk. The data is checked against the CRC stored in the archive.
+ *
+ * @param zip_file_path Full file path of the zip archive.
+ * @param file_name Name of the file inside the archive, e.g., "modelDescription.xml".
+ * @param buffer Receives a pointer to the uncompressed data allocated with callbacks->malloc.
+ *        The data is zero terminated. The caller is responsible for freeing the memory.
+ * @param size Receives the size of the uncompressed data, not counting the terminating zero (may be NULL).
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_unzip_to_memory(const char* zip_file_path, const char* file_name, char** buffer, size_t* size, jm_callbacks* callbacks);
+
+/**
+ * \brief Get the uncompressed size of a single file in a zip archive
+ *
+ * @param zip_file_path Full file path of the zip archive.
+ * @param file_name Name of the file inside the archive.
+ * @param size Receives the uncompressed size of the file.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_get_file_size(const char* zip_file_path, const char* file_name, size_t* size, jm_callbacks* callbacks);
+
+/**
+ * \brief Uncompress a single file from a zip archive into memory provided by the caller
+ *
+ * Like fmi_zip_unzip_to_memory() but the data is written into the buffer, which is not zero terminated.
+ *
+ * @param zip_file_path Full file path of the zip archive.
+ * @param file_name Name of the file inside the archive.
+ * @param buffer Receives the uncompressed data.
+ * @param size Size of the buffer, which must be the size returned by fmi_zip_get_file_size().
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_unzip_to_buffer(const char* zip_file_path, const char* file_name, char* buffer, size_t size, jm_callbacks* callbacks);
+
 /** @} */
 
 #ifdef __cplusplus 
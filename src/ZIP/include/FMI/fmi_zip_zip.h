@@ -22,8 +22,9 @@ extern "C" {
 #endif
 
 #include <JM/jm_types.h>
+#include <JM/jm_callbacks.h>
 /**
- \file fmi_zip_unzip.h
+ \file fmi_zip_zip.h
  Declaration of fmi_zip_zip() function.
 
  \addtogroup fmi_zip Interface to zlib
@@ -43,6 +44,42 @@ extern "C" {
  */
 jm_status_enu_t fmi_zip_zip(const char* zip_file_path, int n_files_to_zip, const char** files_to_zip, jm_callbacks* callbacks);
 
+/** \brief Compression level that stores the files without compression */
+#define FMI_ZIP_LEVEL_STORE 0
+/** \brief Fastest compression level */
+#define FMI_ZIP_LEVEL_FAST 1
+/** \brief Best compression level */
+#define FMI_ZIP_LEVEL_BEST 9
+
+/** \brief Compression level for the entries matching a pattern */
+typedef struct fmi_zip_level_rule_t {
+	/** Pattern matched against the entry name. '*' matches any sequence of characters (including '/') and '?' a single character. */
+	const char* pattern;
+	/** Compression level from #FMI_ZIP_LEVEL_STORE to #FMI_ZIP_LEVEL_BEST */
+	int level;
+} fmi_zip_level_rule_t;
+
+/**
+ * \brief Compress files to the zip format using several threads
+ *
+ * Files are deflated in parallel, large files in chunks of 1 MB, and the entries are written in the order
+ * given followed by the central directory. The current working directory is not used unless the file names are relative
+ * and base_dir is NULL.
+ * 
+ * @param zip_file_path Full file path to the final compressed file. The folders must exist.
+ * @param base_dir Directory the file names are relative to. The file names are used as entry names. May be NULL.
+ * @param n_files_to_zip Number of files to compress
+ * @param files_to_zip List of the file names to compress
+ * @param rules Compression levels for the entries matching the patterns. The first matching rule is used.
+ * @param n_rules Number of rules
+ * @param default_level Compression level for the entries not matching any rule
+ * @param num_threads Number of threads to use. Zero means one thread per processor.
+ * @param callbacks Callback functions
+ * @return Error status.
+ */
+jm_status_enu_t fmi_zip_zip_parallel(const char* zip_file_path, const char* base_dir, int n_files_to_zip, const char** files_to_zip,
+	const fmi_zip_level_rule_t* rules, size_t n_rules, int default_level, unsigned int num_threads, jm_callbacks* callbacks);
+
 /** @} */
 
 #ifdef __cplusplus 
@@ -0,0 +1,268 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zlib.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <FMI/fmi_zip_backend.h>
+#include "fmi_zip_backend_impl.h"
+
+#ifdef FMI_ZIP_HAVE_PCLMUL
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+typedef unsigned long (*fmi_zip_crc32_ft)(unsigned long crc, const unsigned char* data, size_t len);
+
+/* Reflected CRC-32 polynomial used by zip */
+#define FMI_ZIP_CRC32_POLY 0xEDB88320U
+
+static unsigned int fmi_zip_crc32_table[8][256];
+
+static fmi_zip_crc32_backend_enu_t fmi_zip_crc32_backend = fmi_zip_crc32_backend_auto;
+static fmi_zip_crc32_ft fmi_zip_crc32_impl = 0;
+static fmi_zip_inflate_backend_enu_t fmi_zip_inflate_backend = fmi_zip_inflate_backend_chunked;
+static int fmi_zip_deferred_crc_check = 0;
+
+/* Table k gives the CRC of a byte followed by k zero bytes */
+static void fmi_zip_crc32_make_table(void)
+{
+	unsigned int n, k, c;
+
+	for(n = 0; n < 256; n++) {
+		c = n;
+		for(k = 0; k < 8; k++) {
+			c = (c & 1) ? (FMI_ZIP_CRC32_POLY ^ (c >> 1)) : (c >> 1);
+		}
+		fmi_zip_crc32_table[0][n] = c;
+	}
+	for(n = 0; n < 256; n++) {
+		c = fmi_zip_crc32_table[0][n];
+		for(k = 1; k < 8; k++) {
+			c = fmi_zip_crc32_table[0][c & 0xFF] ^ (c >> 8);
+			fmi_zip_crc32_table[k][n] = c;
+		}
+	}
+}
+
+static unsigned int fmi_zip_crc32_bytes(unsigned int c, const unsigned char* data, size_t len)
+{
+	while(len--) {
+		c = fmi_zip_crc32_table[0][(c ^ *data++) & 0xFF] ^ (c >> 8);
+	}
+	return c;
+}
+
+static unsigned long fmi_zip_crc32_zlib(unsigned long crc, const unsigned char* data, size_t len)
+{
+	/* zlib takes the length as uInt */
+	while(len > 0) {
+		uInt chunk = (len > (1U << 30)) ? (1U << 30) : (uInt)len;
+		crc = crc32(crc, data, chunk);
+		data += chunk;
+		len -= chunk;
+	}
+	return crc;
+}
+
+/* The words are assembled from bytes so that the code does not depend on the byte order.
+   Compilers turn this into plain loads on little endian machines. */
+static unsigned long fmi_zip_crc32_slice8(unsigned long crc, const unsigned char* data, size_t len)
+{
+	unsigned int c = (unsigned int)crc ^ 0xFFFFFFFFU;
+
+	while(len && ((size_t)data & 7)) {
+		c = fmi_zip_crc32_table[0][(c ^ *data++) & 0xFF] ^ (c >> 8);
+		len--;
+	}
+	while(len >= 8) {
+		unsigned int lo = c ^ ((unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24));
+		unsigned int hi = (unsigned int)data[4] | ((unsigned int)data[5] << 8) | ((unsigned int)data[6] << 16) | ((unsigned int)data[7] << 24);
+		c = fmi_zip_crc32_table[7][lo & 0xFF] ^ fmi_zip_crc32_table[6][(lo >> 8) & 0xFF] ^
+			fmi_zip_crc32_table[5][(lo >> 16) & 0xFF] ^ fmi_zip_crc32_table[4][lo >> 24] ^
+			fmi_zip_crc32_table[3][hi & 0xFF] ^ fmi_zip_crc32_table[2][(hi >> 8) & 0xFF] ^
+			fmi_zip_crc32_table[1][(hi >> 16) & 0xFF] ^ fmi_zip_crc32_table[0][hi >> 24];
+		data += 8;
+		len -= 8;
+	}
+	return fmi_zip_crc32_bytes(c, data, len) ^ 0xFFFFFFFFU;
+}
+
+#ifdef FMI_ZIP_HAVE_PCLMUL
+static int fmi_zip_cpu_has_pclmul(void)
+{
+	unsigned int ecx;
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	ecx = (unsigned int)info[2];
+#else
+	unsigned int eax, ebx, edx;
+	if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return 0;
+#endif
+	/* PCLMULQDQ is bit 1 and SSE4.1 bit 19 */
+	return (ecx & (1U << 1)) && (ecx & (1U << 19));
+}
+
+/* The folding kernel handles multiples of 16 bytes, at least 64. The rest goes through the tables. */
+static unsigned long fmi_zip_crc32_pclmul(unsigned long crc, const unsigned char* data, size_t len)
+{
+	unsigned int c = (unsigned int)crc ^ 0xFFFFFFFFU;
+
+	if(len >= FMI_ZIP_PCLMUL_MIN_LENGTH) {
+		size_t n = len & ~(size_t)15;
+		c = fmi_zip_crc32_pclmul_fold(c, data, n);
+		data += n;
+		len -= n;
+	}
+	return fmi_zip_crc32_bytes(c, data, len) ^ 0xFFFFFFFFU;
+}
+#endif
+
+int fmi_zip_crc32_backend_is_supported(fmi_zip_crc32_backend_enu_t backend)
+{
+	switch(backend) {
+	case fmi_zip_crc32_backend_auto:
+	case fmi_zip_crc32_backend_zlib:
+	case fmi_zip_crc32_backend_slice8:
+		return 1;
+	case fmi_zip_crc32_backend_pclmul:
+#ifdef FMI_ZIP_HAVE_PCLMUL
+		return fmi_zip_cpu_has_pclmul();
+#else
+		return 0;
+#endif
+	}
+	return 0;
+}
+
+static fmi_zip_crc32_backend_enu_t fmi_zip_resolve_crc32_backend(fmi_zip_crc32_backend_enu_t backend)
+{
+	if(backend != fmi_zip_crc32_backend_auto) return backend;
+	if(fmi_zip_crc32_backend_is_supported(fmi_zip_crc32_backend_pclmul)) return fmi_zip_crc32_backend_pclmul;
+	return fmi_zip_crc32_backend_slice8;
+}
+
+static fmi_zip_crc32_ft fmi_zip_get_crc32_impl(fmi_zip_crc32_backend_enu_t backend)
+{
+	switch(fmi_zip_resolve_crc32_backend(backend)) {
+#ifdef FMI_ZIP_HAVE_PCLMUL
+	case fmi_zip_crc32_backend_pclmul:
+		return fmi_zip_crc32_pclmul;
+#endif
+	case fmi_zip_crc32_backend_zlib:
+		return fmi_zip_crc32_zlib;
+	default:
+		return fmi_zip_crc32_slice8;
+	}
+}
+
+/* The tables are built and the dispatch is resolved once, on first use from any thread */
+static void fmi_zip_crc32_init(void)
+{
+	fmi_zip_crc32_make_table();
+	fmi_zip_crc32_impl = fmi_zip_get_crc32_impl(fmi_zip_crc32_backend);
+}
+
+#ifdef WIN32
+static INIT_ONCE fmi_zip_crc32_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK fmi_zip_crc32_init_once(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+	fmi_zip_crc32_init();
+	return TRUE;
+}
+#define fmi_zip_crc32_call_once() InitOnceExecuteOnce(&fmi_zip_crc32_once, fmi_zip_crc32_init_once, NULL, NULL)
+#else
+static pthread_once_t fmi_zip_crc32_once = PTHREAD_ONCE_INIT;
+#define fmi_zip_crc32_call_once() pthread_once(&fmi_zip_crc32_once, fmi_zip_crc32_init)
+#endif
+
+unsigned long fmi_zip_crc32(unsigned long crc, const unsigned char* data, size_t len)
+{
+	fmi_zip_crc32_call_once();
+	if(!data) return 0;
+	return fmi_zip_crc32_impl(crc, data, len);
+}
+
+jm_status_enu_t fmi_zip_set_crc32_backend(fmi_zip_crc32_backend_enu_t backend)
+{
+	if(!fmi_zip_crc32_backend_is_supported(backend)) return jm_status_error;
+	fmi_zip_crc32_call_once();
+	fmi_zip_crc32_backend = backend;
+	fmi_zip_crc32_impl = fmi_zip_get_crc32_impl(backend);
+	return jm_status_success;
+}
+
+fmi_zip_crc32_backend_enu_t fmi_zip_get_crc32_backend(void)
+{
+	return fmi_zip_resolve_crc32_backend(fmi_zip_crc32_backend);
+}
+
+const char* fmi_zip_crc32_backend_to_string(fmi_zip_crc32_backend_enu_t backend)
+{
+	switch(backend) {
+	case fmi_zip_crc32_backend_auto: return "auto";
+	case fmi_zip_crc32_backend_zlib: return "zlib";
+	case fmi_zip_crc32_backend_slice8: return "slice-by-8";
+	case fmi_zip_crc32_backend_pclmul: return "pclmul";
+	}
+	return "unknown";
+}
+
+void fmi_zip_set_inflate_backend(fmi_zip_inflate_backend_enu_t backend)
+{
+	fmi_zip_inflate_backend = backend;
+}
+
+fmi_zip_inflate_backend_enu_t fmi_zip_get_inflate_backend(void)
+{
+	return fmi_zip_inflate_backend;
+}
+
+const char* fmi_zip_inflate_backend_to_string(fmi_zip_inflate_backend_enu_t backend)
+{
+	switch(backend) {
+	case fmi_zip_inflate_backend_minizip: return "minizip";
+	case fmi_zip_inflate_backend_chunked: return "chunked";
+	}
+	return "unknown";
+}
+
+void fmi_zip_set_deferred_crc_check(int enable)
+{
+	fmi_zip_deferred_crc_check = enable;
+}
+
+int fmi_zip_get_deferred_crc_check(void)
+{
+	return fmi_zip_deferred_crc_check;
+}
+
+#ifdef __cplusplus
+}
+#endif
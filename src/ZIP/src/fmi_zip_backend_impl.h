@@ -0,0 +1,40 @@
+/*
+    Copyright (C) 2012 Modelon AB
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the BSD style license.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    FMILIB_License.txt file for more details.
+
+    You should have received a copy of the FMILIB_License.txt file
+    along with this program. If not, contact Modelon AB <http://www.modelon.com>.
+*/
+
+/** \file fmi_zip_backend_impl.h
+	Internal interface between the CRC-32 dispatcher and the kernels compiled with special instruction sets.
+*/
+
+#ifndef FMI_ZIP_BACKEND_IMPL_H_
+#define FMI_ZIP_BACKEND_IMPL_H_
+
+#include <stdlib.h>
+
+#ifdef FMI_ZIP_HAVE_PCLMUL
+/** \brief Shortest input passed to fmi_zip_crc32_pclmul_fold() */
+#define FMI_ZIP_PCLMUL_MIN_LENGTH 64
+
+/**
+	\brief CRC-32 folding with PCLMULQDQ. Lives in its own file compiled with -msse4.1 -mpclmul and
+	may only be called after checking the processor.
+	\param crc Running CRC register, i.e., inverted as opposed to the value returned by crc32().
+	\param data Input data.
+	\param len Input length, a multiple of 16 and at least #FMI_ZIP_PCLMUL_MIN_LENGTH.
+	\return Updated CRC register.
+*/
+unsigned int fmi_zip_crc32_pclmul_fold(unsigned int crc, const unsigned char* data, size_t len);
+#endif
+
+#endif /* FMI_ZIP_BACKEND_IMPL_H_ */
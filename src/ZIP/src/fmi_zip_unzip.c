@@ -13,75 +13,885 @@
     along with this program. If not, contact Modelon AB <http://www.modelon.com>.
 */
 
+/* pread, mmap and the Linux copy functions are not visible in strict mode otherwise */
+#if !defined(WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #ifdef __cplusplus 
 extern "C" {
 #endif
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 
-#include <miniunz.h>
+#include <unzip.h>
 
 #include <JM/jm_types.h>
 #include <JM/jm_callbacks.h>
 #include <JM/jm_portability.h>
+#include <JM/jm_vector.h>
+#include <FMI/fmi_zip_unzip.h>
+#include <FMI/fmi_zip_backend.h>
+
+#ifdef WIN32
+#include <direct.h>
+#define FMI_ZIP_MKDIR(dir) _mkdir(dir)
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#define FMI_ZIP_MKDIR(dir) mkdir(dir, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH)
+/* Stored entries are copied by the kernel without passing through the inflate buffers */
+#define FMI_ZIP_COPY_STORED
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#ifdef FMI_ZIP_HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+#endif
+
+#define FMI_ZIP_READ_BUFFER_SIZE 65536
+/* Output chunk of the inflate loop and read size of the deferred CRC checks */
+#define FMI_ZIP_INFLATE_BUFFER_SIZE (1 << 18)
 
 static const char* module = "FMIZIP";
 
 jm_status_enu_t fmi_zip_unzip(const char* zip_file_path, const char* output_folder, jm_callbacks* callbacks)
 {
-	/*
-	Usage : miniunz [-e] [-x] [-v] [-l] [-o] [-p password] file.zip [file_to_extr.] [-d extractdir]
-	  -e  Extract without pathname (junk paths)
-	  -x  Extract with pathname
-	  -v  list files
-	  -l  list files
-	  -d  directory to extract into
-	  -o  overwrite files without prompting
-	  -p  extract crypted file using password
-	*/
+	jm_log_verbose(callbacks, module, "Unpacking FMU into %s", output_folder);
 
-	/* A call to minunz may change the current directory and therefore we must change it back */
-	char cd[FILENAME_MAX];
+	return fmi_zip_unzip_selected(zip_file_path, output_folder, 0, 0, callbacks);
+}
 
-	int argc = 6;
-	const char *argv[6];
-	int status;
+/* Entries must stay inside the output folder: no absolute paths and no ".." components */
+static int fmi_zip_is_safe_entry_name(const char* entry_name)
+{
+	const char* p = entry_name;
 
-	jm_log_verbose(callbacks, module, "Unpacking FMU into %s", output_folder);
+	if((*p == '/') || (*p == '\\') || (*p && (p[1] == ':'))) return 0;
+	while(*p) {
+		if((p[0] == '.') && (p[1] == '.') && ((p[2] == 0) || (p[2] == '/') || (p[2] == '\\'))) return 0;
+		while(*p && (*p != '/') && (*p != '\\')) p++;
+		if(*p) p++;
+	}
+	return 1;
+}
+
+/* Create the directories along the path. The last component is created only if the path ends with a separator.
+   Errors are ignored here since they are detected when the file is opened. */
+static void fmi_zip_create_parent_dirs(char* path)
+{
+	char* p;
+	for(p = path + 1; *p; p++) {
+		if((*p == '/') || (*p == '\\')) {
+			char sep = *p;
+			*p = 0;
+			FMI_ZIP_MKDIR(path);
+			*p = sep;
+		}
+	}
+}
+
+/* Outcome of extracting one entry. Workers only record it and the messages are logged
+   afterwards by the calling thread in archive order. */
+typedef enum fmi_zip_entry_status_enu_t {
+	fmi_zip_entry_pending,
+	fmi_zip_entry_done,
+	fmi_zip_entry_open_failed,
+	fmi_zip_entry_create_failed,
+	fmi_zip_entry_write_failed,
+	fmi_zip_entry_crc_failed
+} fmi_zip_entry_status_enu_t;
+
+typedef struct fmi_zip_entry_t {
+	unz_file_pos pos; /* location of the entry in the central directory */
+	size_t name; /* offset of the entry name in the name buffer */
+	uLong size; /* uncompressed size, used for scheduling */
+	uLong crc;
+	size_t index; /* position in the archive */
+	fmi_zip_entry_status_enu_t status;
+} fmi_zip_entry_t;
+
+jm_vector_declare_template(fmi_zip_entry_t)
+
+/* Work shared by all the workers of one unzip call */
+typedef struct fmi_zip_unzip_job_t {
+	const char* zip_file_path;
+	size_t output_folder_len;
+	jm_vector(fmi_zip_entry_t) entries;
+	jm_vector(char) names;
+	size_t next; /* next entry to be extracted */
+	jm_mutex_t* lock; /* protects next, NULL when there is a single worker */
+
+	/* Files waiting for the deferred CRC check. The check thread is started when needed and
+	   stops when the queue is empty, just like the jm_rmdir_async() thread. */
+	int verify; /* deferred checks enabled */
+	fmi_zip_entry_t** verify_queue;
+	size_t verify_count;
+	size_t verify_next;
+	int verify_running;
+	jm_thread_t* verify_thread;
+	jm_mutex_t* verify_lock;
+	char* verify_path;
+	char* verify_buffer;
+} fmi_zip_unzip_job_t;
+
+/* Each worker has its own archive handle and buffers so that nothing is allocated or logged in the threads */
+typedef struct fmi_zip_unzip_worker_t {
+	fmi_zip_unzip_job_t* job;
+	char* buffer;
+	char* output; /* output of the inflate loop */
+	char* path; /* output folder followed by the entry name */
+	jm_thread_t* thread;
+} fmi_zip_unzip_worker_t;
+
+#ifdef FMI_ZIP_COPY_STORED
+/* A read only mapping of a region of the archive. data is NULL if the region could not be mapped. */
+typedef struct fmi_zip_map_t {
+	char* base;
+	size_t size;
+	const char* data;
+} fmi_zip_map_t;
+
+static void fmi_zip_map_range(int zip_fd, ZPOS64_T offset, ZPOS64_T size, fmi_zip_map_t* map)
+{
+	long page_size = sysconf(_SC_PAGESIZE);
+	off_t map_offset = (off_t)(offset - offset % (ZPOS64_T)page_size);
+
+	map->base = 0;
+	map->data = 0;
+	map->size = (size_t)(size + (offset - map_offset));
+	if((size > 0) && ((ZPOS64_T)map->size == size + (offset - map_offset))) {
+		map->base = (char*)mmap(0, map->size, PROT_READ, MAP_SHARED, zip_fd, map_offset);
+		if(map->base == (char*)MAP_FAILED) map->base = 0;
+		else map->data = map->base + (offset - map_offset);
+	}
+}
+
+static void fmi_zip_unmap_range(fmi_zip_map_t* map)
+{
+	if(map->base) munmap(map->base, map->size);
+}
+
+/* CRC of a region of the archive, computed on a mapping of the file if possible */
+static uLong fmi_zip_crc_of_range(int zip_fd, const char* map, ZPOS64_T offset, ZPOS64_T size, char* buffer)
+{
+	uLong crc = fmi_zip_crc32(0L, 0, 0);
+
+	if(map) return fmi_zip_crc32(crc, (const unsigned char*)map, (size_t)size);
+	while(size > 0) {
+		size_t chunk = (size > FMI_ZIP_READ_BUFFER_SIZE) ? FMI_ZIP_READ_BUFFER_SIZE : (size_t)size;
+		ssize_t n = pread(zip_fd, buffer, chunk, (off_t)offset);
+		if(n <= 0) break;
+		crc = fmi_zip_crc32(crc, (const unsigned char*)buffer, (size_t)n);
+		offset += n;
+		size -= n;
+	}
+	return crc;
+}
+
+static int fmi_zip_create_output_file(const char* path, ZPOS64_T size)
+{
+	int out = open(path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+#ifdef FMI_ZIP_HAVE_POSIX_FALLOCATE
+	/* Reserving the space avoids fragmentation of large files. Errors only mean that it is not supported. */
+	if((out >= 0) && (size > 0)) posix_fallocate(out, 0, (off_t)size);
+#endif
+	return out;
+}
+
+/* Copy the data of a stored entry that starts at offset in the archive into path.
+   copy_file_range lets the file system share or copy the blocks directly, sendfile still avoids the
+   user space copies. Otherwise the data is written from a mapping of the archive or through the buffer. */
+static fmi_zip_entry_status_enu_t fmi_zip_extract_stored_entry(int zip_fd, ZPOS64_T offset, ZPOS64_T size, uLong crc, int check_crc, const char* path, char* buffer)
+{
+	fmi_zip_entry_status_enu_t status = fmi_zip_entry_done;
+	fmi_zip_map_t map;
+	ZPOS64_T done = 0;
+	int out;
 
-	argv[0]="miniunz";
-	argv[1]="-x";
-	argv[2]="-o";
-	argv[3]=zip_file_path;
-	argv[4]="-d";
-	argv[5]=output_folder;
-	
-
-	/* Temporary save the current directory */
-	if (jm_portability_get_current_working_directory(cd, sizeof(cd) / sizeof(char)) == jm_status_error) {
-		jm_log_fatal(callbacks, module, "Could not get Current Directory");
+	fmi_zip_map_range(zip_fd, offset, size, &map);
+	/* The CRC is checked up front as unzCloseCurrentFile does it only for the data read through minizip */
+	if(check_crc && (fmi_zip_crc_of_range(zip_fd, map.data, offset, size, buffer) != crc)) {
+		fmi_zip_unmap_range(&map);
+		return fmi_zip_entry_crc_failed;
+	}
+
+	out = fmi_zip_create_output_file(path, size);
+	if(out < 0) {
+		fmi_zip_unmap_range(&map);
+		return fmi_zip_entry_create_failed;
+	}
+#ifdef FMI_ZIP_HAVE_COPY_FILE_RANGE
+	{
+		loff_t in_offset = (loff_t)offset;
+		ssize_t n;
+		while((done < size) && ((n = copy_file_range(zip_fd, &in_offset, out, 0, (size_t)(size - done), 0)) > 0)) {
+			done += n;
+		}
+	}
+#endif
+#ifdef FMI_ZIP_HAVE_SENDFILE
+	{
+		off_t in_offset = (off_t)(offset + done);
+		ssize_t n;
+		while((done < size) && ((n = sendfile(out, zip_fd, &in_offset, (size_t)(size - done))) > 0)) {
+			done += n;
+		}
+	}
+#endif
+	while(done < size) {
+		size_t chunk = (size - done > FMI_ZIP_READ_BUFFER_SIZE) ? FMI_ZIP_READ_BUFFER_SIZE : (size_t)(size - done);
+		const char* data = map.data ? map.data + done : buffer;
+		if(!map.data && (pread(zip_fd, buffer, chunk, (off_t)(offset + done)) != (ssize_t)chunk)) break;
+		if(write(out, data, chunk) != (ssize_t)chunk) break;
+		done += chunk;
+	}
+	if((close(out) != 0) || (done != size)) {
+		status = fmi_zip_entry_write_failed;
+	}
+	fmi_zip_unmap_range(&map);
+	return status;
+}
+
+/* Inflate a deflated entry that starts at offset in the archive into path.
+   The compressed data is taken from a mapping of the archive when possible and inflated into a large
+   output buffer so that the data is written and checksummed in big pieces. */
+static fmi_zip_entry_status_enu_t fmi_zip_inflate_entry(int zip_fd, ZPOS64_T offset, ZPOS64_T compressed_size, ZPOS64_T size,
+	uLong crc, int check_crc, const char* path, char* buffer, char* output)
+{
+	fmi_zip_entry_status_enu_t status = fmi_zip_entry_done;
+	uLong actual_crc = fmi_zip_crc32(0L, 0, 0);
+	ZPOS64_T in_done = 0, out_done = 0;
+	fmi_zip_map_t map;
+	z_stream strm;
+	int ret = Z_OK;
+	int out;
+
+	memset(&strm, 0, sizeof(strm));
+	if(inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+		return fmi_zip_entry_open_failed;
+	}
+	out = fmi_zip_create_output_file(path, size);
+	if(out < 0) {
+		inflateEnd(&strm);
+		return fmi_zip_entry_create_failed;
+	}
+	fmi_zip_map_range(zip_fd, offset, compressed_size, &map);
+
+	while(ret != Z_STREAM_END) {
+		size_t n;
+		if(strm.avail_in == 0) {
+			ZPOS64_T left = compressed_size - in_done;
+			uInt chunk;
+			if(left == 0) break;
+			if(map.data) {
+				chunk = (left > (1U << 30)) ? (1U << 30) : (uInt)left;
+				strm.next_in = (Bytef*)map.data + in_done;
+			}
+			else {
+				chunk = (left > FMI_ZIP_READ_BUFFER_SIZE) ? FMI_ZIP_READ_BUFFER_SIZE : (uInt)left;
+				if(pread(zip_fd, buffer, chunk, (off_t)(offset + in_done)) != (ssize_t)chunk) break;
+				strm.next_in = (Bytef*)buffer;
+			}
+			strm.avail_in = chunk;
+			in_done += chunk;
+		}
+		strm.next_out = (Bytef*)output;
+		strm.avail_out = FMI_ZIP_INFLATE_BUFFER_SIZE;
+		ret = inflate(&strm, Z_NO_FLUSH);
+		if((ret != Z_OK) && (ret != Z_STREAM_END)) break;
+
+		n = FMI_ZIP_INFLATE_BUFFER_SIZE - strm.avail_out;
+		out_done += n;
+		/* More data than announced in the central directory is an error anyway */
+		if(out_done > size) break;
+		if(check_crc) actual_crc = fmi_zip_crc32(actual_crc, (const unsigned char*)output, n);
+		if(write(out, output, n) != (ssize_t)n) break;
+	}
+	if((ret != Z_STREAM_END) || (out_done != size)) {
+		status = fmi_zip_entry_write_failed;
+	}
+	else if(check_crc && (actual_crc != crc)) {
+		status = fmi_zip_entry_crc_failed;
+	}
+	if(close(out) != 0) {
+		status = fmi_zip_entry_write_failed;
+	}
+	fmi_zip_unmap_range(&map);
+	inflateEnd(&strm);
+	return status;
+}
+
+/* CRC of a file that was extracted earlier */
+static int fmi_zip_crc_of_file(const char* path, char* buffer, uLong* crc)
+{
+	int fd = open(path, O_RDONLY);
+	ssize_t n;
+
+	if(fd < 0) return 0;
+	*crc = fmi_zip_crc32(0L, 0, 0);
+	while((n = read(fd, buffer, FMI_ZIP_INFLATE_BUFFER_SIZE)) > 0) {
+		*crc = fmi_zip_crc32(*crc, (const unsigned char*)buffer, (size_t)n);
+	}
+	close(fd);
+	return (n == 0);
+}
+
+/* Body of the deferred CRC check thread */
+static void fmi_zip_verify_worker(void* data)
+{
+	fmi_zip_unzip_job_t* job = (fmi_zip_unzip_job_t*)data;
+	char* entry_path = job->verify_path + job->output_folder_len + 1;
+
+	while(1) {
+		fmi_zip_entry_t* entry = 0;
+		uLong crc;
+		jm_mutex_lock(job->verify_lock);
+		if(job->verify_next < job->verify_count) {
+			entry = job->verify_queue[job->verify_next++];
+		}
+		else {
+			job->verify_running = 0;
+		}
+		jm_mutex_unlock(job->verify_lock);
+		if(!entry) break;
+
+		strcpy(entry_path, jm_vector_get_itemp(char)(&job->names, entry->name));
+		if(!fmi_zip_crc_of_file(job->verify_path, job->verify_buffer, &crc) || (crc != entry->crc)) {
+			entry->status = fmi_zip_entry_crc_failed;
+		}
+	}
+}
+
+/* Queue an extracted file for the deferred CRC check */
+static void fmi_zip_queue_verify(fmi_zip_unzip_job_t* job, fmi_zip_entry_t* entry)
+{
+	int run_here = 0;
+
+	jm_mutex_lock(job->verify_lock);
+	job->verify_queue[job->verify_count++] = entry;
+	if(!job->verify_running) {
+		/* The previous thread has emptied the queue and is about to exit */
+		if(job->verify_thread) jm_thread_join(job->verify_thread);
+		job->verify_thread = jm_thread_create(0, fmi_zip_verify_worker, job);
+		job->verify_running = 1;
+		run_here = (job->verify_thread == 0);
+	}
+	jm_mutex_unlock(job->verify_lock);
+	if(run_here) {
+		fmi_zip_verify_worker(job);
+	}
+}
+#endif
+
+/* Extract the entry at the given position into path. deferred is set if the CRC is left for the deferred check. */
+static fmi_zip_entry_status_enu_t fmi_zip_extract_entry(unzFile zip, int zip_fd, fmi_zip_entry_t* entry, const char* path,
+	char* buffer, char* output, int verify, int* deferred)
+{
+	FILE* file;
+	int n;
+
+	*deferred = 0;
+	if((unzGoToFilePos(zip, &entry->pos) != UNZ_OK) || (unzOpenCurrentFile(zip) != UNZ_OK)) {
+		return fmi_zip_entry_open_failed;
+	}
+#ifdef FMI_ZIP_COPY_STORED
+	if(zip_fd >= 0) {
+		unz_file_info64 info;
+		fmi_zip_entry_status_enu_t status;
+
+		/* Encrypted entries are left to minizip */
+		if((unzGetCurrentFileInfo64(zip, &info, 0, 0, 0, 0, 0, 0) == UNZ_OK) && !(info.flag & 1)) {
+			if((info.compression_method == 0) && (info.compressed_size == info.uncompressed_size)) {
+				/* Not compressed: the data is a plain copy of the file */
+				status = fmi_zip_extract_stored_entry(zip_fd, unzGetCurrentFileZStreamPos64(zip),
+					info.uncompressed_size, info.crc, !verify, path, buffer);
+				unzCloseCurrentFile(zip);
+				*deferred = verify && (status == fmi_zip_entry_done);
+				return status;
+			}
+			if((info.compression_method == Z_DEFLATED) && output) {
+				status = fmi_zip_inflate_entry(zip_fd, unzGetCurrentFileZStreamPos64(zip),
+					info.compressed_size, info.uncompressed_size, info.crc, !verify, path, buffer, output);
+				unzCloseCurrentFile(zip);
+				*deferred = verify && (status == fmi_zip_entry_done);
+				return status;
+			}
+		}
+	}
+#endif
+	file = fopen(path, "wb");
+	if(!file) {
+		unzCloseCurrentFile(zip);
+		return fmi_zip_entry_create_failed;
+	}
+	while((n = unzReadCurrentFile(zip, buffer, FMI_ZIP_READ_BUFFER_SIZE)) > 0) {
+		if(fwrite(buffer, 1, n, file) != (size_t)n) {
+			n = -1;
+			break;
+		}
+	}
+	/* Closing the entry verifies the CRC */
+	if((fclose(file) != 0) || (n < 0)) {
+		unzCloseCurrentFile(zip);
+		return fmi_zip_entry_write_failed;
+	}
+	if(unzCloseCurrentFile(zip) != UNZ_OK) {
+		return fmi_zip_entry_crc_failed;
+	}
+	return fmi_zip_entry_done;
+}
+
+static void fmi_zip_unzip_worker(void* data)
+{
+	fmi_zip_unzip_worker_t* worker = (fmi_zip_unzip_worker_t*)data;
+	fmi_zip_unzip_job_t* job = worker->job;
+	char* entry_path = worker->path + job->output_folder_len + 1;
+	unzFile zip = unzOpen(job->zip_file_path);
+	int zip_fd = -1;
+
+	/* Entries not taken by a worker stay pending and are reported by the caller */
+	if(!zip) return;
+#ifdef FMI_ZIP_COPY_STORED
+	zip_fd = open(job->zip_file_path, O_RDONLY);
+#endif
+
+	while(1) {
+		fmi_zip_entry_t* entry = 0;
+		int deferred;
+		if(job->lock) jm_mutex_lock(job->lock);
+		if(job->next < jm_vector_get_size(fmi_zip_entry_t)(&job->entries)) {
+			entry = jm_vector_get_itemp(fmi_zip_entry_t)(&job->entries, job->next++);
+		}
+		if(job->lock) jm_mutex_unlock(job->lock);
+		if(!entry) break;
+
+		strcpy(entry_path, jm_vector_get_itemp(char)(&job->names, entry->name));
+		entry->status = fmi_zip_extract_entry(zip, zip_fd, entry, worker->path, worker->buffer, worker->output, job->verify, &deferred);
+#ifdef FMI_ZIP_COPY_STORED
+		if(deferred) fmi_zip_queue_verify(job, entry);
+#endif
+	}
+#ifdef FMI_ZIP_COPY_STORED
+	if(zip_fd >= 0) close(zip_fd);
+#endif
+	unzClose(zip);
+}
+
+/* Larger entries first to balance the load between the workers */
+static int fmi_zip_compare_entry_size(const void* a, const void* b)
+{
+	const fmi_zip_entry_t* e1 = (const fmi_zip_entry_t*)a;
+	const fmi_zip_entry_t* e2 = (const fmi_zip_entry_t*)b;
+	if(e1->size != e2->size) return (e1->size > e2->size) ? -1 : 1;
+	return (e1->index < e2->index) ? -1 : (e1->index > e2->index);
+}
+
+static int fmi_zip_compare_entry_index(const void* a, const void* b)
+{
+	const fmi_zip_entry_t* e1 = (const fmi_zip_entry_t*)a;
+	const fmi_zip_entry_t* e2 = (const fmi_zip_entry_t*)b;
+	return (e1->index < e2->index) ? -1 : (e1->index > e2->index);
+}
+
+/* Read the central directory, create the directory tree and collect the files to be extracted.
+   Errors for individual entries are logged and reported via the return value. */
+static jm_status_enu_t fmi_zip_collect_entries(unzFile zip, fmi_zip_unzip_job_t* job, char* path, fmi_zip_entry_filter_ft filter, void* filter_data, jm_callbacks* callbacks)
+{
+	char* entry_name = path + job->output_folder_len + 1;
+	jm_status_enu_t status = jm_status_success;
+	size_t index = 0;
+	int ret;
+
+	for(ret = unzGoToFirstFile(zip); ret == UNZ_OK; ret = unzGoToNextFile(zip), index++) {
+		unz_file_info file_info;
+		fmi_zip_entry_t entry;
+		size_t len;
+
+		if(unzGetCurrentFileInfo(zip, &file_info, entry_name, FILENAME_MAX, 0, 0, 0, 0) != UNZ_OK) {
+			ret = UNZ_ERRNO;
+			break;
+		}
+		if(filter && !filter(entry_name, filter_data)) continue;
+
+		if(!fmi_zip_is_safe_entry_name(entry_name)) {
+			jm_log_error(callbacks, module, "Skipping %s since it points outside the output directory", entry_name);
+			status = jm_status_error;
+			continue;
+		}
+		fmi_zip_create_parent_dirs(path);
+
+		/* Directory entries end with a separator and are fully handled above */
+		len = strlen(entry_name);
+		if((len == 0) || (entry_name[len - 1] == '/')) continue;
+
+		unzGetFilePos(zip, &entry.pos);
+		entry.name = jm_vector_get_size(char)(&job->names);
+		entry.size = file_info.uncompressed_size;
+		entry.crc = file_info.crc;
+		entry.index = index;
+		entry.status = fmi_zip_entry_pending;
+		if((jm_vector_resize(char)(&job->names, entry.name + len + 1) != entry.name + len + 1) ||
+		   !jm_vector_push_back(fmi_zip_entry_t)(&job->entries, entry)) {
+			jm_log_fatal(callbacks, module, "Could not allocate memory");
+			return jm_status_error;
+		}
+		memcpy(jm_vector_get_itemp(char)(&job->names, entry.name), entry_name, len + 1);
+	}
+	if(ret != UNZ_END_OF_LIST_OF_FILE) {
+		jm_log_error(callbacks, module, "Error while reading the list of files in %s", job->zip_file_path);
+		status = jm_status_error;
+	}
+	return status;
+}
+
+jm_status_enu_t fmi_zip_unzip_selected(const char* zip_file_path, const char* output_folder, fmi_zip_entry_filter_ft filter, void* filter_data, jm_callbacks* callbacks)
+{
+	return fmi_zip_unzip_parallel(zip_file_path, output_folder, filter, filter_data, 1, callbacks);
+}
+
+jm_status_enu_t fmi_zip_unzip_parallel(const char* zip_file_path, const char* output_folder, fmi_zip_entry_filter_ft filter, void* filter_data, unsigned int num_threads, jm_callbacks* callbacks)
+{
+	unzFile zip;
+	fmi_zip_unzip_job_t job;
+	fmi_zip_unzip_worker_t* workers;
+	size_t path_size, num_entries, i;
+	jm_status_enu_t status;
+
+	jm_log_verbose(callbacks, module, "Unpacking files from %s into %s", zip_file_path, output_folder);
+
+	zip = unzOpen(zip_file_path);
+	if(!zip) {
+		jm_log_fatal(callbacks, module, "Could not open %s as a zip archive", zip_file_path);
+		return jm_status_error;
+	}
+
+	job.zip_file_path = zip_file_path;
+	job.output_folder_len = strlen(output_folder);
+	job.next = 0;
+	job.lock = 0;
+	job.verify = 0;
+	job.verify_queue = 0;
+	job.verify_count = job.verify_next = 0;
+	job.verify_running = 0;
+	job.verify_thread = 0;
+	job.verify_lock = 0;
+	job.verify_path = job.verify_buffer = 0;
+	jm_vector_init(fmi_zip_entry_t)(&job.entries, 0, callbacks);
+	jm_vector_init(char)(&job.names, 0, callbacks);
+
+	if(num_threads == 0) num_threads = jm_get_number_of_processors();
+	path_size = job.output_folder_len + FILENAME_MAX + 2;
+	workers = (fmi_zip_unzip_worker_t*)callbacks->calloc(num_threads, sizeof(fmi_zip_unzip_worker_t));
+	if(!workers || !(workers[0].path = (char*)callbacks->malloc(path_size))) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		callbacks->free(workers);
+		unzClose(zip);
+		return jm_status_error;
+	}
+	strcpy(workers[0].path, output_folder);
+	strcat(workers[0].path, "/");
+
+	status = fmi_zip_collect_entries(zip, &job, workers[0].path, filter, filter_data, callbacks);
+	unzClose(zip);
+
+	num_entries = jm_vector_get_size(fmi_zip_entry_t)(&job.entries);
+	if(num_threads > num_entries) num_threads = num_entries ? (unsigned int)num_entries : 1;
+	if(num_threads > 1) {
+		job.lock = jm_mutex_create(callbacks);
+		if(!job.lock) num_threads = 1;
+	}
+	if(num_threads > 1) {
+		jm_log_verbose(callbacks, module, "Extracting %u files using %u threads", (unsigned int)num_entries, num_threads);
+		jm_vector_qsort(fmi_zip_entry_t)(&job.entries, fmi_zip_compare_entry_size);
+	}
+	/* Resolve the CRC-32 dispatch so that the implementation in use is logged */
+	fmi_zip_crc32(0L, 0, 0);
+	jm_log_debug(callbacks, module, "Using %s inflate and %s CRC-32%s", fmi_zip_inflate_backend_to_string(fmi_zip_get_inflate_backend()),
+		fmi_zip_crc32_backend_to_string(fmi_zip_get_crc32_backend()), fmi_zip_get_deferred_crc_check() ? " (deferred)" : "");
+#ifdef FMI_ZIP_COPY_STORED
+	if(fmi_zip_get_deferred_crc_check() && (num_entries > 0)) {
+		job.verify_queue = (fmi_zip_entry_t**)callbacks->malloc(num_entries * sizeof(fmi_zip_entry_t*));
+		job.verify_path = (char*)callbacks->malloc(path_size);
+		job.verify_buffer = (char*)callbacks->malloc(FMI_ZIP_INFLATE_BUFFER_SIZE);
+		job.verify_lock = jm_mutex_create(callbacks);
+		job.verify = job.verify_queue && job.verify_path && job.verify_buffer && job.verify_lock;
+		if(job.verify) memcpy(job.verify_path, workers[0].path, job.output_folder_len + 2);
+	}
+#endif
+
+	/* The calling thread acts as the first worker */
+	for(i = 0; i < num_threads; i++) {
+		fmi_zip_unzip_worker_t* worker = &workers[i];
+		worker->job = &job;
+		if(!worker->path) {
+			worker->path = (char*)callbacks->malloc(path_size);
+			if(!worker->path) break;
+			memcpy(worker->path, workers[0].path, job.output_folder_len + 2);
+		}
+		worker->buffer = (char*)callbacks->malloc(FMI_ZIP_READ_BUFFER_SIZE);
+		if(!worker->buffer) break;
+#ifdef FMI_ZIP_COPY_STORED
+		/* Without the output buffer the worker falls back to minizip */
+		if(fmi_zip_get_inflate_backend() == fmi_zip_inflate_backend_chunked) {
+			worker->output = (char*)callbacks->malloc(FMI_ZIP_INFLATE_BUFFER_SIZE);
+		}
+#endif
+		if(i > 0) {
+			worker->thread = jm_thread_create(callbacks, fmi_zip_unzip_worker, worker);
+			if(!worker->thread) break;
+		}
+	}
+	if(workers[0].buffer) {
+		fmi_zip_unzip_worker(&workers[0]);
+	}
+	for(i = 0; i < num_threads; i++) {
+		if(workers[i].thread) jm_thread_join(workers[i].thread);
+		callbacks->free(workers[i].buffer);
+		callbacks->free(workers[i].output);
+		callbacks->free(workers[i].path);
+	}
+	callbacks->free(workers);
+	jm_mutex_free(job.lock);
+	/* The last check thread finishes the queue */
+	if(job.verify_thread) jm_thread_join(job.verify_thread);
+	jm_mutex_free(job.verify_lock);
+	callbacks->free(job.verify_queue);
+	callbacks->free(job.verify_path);
+	callbacks->free(job.verify_buffer);
+
+	/* Report the problems in the order of the entries in the archive */
+	if(num_threads > 1) {
+		jm_vector_qsort(fmi_zip_entry_t)(&job.entries, fmi_zip_compare_entry_index);
+	}
+	for(i = 0; i < num_entries; i++) {
+		fmi_zip_entry_t* entry = jm_vector_get_itemp(fmi_zip_entry_t)(&job.entries, i);
+		const char* name = jm_vector_get_itemp(char)(&job.names, entry->name);
+		switch(entry->status) {
+		case fmi_zip_entry_done:
+			jm_log_debug(callbacks, module, "Extracted %s", name);
+			continue;
+		case fmi_zip_entry_pending:
+			jm_log_error(callbacks, module, "Could not extract %s", name);
+			break;
+		case fmi_zip_entry_open_failed:
+			jm_log_error(callbacks, module, "Could not open %s in the archive", name);
+			break;
+		case fmi_zip_entry_create_failed:
+			jm_log_error(callbacks, module, "Could not create file %s/%s", output_folder, name);
+			break;
+		case fmi_zip_entry_write_failed:
+			jm_log_error(callbacks, module, "Error while extracting %s", name);
+			break;
+		case fmi_zip_entry_crc_failed:
+			jm_log_error(callbacks, module, "CRC error in %s", name);
+			break;
+		}
+		status = jm_status_error;
+	}
+
+	jm_vector_free_data(fmi_zip_entry_t)(&job.entries);
+	jm_vector_free_data(char)(&job.names);
+	if(status != jm_status_success) {
+		jm_log_fatal(callbacks, module, "Unpacking of FMU %s into %s failed", zip_file_path, output_folder);
+	}
+	return status;
+}
+
+jm_status_enu_t fmi_zip_get_archive_digest(const char* zip_file_path, char* digest, size_t* total_size, jm_callbacks* callbacks)
+{
+	unzFile zip;
+	char entry_name[FILENAME_MAX];
+	uLong crc = crc32(0L, Z_NULL, 0);
+	uLong adler = adler32(0L, Z_NULL, 0);
+	size_t size = 0;
+	int ret;
+
+	zip = unzOpen(zip_file_path);
+	if(!zip) {
+		jm_log_fatal(callbacks, module, "Could not open %s as a zip archive", zip_file_path);
+		return jm_status_error;
+	}
+	/* The central directory holds name, CRC and sizes of every entry which identifies the content
+	   without inflating anything */
+	for(ret = unzGoToFirstFile(zip); ret == UNZ_OK; ret = unzGoToNextFile(zip)) {
+		unz_file_info file_info;
+		unsigned char record[12];
+		int i;
+
+		if(unzGetCurrentFileInfo(zip, &file_info, entry_name, sizeof(entry_name), 0, 0, 0, 0) != UNZ_OK) {
+			ret = UNZ_ERRNO;
+			break;
+		}
+		for(i = 0; i < 4; i++) {
+			record[i] = (unsigned char)(file_info.crc >> (8 * i));
+			record[4 + i] = (unsigned char)(file_info.compressed_size >> (8 * i));
+			record[8 + i] = (unsigned char)(file_info.uncompressed_size >> (8 * i));
+		}
+		crc = crc32(crc, (const Bytef*)entry_name, (uInt)strlen(entry_name) + 1);
+		crc = crc32(crc, record, sizeof(record));
+		adler = adler32(adler, (const Bytef*)entry_name, (uInt)strlen(entry_name) + 1);
+		adler = adler32(adler, record, sizeof(record));
+		size += file_info.uncompressed_size;
+	}
+	unzClose(zip);
+	if(ret != UNZ_END_OF_LIST_OF_FILE) {
+		jm_log_fatal(callbacks, module, "Error while reading the list of files in %s", zip_file_path);
+		return jm_status_error;
+	}
+
+	sprintf(digest, "%08lx%08lx", crc & 0xFFFFFFFFUL, adler & 0xFFFFFFFFUL);
+	if(total_size) *total_size = size;
+	return jm_status_success;
+}
+
+jm_status_enu_t fmi_zip_count_entries(const char* zip_file_path, fmi_zip_entry_filter_ft filter, void* filter_data, size_t* count, jm_callbacks* callbacks)
+{
+	unzFile zip;
+	char entry_name[FILENAME_MAX];
+	int ret;
+
+	*count = 0;
+	zip = unzOpen(zip_file_path);
+	if(!zip) {
+		jm_log_fatal(callbacks, module, "Could not open %s as a zip archive", zip_file_path);
+		return jm_status_error;
+	}
+	for(ret = unzGoToFirstFile(zip); ret == UNZ_OK; ret = unzGoToNextFile(zip)) {
+		if(unzGetCurrentFileInfo(zip, 0, entry_name, sizeof(entry_name), 0, 0, 0, 0) != UNZ_OK) {
+			ret = UNZ_ERRNO;
+			break;
+		}
+		if(!filter || filter(entry_name, filter_data)) (*count)++;
+	}
+	unzClose(zip);
+	if(ret != UNZ_END_OF_LIST_OF_FILE) {
+		jm_log_fatal(callbacks, module, "Error while reading the list of files in %s", zip_file_path);
 		return jm_status_error;
 	}
+	return jm_status_success;
+}
 
-	/* Unzip */
-	status = miniunz(argc, (char**)argv);
+/* Open the archive and locate a file in it. Returns NULL on failure. */
+static unzFile fmi_zip_locate_file(const char* zip_file_path, const char* file_name, unz_file_info* file_info, jm_callbacks* callbacks)
+{
+	unzFile zip = unzOpen(zip_file_path);
+	if(!zip) {
+		jm_log_fatal(callbacks, module, "Could not open %s as a zip archive", zip_file_path);
+		return 0;
+	}
 
-	/* Reset the current directory */
-	if (jm_portability_set_current_working_directory(cd) == jm_status_error) {
-		jm_log_warning(callbacks, module, "Could not restore Current Directory after unpacking");
-		return jm_status_warning;
+	if((unzLocateFile(zip, file_name, 1) != UNZ_OK) ||
+	   (unzGetCurrentFileInfo(zip, file_info, 0, 0, 0, 0, 0, 0) != UNZ_OK)) {
+		jm_log_fatal(callbacks, module, "Could not find %s in %s", file_name, zip_file_path);
+		unzClose(zip);
+		return 0;
 	}
+	return zip;
+}
 
-	/* Return error status */
-	if (status == 0) {
-		return jm_status_success;
-	} else {
-		jm_log_fatal(callbacks, "FMIZIP", "Unpacking of FMU %s into %s failed", zip_file_path, output_folder);
-		return jm_status_error;	
+/* Uncompress the located file into data_size bytes at data and close the archive */
+static jm_status_enu_t fmi_zip_read_located_file(unzFile zip, const char* zip_file_path, const char* file_name, char* data, size_t data_size, jm_callbacks* callbacks)
+{
+	size_t offset;
+	int status = UNZ_OK;
+
+	if(unzOpenCurrentFile(zip) != UNZ_OK) {
+		jm_log_fatal(callbacks, module, "Could not open %s in %s", file_name, zip_file_path);
+		unzClose(zip);
+		return jm_status_error;
 	}
+
+	offset = 0;
+	do {
+		unsigned chunk = (data_size - offset > UINT_MAX) ? UINT_MAX : (unsigned)(data_size - offset);
+		if(chunk == 0) break;
+		status = unzReadCurrentFile(zip, data + offset, chunk);
+		if(status > 0) offset += status;
+	} while(status > 0);
+
+	/* Closing the entry verifies the CRC when all the data was read */
+	if((status < 0) || (offset != data_size) || (unzCloseCurrentFile(zip) != UNZ_OK)) {
+		jm_log_fatal(callbacks, module, "Error while reading %s from %s", file_name, zip_file_path);
+		unzClose(zip);
+		return jm_status_error;
+	}
+	unzClose(zip);
+	return jm_status_success;
 }
 
+jm_status_enu_t fmi_zip_unzip_to_memory(const char* zip_file_path, const char* file_name, char** buffer, size_t* size, jm_callbacks* callbacks)
+{
+	unzFile zip;
+	unz_file_info file_info;
+	char* data;
+	size_t data_size;
+
+	*buffer = 0;
+	if(size) *size = 0;
+
+	jm_log_verbose(callbacks, module, "Reading %s from %s", file_name, zip_file_path);
+
+	zip = fmi_zip_locate_file(zip_file_path, file_name, &file_info, callbacks);
+	if(!zip) return jm_status_error;
+
+	/* The buffer is zero terminated so that text files can be used directly */
+	data_size = (size_t)file_info.uncompressed_size;
+	data = (char*)callbacks->malloc(data_size + 1);
+	if(!data) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		unzClose(zip);
+		return jm_status_error;
+	}
+
+	if(fmi_zip_read_located_file(zip, zip_file_path, file_name, data, data_size, callbacks) != jm_status_success) {
+		callbacks->free(data);
+		return jm_status_error;
+	}
+
+	data[data_size] = 0;
+	*buffer = data;
+	if(size) *size = data_size;
+	return jm_status_success;
+}
+
+jm_status_enu_t fmi_zip_get_file_size(const char* zip_file_path, const char* file_name, size_t* size, jm_callbacks* callbacks)
+{
+	unz_file_info file_info;
+	unzFile zip = fmi_zip_locate_file(zip_file_path, file_name, &file_info, callbacks);
+
+	*size = 0;
+	if(!zip) return jm_status_error;
+	unzClose(zip);
+	*size = (size_t)file_info.uncompressed_size;
+	return jm_status_success;
+}
+
+jm_status_enu_t fmi_zip_unzip_to_buffer(const char* zip_file_path, const char* file_name, char* buffer, size_t size, jm_callbacks* callbacks)
+{
+	unz_file_info file_info;
+	unzFile zip;
+
+	jm_log_verbose(callbacks, module, "Reading %s from %s", file_name, zip_file_path);
+
+	zip = fmi_zip_locate_file(zip_file_path, file_name, &file_info, callbacks);
+	if(!zip) return jm_status_error;
+
+	if((size_t)file_info.uncompressed_size != size) {
+		jm_log_fatal(callbacks, module, "Size of %s in %s has changed", file_name, zip_file_path);
+		unzClose(zip);
+		return jm_status_error;
+	}
+	return fmi_zip_read_located_file(zip, zip_file_path, file_name, buffer, size, callbacks);
+}
+
+#define JM_TEMPLATE_INSTANCE_TYPE fmi_zip_entry_t
+#include <JM/jm_vector_template.h>
+
 #ifdef __cplusplus 
 }
-#endif
\ No newline at end of file
+#endif
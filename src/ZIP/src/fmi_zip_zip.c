@@ -15,77 +15,366 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <minizip.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <zip.h>
+
+#include <fmilib_config.h>
 
 #include <JM/jm_types.h>
 #include <JM/jm_callbacks.h>
 #include <JM/jm_portability.h>
+#include <FMI/fmi_zip_zip.h>
+#include <FMI/fmi_zip_backend.h>
+
+/* Files larger than this are split into chunks that are deflated in parallel */
+#define FMI_ZIP_CHUNK_SIZE (1 << 20)
+
+/* Deflate window, the tail of the previous chunk is used as dictionary for the next one */
+#define FMI_ZIP_DICTIONARY_SIZE 32768
+
+/* Number of chunks per worker kept in memory before they are written to the archive */
+#define FMI_ZIP_CHUNKS_PER_WORKER 4
+
+static const char* module = "FMIZIP";
+
+/* A file to be added to the archive */
+typedef struct fmi_zip_file_t {
+	char* path; /* path used to read the file */
+	const char* name; /* entry name inside path */
+	long size;
+	int level;
+	zip_fileinfo info;
+} fmi_zip_file_t;
+
+/* A piece of a file compressed by one worker. Buffers are allocated by the calling thread. */
+typedef struct fmi_zip_chunk_t {
+	fmi_zip_file_t* file;
+	long offset;
+	long size;
+	long dictionary; /* bytes preceding the chunk read as deflate dictionary */
+	char* input;
+	char* data; /* compressed data */
+	size_t data_size;
+	uLong crc;
+	int failed;
+} fmi_zip_chunk_t;
+
+/* Chunks of one batch shared by the workers */
+typedef struct fmi_zip_zip_job_t {
+	fmi_zip_chunk_t* chunks;
+	size_t n_chunks;
+	size_t next;
+	jm_mutex_t* lock;
+} fmi_zip_zip_job_t;
+
+/* Match an entry name against a pattern where '*' matches any sequence of characters and '?' a single one */
+static int fmi_zip_match_pattern(const char* pattern, const char* name)
+{
+	const char* star = 0;
+	const char* star_name = 0;
+
+	while(*name) {
+		if((*pattern == '?') || (*pattern == *name)) {
+			pattern++;
+			name++;
+		}
+		else if(*pattern == '*') {
+			star = pattern++;
+			star_name = name;
+		}
+		else if(star) {
+			pattern = star + 1;
+			name = ++star_name;
+		}
+		else {
+			return 0;
+		}
+	}
+	while(*pattern == '*') pattern++;
+	return *pattern == 0;
+}
+
+static void fmi_zip_set_file_time(const char* path, zip_fileinfo* info)
+{
+	struct stat st;
+	struct tm* t;
+
+	memset(info, 0, sizeof(zip_fileinfo));
+	if(stat(path, &st) || !(t = localtime(&st.st_mtime))) return;
+	info->tmz_date.tm_sec = t->tm_sec;
+	info->tmz_date.tm_min = t->tm_min;
+	info->tmz_date.tm_hour = t->tm_hour;
+	info->tmz_date.tm_mday = t->tm_mday;
+	info->tmz_date.tm_mon = t->tm_mon;
+	info->tmz_date.tm_year = t->tm_year + 1900;
+}
+
+/* Read the chunk and compress it into chunk->data. Chunks after the first one of a file are primed with
+   the end of the previous chunk and all but the last one end with a sync flush so that the compressed
+   chunks can simply be concatenated. */
+static void fmi_zip_compress_chunk(fmi_zip_chunk_t* chunk)
+{
+	int last = (chunk->offset + chunk->size == chunk->file->size);
+	size_t length = (size_t)(chunk->dictionary + chunk->size);
+	FILE* file;
+
+	chunk->failed = 1;
+	file = fopen(chunk->file->path, "rb");
+	if(!file) return;
+	if(fseek(file, chunk->offset - chunk->dictionary, SEEK_SET) || (fread(chunk->input, 1, length, file) != length)) {
+		fclose(file);
+		return;
+	}
+	fclose(file);
+	chunk->crc = fmi_zip_crc32(0L, (const unsigned char*)chunk->input + chunk->dictionary, chunk->size);
+
+	if(chunk->file->level == 0) {
+		memcpy(chunk->data, chunk->input, chunk->size);
+		chunk->data_size = chunk->size;
+		chunk->failed = 0;
+	}
+	else {
+		z_stream strm;
+		int ret;
+
+		memset(&strm, 0, sizeof(strm));
+		if(deflateInit2(&strm, chunk->file->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) return;
+		if((chunk->dictionary == 0) || (deflateSetDictionary(&strm, (const Bytef*)chunk->input, (uInt)chunk->dictionary) == Z_OK)) {
+			strm.next_in = (Bytef*)chunk->input + chunk->dictionary;
+			strm.avail_in = (uInt)chunk->size;
+			strm.next_out = (Bytef*)chunk->data;
+			strm.avail_out = (uInt)chunk->data_size;
+			ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+			if(((ret == Z_STREAM_END) || (!last && (ret == Z_OK))) && (strm.avail_in == 0) && (strm.avail_out > 0)) {
+				chunk->data_size = strm.total_out;
+				chunk->failed = 0;
+			}
+		}
+		deflateEnd(&strm);
+	}
+}
+
+static void fmi_zip_zip_worker(void* data)
+{
+	fmi_zip_zip_job_t* job = (fmi_zip_zip_job_t*)data;
+	while(1) {
+		fmi_zip_chunk_t* chunk = 0;
+		if(job->lock) jm_mutex_lock(job->lock);
+		if(job->next < job->n_chunks) {
+			chunk = &job->chunks[job->next++];
+		}
+		if(job->lock) jm_mutex_unlock(job->lock);
+		if(!chunk) break;
+		fmi_zip_compress_chunk(chunk);
+	}
+}
+
+/* Compress the chunks of a batch using the calling thread and num_threads - 1 additional threads */
+static void fmi_zip_compress_batch(fmi_zip_zip_job_t* job, unsigned int num_threads, jm_thread_t** threads, jm_callbacks* callbacks)
+{
+	unsigned int i;
+
+	job->next = 0;
+	for(i = 1; i < num_threads; i++) {
+		threads[i] = jm_thread_create(callbacks, fmi_zip_zip_worker, job);
+	}
+	fmi_zip_zip_worker(job);
+	for(i = 1; i < num_threads; i++) {
+		if(threads[i]) jm_thread_join(threads[i]);
+	}
+}
+
+/* Write a compressed chunk into the archive opening and closing the entry as needed */
+static int fmi_zip_write_chunk(zipFile zf, fmi_zip_chunk_t* chunk, uLong* crc)
+{
+	fmi_zip_file_t* file = chunk->file;
+	int err = ZIP_OK;
+
+	if(chunk->offset == 0) {
+		err = zipOpenNewFileInZip3_64(zf, file->name, &file->info, NULL, 0, NULL, 0, NULL,
+			(file->level != 0) ? Z_DEFLATED : 0, file->level, 1,
+			-MAX_WBITS, 8, Z_DEFAULT_STRATEGY, NULL, 0, (ZPOS64_T)file->size >= 0xffffffffUL);
+		*crc = chunk->crc;
+	}
+	else {
+		*crc = crc32_combine(*crc, chunk->crc, chunk->size);
+	}
+	if((err == ZIP_OK) && (chunk->data_size > 0)) {
+		err = zipWriteInFileInZip(zf, chunk->data, (unsigned)chunk->data_size);
+	}
+	if((err == ZIP_OK) && (chunk->offset + chunk->size == file->size)) {
+		err = zipCloseFileInZipRaw64(zf, (ZPOS64_T)file->size, *crc);
+	}
+	return err;
+}
 
 jm_status_enu_t fmi_zip_zip(const char* zip_file_path, int n_files_to_zip, const char** files_to_zip, jm_callbacks* callbacks)
 {
-	/* A call to minizip may change the current directory and therefore we must change it back */
-	char cd[FILENAME_MAX];
+	return fmi_zip_zip_parallel(zip_file_path, 0, n_files_to_zip, files_to_zip, 0, 0, FMI_ZIP_LEVEL_FAST, 1, callbacks);
+}
 
-#define N_BASIC_ARGS 4
-	int argc;
-	char** argv;
+jm_status_enu_t fmi_zip_zip_parallel(const char* zip_file_path, const char* base_dir, int n_files_to_zip, const char** files_to_zip,
+	const fmi_zip_level_rule_t* rules, size_t n_rules, int default_level, unsigned int num_threads, jm_callbacks* callbacks)
+{
+	jm_status_enu_t status = jm_status_success;
+	fmi_zip_file_t* files;
+	fmi_zip_zip_job_t job;
+	jm_thread_t** threads = 0;
+	size_t batch_size, n_chunks = 0, done = 0;
+	uLong crc = 0;
+	long offset;
+	zipFile zf;
 	int k;
-	int status;
 
-	/* Temporary save the current directory */
-	if (jm_portability_get_current_working_directory(cd, sizeof(cd) / sizeof(char)) == jm_status_error) {
-		jm_log(callbacks, "UNZIP", jm_log_level_error, "Could not get Current Directory");
+	if(num_threads == 0) {
+		num_threads = jm_get_number_of_processors();
+	}
+	files = (fmi_zip_file_t*)callbacks->calloc(n_files_to_zip + 1, sizeof(fmi_zip_file_t));
+	if(!files) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
 		return jm_status_error;
 	}
 
-	argc = N_BASIC_ARGS + n_files_to_zip;
-	argv = callbacks->calloc(sizeof(char*), argc);	
-	/* Failed to allocate memory, return error */
-	if (argv == NULL) {
-		callbacks->logger(NULL, "FMIZIP", jm_log_level_error, "Failed to allocate memory.");
-		return jm_status_error;	
+	jm_log_info(callbacks, module, "Will compress following files:");
+	for(k = 0; k < n_files_to_zip; k++) {
+		fmi_zip_file_t* file = &files[k];
+		const char* name = files_to_zip[k];
+		size_t i, len = (base_dir ? strlen(base_dir) + 1 : 0) + strlen(name) + 1;
+		char* entry;
+		FILE* f;
+
+		jm_log_info(callbacks, module, "\t%s", name);
+		/* The path is followed by the entry name in the same buffer */
+		file->path = (char*)callbacks->malloc(len + strlen(name) + 1);
+		if(!file->path) {
+			jm_log_fatal(callbacks, module, "Could not allocate memory");
+			status = jm_status_error;
+			break;
+		}
+		if(base_dir) {
+			sprintf(file->path, "%s%s%s", base_dir, FMI_FILE_SEP, name);
+		}
+		else {
+			strcpy(file->path, name);
+		}
+
+		/* Entry names use '/' as separator and must not start with one */
+		entry = file->path + len;
+		strcpy(entry, name);
+		for(i = 0; entry[i]; i++) {
+			if(entry[i] == '\\') entry[i] = '/';
+		}
+		while(*entry == '/') entry++;
+		file->name = entry;
+
+		file->level = default_level;
+		for(i = 0; i < n_rules; i++) {
+			if(fmi_zip_match_pattern(rules[i].pattern, file->name)) {
+				file->level = rules[i].level;
+				break;
+			}
+		}
+		if((file->level < 0) || (file->level > 9)) file->level = Z_DEFAULT_COMPRESSION;
+
+		f = fopen(file->path, "rb");
+		if(!f || fseek(f, 0, SEEK_END) || ((file->size = ftell(f)) < 0)) {
+			jm_log_error(callbacks, module, "Could not open %s for reading", file->path);
+			if(f) fclose(f);
+			status = jm_status_error;
+			break;
+		}
+		fclose(f);
+		fmi_zip_set_file_time(file->path, &file->info);
+		n_chunks += (file->size > 0) ? (file->size + FMI_ZIP_CHUNK_SIZE - 1) / FMI_ZIP_CHUNK_SIZE : 1;
 	}
 
-	/* Input arguments to the corresponding minizip main() function call */
-	/*
-	Usage : minizip [-o] [-a] [-0 to -9] [-p password] [-j] file.zip [files_to_add]
-
-	-o  Overwrite existing file.zip
-	-a  Append to existing file.zip
-	-0  Store only
-	-1  Compress faster
-	-9  Compress better
+	if(num_threads > n_chunks) num_threads = (unsigned int)n_chunks;
+	if(num_threads == 0) num_threads = 1;
+	batch_size = num_threads * FMI_ZIP_CHUNKS_PER_WORKER;
 
-	-j  exclude path. store only the file name.
-	*/
-	argv[0]="minizip";
-	argv[1]="-o";
-	argv[2]="-1";
-	argv[3]=(char*)zip_file_path;
+	memset(&job, 0, sizeof(job));
+	job.chunks = (fmi_zip_chunk_t*)callbacks->calloc(batch_size, sizeof(fmi_zip_chunk_t));
+	threads = (jm_thread_t**)callbacks->calloc(num_threads, sizeof(jm_thread_t*));
+	if((num_threads > 1) && threads) job.lock = jm_mutex_create(callbacks);
+	if((status == jm_status_success) && (!job.chunks || !threads || ((num_threads > 1) && !job.lock))) {
+		jm_log_fatal(callbacks, module, "Could not allocate memory");
+		status = jm_status_error;
+	}
 
-	/* Append the input argument list with the files to unzip */
-	jm_log_info(callbacks, "FMIZIP", "Will compress following files: \n");
-	for (k = 0; k < n_files_to_zip; k++) {
-		jm_log_info(callbacks, "FMIZIP", "\t%s\n", files_to_zip[k]);
-		argv[N_BASIC_ARGS + k] = (char*)files_to_zip[k];
+	zf = 0;
+	if(status == jm_status_success) {
+		zf = zipOpen64(zip_file_path, APPEND_STATUS_CREATE);
+		if(!zf) {
+			jm_log_error(callbacks, module, "Could not create %s", zip_file_path);
+			status = jm_status_error;
+		}
 	}
 
-	/* Zip */
-	status = minizip(argc, (char**)argv);
+	/* Compress a batch of chunks in parallel and append them to the archive in order */
+	k = 0;
+	offset = 0;
+	while((status == jm_status_success) && (done < n_chunks)) {
+		size_t i;
+
+		for(job.n_chunks = 0; job.n_chunks < batch_size && k < n_files_to_zip; job.n_chunks++) {
+			fmi_zip_chunk_t* chunk = &job.chunks[job.n_chunks];
+			memset(chunk, 0, sizeof(fmi_zip_chunk_t));
+			chunk->file = &files[k];
+			chunk->offset = offset;
+			chunk->size = (files[k].size - offset > FMI_ZIP_CHUNK_SIZE) ? FMI_ZIP_CHUNK_SIZE : files[k].size - offset;
+			if(files[k].level != 0) {
+				chunk->dictionary = (offset < FMI_ZIP_DICTIONARY_SIZE) ? offset : FMI_ZIP_DICTIONARY_SIZE;
+			}
+			/* A sync flush adds an empty stored block of at most 5 bytes */
+			chunk->data_size = compressBound(chunk->size) + 16;
+			chunk->input = (char*)callbacks->malloc(chunk->dictionary + chunk->size + 1);
+			chunk->data = (char*)callbacks->malloc(chunk->data_size);
+			if(!chunk->input || !chunk->data) {
+				jm_log_fatal(callbacks, module, "Could not allocate memory");
+				status = jm_status_error;
+			}
+			offset += chunk->size;
+			if(offset == files[k].size) {
+				offset = 0;
+				k++;
+			}
+		}
+		if(status == jm_status_success) {
+			fmi_zip_compress_batch(&job, num_threads, threads, callbacks);
+		}
 
-	/* Free allocated memory */
-	callbacks->free(argv);
+		for(i = 0; i < job.n_chunks; i++) {
+			fmi_zip_chunk_t* chunk = &job.chunks[i];
+			if((status == jm_status_success) && chunk->failed) {
+				jm_log_error(callbacks, module, "Could not compress %s", chunk->file->path);
+				status = jm_status_error;
+			}
+			if((status == jm_status_success) && (fmi_zip_write_chunk(zf, chunk, &crc) != ZIP_OK)) {
+				jm_log_error(callbacks, module, "Error while writing %s into %s", chunk->file->name, zip_file_path);
+				status = jm_status_error;
+			}
+			callbacks->free(chunk->input);
+			callbacks->free(chunk->data);
+		}
+		done += job.n_chunks;
+	}
 
-	/* Reset the current directory */
-	if (jm_portability_set_current_working_directory(cd) == jm_status_error) {
-		jm_log(callbacks, "UNZIP", jm_log_level_warning, "Could not change back Current Directory");
-		return jm_status_warning;
+	/* The central directory is written when the archive is closed */
+	if(zf && (zipClose(zf, NULL) != ZIP_OK) && (status == jm_status_success)) {
+		jm_log_error(callbacks, module, "Error while writing the central directory of %s", zip_file_path);
+		status = jm_status_error;
 	}
 
-	/* Return error status */
-	if (status == 0) {
-		return jm_status_success;
-	} else {
-		return jm_status_error;	
+	jm_mutex_free(job.lock);
+	callbacks->free(job.chunks);
+	callbacks->free(threads);
+	for(k = 0; k < n_files_to_zip; k++) {
+		callbacks->free(files[k].path);
 	}
+	callbacks->free(files);
+	return status;
 }